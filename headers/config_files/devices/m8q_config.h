@@ -18,8 +18,15 @@
 //=======================================================================================
 // Macros 
 
+// GPS message output. By default the M8Q sends the PUBX POSITION and TIME text messages 
+// which the driver parses. When set the M8Q sends the UBX NAV-PVT binary message instead 
+// and the controller parses it (see m8q_ubx.h). Can be set from the build. 
+#ifndef M8Q_UBX_NAV_PVT 
+#define M8Q_UBX_NAV_PVT 0                // 0 = PUBX POSITION and TIME, 1 = UBX NAV-PVT 
+#endif
+
 // Number of messages in a configuration packet 
-#define M8Q_CONFIG_MSG_NUM 12 
+#define M8Q_CONFIG_MSG_NUM 13 
 
 // Max length of a single config message in a packet 
 #define M8Q_CONFIG_MSG_MAX_LEN 150 
@@ -34,4 +41,4 @@ extern const char m8q_config_msgs[M8Q_CONFIG_MSG_NUM][M8Q_CONFIG_MSG_MAX_LEN];
 
 //=======================================================================================
 
-#endif  // _M8Q_CONFIG_H_
\ No newline at end of file
+#endif  // _M8Q_CONFIG_H_
@@ -37,6 +37,7 @@ mtbdl_fault_dir[],           // Fault sub-directory
 mtbdl_bike_param_file[],     // Bike parameters file 
 mtbdl_sys_param_file[],      // System parameters file 
 mtbdl_log_file[],            // Log file name template 
+mtbdl_log_file_bin[],        // Binary log file name template 
 mtbdl_fault_file[];          // Fault record file 
 
 //=======================================================================================
@@ -65,7 +66,12 @@ mtbdl_data_log_default[],    // Default data log message
 mtbdl_data_log_adc[],        // Default + ADC data log message 
 mtbdl_data_log_gps[],        // Default + GPS data log message 
 mtbdl_data_log_accel[],      // Default + Accelerometer data log message 
-mtbdl_data_log_speed[];      // Default + Wheel speed data log message 
+mtbdl_data_log_speed[],      // Default + Wheel speed (short/long window revs) message 
+mtbdl_data_log_rev_period[], // Default + Wheel revolution period data log message 
+mtbdl_data_log_sep[],        // Data log line field separator 
+mtbdl_data_log_blank[],      // Data log line fields with no data 
+// Execution time profiling 
+mtbdl_prof_start[];          // Start of the profiling footer 
 
 //=======================================================================================
 
@@ -79,6 +79,10 @@ typedef struct int_handle_flags_s
     uint8_t usart1_flag : 1;                       // USART1 global 
     uint8_t usart2_flag : 1;                       // USART2 global 
     uint8_t usart6_flag : 1;                       // USART6 global 
+
+    // I2C interrupt flags 
+    uint8_t i2c1_ev_flag : 1;                      // I2C1 event 
+    uint8_t i2c1_er_flag : 1;                      // I2C1 error 
 } 
 int_handle_flags_t;
 
@@ -274,9 +278,11 @@ void EXTI15_10_IRQHandler(void);
  *          then clears all the DMA interrupt flags so that the handler can be exited. 
  *          Interrupts can be produced when half-transfer is reached, transfer is complete, 
  *          there is a transfer error, there is a FIFO error (overrun, underrun, FIFO level 
- *          error), or there is a direct mode error. 
+ *          error), or there is a direct mode error. This stream is the I2C1 RX stream so 
+ *          the I2C bus manager is called to finish the read in flight. 
  * 
  * @see dma_clear_int_flags
+ * @see i2c_bus_dma_handler 
  */
 void DMA1_Stream0_IRQHandler(void); 
 
@@ -388,7 +394,11 @@ void DMA1_Stream7_IRQHandler(void);
  *          there is a transfer error, there is a FIFO error (overrun, underrun, FIFO level 
  *          error), or there is a direct mode error. 
  * 
+ *          This stream moves ADC1 samples into the data logging buffers and interrupts 
+ *          when a buffer is full. log_data_adc_handler is called to hand off the samples. 
+ * 
  * @see dma_clear_int_flags
+ * @see log_data_adc_handler 
  */
 void DMA2_Stream0_IRQHandler(void); 
 
@@ -669,6 +679,29 @@ void USART2_IRQHandler(void);
  */
 void USART6_IRQHandler(void); 
 
+
+/**
+ * @brief I2C1 event interrupt handler 
+ * 
+ * @details Interrupt handler for I2C1 events. This handler sets i2c1_ev_flag and runs the 
+ *          I2C bus manager transaction in flight. The event flags are cleared by the 
+ *          register accesses of the bus manager. 
+ * 
+ * @see i2c_bus_ev_handler 
+ */
+void I2C1_EV_IRQHandler(void); 
+
+
+/**
+ * @brief I2C1 error interrupt handler 
+ * 
+ * @details Interrupt handler for I2C1 errors. This handler sets i2c1_er_flag and lets the 
+ *          I2C bus manager clear the error and stop the transaction in flight. 
+ * 
+ * @see i2c_bus_er_handler 
+ */
+void I2C1_ER_IRQHandler(void); 
+
 //=======================================================================================
 
 #ifdef __cplusplus
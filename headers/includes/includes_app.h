@@ -28,6 +28,8 @@
 #include "sd_controller.h"
 #include "m8q_controller.h"
 #include "mpu6050_controller.h"
+#include "i2c_bus.h"
+#include "sd_spi.h"
 
 // Config files 
 #include "battery_config.h"
@@ -21,6 +21,15 @@
 #include "includes_drivers.h"
 #include "system_parameters.h"
 #include "string_config.h"
+#include "log_record.h"
+#include "log_ring.h"
+#include "log_format.h"
+#include "log_pack.h"
+#include "log_prof.h"
+#include "log_rev.h"
+#include "log_schedule.h"
+#include "mpu6050_controller.h"
+#include "m8q_controller.h"
 
 //=======================================================================================
 
@@ -28,23 +37,145 @@
 //=======================================================================================
 // Macros 
 
+// Suspension (fork and shock) sample rate. Can be set from the build. The sample period 
+// must divide evenly into the log stream period so the rate can be 100, 200, 500 or 
+// 1000 Hz. 
+#ifndef LOG_SUS_RATE 
+#define LOG_SUS_RATE 100                 // (Hz) ADC sample rate 
+#endif
+
 // Data logging sequence/timing 
-#define LOG_PERIOD 10                    // (ms) Period between data samples 
-#define LOG_PERIOD_DIVIDER 5             // LOG_PERIOD * this == non-ADC log stream period 
-#define LOG_GPS_OFFSET 0                 // GPS stream starting log offset 
-#define LOG_GPS_PERIOD 20                // GPS stream counter period 
-#define LOG_ACCEL_OFFSET 1               // ACCEL stream starting log offset 
-#define LOG_ACCEL_PERIOD 2               // ACCEL stream counter period 
-#define LOG_SPEED_OFFSET 2               // SPEED stream starting log offset 
-#define LOG_SPEED_PERIOD 4               // SPEED stream counter period 
+#define LOG_PERIOD (1000 / LOG_SUS_RATE)   // (ms) Period between data samples 
+#define LOG_PERIOD_US (LOG_PERIOD * 1000)  // (us) Period between data samples 
+#define LOG_PERIOD_DIVIDER (LOG_STREAM_PERIOD / LOG_PERIOD)   // Samples per stream period 
+// The log stream period (LOG_STREAM_PERIOD) and the GPS, accel and speed stream timing 
+// are set in the log stream schedule (log_schedule.h). 
 
 // Buffer sizes 
-#define LOG_GPS_BUFF_LEN 12              // GPS coordinate buffer size 
 #define LOG_TIME_BUFF_LEN 10             // UTC time and data buff size 
 #define LOG_MAX_LOG_LEN (LOG_PERIOD_DIVIDER*MTBDL_MAX_STR_LEN) 
-
-// Wheel RPM info 
-#define LOG_REV_SAMPLE_SIZE 20           // Number of samples for revolution calc 
+#define LOG_ADC_RING_SIZE 512            // ADC sample sets that can be queued - power of 2 
+#define LOG_ADC_BLOCK_SIZE LOG_PERIOD_DIVIDER   // ADC sample sets per DMA buffer 
+#define LOG_ADC_NUM_BLOCKS 2             // DMA buffers (double buffer mode) 
+
+// ADC oversampling. Each logged ADC sample is made from LOG_ADC_OSR conversions which 
+// gives LOG_ADC_OSR_BITS more bits of resolution than a single conversion. Can be set 
+// from the build. 
+#ifndef LOG_ADC_OSR_BITS 
+#define LOG_ADC_OSR_BITS 2               // Extra bits: 0-2 (1x, 4x or 16x oversampling) 
+#endif
+#define LOG_ADC_OSR (1 << (2 * LOG_ADC_OSR_BITS))   // Conversions per logged sample 
+#define LOG_ADC_CONV_BITS 10             // Resolution of one conversion (ADC_RES_10) 
+#define LOG_ADC_RES_BITS (LOG_ADC_CONV_BITS + LOG_ADC_OSR_BITS)   // Logged ADC resolution 
+
+// Wheel RPM info. The revolutions counted in each speed stream period are summed over 
+// a short and a long window (lengths in speed stream periods) and both sums are logged 
+// together. The long window sets the revolution buffer size. Can be set from the build. 
+#ifndef LOG_REV_WINDOW_SHORT 
+#define LOG_REV_WINDOW_SHORT 5           // Short revolution window (1s at 200ms) 
+#endif
+#ifndef LOG_REV_WINDOW_LONG 
+#define LOG_REV_WINDOW_LONG 20           // Long revolution window (4s at 200ms) 
+#endif
+#define LOG_REV_NUM_WINDOWS LOG_REC_REV_WINDOWS   // Revolution windows logged 
+#define LOG_REV_SAMPLE_SIZE LOG_REV_WINDOW_LONG   // Number of samples for revolution calc 
+
+// Wheel speed measurement. Can be set from the build. By default the Hall effect sensor 
+// (PB0) triggers EXTI0 and the revolutions in each speed stream period are counted. 
+// With input capture the sensor goes to PA0 (TIM5 channel 1) and every revolution is 
+// timestamped by the timer and copied to rev_capture by DMA, so the period of every 
+// revolution is logged to the microsecond in place of the revolution count (see 
+// log_rev.h). The log header shows revolution window sizes (REV_size) of 0 when the 
+// period is logged. Revolutions are at least LOG_REV_MIN_PERIOD apart so a speed stream 
+// sees 10 at most (12 leaves room for a deferred slot). Any more stay in rev_capture 
+// for the next speed stream. 
+#ifndef LOG_SPEED_CAPTURE 
+#define LOG_SPEED_CAPTURE 0              // 0 = count EXTI0 edges, 1 = TIM5 input capture 
+#endif
+#define LOG_REV_CAPTURE_SIZE 16          // Revolution timestamps the DMA buffer holds 
+#define LOG_REV_MAX_PERIODS 12           // Revolution periods logged per speed stream 
+
+// IMU FIFO. When set the MPU-6050 samples the accelerometer and gyroscope into its FIFO 
+// at LOG_IMU_RATE and the FIFO is read in one burst every log stream period. Every 
+// sample goes in an IMU record, so this only adds data to binary and packed logs. Each 
+// sample is 12 bytes over I2C. The burst reads run in the background in fast mode 
+// (400kHz) through the I2C bus manager and the samples are logged the period after 
+// they're read. 0 turns the FIFO off. Can be set from the build. 
+#ifndef LOG_IMU_RATE 
+#define LOG_IMU_RATE 200                 // (Hz) IMU FIFO sample rate: 0 or 1000/n 
+#endif
+#define LOG_IMU_RATE_DIV (LOG_IMU_RATE ? (MPU6050_FIFO_BASE_RATE / LOG_IMU_RATE - 1) : 0) 
+#define LOG_IMU_BUFF_SIZE MPU6050_FIFO_SIZE   // (bytes) IMU FIFO burst read buffer 
+#define LOG_IMU_MAX_SAMPLES (LOG_IMU_BUFF_SIZE / MPU6050_FIFO_FRAME_SIZE)   // Per burst 
+
+// Log file format 
+#define LOG_MODE_DEFAULT LOG_MODE_TEXT   // Log file format used at startup 
+
+// Log file pre-allocation - set LOG_PREALLOC_TIME to 0 to let log files grow as written. 
+// The expected data rate (bytes/s) of each log mode sizes the pre-allocation. Binary and 
+// packed logs also hold the IMU samples plus an IMU record for each burst read (one per 
+// log stream period). 
+#define LOG_PREALLOC_TIME 7200           // (s) Expected ride length 
+#define LOG_PREALLOC_IMU_RATE (LOG_IMU_RATE ? \
+    ((LOG_IMU_RATE * MPU6050_FIFO_FRAME_SIZE) + \
+     ((1000 / LOG_STREAM_PERIOD) * sizeof(log_rec_imu_t))) : 0) 
+#define LOG_PREALLOC_TEXT_RATE (40 * LOG_SUS_RATE) 
+#define LOG_PREALLOC_BIN_RATE ((9 * LOG_SUS_RATE) + LOG_PREALLOC_IMU_RATE) 
+#define LOG_PREALLOC_PACK_RATE ((4 * LOG_SUS_RATE) + LOG_PREALLOC_IMU_RATE) 
+
+// Log file sync. A sync commits the file to the card's directory and FAT. Binary and 
+// packed logs get a sync record with its offset in the log data first. A pre-allocated 
+// file keeps its full size through each sync, so after a crash or power loss during a 
+// ride the file holds stale card data past the last data written, and the last sync 
+// record on the card is what marks where the log data ends (see log_record.h). Text logs 
+// have no sync records so the text format doesn't change. A sync is due once 
+// LOG_SYNC_PERIOD has passed or LOG_SYNC_SECTORS of log data have been written since the 
+// last one (0 turns that limit off). It runs in the first log stream slot whose streams 
+// leave LOG_SYNC_COST of the slot budget, which at the full budget is the next slot of 
+// the standard stream. The first sync is due at the start of the log. Set both limits to 
+// 0 to only sync the log when it's closed. The limits can be set from the build. 
+#ifndef LOG_SYNC_PERIOD 
+#define LOG_SYNC_PERIOD 10               // (s) Time between syncs 
+#endif
+#ifndef LOG_SYNC_SECTORS 
+#define LOG_SYNC_SECTORS 64              // Sectors of log data between syncs 
+#endif
+#define LOG_SYNC_COST 1500               // (us) Sync time (directory write and card busy) 
+// Sync limits in log stream slots and bytes. A limit that's off is never reached. 
+#define LOG_SYNC_ENABLE (LOG_SYNC_PERIOD || LOG_SYNC_SECTORS) 
+#define LOG_SYNC_SLOTS \
+    (LOG_SYNC_PERIOD ? ((uint32_t)LOG_SYNC_PERIOD * 1000 / LOG_STREAM_PERIOD) : UINT32_MAX)
+#define LOG_SYNC_BYTES \
+    (LOG_SYNC_SECTORS ? ((uint32_t)LOG_SYNC_SECTORS * SD_SECTOR_SIZE) : UINT32_MAX)
+
+// Packed logs - ADC samples are packed in blocks of one log stream period 
+#define LOG_PACK_KEY_PERIOD 20           // Blocks per keyframe (1s at a 50ms stream period) 
+
+#if (LOG_SUS_RATE < 100) || (LOG_SUS_RATE > 1000) || (1000 % LOG_SUS_RATE) || \
+    (LOG_STREAM_PERIOD % LOG_PERIOD)
+#error "LOG_SUS_RATE must be 100Hz-1kHz and divide evenly into 1s and LOG_STREAM_PERIOD"
+#endif
+
+#if (LOG_ADC_OSR_BITS < 0) || (LOG_ADC_OSR_BITS > 2)
+#error "LOG_ADC_OSR_BITS must be 0-2"
+#endif
+
+#if LOG_PERIOD_DIVIDER > LOG_PACK_MAX_SAMPLES
+#error "A log stream period has more ADC samples than a packed block can hold"
+#endif
+
+#if (LOG_IMU_RATE < 0) || (LOG_IMU_RATE > 1000) || (LOG_IMU_RATE && (1000 % LOG_IMU_RATE))
+#error "LOG_IMU_RATE must be 0 or divide evenly into 1kHz"
+#endif
+
+#if (LOG_SYNC_PERIOD < 0) || (LOG_SYNC_SECTORS < 0) || (LOG_SYNC_COST > LOG_SLOT_BUDGET)
+#error "Log sync limits can't be negative and the sync cost must fit in LOG_SLOT_BUDGET"
+#endif
+
+#if (LOG_REV_WINDOW_SHORT < 1) || (LOG_REV_WINDOW_SHORT > LOG_REV_WINDOW_LONG) || \
+    (LOG_REV_WINDOW_LONG > 255)
+#error "Revolution windows must be 1-255 speed periods with the short window first"
+#endif
 
 //=======================================================================================
 
@@ -60,68 +191,107 @@ typedef enum {
     ADC_BUFF_SIZE   // Size of buffer to hold all ADC values 
 } mtbdl_adc_buff_index_t; 
 
+
+// Log file format 
+typedef enum {
+    LOG_MODE_TEXT,     // Human readable lines - log_%u.txt 
+    LOG_MODE_BINARY,   // Fixed width records (see log_record.h) - log_%u.bin 
+    LOG_MODE_PACKED,   // Records with packed ADC blocks (see log_pack.h) - log_%u.bin 
+    LOG_MODE_NUM       // Number of log modes 
+} log_mode_t; 
+
 //=======================================================================================
 
 
 //=======================================================================================
 // Structure 
 
+// ADC sample set queued by the ADC interrupt 
+typedef struct log_adc_set_s
+{
+    uint16_t sample[ADC_BUFF_SIZE];             // Decimated ADC values 
+    uint32_t time;                              // (us) Timebase count of the sample 
+}
+log_adc_set_t; 
+
+
 // Data logging data record 
 typedef struct mtbdl_log_s 
 {
     // Peripherals 
     IRQn_Type rpm_irq;                          // Wheel RPM interrupt number 
-    IRQn_Type log_irq;                          // Log sample period interrupt number 
+    IRQn_Type log_irq;                          // ADC DMA stream interrupt number 
     ADC_TypeDef *adc;                           // ADC port for battery soc and pots 
     DMA_TypeDef *dma;                           // DMA port for ADC transfers 
     DMA_Stream_TypeDef *dma_stream;             // DMA stream for ADC transfers 
+    TIM_TypeDef *timebase;                      // Free running 32-bit 1us timer 
 
     // Log file info 
+    log_mode_t log_mode;                        // Log file format 
     uint8_t utc_time[LOG_TIME_BUFF_LEN];        // UTC time 
     uint8_t utc_date[LOG_TIME_BUFF_LEN];        // UTC date 
 
-    // ADC data - buffers to store current and pervious values - SOC, fork pot, shock pot 
-    uint16_t adc_buff[ADC_BUFF_SIZE]; 
-    uint16_t adc_period[LOG_PERIOD_DIVIDER][ADC_BUFF_SIZE]; 
+    // ADC data - SOC, fork pot, shock pot. The DMA fills the adc_block buffers with 
+    // LOG_ADC_OSR conversions for each sample set, the DMA interrupt decimates each 
+    // sample set of a full buffer, gives it its time and queues it in adc_ring and 
+    // log_data pops them into adc_set. 
+    uint16_t adc_block[LOG_ADC_NUM_BLOCKS][LOG_ADC_BLOCK_SIZE][LOG_ADC_OSR][ADC_BUFF_SIZE]; 
+    log_adc_set_t adc_set; 
+    log_adc_set_t adc_ring_buff[LOG_ADC_RING_SIZE]; 
+    log_ring_t adc_ring; 
+    log_pack_t adc_pack;                        // ADC sample packing (packed mode) 
 
     // GPS data 
-    uint8_t lat_str[LOG_GPS_BUFF_LEN];          // Latitude string 
-    uint8_t NS;                                 // North/South indicator of latitude 
-    uint8_t lon_str[LOG_GPS_BUFF_LEN];          // Longitude string 
-    uint8_t EW;                                 // East/West indicator of longitude 
-    uint8_t sog_str[LOG_GPS_BUFF_LEN];          // Speed over ground string 
+    m8q_fix_t gps;                              // Last fix from the GPS controller 
 
     // Accelerometer data 
     int16_t accel[NUM_AXES]; 
 
+    // IMU FIFO data 
+    uint8_t imu_buff[LOG_IMU_BUFF_SIZE];        // IMU FIFO burst read buffer 
+    uint8_t imu_rec[sizeof(log_rec_imu_t) +     // IMU record of a burst read 
+                    LOG_IMU_MAX_SAMPLES*sizeof(log_rec_imu_sample_t)]; 
+    uint16_t imu_overflow;                      // IMU FIFO overflow count last checked 
+
     // Wheel revolution data 
     uint8_t rev_count;                          // Wheel revolution counter 
     uint8_t rev_buff_index;                     // Wheel revolution circular buffer index 
     uint8_t rev_buff[LOG_REV_SAMPLE_SIZE];      // Wheel revolution circular buffer
+    uint16_t rev_sums[LOG_REV_NUM_WINDOWS];     // Revolutions in each window (running sum) 
+    TIM_TypeDef *rev_timer;                     // Revolution capture timer (input capture) 
+    DMA_Stream_TypeDef *rev_dma_stream;         // Revolution capture DMA stream 
+    volatile uint32_t rev_capture[LOG_REV_CAPTURE_SIZE];   // Revolution timestamps (DMA) 
+    log_rev_t rev;                              // Revolution period from rev_capture 
 
     // User input data 
     uint8_t trailmark;                          // Trail marker flag 
 
     // Logging counters 
-    uint8_t log_interval_divider;               // Controls timing of non-ADC streams 
-    uint8_t gps_stream_counter;                 // GPS log stream counter 
-    uint8_t accel_stream_counter;               // Accelerometer log stream counter 
-    uint8_t speed_stream_counter;               // Wheel speed log stream counter 
-    uint8_t interrupt_counter;                  // Counts interrupts called 
+    log_schedule_t schedule;                    // Log stream schedule 
+    char *line;                                 // Text line of the slot being written 
+    uint8_t line_field;                         // Next field of the slot text line 
 
     // Calibration data 
     int32_t cal_buff[PARAM_SYS_SET_NUM];        // Calibration data buffer 
     int32_t cal_adc_samples;                    // Number of ADC calibration samples 
     int32_t cal_accel_samples;                  // Number of accelerometer calibration samples 
 
-    // SD card data - buffers to hold interval data, log data string and log file name 
-    char data_buff[LOG_PERIOD_DIVIDER][MTBDL_MAX_STR_LEN]; 
+    // SD card data - log data string that holds the data from each interval until it's 
+    // written, and log file name 
     char data_str[LOG_MAX_LOG_LEN]; 
+    uint16_t data_len;                          // Bytes of log data in data_str 
     uint8_t data_buff_index; 
     char filename[MTBDL_MAX_STR_LEN]; 
 
+    // Log file sync 
+    uint32_t log_id;                            // Log id of the header and sync records 
+    uint32_t data_bytes;                        // Log data bytes written after the header 
+    uint32_t sync_slots;                        // Log stream slots since the last sync 
+    uint32_t sync_offset;                       // Log data bytes at the last sync 
+    uint32_t sync_seq;                          // Sync records written 
+
     // Debugging / log checking 
-    uint8_t overrun;                            // Checks if data has been skipped 
+    uint8_t overrun;                            // ADC sample sets dropped (saturates) 
 }
 mtbdl_log_t; 
 
@@ -136,11 +306,17 @@ mtbdl_log_t;
  * 
  * @details Sets all the data handling info to its default value and configures the DMA 
  *          stream. DMA stream configuration is done here instead of in the setup file so 
- *          the buffer used to store ADC values (for suspension position and battery SOC) 
- *          is within scope to set as the DMA memory address. 
+ *          the buffers used to store ADC values (for suspension position and battery SOC) 
+ *          are within scope to set as the DMA memory addresses. 
+ * 
+ *          The ADC conversions are started by a timer trigger LOG_ADC_OSR times every 
+ *          sample period and the DMA stream runs in circular double buffer mode, swapping 
+ *          between two buffers of LOG_ADC_BLOCK_SIZE oversampled sample sets. The stream 
+ *          must be initialized with double buffer mode enabled. The transfer complete 
+ *          interrupt is enabled here and fires each time a buffer is full. 
  * 
  * @param rpm_irqn : wheel speed periodic interrupt index 
- * @param log_irqn : data sample periodic interrupt index 
+ * @param log_irqn : ADC DMA stream interrupt index 
  * @param adc : ADC port used 
  * @param dma : DMA port to use 
  * @param dma_stream : DMA stream being used 
@@ -152,6 +328,51 @@ void log_init(
     DMA_TypeDef *dma, 
     DMA_Stream_TypeDef *dma_stream); 
 
+
+/**
+ * @brief Initialize the timebase 
+ * 
+ * @details The timer must already be set to count up in microseconds over its full 32 
+ *          bits (TIM2 or TIM5) and stay running. Its count is read in the ADC interrupt 
+ *          to time each sample set and when the IMU is read, and the times go in binary 
+ *          and packed logs (see log_record.h). Must be set before logging starts. 
+ * 
+ * @param timer : free running 32-bit 1us timer 
+ */
+void log_timebase_init(TIM_TypeDef *timer); 
+
+
+/**
+ * @brief Initialize wheel revolution input capture 
+ * 
+ * @details Only used when LOG_SPEED_CAPTURE is set. Configures the DMA stream to copy 
+ *          each capture of the timer's channel 1 into the revolution timestamp buffer. 
+ *          The timer must already be set to count in microseconds with channel 1 in 
+ *          input capture mode with DMA requests enabled, and the DMA stream must be 
+ *          initialized in circular mode with word size transfers. 
+ * 
+ * @param timer : revolution capture timer (channel 1) 
+ * @param dma_stream : DMA stream of the timer's channel 1 requests 
+ */
+void log_rev_capture_init(
+    TIM_TypeDef *timer, 
+    DMA_Stream_TypeDef *dma_stream); 
+
+
+/**
+ * @brief Initialize the IMU FIFO 
+ * 
+ * @details Only used when LOG_IMU_RATE is set. Sets the IMU sample rate to LOG_IMU_RATE 
+ *          and enables the IMU FIFO with the IMU burst read buffer through the IMU 
+ *          controller. The IMU controller must already be initialized. 
+ * 
+ * @param i2c : I2C port the IMU is on 
+ * @param addr : IMU I2C address 
+ */
+void log_imu_fifo_init(
+    I2C_TypeDef *i2c, 
+    mpu6050_i2c_addr_t addr); 
+
 //=======================================================================================
 
 
@@ -207,19 +428,25 @@ void log_data_prep(void);
  *          called continuously while in data logging mode in order for all data to be 
  *          captured. 
  *          
- *          A periodic interrupt will call the log_data_adc_handler function which 
- *          records ADC data and increments an interrupt counter. This function looks for 
- *          the interrupt counter to be greater than 0. If this is true then it writes 
- *          data from the previous interval to the SD card. Data that can be written 
- *          includes ADC data (suspension position), GPS location, IMU orientation, wheel 
- *          speed and user input/flags. ADC data gets recorded each interval, while GPS, 
- *          IMU and speed data gets recorded at a slower frequency but on a fixed 
- *          schedule. The schedule for this data is defined in such a way that only 
- *          one of GPS, IMU or speed data will get read and recorded during an interval. 
- *          This is done because the interval is short and too much data handling could 
- *          lead to a loss of data. 
+ *          The ADC DMA interrupt will call the log_data_adc_handler function which 
+ *          queues the ADC data of each interval in a ring buffer. This function pops one 
+ *          interval from the ring each time it's called and formats it, and every 
+ *          LOG_PERIOD_DIVIDER intervals it writes the formatted data to the SD card. The 
+ *          ring lets the interrupt keep queueing intervals while a slow SD card write is 
+ *          in progress. Intervals are only lost if the ring fills up, in which case 
+ *          they're counted as an overrun. Data that can be written includes ADC data 
+ *          (suspension position), GPS location, IMU orientation, wheel speed and user 
+ *          input/flags. ADC data gets recorded each interval, while GPS, IMU and speed 
+ *          data gets recorded at a slower frequency in the last interval of a log stream 
+ *          slot, on a fixed schedule (see log_schedule.h). The streams due in a slot run 
+ *          together as long as their cost fits in LOG_SLOT_BUDGET. A stream that doesn't 
+ *          fit is deferred to the next slot, so the time spent in one interval stays 
+ *          bounded and the ADC ring can cover it. 
  *          
- *          The perodic interrupt triggers every 10ms. 
+ *          ADC samples are taken at LOG_SUS_RATE (every LOG_PERIOD ms) which can be set 
+ *          up to 1kHz to capture fast suspension movement. The GPS, IMU and speed 
+ *          schedule counts in LOG_STREAM_PERIOD steps so it doesn't change with the 
+ *          sample rate. 
  *          
  *          This function will also increment a revolution counter triggered by an 
  *          external interrupt which is used to help with the wheel speed calculation. 
@@ -238,13 +465,19 @@ void log_data(void);
 /**
  * @brief Data logging interrupt callback 
  * 
- * @details When in data logging mode, a periodic interrupt is used to keep track of 
- *          when to record data. The interrupt handler calls this function. In this 
- *          function an interrupt counter is incremented and ADC data from the previous 
- *          interval recorded. The counter is used to trigger a data recording in the 
- *          log file when the log_data function is called. Before exiting, this function 
- *          will start the next ADC conversion which will be recored the next time the 
- *          interrupt is triggered. 
+ * @details The ADC conversions are started by a timer trigger LOG_ADC_OSR times every 
+ *          sample period and the results are moved into one of two buffers by the DMA. 
+ *          When a buffer is full the DMA moves on to the other buffer and the DMA 
+ *          transfer complete interrupt handler calls this function. When in data logging 
+ *          mode, the conversions of each sample set (interval) in the full buffer are 
+ *          decimated to one sample set of LOG_ADC_RES_BITS resolution which is pushed 
+ *          onto the ADC ring buffer where it waits to be recorded in the log file by the 
+ *          log_data function. If the ring is full the data is dropped and counted. 
+ * 
+ *          Sample timing is set by the timer alone so it doesn't depend on interrupt 
+ *          latency or CPU load, and there's one interrupt per LOG_ADC_BLOCK_SIZE samples. 
+ *          The timebase is read once per block and each sample set is queued with its 
+ *          time, counted back LOG_PERIOD_US per sample from the last one of the block. 
  * 
  * @see log_data 
  */
@@ -334,6 +567,31 @@ void log_calibration_calculation(void);
  */
 void log_set_trailmark(void); 
 
+
+/**
+ * @brief Set the log file format 
+ * 
+ * @details Selects whether data logs are written as text lines (LOG_MODE_TEXT), as the 
+ *          fixed width binary records defined in log_record.h (LOG_MODE_BINARY) or as 
+ *          binary records with the ADC samples packed (LOG_MODE_PACKED). Binary records 
+ *          are a fraction of the size of the text lines and need no formatting, which 
+ *          leaves more time in each logging interval. Packed logs replace the ADC 
+ *          records with a block of samples per log stream period, each sample written as 
+ *          the zig-zag varint encoded delta from the one before it and every 
+ *          LOG_PACK_KEY_PERIOD blocks a keyframe that decodes on its own (see 
+ *          log_pack.h). Most samples then take one byte. Binary and packed logs are 
+ *          converted to the text format on a host using the log decoder tool, which 
+ *          unpacks the ADC blocks of packed logs. 
+ * 
+ *          The mode is applied when the next log file name is generated so it should not 
+ *          be changed while data logging. Invalid modes are ignored. 
+ * 
+ * @see log_data_name_prep 
+ * 
+ * @param mode : log file format 
+ */
+void log_set_mode(log_mode_t mode); 
+
 //=======================================================================================
 
 
@@ -352,12 +610,45 @@ void log_set_trailmark(void);
  *          
  *          Note that the value returned will depend on both the ADC resolution set and 
  *          the voltage range of the battery. The SOC calculation should account for 
- *          this. 
+ *          this. The value is oversampled so it has LOG_ADC_RES_BITS of resolution. 
  * 
  * @return uint16_t : battery ADC that represents voltage 
  */
 uint16_t log_get_batt_voltage(void); 
 
+
+/**
+ * @brief Get the ADC ring count 
+ * 
+ * @details Returns the number of ADC sample sets waiting to be logged. 
+ * 
+ * @return uint32_t : ADC sample sets in the ADC ring 
+ */
+uint32_t log_get_adc_ring_count(void); 
+
+
+/**
+ * @brief Get the ADC ring high water mark 
+ * 
+ * @details Returns the most ADC sample sets that were waiting to be logged at once since 
+ *          the last log or calibration was started. This shows how close the logging has 
+ *          come to dropping data relative to LOG_ADC_RING_SIZE. 
+ * 
+ * @return uint32_t : ADC ring high water mark 
+ */
+uint32_t log_get_adc_ring_hwm(void); 
+
+
+/**
+ * @brief Get the ADC ring drop count 
+ * 
+ * @details Returns the number of ADC sample sets dropped because the ADC ring was full 
+ *          since the last log or calibration was started. 
+ * 
+ * @return uint32_t : ADC ring drop count 
+ */
+uint32_t log_get_adc_ring_drops(void); 
+
 //=======================================================================================
 
 #endif   // _DATA_LOGGING_H_ 
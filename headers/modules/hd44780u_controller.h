@@ -29,6 +29,9 @@ extern "C" {
 // Drivers 
 #include "hd44780u_driver.h"
 
+// Modules 
+#include "i2c_bus.h"
+
 //=======================================================================================
 
 
@@ -0,0 +1,246 @@
+/**
+ * @file i2c_bus.h
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief I2C bus manager interface 
+ * 
+ * @details Shares one I2C port between the devices on it (screen, IMU and GPS). Reads 
+ *          and writes are posted as transactions and run in the background from the I2C 
+ *          interrupts. Reads use a DMA stream so only the start, address and stop of a 
+ *          transaction need the CPU. Each transaction is a register (or data stream) 
+ *          address write followed by a read (repeated start) or by the data to write. 
+ * 
+ *          Transactions are queued by priority and run in the order they were posted 
+ *          within a priority. The transaction in flight is never stopped for a new one. 
+ *          When a transaction finishes its callback is called from the interrupt, which 
+ *          can post the next transaction of a sequence (ex. a read sized by a read before 
+ *          it). 
+ * 
+ *          The bus can be given a free running 32-bit timer (timebase) so each finished 
+ *          transaction holds the timer count at the time it finished. Sensor data read 
+ *          through the bus can then be placed in time without depending on when the 
+ *          data is used. 
+ * 
+ *          Transactions can run in fast mode (400kHz) for devices that support it. The 
+ *          bus goes back to standard mode (100kHz) for blocking driver calls. 
+ * 
+ *          Device drivers that use the bus directly (blocking) must lock the bus for the 
+ *          driver calls. Locking waits for the transaction in flight and holds back the 
+ *          queue until the bus is unlocked. Drivers that aren't time critical (screen) 
+ *          should only lock the bus when it's idle so they never delay a sensor read. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _I2C_BUS_H_ 
+#define _I2C_BUS_H_ 
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=======================================================================================
+// Includes 
+
+#include "i2c_comm.h"
+#include "dma_driver.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+// Fast mode (400kHz) timing for a 42MHz APB1 clock. Standard mode timing is whatever the 
+// I2C port was initialized with. 
+#define I2C_BUS_CCR_FM 35                // 42MHz / (3 * 400kHz) - 2:1 low/high duty 
+#define I2C_BUS_TRISE_FM 13              // 300ns max rise time at 42MHz + 1 
+
+// Lock wait loop count before the transaction in flight is stopped (device not 
+// responding). Longer than the largest IMU FIFO read in standard mode. 
+#define I2C_BUS_TIMEOUT 0x003FFFFF 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Enums 
+
+// Transaction direction 
+typedef enum {
+    I2C_BUS_WRITE,             // Write the register address then the data 
+    I2C_BUS_READ               // Write the register address then read the data 
+} i2c_bus_dir_t; 
+
+
+// Transaction priority - higher priority transactions run first 
+typedef enum {
+    I2C_BUS_PRIO_HIGH,         // Data is lost if late (ex. IMU FIFO) 
+    I2C_BUS_PRIO_NORMAL,       // Sensor reads (ex. GPS) 
+    I2C_BUS_PRIO_LOW           // Not time critical (ex. screen) 
+} i2c_bus_prio_t; 
+
+
+// Bus speed 
+typedef enum {
+    I2C_BUS_SM,                // Standard mode (100kHz) 
+    I2C_BUS_FM                 // Fast mode (400kHz) 
+} i2c_bus_speed_t; 
+
+
+// Transaction status 
+typedef enum {
+    I2C_BUS_IDLE,              // Not posted yet 
+    I2C_BUS_QUEUED,            // Waiting for the bus 
+    I2C_BUS_BUSY,              // In flight 
+    I2C_BUS_DONE,              // Finished 
+    I2C_BUS_ERROR              // Stopped - no acknowledge, bus error or timeout 
+} i2c_bus_status_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// I2C bus transaction. The transaction is owned by the caller and must stay valid until 
+// it's finished. 
+typedef struct i2c_bus_trans_s
+{
+    // Set by the caller 
+    uint8_t addr;                               // Device address (8-bit write address) 
+    uint8_t reg;                                // Register address written first 
+    uint8_t dir;                                // Direction - i2c_bus_dir_t 
+    uint8_t prio;                               // Priority - i2c_bus_prio_t 
+    uint8_t speed;                              // Bus speed - i2c_bus_speed_t 
+    uint8_t *data;                              // Data to write or read buffer 
+    uint16_t len;                               // Bytes to write or read 
+    void (*callback)(struct i2c_bus_trans_s *); // Called when finished, NULL for none 
+    void *context;                              // Caller data for the callback 
+
+    // Set by the bus 
+    volatile uint8_t status;                    // Status - i2c_bus_status_t 
+    uint32_t time;                              // Timebase count when finished 
+    struct i2c_bus_trans_s *next;               // Next transaction in the queue 
+}
+i2c_bus_trans_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Functions 
+
+/**
+ * @brief I2C bus manager initialization 
+ * 
+ * @details The I2C port must already be initialized in standard mode and the DMA stream 
+ *          set up for I2C RX (peripheral to memory, byte size, memory increment, no 
+ *          circular mode). The DMA stream interrupts are configured here. The I2C event, 
+ *          I2C error and DMA stream interrupt handlers must call the handlers below. 
+ * 
+ * @param i2c : I2C port the devices are on 
+ * @param dma : DMA port of the I2C RX stream 
+ * @param dma_stream : I2C RX DMA stream 
+ * @param timer : free running 32-bit timebase, NULL for no transaction times 
+ */
+void i2c_bus_init(
+    I2C_TypeDef *i2c, 
+    DMA_TypeDef *dma, 
+    DMA_Stream_TypeDef *dma_stream, 
+    TIM_TypeDef *timer); 
+
+
+/**
+ * @brief Post a transaction 
+ * 
+ * @details Queues the transaction by priority and starts it if the bus is free. The 
+ *          status shows when it's finished if there's no callback. A transaction can't 
+ *          be posted again until it's finished. Can be called from a transaction 
+ *          callback. 
+ * 
+ * @param trans : transaction 
+ * @return uint8_t : TRUE if posted, FALSE if invalid or still queued/in flight 
+ */
+uint8_t i2c_bus_post(i2c_bus_trans_t *trans); 
+
+
+/**
+ * @brief Check if the bus is idle 
+ * 
+ * @return uint8_t : TRUE if there's no transaction in flight or queued and the bus isn't 
+ *                   locked 
+ */
+uint8_t i2c_bus_idle(void); 
+
+
+/**
+ * @brief Get the timebase count 
+ * 
+ * @details For timing blocking driver calls the same way as finished transactions. 
+ * 
+ * @return uint32_t : timebase count, 0 if the bus has no timebase 
+ */
+uint32_t i2c_bus_time(void); 
+
+
+/**
+ * @brief Lock the bus for blocking driver calls 
+ * 
+ * @details Waits for the transaction in flight to finish (stopped as an error after 
+ *          I2C_BUS_TIMEOUT) and puts the bus in standard mode. Queued and newly posted 
+ *          transactions wait until the bus is unlocked. Locks don't nest. 
+ */
+void i2c_bus_lock(void); 
+
+
+/**
+ * @brief Unlock the bus 
+ * 
+ * @details Starts the next queued transaction. 
+ */
+void i2c_bus_unlock(void); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Interrupt callbacks 
+
+/**
+ * @brief I2C event interrupt callback 
+ * 
+ * @details Runs the transaction in flight through its start, address, register address 
+ *          and write data steps. 
+ */
+void i2c_bus_ev_handler(void); 
+
+
+/**
+ * @brief I2C error interrupt callback 
+ * 
+ * @details Stops the transaction in flight on a no acknowledge (device not responding), 
+ *          bus error or arbitration loss and starts the next one. 
+ */
+void i2c_bus_er_handler(void); 
+
+
+/**
+ * @brief I2C RX DMA stream interrupt callback 
+ * 
+ * @details Finishes a read once the DMA has copied the data. 
+ */
+void i2c_bus_dma_handler(void); 
+
+//=======================================================================================
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif   // _I2C_BUS_H_ 
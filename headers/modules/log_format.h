@@ -0,0 +1,311 @@
+/**
+ * @file log_format.h
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Data log text formatting interface 
+ * 
+ * @details Writes numbers and strings into a buffer without snprintf. Used to build text 
+ *          data log lines in the logging hot path where snprintf takes a significant 
+ *          portion of each sample interval. The output matches the mtbdl_data_log_* 
+ *          formats byte for byte. 
+ * 
+ *          Every writer takes a pointer to where the text goes, writes it followed by a 
+ *          '\0' and returns a pointer to the '\0'. Writers can be chained to build a line 
+ *          and the buffer is always a valid string. Nothing is checked against the size of 
+ *          the buffer so the caller must make sure the text fits (the max lengths are 
+ *          given below). No state is kept so the writers are reentrant. 
+ * 
+ *          This file has no firmware dependencies so it can be shared with host-side 
+ *          tools. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _LOG_FORMAT_H_ 
+#define _LOG_FORMAT_H_ 
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=======================================================================================
+// Includes 
+
+#include "string_config.h"
+
+#include <stdint.h>
+#include <string.h>
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+// Number lengths (characters) 
+#define LOG_FORMAT_U8_MAX_LEN 3          // "255" 
+#define LOG_FORMAT_U16_MAX_LEN 5         // "65535" 
+#define LOG_FORMAT_I16_MAX_LEN 6         // "-32768" 
+#define LOG_FORMAT_U32_MAX_LEN 10        // "4294967295" 
+#define LOG_FORMAT_MILLI_MAX_LEN 11      // "4294967.295" 
+#define LOG_FORMAT_COORD_MAX_LEN 12      // "18000.00000E" 
+
+// GPS coordinates and speed 
+#define LOG_FORMAT_COORD_SCALE 10000000  // Coordinate units per degree (1e-7 deg) 
+#define LOG_FORMAT_KMH_MILLI(mm_s) (((uint32_t)(mm_s) * 18 + 2) / 5)   // mm/s to km/h/1000 
+#define LOG_FORMAT_LAT_DEG_LEN 2         // Latitude degree digits 
+#define LOG_FORMAT_LON_DEG_LEN 3         // Longitude degree digits 
+
+// Data log line fields 
+#define LOG_FORMAT_LINE_FIELDS 7         // Fields after the ADC data in a line 
+#define LOG_FORMAT_FIELD_LEN 3           // Length of a blank field (", -") 
+#define LOG_FORMAT_SPEED_FIELD 0         // Wheel speed field index (after the ADC data) 
+#define LOG_FORMAT_ACCEL_FIELD 1         // First accelerometer field index 
+#define LOG_FORMAT_GPS_FIELD 4           // First GPS field index 
+#define LOG_FORMAT_GPS_FIELDS 3          // Number of GPS fields 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Number and string writers 
+
+/**
+ * @brief Write an unsigned 8-bit number 
+ * 
+ * @details Writes the number in decimal with no padding, the same as "%u". At most 
+ *          LOG_FORMAT_U8_MAX_LEN characters are written plus the '\0'. 
+ * 
+ * @param str : where to write the number 
+ * @param value : number to write 
+ * @return char* : end of the written text (the '\0') 
+ */
+char *log_format_u8(
+    char *str, 
+    uint8_t value); 
+
+
+/**
+ * @brief Write an unsigned 16-bit number 
+ * 
+ * @details Writes the number in decimal with no padding, the same as "%u". Digits are 
+ *          written two at a time from a lookup table. At most LOG_FORMAT_U16_MAX_LEN 
+ *          characters are written plus the '\0'. 
+ * 
+ * @param str : where to write the number 
+ * @param value : number to write 
+ * @return char* : end of the written text (the '\0') 
+ */
+char *log_format_u16(
+    char *str, 
+    uint16_t value); 
+
+
+/**
+ * @brief Write an unsigned 32-bit number 
+ * 
+ * @details Writes the number in decimal with no padding, the same as "%lu". At most 
+ *          LOG_FORMAT_U32_MAX_LEN characters are written plus the '\0'. 
+ * 
+ * @param str : where to write the number 
+ * @param value : number to write 
+ * @return char* : end of the written text (the '\0') 
+ */
+char *log_format_u32(
+    char *str, 
+    uint32_t value); 
+
+
+/**
+ * @brief Write a zero padded unsigned 32-bit number 
+ * 
+ * @details Same as "%0*lu" - numbers with fewer than 'width' digits are padded with 
+ *          leading zeros. At most LOG_FORMAT_U32_MAX_LEN characters are written plus the 
+ *          '\0' if 'width' isn't larger. 
+ * 
+ * @param str : where to write the number 
+ * @param value : number to write 
+ * @param width : min number of digits 
+ * @return char* : end of the written text (the '\0') 
+ */
+char *log_format_u32_pad(
+    char *str, 
+    uint32_t value, 
+    uint8_t width); 
+
+
+/**
+ * @brief Write a number in thousandths 
+ * 
+ * @details Writes value/1000 with three decimals, the same as "%.3f" of the value in 
+ *          thousandths. Used for GPS speed over ground (km/h) from an integer speed. At 
+ *          most LOG_FORMAT_MILLI_MAX_LEN characters are written plus the '\0'. 
+ * 
+ * @param str : where to write the number 
+ * @param value : number to write (thousandths) 
+ * @return char* : end of the written text (the '\0') 
+ */
+char *log_format_milli(
+    char *str, 
+    uint32_t value); 
+
+
+/**
+ * @brief Write a GPS coordinate 
+ * 
+ * @details Writes a coordinate in 1e-7 degrees the same way as the PUBX POSITION 
+ *          message: degrees and minutes to 5 decimals (ddmm.mmmmm for latitude, 
+ *          dddmm.mmmmm for longitude) followed by the hemisphere character. At most 
+ *          LOG_FORMAT_COORD_MAX_LEN characters are written plus the '\0'. 
+ * 
+ * @param str : where to write the coordinate 
+ * @param value : coordinate (1e-7 deg) 
+ * @param deg_len : degree digits - LOG_FORMAT_LAT_DEG_LEN or LOG_FORMAT_LON_DEG_LEN 
+ * @param pos : hemisphere character of a positive coordinate ('N' or 'E') 
+ * @param neg : hemisphere character of a negative coordinate ('S' or 'W') 
+ * @return char* : end of the written text (the '\0') 
+ */
+char *log_format_coord(
+    char *str, 
+    int32_t value, 
+    uint8_t deg_len, 
+    char pos, 
+    char neg); 
+
+
+/**
+ * @brief Write a signed 16-bit number 
+ * 
+ * @details Writes the number in decimal with no padding, the same as "%d". At most 
+ *          LOG_FORMAT_I16_MAX_LEN characters are written plus the '\0'. 
+ * 
+ * @param str : where to write the number 
+ * @param value : number to write 
+ * @return char* : end of the written text (the '\0') 
+ */
+char *log_format_i16(
+    char *str, 
+    int16_t value); 
+
+
+/**
+ * @brief Write a string 
+ * 
+ * @details Copies a preformatted string, the same as "%s". Copying stops at the end of 
+ *          the string or after 'max_len' characters, whichever comes first. 
+ * 
+ * @param str : where to write the string 
+ * @param src : string to write 
+ * @param max_len : max number of characters to copy 
+ * @return char* : end of the written text (the '\0') 
+ */
+char *log_format_str(
+    char *str, 
+    const char *src, 
+    uint16_t max_len); 
+
+
+/**
+ * @brief Write a character 
+ * 
+ * @details Same as "%c" except a '\0' character is not written so the result is always 
+ *          a valid string. 
+ * 
+ * @param str : where to write the character 
+ * @param c : character to write 
+ * @return char* : end of the written text (the '\0') 
+ */
+char *log_format_char(
+    char *str, 
+    char c); 
+
+
+/**
+ * @brief Write a field separator 
+ * 
+ * @details Writes the separator that goes before each field of a data log line after the 
+ *          first one. 
+ * 
+ * @param str : where to write the separator 
+ * @return char* : end of the written text (the '\0') 
+ */
+char *log_format_sep(char *str); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Data log line writers 
+
+/**
+ * @brief Write the start of a data log line 
+ * 
+ * @details Writes the trail marker and ADC fields that start every data log line. The 
+ *          rest of the line is written with the other writers and finished with 
+ *          log_format_line_end. Fields that follow are written with a separator in 
+ *          front of them. 
+ * 
+ *          Example of a complete wheel speed line: 
+ * 
+ *          p = log_format_line_start(str, trailmark, fork, shock); 
+ *          p = log_format_sep(p); 
+ *          p = log_format_u8(p, revs); 
+ *          p = log_format_line_end(p, LOG_FORMAT_LINE_FIELDS - 1); 
+ * 
+ * @see log_format_line_end 
+ * 
+ * @param str : where to write the line 
+ * @param trailmark : trail marker flag 
+ * @param fork : fork potentiometer ADC value 
+ * @param shock : shock potentiometer ADC value 
+ * @return char* : end of the written text (the '\0') 
+ */
+char *log_format_line_start(
+    char *str, 
+    uint8_t trailmark, 
+    uint16_t fork, 
+    uint16_t shock); 
+
+
+/**
+ * @brief Write blank data log line fields 
+ * 
+ * @details Writes 'fields' fields with no data ("-"), each with a separator in front. 
+ *          Used for the fields before the data of a stream. 
+ * 
+ * @param str : where to write the fields 
+ * @param fields : number of blank fields (at most LOG_FORMAT_LINE_FIELDS) 
+ * @return char* : end of the written text (the '\0') 
+ */
+char *log_format_line_blank(
+    char *str, 
+    uint8_t fields); 
+
+
+/**
+ * @brief Write the end of a data log line 
+ * 
+ * @details Writes the last 'fields' fields of a line with no data followed by the line 
+ *          ending. Used for the fields after the data of a stream, or all the fields 
+ *          (LOG_FORMAT_LINE_FIELDS) for a line with only ADC data. 
+ * 
+ * @param str : where to write the fields 
+ * @param fields : number of blank fields (at most LOG_FORMAT_LINE_FIELDS) 
+ * @return char* : end of the written text (the '\0') 
+ */
+char *log_format_line_end(
+    char *str, 
+    uint8_t fields); 
+
+//=======================================================================================
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif   // _LOG_FORMAT_H_ 
@@ -0,0 +1,256 @@
+/**
+ * @file log_pack.h
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Packed ADC sample interface 
+ * 
+ * @details Streaming compressor for the suspension position (fork and shock) samples 
+ *          of a data log. Samples are grouped in blocks and each channel is written as 
+ *          the difference (delta) from its previous sample. Deltas are zig-zag encoded 
+ *          so small negative and positive changes are both small unsigned numbers, then 
+ *          written as varints (7 bits per byte, the top bit set on every byte but the 
+ *          last). Suspension position changes little between samples so most values 
+ *          take one byte instead of the two bytes of a raw sample or the 3-5 characters 
+ *          of a text log. 
+ * 
+ *          Every key_period blocks the block is a keyframe. A keyframe starts with the 
+ *          index of its first sample and its deltas are taken from 0 (i.e. the first 
+ *          sample is written as is), so a keyframe can be decoded without any of the 
+ *          blocks before it. This limits how far a damaged block can carry into the 
+ *          rest of the log and lets a reader start decoding at any keyframe. 
+ * 
+ *          Each finished block is written as a log_rec_adc_pack_t record followed by 
+ *          the packed data. The same functions are used by the firmware and by host 
+ *          tools so this file has no firmware dependencies. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _LOG_PACK_H_ 
+#define _LOG_PACK_H_ 
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=======================================================================================
+// Includes 
+
+#include "log_record.h"
+
+#include <stdint.h>
+#include <string.h>
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define LOG_PACK_MAX_SAMPLES 50          // Max samples in a block 
+#define LOG_PACK_VARINT_MAX_LEN 5        // Max length of a packed 32-bit value (bytes) 
+#define LOG_PACK_VALUE_MAX_LEN 3         // Max length of a packed sample value (bytes) 
+
+// Max packed data length of a block - keyframe index plus every sample value 
+#define LOG_PACK_MAX_VALUES (LOG_PACK_MAX_SAMPLES*LOG_REC_PACK_CHANNELS) 
+#define LOG_PACK_MAX_LEN (LOG_PACK_VARINT_MAX_LEN + LOG_PACK_MAX_VALUES*LOG_PACK_VALUE_MAX_LEN) 
+
+// Max length of a block record 
+#define LOG_PACK_MAX_RECORD_LEN (sizeof(log_rec_adc_pack_t) + LOG_PACK_MAX_LEN) 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// Packing (compressor) data 
+typedef struct log_pack_s
+{
+    // Settings 
+    uint8_t key_period;                         // Blocks per keyframe 
+
+    // Predictor - the last sample of each channel 
+    uint16_t prev[LOG_REC_PACK_CHANNELS]; 
+
+    // Block being packed 
+    uint8_t data[LOG_PACK_MAX_LEN];             // Packed data 
+    uint16_t size;                              // Packed data size (bytes) 
+    uint8_t count;                              // Samples in the block 
+    uint8_t trailmark;                          // Sample with the trail marker set 
+    uint8_t key_count;                          // Blocks since the last keyframe 
+
+    // Sample index of the next sample 
+    uint32_t index; 
+}
+log_pack_t; 
+
+
+// Unpacking (decompressor) data 
+typedef struct log_unpack_s
+{
+    uint16_t prev[LOG_REC_PACK_CHANNELS];       // The last sample of each channel 
+    uint32_t index;                             // Sample index of the next sample 
+    uint8_t synced;                             // A keyframe has been decoded 
+}
+log_unpack_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Value encoding 
+
+/**
+ * @brief Zig-zag encode a signed number 
+ * 
+ * @details Maps signed numbers to unsigned numbers so that numbers close to 0 stay 
+ *          small: 0, -1, 1, -2, 2 ... become 0, 1, 2, 3, 4 ... 
+ * 
+ * @param value : number to encode 
+ * @return uint32_t : encoded number 
+ */
+uint32_t log_pack_zigzag(int32_t value); 
+
+
+/**
+ * @brief Zig-zag decode a number 
+ * 
+ * @see log_pack_zigzag 
+ * 
+ * @param value : number to decode 
+ * @return int32_t : decoded number 
+ */
+int32_t log_unpack_zigzag(uint32_t value); 
+
+
+/**
+ * @brief Write a varint 
+ * 
+ * @details Writes 7 bits of the number per byte starting with the lowest bits. The top 
+ *          bit of each byte is set if more bytes follow. At most LOG_PACK_VARINT_MAX_LEN 
+ *          bytes are written. 
+ * 
+ * @param buff : where to write the number 
+ * @param value : number to write 
+ * @return uint8_t* : end of the written bytes 
+ */
+uint8_t *log_pack_varint(
+    uint8_t *buff, 
+    uint32_t value); 
+
+
+/**
+ * @brief Read a varint 
+ * 
+ * @see log_pack_varint 
+ * 
+ * @param buff : where to read the number from 
+ * @param end : end of the readable bytes 
+ * @param value : buffer to store the number 
+ * @return const uint8_t* : end of the read bytes, NULL if the number is incomplete or 
+ *                          too long 
+ */
+const uint8_t *log_unpack_varint(
+    const uint8_t *buff, 
+    const uint8_t *end, 
+    uint32_t *value); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Packing 
+
+/**
+ * @brief Initialize packing 
+ * 
+ * @details Clears the packing data so the first block packed is a keyframe with a 
+ *          sample index of 0. Must be called before each new log. 
+ * 
+ * @param pack : packing data 
+ * @param key_period : blocks per keyframe (0 is treated as 1, i.e. every block) 
+ */
+void log_pack_init(
+    log_pack_t *pack, 
+    uint8_t key_period); 
+
+
+/**
+ * @brief Add a sample to the block 
+ * 
+ * @details Packs one sample (the value of each channel) into the current block. If the 
+ *          trail marker is set then the sample is recorded as the block trail marker. 
+ *          Samples past LOG_PACK_MAX_SAMPLES in a block are ignored. 
+ * 
+ * @param pack : packing data 
+ * @param sample : value of each channel 
+ * @param trailmark : trail marker flag of the sample 
+ */
+void log_pack_sample(
+    log_pack_t *pack, 
+    const uint16_t *sample, 
+    uint8_t trailmark); 
+
+
+/**
+ * @brief Finish the block 
+ * 
+ * @details Writes the block record followed by the packed data to the buffer and 
+ *          starts a new block. The buffer must hold LOG_PACK_MAX_RECORD_LEN bytes. 
+ *          Nothing is written if the block has no samples. 
+ * 
+ * @param pack : packing data 
+ * @param buff : where to write the record 
+ * @return uint16_t : number of bytes written 
+ */
+uint16_t log_pack_block(
+    log_pack_t *pack, 
+    uint8_t *buff); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Unpacking 
+
+/**
+ * @brief Initialize unpacking 
+ * 
+ * @param unpack : unpacking data 
+ */
+void log_unpack_init(log_unpack_t *unpack); 
+
+
+/**
+ * @brief Unpack a block 
+ * 
+ * @details Decodes the packed data of a block record into samples. Delta blocks are 
+ *          decoded from the last sample of the previous block so they can only be 
+ *          decoded after a keyframe. 
+ * 
+ * @param unpack : unpacking data 
+ * @param record : block record 
+ * @param data : packed data that follows the record 
+ * @param samples : buffer to store the samples (at least LOG_PACK_MAX_SAMPLES) 
+ * @return int : number of samples, -1 if the block is invalid or there has been no 
+ *               keyframe 
+ */
+int log_unpack_block(
+    log_unpack_t *unpack, 
+    const log_rec_adc_pack_t *record, 
+    const uint8_t *data, 
+    uint16_t (*samples)[LOG_REC_PACK_CHANNELS]); 
+
+//=======================================================================================
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif   // _LOG_PACK_H_ 
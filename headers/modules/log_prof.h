@@ -0,0 +1,187 @@
+/**
+ * @file log_prof.h
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Execution time profiling interface 
+ * 
+ * @details Keeps a histogram of the execution time of each log stream, the log data SD 
+ *          card writes, sd_puts, the log file syncs and each device controller. Times are 
+ *          measured with the Cortex-M4 DWT cycle counter and binned by powers of 2 (in 
+ *          microseconds) so a single slow call stands out from thousands of fast ones. 
+ *          The histograms are reset at the start of each log and written to the footer of 
+ *          the log file, so they can be read with the log on the SD card or over 
+ *          Bluetooth. 
+ * 
+ *          Profiling is set with LOG_PROF_ENABLE from the build and is off by default. 
+ *          When it's off the LOG_PROF_* macros are empty so nothing is measured or 
+ *          written and the histogram code is not linked in. The DWT is only used in the 
+ *          macros so the histogram code has no firmware dependencies. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _LOG_PROF_H_ 
+#define _LOG_PROF_H_ 
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=======================================================================================
+// Includes 
+
+#include <stdint.h>
+#include <string.h>
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#ifndef LOG_PROF_ENABLE 
+#define LOG_PROF_ENABLE 0                // Execution time profiling: 0 = off, 1 = on 
+#endif
+
+#define LOG_PROF_CLOCK_MHZ 84            // (MHz) Cycle counter (core clock) frequency 
+#define LOG_PROF_NUM_BINS 16             // Histogram bins - the last has no upper limit 
+
+// Profiling points. LOG_PROF_START declares the start time variable so it goes at the 
+// start of a block and LOG_PROF_STOP records the time since then to a histogram. 
+// Example: 
+// 
+// LOG_PROF_START(prof_start); 
+// m8q_controller(); 
+// LOG_PROF_STOP(prof_start, LOG_PROF_M8Q); 
+#if LOG_PROF_ENABLE
+#define LOG_PROF_INIT() (CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk, DWT->CYCCNT = 0, DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk) 
+#define LOG_PROF_START(start) uint32_t start = DWT->CYCCNT 
+#define LOG_PROF_STOP(start, id) log_prof_record((id), DWT->CYCCNT - (start)) 
+#else
+#define LOG_PROF_INIT() 
+#define LOG_PROF_START(start) 
+#define LOG_PROF_STOP(start, id) 
+#endif
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Enums 
+
+// Profiled code. The log streams come first and must be in the same order as 
+// log_stream_t so a stream can be used as its histogram index. 
+typedef enum {
+    LOG_PROF_STANDARD,   // Standard log stream 
+    LOG_PROF_GPS,        // GPS log stream 
+    LOG_PROF_ACCEL,      // Accelerometer log stream 
+    LOG_PROF_SPEED,      // Wheel speed log stream 
+    LOG_PROF_IMU,        // IMU FIFO read and record of each log stream period 
+    LOG_PROF_SD_WRITE,   // Log data write of each log stream period 
+    LOG_PROF_SD_PUTS,    // sd_puts 
+    LOG_PROF_SD_SYNC,    // Log file sync 
+    LOG_PROF_HD44780U,   // Screen controller 
+    LOG_PROF_SD_CTRL,    // SD card controller 
+    LOG_PROF_MPU6050,    // Accelerometer controller 
+    LOG_PROF_M8Q,        // GPS controller 
+    LOG_PROF_NUM         // Number of histograms 
+} log_prof_id_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// Execution time histogram 
+typedef struct log_prof_hist_s
+{
+    uint32_t count;                             // Number of times recorded 
+    uint32_t max;                               // (cycles) Longest time recorded 
+    uint32_t bins[LOG_PROF_NUM_BINS];           // Times recorded in each bin 
+}
+log_prof_hist_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Histograms 
+
+/**
+ * @brief Clear every histogram 
+ * 
+ * @details Called at the start of a log so the histograms only cover that log. 
+ */
+void log_prof_reset(void); 
+
+
+/**
+ * @brief Get the histogram bin of a time 
+ * 
+ * @details Bin 0 holds times under 1us and bin n holds times from 2^(n-1)us up to 
+ *          (but not including) 2^n us. The last bin holds every longer time. 
+ * 
+ * @param cycles : time (cycles) 
+ * @return uint8_t : bin index 
+ */
+uint8_t log_prof_bin(uint32_t cycles); 
+
+
+/**
+ * @brief Record a time 
+ * 
+ * @details Adds a time to a histogram. Usually called with LOG_PROF_STOP. Counts 
+ *          saturate instead of wrapping. An invalid histogram index is ignored. 
+ * 
+ * @param id : histogram index 
+ * @param cycles : time (cycles) 
+ */
+void log_prof_record(
+    log_prof_id_t id, 
+    uint32_t cycles); 
+
+
+/**
+ * @brief Get a histogram 
+ * 
+ * @param id : histogram index 
+ * @return const log_prof_hist_t* : histogram, NULL if the index is invalid 
+ */
+const log_prof_hist_t *log_prof_get(log_prof_id_t id); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Log footer 
+
+/**
+ * @brief Write a histogram as a log footer line 
+ * 
+ * @details Writes the histogram name, count, max time (us) and the count of each bin, 
+ *          separated the same way as the data log lines. The footer starts with the 
+ *          mtbdl_prof_start line which names the bins. 
+ * 
+ * @param str : where to write the line 
+ * @param len : size of str (bytes) 
+ * @param id : histogram index 
+ * @return uint16_t : length of the line, 0 if the index is invalid or it doesn't fit 
+ */
+uint16_t log_prof_format(
+    char *str, 
+    uint16_t len, 
+    log_prof_id_t id); 
+
+//=======================================================================================
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif   // _LOG_PROF_H_ 
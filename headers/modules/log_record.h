@@ -0,0 +1,290 @@
+/**
+ * @file log_record.h
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Binary data log record format 
+ * 
+ * @details Defines the fixed-width records written to a log file when the data logging 
+ *          module is in binary mode. This file has no firmware dependencies so it can be 
+ *          shared with host-side tools that decode binary log files. 
+ * 
+ *          A binary log file starts with the same text header as a text log file, up to 
+ *          and including the "Data log:" line. After that, the file is a sequence of 
+ *          records. Each record starts with a one byte tag (log_rec_tag_t) followed by a 
+ *          payload whose size is fixed by the tag. IMU, revolution period and packed ADC 
+ *          block records are followed by data whose size is given in the record. 
+ *          Multi-byte fields are little endian. 
+ * 
+ *          Record order within a log: 
+ *          - One header record directly after the text header. 
+ *          - A time record ahead of the records of the last interval of each log stream 
+ *            period, which holds the time of that interval's ADC sample. 
+ *          - One ADC record per sample interval. A trail marker record precedes the ADC 
+ *            record of any interval where the trail marker was set. 
+ *          - A GPS (or GPS NAV-PVT), accelerometer or wheel speed (or revolution 
+ *            period) record directly after the ADC record of the interval the stream 
+ *            ran in. 
+ *          - When the IMU FIFO is used, an IMU record after the records of each log 
+ *            stream period that holds the IMU samples read in that period. 
+ *          - A sync record after the records of each log stream period the log file was 
+ *            synced in. 
+ *          - One sync record then one end record to terminate the log. 
+ * 
+ *          A log file is pre-allocated so a file that wasn't closed (e.g. power was lost 
+ *          while logging) keeps its pre-allocated size and whatever was on the card 
+ *          before fills the space past the last record written, which can include 
+ *          records of deleted logs. Sync records mark how much of the file is log data. 
+ *          A sync record belongs to the log if its id matches the header record, its 
+ *          sequence number is one more than the sync record before it (0 for the first) 
+ *          and its offset is where it sits in the file. Records up to the last sync 
+ *          record that checks out are log data. An end record only ends the log if it 
+ *          directly follows a sync record that checks out. 
+ * 
+ *          Packed logs replace the ADC and trail marker records with one packed ADC 
+ *          block record (keyframe or delta) per log stream period. A block record is 
+ *          followed by 'size' bytes of packed samples (see log_pack.h) and holds the 
+ *          samples of every interval in the period, so stream records directly follow 
+ *          the block record and belong to its last sample. 
+ * 
+ *          Times are counts of the free running 32-bit 1us timebase taken in the 
+ *          interrupts: the ADC sample time comes from the DMA interrupt of its block and 
+ *          GPS and IMU times from the I2C bus when the device read finished. The earlier 
+ *          samples of a period are one sample interval (header log_period) apart going 
+ *          back from the time record, so dropped samples and jitter show up as time 
+ *          records that aren't one log stream period apart. The count wraps every 71.6 minutes which 
+ *          is much longer than the time between records, so times are unwrapped from 
+ *          the difference to the last time. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _LOG_RECORD_H_ 
+#define _LOG_RECORD_H_ 
+
+#ifdef __cplusplus 
+extern "C" {
+#endif
+
+//=======================================================================================
+// Includes 
+
+#include <stdint.h>
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define LOG_REC_VERSION 10               // Record format version - bump on layout change 
+#define LOG_REC_MAGIC_LEN 4              // Header record magic number length 
+#define LOG_REC_MAGIC "MTBL"             // Header record magic number 
+#define LOG_REC_STR_LEN 12               // GPS string field length 
+#define LOG_REC_PACK_CHANNELS 2          // Channels in a packed ADC sample (fork, shock) 
+#define LOG_REC_NO_TRAILMARK 0xFF        // Packed ADC block with no trail marker 
+#define LOG_REC_REV_WINDOWS 2            // Wheel revolution windows (short, long) 
+#define LOG_REC_IMU_AXES 3               // Axes per IMU sensor (accelerometer, gyroscope) 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Enums 
+
+// Record tags 
+typedef enum {
+    LOG_REC_NONE,        // Not a record 
+    LOG_REC_HEADER,      // Log header - log_rec_header_t 
+    LOG_REC_ADC,         // Suspension position - log_rec_adc_t 
+    LOG_REC_GPS,         // GPS position and ground speed - log_rec_gps_t 
+    LOG_REC_ACCEL,       // Acceleration - log_rec_accel_t 
+    LOG_REC_SPEED,       // Wheel revolutions - log_rec_speed_t 
+    LOG_REC_TRAILMARK,   // Trail marker - log_rec_trailmark_t 
+    LOG_REC_END,         // End of log - log_rec_end_t 
+    LOG_REC_ADC_KEY,     // Packed suspension position keyframe - log_rec_adc_pack_t 
+    LOG_REC_ADC_DELTA,   // Packed suspension position deltas - log_rec_adc_pack_t 
+    LOG_REC_REV_PERIOD,  // Wheel revolution periods - log_rec_rev_period_t + uint32_t each 
+    LOG_REC_IMU,         // IMU FIFO samples - log_rec_imu_t + log_rec_imu_sample_t each 
+    LOG_REC_GPS_PVT,     // GPS position and ground speed (UBX NAV-PVT) - log_rec_gps_pvt_t 
+    LOG_REC_TIME,        // ADC sample time - log_rec_time_t 
+    LOG_REC_SYNC,        // Log file sync - log_rec_sync_t 
+    LOG_REC_NUM          // Number of record tags 
+} log_rec_tag_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Records 
+
+// Header record 
+typedef struct __attribute__((packed)) log_rec_header_s
+{
+    uint8_t tag;                                // LOG_REC_HEADER 
+    char magic[LOG_REC_MAGIC_LEN];              // LOG_REC_MAGIC (not null terminated) 
+    uint8_t version;                            // LOG_REC_VERSION 
+    uint8_t log_period;                         // Sample interval (ms) 
+    uint8_t period_divider;                     // Sample intervals per log stream slot 
+    uint16_t rev_period;                        // Wheel speed stream period (ms) 
+    uint8_t rev_windows[LOG_REC_REV_WINDOWS];   // Wheel revolution window sizes, 0 = period 
+    uint8_t adc_res;                            // ADC data resolution (bits) 
+    uint16_t imu_rate;                          // IMU FIFO sample rate (Hz), 0 = no IMU 
+    uint32_t id;                                // Log id - also in each sync record 
+}
+log_rec_header_t; 
+
+
+// ADC record 
+typedef struct __attribute__((packed)) log_rec_adc_s
+{
+    uint8_t tag;                                // LOG_REC_ADC 
+    uint16_t fork;                              // Fork potentiometer 
+    uint16_t shock;                             // Shock potentiometer 
+}
+log_rec_adc_t; 
+
+
+// GPS record - strings are copied as read from the GPS and are null padded 
+typedef struct __attribute__((packed)) log_rec_gps_s
+{
+    uint8_t tag;                                // LOG_REC_GPS 
+    char sog[LOG_REC_STR_LEN];                  // Speed over ground 
+    char lat[LOG_REC_STR_LEN];                  // Latitude 
+    char NS;                                    // North/South indicator 
+    char lon[LOG_REC_STR_LEN];                  // Longitude 
+    char EW;                                    // East/West indicator 
+    uint32_t time;                              // (us) Timebase count of the GPS read 
+}
+log_rec_gps_t; 
+
+
+// GPS NAV-PVT record - replaces the GPS record when the GPS sends UBX NAV-PVT messages 
+typedef struct __attribute__((packed)) log_rec_gps_pvt_s
+{
+    uint8_t tag;                                // LOG_REC_GPS_PVT 
+    uint32_t itow;                              // (ms) GPS time of week of the fix 
+    int32_t lat;                                // (1e-7 deg) Latitude, positive north 
+    int32_t lon;                                // (1e-7 deg) Longitude, positive east 
+    uint32_t speed;                             // (mm/s) Ground speed 
+    uint8_t fix;                                // Fix type (0 = none, 2 = 2D, 3 = 3D, ...) 
+    uint8_t num_sv;                             // Satellites used in the fix 
+    uint32_t time;                              // (us) Timebase count of the GPS read 
+}
+log_rec_gps_pvt_t; 
+
+
+// Accelerometer record 
+typedef struct __attribute__((packed)) log_rec_accel_s
+{
+    uint8_t tag;                                // LOG_REC_ACCEL 
+    int16_t x;                                  // X-axis acceleration 
+    int16_t y;                                  // Y-axis acceleration 
+    int16_t z;                                  // Z-axis acceleration 
+    uint32_t time;                              // (us) Timebase count of the read 
+}
+log_rec_accel_t; 
+
+
+// Wheel speed record 
+typedef struct __attribute__((packed)) log_rec_speed_s
+{
+    uint8_t tag;                                // LOG_REC_SPEED 
+    uint16_t revs[LOG_REC_REV_WINDOWS];         // Revolutions in each revolution window 
+}
+log_rec_speed_t; 
+
+
+// Wheel revolution period record - replaces the wheel speed record when the wheel 
+// speed is measured with input capture. Followed by the period (uint32_t, us) of each 
+// of the 'count' revolutions finished since the last record, oldest first. 
+typedef struct __attribute__((packed)) log_rec_rev_period_s
+{
+    uint8_t tag;                                // LOG_REC_REV_PERIOD 
+    uint8_t count;                              // Revolution periods that follow 
+    uint32_t period;                            // (us) Period at the record, 0 = stopped 
+}
+log_rec_rev_period_t; 
+
+
+// IMU record - followed by 'count' IMU samples in the order they were taken. The 
+// samples are evenly spaced at the header IMU rate unless samples were lost, and the 
+// last one was taken at most one IMU sample period before 'time'. 
+typedef struct __attribute__((packed)) log_rec_imu_s
+{
+    uint8_t tag;                                // LOG_REC_IMU 
+    uint8_t count;                              // IMU samples that follow 
+    uint8_t lost;                               // Samples were lost before these (FIFO full) 
+    uint32_t time;                              // (us) Timebase count of the FIFO count read 
+}
+log_rec_imu_t; 
+
+
+// IMU sample (raw device values) 
+typedef struct __attribute__((packed)) log_rec_imu_sample_s
+{
+    int16_t accel[LOG_REC_IMU_AXES];            // X, Y, Z acceleration 
+    int16_t gyro[LOG_REC_IMU_AXES];             // X, Y, Z angular rate 
+}
+log_rec_imu_sample_t; 
+
+
+// Time record 
+typedef struct __attribute__((packed)) log_rec_time_s
+{
+    uint8_t tag;                                // LOG_REC_TIME 
+    uint32_t time;                              // (us) Timebase count of the ADC sample 
+}
+log_rec_time_t; 
+
+
+// Sync record - 'offset' is the number of bytes between the end of the header record 
+// and the start of this record 
+typedef struct __attribute__((packed)) log_rec_sync_s
+{
+    uint8_t tag;                                // LOG_REC_SYNC 
+    uint32_t seq;                               // Sync record number, 0 for the first 
+    uint32_t offset;                            // (bytes) Position in the log data 
+    uint32_t id;                                // Log id from the header record 
+}
+log_rec_sync_t; 
+
+
+// Trail marker record 
+typedef struct __attribute__((packed)) log_rec_trailmark_s
+{
+    uint8_t tag;                                // LOG_REC_TRAILMARK 
+}
+log_rec_trailmark_t; 
+
+
+// End record 
+typedef struct __attribute__((packed)) log_rec_end_s
+{
+    uint8_t tag;                                // LOG_REC_END 
+    uint8_t overrun;                            // Data overrun count 
+}
+log_rec_end_t; 
+
+
+// Packed ADC block record - followed by 'size' bytes of packed samples 
+typedef struct __attribute__((packed)) log_rec_adc_pack_s
+{
+    uint8_t tag;                                // LOG_REC_ADC_KEY or LOG_REC_ADC_DELTA 
+    uint8_t count;                              // Samples (intervals) in the block 
+    uint8_t trailmark;                          // Sample with the trail marker set 
+    uint16_t size;                              // Packed sample data size (bytes) 
+}
+log_rec_adc_pack_t; 
+
+//=======================================================================================
+
+#ifdef __cplusplus 
+}
+#endif
+
+#endif   // _LOG_RECORD_H_ 
@@ -0,0 +1,148 @@
+/**
+ * @file log_rev.h
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Wheel revolution capture interface 
+ * 
+ * @details Turns the timestamps of each wheel revolution into a revolution period. A 
+ *          timer input capture channel timestamps the Hall effect sensor edge of every 
+ *          magnet pass in hardware and a circular DMA stream copies each timestamp into 
+ *          a buffer, so no revolution is missed no matter how long the main loop takes. 
+ *          The timestamps are read from the buffer in the wheel speed stream by passing 
+ *          in the DMA write position. 
+ * 
+ *          The period of every full revolution read is handed back so none are lost 
+ *          between reads, and the period of the last one is kept. If the wheel has been 
+ *          turning for longer than that since the last edge then the time since the last 
+ *          edge is used instead so a slowing wheel is seen before its next edge. The 
+ *          wheel is seen as stopped (period of 0) when there is no edge for 
+ *          LOG_REV_STOP_TIME. 
+ * 
+ *          Timestamps are in timer counts (1us) and all time math wraps so a free running 
+ *          32-bit counter can be used directly. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _LOG_REV_H_ 
+#define _LOG_REV_H_ 
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=======================================================================================
+// Includes 
+
+#include <stdint.h>
+#include <stddef.h>
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define LOG_REV_STOP_TIME 4000000        // (us) No edge for this long means stopped 
+#define LOG_REV_MIN_PERIOD 20000         // (us) Edges closer than this are sensor bounce 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// Revolution capture data 
+typedef struct log_rev_s
+{
+    const volatile uint32_t *buff;              // Capture timestamps (written by DMA) 
+    uint16_t size;                              // Number of timestamps the buffer holds 
+    uint16_t tail;                              // Next timestamp to read 
+    uint32_t last;                              // (us) Time of the most recent edge 
+    uint32_t period;                            // (us) Period of the last full revolution 
+    uint8_t edges;                              // Edges seen since reset (saturates at 2) 
+}
+log_rev_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Functions 
+
+/**
+ * @brief Initialize revolution capture data 
+ * 
+ * @param rev : revolution capture data 
+ * @param buff : capture timestamp buffer 
+ * @param size : number of timestamps the buffer holds 
+ */
+void log_rev_init(
+    log_rev_t *rev, 
+    const volatile uint32_t *buff, 
+    uint16_t size); 
+
+
+/**
+ * @brief Reset the revolution period 
+ * 
+ * @details Skips every timestamp up to the DMA write position and forgets the last edge 
+ *          so the period is 0 until two new edges are seen. Called at the start of a log. 
+ * 
+ * @param rev : revolution capture data 
+ * @param head : buffer index the DMA writes next 
+ */
+void log_rev_reset(
+    log_rev_t *rev, 
+    uint16_t head); 
+
+
+/**
+ * @brief Read new revolution timestamps 
+ * 
+ * @details Reads every timestamp from the last read position up to the DMA write 
+ *          position and updates the revolution period. Edges within LOG_REV_MIN_PERIOD 
+ *          of the last edge are ignored and an edge after a stop only restarts the 
+ *          period. The period of each full revolution is stored in 'periods' (oldest 
+ *          first). Once 'max' periods are stored the read stops and the timestamps left 
+ *          are read next call. The buffer must be large enough that the DMA can't lap 
+ *          the read position between calls. 
+ * 
+ * @param rev : revolution capture data 
+ * @param head : buffer index the DMA writes next 
+ * @param periods : buffer for the period of each revolution read (us), NULL to read 
+ *                  every timestamp and only update the period 
+ * @param max : number of periods the buffer holds 
+ * @return uint16_t : number of full revolutions read 
+ */
+uint16_t log_rev_update(
+    log_rev_t *rev, 
+    uint16_t head, 
+    uint32_t *periods, 
+    uint16_t max); 
+
+
+/**
+ * @brief Get the revolution period 
+ * 
+ * @param rev : revolution capture data 
+ * @param now : current timer count (us) 
+ * @return uint32_t : revolution period (us), 0 if the wheel is stopped or the period 
+ *                    isn't known yet 
+ */
+uint32_t log_rev_period(
+    const log_rev_t *rev, 
+    uint32_t now); 
+
+//=======================================================================================
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif   // _LOG_REV_H_ 
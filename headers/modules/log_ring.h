@@ -0,0 +1,191 @@
+/**
+ * @file log_ring.h
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Single producer single consumer sample ring interface 
+ * 
+ * @details Fixed size ring buffer used to pass samples from an interrupt (producer) to 
+ *          the main loop (consumer) without disabling interrupts. The producer only 
+ *          writes the head index and the consumer only writes the tail index. Each index 
+ *          is a free running counter that is masked to get a buffer position, so the 
+ *          number of items in the ring is always head - tail and the ring size must be a 
+ *          power of 2. 
+ * 
+ *          The indexes are published with acquire/release ordering so an item is fully 
+ *          written before the consumer can see it and fully read before the producer can 
+ *          overwrite it. If the ring is full when the producer pushes, the new item is 
+ *          dropped and counted. A high water mark of the ring fill level is kept so the 
+ *          ring size can be checked against real use. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _LOG_RING_H_ 
+#define _LOG_RING_H_ 
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=======================================================================================
+// Includes 
+
+#include "tools.h"
+
+#include <stdint.h>
+#include <string.h>
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+// Checks that a ring size is a non-zero power of 2 
+#define LOG_RING_SIZE_VALID(size) (((size) != 0) && (((size) & ((size) - 1)) == 0)) 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// Ring buffer data 
+typedef struct log_ring_s
+{
+    // Buffer info 
+    uint8_t *buff;                              // Item storage 
+    uint32_t item_size;                         // Size of one item (bytes) 
+    uint32_t size;                              // Number of items the ring can hold 
+    uint32_t mask;                              // Index to buffer position mask 
+
+    // Indexes - head is only written by the producer and tail by the consumer 
+    volatile uint32_t head;                     // Next item to write 
+    volatile uint32_t tail;                     // Next item to read 
+
+    // Status - only written by the producer 
+    volatile uint32_t hwm;                      // Most items held in the ring at once 
+    volatile uint32_t drops;                    // Items dropped because the ring was full 
+}
+log_ring_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Initialization 
+
+/**
+ * @brief Initialize a ring 
+ * 
+ * @details Assigns the item storage and clears the indexes and status counters. The 
+ *          storage must hold 'size' items of 'item_size' bytes and 'size' must be a power 
+ *          of 2. If the size is invalid then the ring is left empty with no storage and 
+ *          all pushes will be dropped. 
+ * 
+ * @param ring : ring to initialize 
+ * @param buff : item storage 
+ * @param item_size : size of one item (bytes) 
+ * @param size : number of items the storage can hold 
+ * @return uint8_t : TRUE if the ring was initialized, FALSE if the size is invalid 
+ */
+uint8_t log_ring_init(
+    log_ring_t *ring, 
+    void *buff, 
+    uint32_t item_size, 
+    uint32_t size); 
+
+
+/**
+ * @brief Reset a ring 
+ * 
+ * @details Empties the ring and clears the status counters. This must only be called 
+ *          while the producer is stopped (i.e. its interrupt is disabled). 
+ * 
+ * @param ring : ring to reset 
+ */
+void log_ring_reset(log_ring_t *ring); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Producer / consumer 
+
+/**
+ * @brief Push an item onto a ring 
+ * 
+ * @details Copies an item into the ring and publishes it to the consumer. Must only be 
+ *          called from the producer context. If the ring is full the item is dropped and 
+ *          the drop counter is incremented. 
+ * 
+ * @param ring : ring to push to 
+ * @param item : item to copy into the ring 
+ * @return uint8_t : TRUE if the item was queued, FALSE if it was dropped 
+ */
+uint8_t log_ring_push(
+    log_ring_t *ring, 
+    const void *item); 
+
+
+/**
+ * @brief Pop an item from a ring 
+ * 
+ * @details Copies the oldest item out of the ring and frees its space for the producer. 
+ *          Must only be called from the consumer context. 
+ * 
+ * @param ring : ring to pop from 
+ * @param item : buffer to copy the item to 
+ * @return uint8_t : TRUE if an item was read, FALSE if the ring is empty 
+ */
+uint8_t log_ring_pop(
+    log_ring_t *ring, 
+    void *item); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Getters 
+
+/**
+ * @brief Get the number of items in a ring 
+ * 
+ * @details The value is a snapshot. The producer may add items at any time so from the 
+ *          consumer context the ring holds at least this many items. 
+ * 
+ * @param ring : ring to check 
+ * @return uint32_t : number of items in the ring 
+ */
+uint32_t log_ring_get_count(log_ring_t *ring); 
+
+
+/**
+ * @brief Get the ring high water mark 
+ * 
+ * @param ring : ring to check 
+ * @return uint32_t : most items held in the ring at once since the last reset 
+ */
+uint32_t log_ring_get_hwm(log_ring_t *ring); 
+
+
+/**
+ * @brief Get the ring drop count 
+ * 
+ * @param ring : ring to check 
+ * @return uint32_t : items dropped because the ring was full since the last reset 
+ */
+uint32_t log_ring_get_drops(log_ring_t *ring); 
+
+//=======================================================================================
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif   // _LOG_RING_H_ 
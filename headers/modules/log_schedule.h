@@ -0,0 +1,234 @@
+/**
+ * @file log_schedule.h
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Log stream schedule interface 
+ * 
+ * @details Holds the timing of the log streams in one table (LOG_SCHEDULE) and picks 
+ *          the streams that run in each log stream slot. A slot comes every 
+ *          LOG_STREAM_PERIOD and the standard stream runs in any slot where no other 
+ *          stream runs. 
+ * 
+ *          Each stream has a counter that starts at its offset and counts slots up to 
+ *          its period, so a stream with a period of 4 runs every 4th slot and the offset 
+ *          moves which slot that is. Streams that are due in the same slot (a collision) 
+ *          run together as long as their worst case times (costs) fit in the slot budget. 
+ *          A stream that doesn't fit is deferred to the next slot where it goes ahead of 
+ *          the streams due then. The stream counters keep running while a stream is 
+ *          deferred so its later slots don't move. 
+ * 
+ *          The schedule repeats every hyperperiod (the least common multiple of the 
+ *          stream periods). The hyperperiod, the collisions between each pair of streams 
+ *          and the stream time needed over a hyperperiod are worked out at compile time 
+ *          from the table and checked in log_schedule.c, so a bad schedule doesn't build. 
+ *          tools/log_timeline prints the slots of the hyperperiod. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _LOG_SCHEDULE_H_ 
+#define _LOG_SCHEDULE_H_ 
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=======================================================================================
+// Includes 
+
+#include <stdint.h>
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define LOG_STREAM_PERIOD 50             // (ms) Log stream slot and SD card write period 
+#define LOG_SLOT_BUDGET 1500             // (us) Stream time allowed in one slot 
+
+// Log stream schedule - the only place the stream timing is set. The row order is the 
+// stream order (log_sched_stream_t) and the priority when a slot's budget is short. 
+// - offset : counter starting value, less than the period 
+// - period : counter period (slots), 1-255. Period * LOG_STREAM_PERIOD == stream period 
+// - cost : (us) worst case stream time 
+//   - GPS copies the last fix 
+//   - Accel is a blocking I2C read (100kHz) 
+//   - Speed sums the revolution windows 
+// - share : 1 if the stream can be due in the same slot as other streams that share. A 
+//   collision between streams that don't both share fails the build. 
+// 
+// X(stream, offset, period, cost, share) 
+#define LOG_SCHEDULE(X) \
+    X(GPS,   0, 20, 50,   0) \
+    X(ACCEL, 1,  2, 1000, 0) \
+    X(SPEED, 2,  4, 50,   0)
+
+// Stream bit in a set of streams 
+#define LOG_SCHED_BIT(stream) (1U << (stream)) 
+
+// Euclid's algorithm as a chain of enumerators (name##_A0 = a, name##_B0 = b). Each 
+// step only names the step before it so the expansion stays small. b must be a period 
+// (<= 255) so 14 steps always reach the GCD, which is left in name##_A14. 
+#define LOG_SCHED_GCD_STEP(name, i, j) \
+    name##_A##j = (name##_B##i != 0) ? name##_B##i : name##_A##i, \
+    name##_B##j = (name##_B##i != 0) ? \
+                  (name##_A##i % (name##_B##i + (name##_B##i == 0))) : 0, 
+
+#define LOG_SCHED_GCD(name, a, b) \
+    name##_A0 = (a), name##_B0 = (b), \
+    LOG_SCHED_GCD_STEP(name, 0, 1) LOG_SCHED_GCD_STEP(name, 1, 2) \
+    LOG_SCHED_GCD_STEP(name, 2, 3) LOG_SCHED_GCD_STEP(name, 3, 4) \
+    LOG_SCHED_GCD_STEP(name, 4, 5) LOG_SCHED_GCD_STEP(name, 5, 6) \
+    LOG_SCHED_GCD_STEP(name, 6, 7) LOG_SCHED_GCD_STEP(name, 7, 8) \
+    LOG_SCHED_GCD_STEP(name, 8, 9) LOG_SCHED_GCD_STEP(name, 9, 10) \
+    LOG_SCHED_GCD_STEP(name, 10, 11) LOG_SCHED_GCD_STEP(name, 11, 12) \
+    LOG_SCHED_GCD_STEP(name, 12, 13) LOG_SCHED_GCD_STEP(name, 13, 14) \
+    name = name##_A14
+
+// Least common multiple of a and a period b (name##_GCD holds their GCD) 
+#define LOG_SCHED_LCM(name, a, b) \
+    LOG_SCHED_GCD(name##_GCD, a, b), \
+    name = ((a) / (name##_GCD + (name##_GCD == 0))) * (b)
+
+// Collision check of two streams. Both are due in the same slot at some point if their 
+// offsets match modulo the GCD of their periods. name is 1 for a collision that isn't 
+// allowed. 
+#define LOG_SCHED_PAIR(name, a, b) \
+    LOG_SCHED_GCD(name##_GCD, LOG_##a##_PERIOD, LOG_##b##_PERIOD), \
+    name##_COLLIDE = ((LOG_##a##_OFFSET % name##_GCD) == \
+                      (LOG_##b##_OFFSET % name##_GCD)), \
+    name = name##_COLLIDE && !(LOG_##a##_SHARE && LOG_##b##_SHARE)
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Enums 
+
+// Log streams - the standard stream and the schedule rows in table order 
+#define LOG_SCHED_STREAM(stream, offset, period, cost, share) LOG_SCHED_##stream, 
+
+typedef enum {
+    LOG_SCHED_STANDARD,                 // Standard stream - runs when no other does 
+    LOG_SCHEDULE(LOG_SCHED_STREAM)
+    LOG_SCHED_NUM                       // Number of log streams 
+} log_sched_stream_t; 
+
+
+// Stream timing from the table (LOG_GPS_OFFSET, LOG_GPS_PERIOD, LOG_GPS_COST, ...) 
+#define LOG_SCHED_CONST(stream, offset, period, cost, share) \
+    LOG_##stream##_OFFSET = (offset), \
+    LOG_##stream##_PERIOD = (period), \
+    LOG_##stream##_COST = (cost), \
+    LOG_##stream##_SHARE = (share), 
+
+enum {
+    LOG_SCHEDULE(LOG_SCHED_CONST)
+}; 
+
+
+// Hyperperiod (slots) - the schedule repeats after this many slots. Adding a stream 
+// adds a step here (checked in log_schedule.c). 
+enum {
+    LOG_SCHED_LCM(LOG_SCHED_H_GPS, 1, LOG_GPS_PERIOD), 
+    LOG_SCHED_LCM(LOG_SCHED_H_ACCEL, LOG_SCHED_H_GPS, LOG_ACCEL_PERIOD), 
+    LOG_SCHED_LCM(LOG_SCHED_H_SPEED, LOG_SCHED_H_ACCEL, LOG_SPEED_PERIOD), 
+    LOG_SCHED_HYPERPERIOD = LOG_SCHED_H_SPEED, 
+    LOG_SCHED_HYPER_STREAMS = 3         // Streams folded into the hyperperiod 
+}; 
+
+
+// Collisions between each pair of streams (LOG_SCHED_GPS_ACCEL_COLLIDE, ...) and the 
+// number that aren't allowed. Adding a stream adds its pairs here (checked in 
+// log_schedule.c). 
+enum {
+    LOG_SCHED_PAIR(LOG_SCHED_GPS_ACCEL, GPS, ACCEL), 
+    LOG_SCHED_PAIR(LOG_SCHED_GPS_SPEED, GPS, SPEED), 
+    LOG_SCHED_PAIR(LOG_SCHED_ACCEL_SPEED, ACCEL, SPEED), 
+    LOG_SCHED_COLLISIONS = LOG_SCHED_GPS_ACCEL + LOG_SCHED_GPS_SPEED + 
+                           LOG_SCHED_ACCEL_SPEED, 
+    LOG_SCHED_PAIRS = 3                 // Stream pairs checked 
+}; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// Log stream schedule data 
+typedef struct log_schedule_s
+{
+    uint8_t counter[LOG_SCHED_NUM];             // Stream counters (standard unused) 
+    uint8_t deferred;                           // Streams deferred to the next slot (bits) 
+}
+log_schedule_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Functions 
+
+/**
+ * @brief Initialize the schedule 
+ * 
+ * @details Sets each stream counter to its offset and clears deferred streams. The next 
+ *          slot is the first slot of the schedule. 
+ * 
+ * @param sched : schedule data 
+ */
+void log_schedule_init(log_schedule_t *sched); 
+
+
+/**
+ * @brief Pick the streams of a slot 
+ * 
+ * @details Counts the slot for every stream then picks the deferred streams and then 
+ *          the streams that are due now, each in table order, as long as their cost fits 
+ *          in what's left of LOG_SLOT_BUDGET. The rest are deferred to the next slot. The 
+ *          choice only depends on the schedule so it's the same every time the schedule 
+ *          runs. Call once per slot. 
+ * 
+ * @param sched : schedule data 
+ * @return uint8_t : streams to run (LOG_SCHED_BIT), 0 for the standard stream 
+ */
+uint8_t log_schedule_select(log_schedule_t *sched); 
+
+
+/**
+ * @brief Count a slot for one stream 
+ * 
+ * @details For when only one stream of the schedule is used (ex. calibration). Call once 
+ *          per slot. 
+ * 
+ * @param sched : schedule data 
+ * @param stream : stream to count 
+ * @return uint8_t : 1 if the stream is due in this slot, 0 otherwise 
+ */
+uint8_t log_schedule_due(
+    log_schedule_t *sched, 
+    log_sched_stream_t stream); 
+
+
+/**
+ * @brief Get the cost of a set of streams 
+ * 
+ * @param streams : streams (LOG_SCHED_BIT) 
+ * @return uint32_t : (us) summed worst case time of the streams 
+ */
+uint32_t log_schedule_cost(uint8_t streams); 
+
+//=======================================================================================
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif   // _LOG_SCHEDULE_H_ 
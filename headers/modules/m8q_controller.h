@@ -24,6 +24,19 @@ extern "C" {
 
 #include "m8q_driver.h"
 #include "timers_driver.h"
+#include "m8q_config.h"
+#include "m8q_ubx.h"
+#include "i2c_bus.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define M8Q_UBX_BUFF_SIZE 256           // Data stream read buffer size (UBX NAV-PVT mode) 
+#define M8Q_FIX_STR_LEN 12              // Position string buffer size (PUBX mode) 
+#define M8Q_FIX_TIME_LEN 10             // UTC time and date buffer size (PUBX mode) 
 
 //=======================================================================================
 
@@ -56,6 +69,32 @@ typedef m8q_states_t M8Q_STATE;
 //=======================================================================================
 
 
+//=======================================================================================
+// Structures 
+
+// GPS fix - the data published by the controller after each read of the device 
+typedef struct m8q_fix_s
+{
+    uint16_t navstat;                       // Navigation status (see m8q_get_navstat) 
+    uint8_t lock;                           // Navigation status lock 
+    uint32_t time;                          // I2C bus timebase count when it was read 
+#if M8Q_UBX_NAV_PVT
+    m8q_ubx_nav_pvt_t pvt;                  // Last NAV-PVT message 
+#else
+    uint8_t lat_str[M8Q_FIX_STR_LEN];       // Latitude string 
+    uint8_t NS;                             // North/South indicator of latitude 
+    uint8_t lon_str[M8Q_FIX_STR_LEN];       // Longitude string 
+    uint8_t EW;                             // East/West indicator of longitude 
+    uint8_t sog_str[M8Q_FIX_STR_LEN];       // Speed over ground string 
+    uint8_t utc_time[M8Q_FIX_TIME_LEN];     // UTC time (PUBX TIME message) 
+    uint8_t utc_date[M8Q_FIX_TIME_LEN];     // UTC date (PUBX TIME message) 
+#endif
+}
+m8q_fix_t; 
+
+//=======================================================================================
+
+
 //=======================================================================================
 // Control functions 
 
@@ -107,9 +146,10 @@ void m8q_controller(void);
  *          coming from the init and low power exit states. After running the controller 
  *          initialization function the controller will default to the read state from 
  *          the init state without needing to set this flag. In the read state the 
- *          controller checks for the presence of data in the data stream using the TX 
- *          ready pin. If there is data then it will be read and stored by the driver 
- *          as needed. 
+ *          controller reads the data stream once the TX ready interrupt shows there's 
+ *          data waiting and publishes the new fix. 
+ * 
+ * @see m8q_txr_handler 
  */
 void m8q_set_read_flag(void); 
 
@@ -207,6 +247,78 @@ uint8_t m8q_get_lp_flag(void);
  */
 M8Q_FAULT_CODE m8q_get_fault_code(void); 
 
+
+/**
+ * @brief Get the navigation status 
+ * 
+ * @details Returns the two character navigation status (ex. "G3") with the first 
+ *          character in the high byte. Comes from the last fix published by the 
+ *          controller (PUBX POSITION message or NAV-PVT message in UBX NAV-PVT mode). 
+ * 
+ * @see m8q_ubx_navstat 
+ * 
+ * @return uint16_t : navigation status 
+ */
+uint16_t m8q_get_navstat(void); 
+
+
+/**
+ * @brief Get the navigation status lock 
+ * 
+ * @details Comes from the last fix published by the controller. 
+ * 
+ * @return uint8_t : 1 if there's a position fix, 0 otherwise 
+ */
+uint8_t m8q_get_navstat_lock(void); 
+
+
+/**
+ * @brief Get the data ready flag 
+ * 
+ * @details The flag is set by the TX ready interrupt when the device has data to send 
+ *          and it's cleared when the read state reads the data. This lets the caller 
+ *          choose when the controller uses the I2C bus, ex. data logging only reads the 
+ *          device between logging stream slots. 
+ * 
+ * @see m8q_txr_handler 
+ * 
+ * @return uint8_t : 1 if the device has data waiting, 0 otherwise 
+ */
+uint8_t m8q_get_data_ready(void); 
+
+
+/**
+ * @brief Get the last GPS fix 
+ * 
+ * @details Copies the last fix published by the controller. The fix is published with 
+ *          a sequence count that's odd while it's being written, so the copy is retried 
+ *          if it started during a write or a write happened during the copy. This means 
+ *          the fields always come from the same read of the device no matter where the 
+ *          controller runs from, and getting the fix never touches the I2C bus. The fix 
+ *          is empty with a navigation status of NF until the first read of the device. 
+ * 
+ * @param fix : buffer to store the fix 
+ */
+void m8q_get_fix(m8q_fix_t *fix); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Interrupt callbacks 
+
+/**
+ * @brief TX ready interrupt callback 
+ * 
+ * @details Called from the EXTI interrupt of the TX ready pin. The device sets the pin 
+ *          when the data waiting to be sent passes the TX ready threshold in the port 
+ *          configuration, so this only sets the data ready flag and the data is read the 
+ *          next time the controller runs in the read state. 
+ * 
+ * @see m8q_get_data_ready 
+ */
+void m8q_txr_handler(void); 
+
 //=======================================================================================
 
 #ifdef __cplusplus
@@ -0,0 +1,195 @@
+/**
+ * @file m8q_ubx.h
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief SAM-M8Q UBX message parser interface 
+ * 
+ * @details Finds UBX-NAV-PVT messages in the bytes read from the M8Q data stream. Bytes 
+ *          are fed in as they're read and the parser keeps its place between calls so 
+ *          a message can be split across reads. Other UBX messages (ACK, etc.) and any 
+ *          NMEA text in the stream are skipped. A NAV-PVT message is only kept once its 
+ *          checksum passes, so the last good fix stays available until a new one arrives. 
+ * 
+ *          NAV-PVT is a fixed 92 byte little-endian payload so it's copied directly into 
+ *          its structure. That's the same byte order as the Cortex-M4 and x86 hosts. 
+ * 
+ *          This file has no firmware dependencies so it can be shared with host-side 
+ *          tools. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _M8Q_UBX_H_ 
+#define _M8Q_UBX_H_ 
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=======================================================================================
+// Includes 
+
+#include <stdint.h>
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define M8Q_UBX_SYNC_1 0xB5              // First UBX sync character 
+#define M8Q_UBX_SYNC_2 0x62              // Second UBX sync character 
+#define M8Q_UBX_CLASS_NAV 0x01           // Navigation message class 
+#define M8Q_UBX_ID_NAV_PVT 0x07          // NAV-PVT message ID 
+#define M8Q_UBX_NAV_PVT_LEN 92           // NAV-PVT payload length 
+#define M8Q_UBX_FRAME_LEN 8              // Sync, class, ID, length and checksum bytes 
+
+// NAV-PVT flags 
+#define M8Q_UBX_PVT_GNSS_FIX_OK 0x01     // flags: fix is valid 
+#define M8Q_UBX_PVT_DIFF_SOLN 0x02       // flags: differential corrections applied 
+#define M8Q_UBX_PVT_VALID_DATE 0x01      // valid: UTC date is valid 
+#define M8Q_UBX_PVT_VALID_TIME 0x02      // valid: UTC time of day is valid 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Enums 
+
+// NAV-PVT fix types 
+typedef enum {
+    M8Q_UBX_FIX_NONE,          // No fix 
+    M8Q_UBX_FIX_DR,            // Dead reckoning only 
+    M8Q_UBX_FIX_2D,            // 2D fix 
+    M8Q_UBX_FIX_3D,            // 3D fix 
+    M8Q_UBX_FIX_GNSS_DR,       // GNSS and dead reckoning 
+    M8Q_UBX_FIX_TIME           // Time only fix 
+} m8q_ubx_fix_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// NAV-PVT payload 
+typedef struct __attribute__((packed)) m8q_ubx_nav_pvt_s
+{
+    uint32_t iTOW;                              // (ms) GPS time of week 
+    uint16_t year;                              // UTC year 
+    uint8_t month;                              // UTC month (1-12) 
+    uint8_t day;                                // UTC day of month (1-31) 
+    uint8_t hour;                               // UTC hour (0-23) 
+    uint8_t min;                                // UTC minute (0-59) 
+    uint8_t sec;                                // UTC second (0-60) 
+    uint8_t valid;                              // Date and time valid flags 
+    uint32_t tAcc;                              // (ns) Time accuracy estimate 
+    int32_t nano;                               // (ns) UTC fraction of a second 
+    uint8_t fixType;                            // Fix type - m8q_ubx_fix_t 
+    uint8_t flags;                              // Fix status flags 
+    uint8_t flags2;                             // Additional flags 
+    uint8_t numSV;                              // Satellites used in the fix 
+    int32_t lon;                                // (1e-7 deg) Longitude 
+    int32_t lat;                                // (1e-7 deg) Latitude 
+    int32_t height;                             // (mm) Height above ellipsoid 
+    int32_t hMSL;                               // (mm) Height above mean sea level 
+    uint32_t hAcc;                              // (mm) Horizontal accuracy estimate 
+    uint32_t vAcc;                              // (mm) Vertical accuracy estimate 
+    int32_t velN;                               // (mm/s) North velocity 
+    int32_t velE;                               // (mm/s) East velocity 
+    int32_t velD;                               // (mm/s) Down velocity 
+    int32_t gSpeed;                             // (mm/s) Ground speed 
+    int32_t headMot;                            // (1e-5 deg) Heading of motion 
+    uint32_t sAcc;                              // (mm/s) Speed accuracy estimate 
+    uint32_t headAcc;                           // (1e-5 deg) Heading accuracy estimate 
+    uint16_t pDOP;                              // (0.01) Position DOP 
+    uint8_t flags3;                             // Additional flags 
+    uint8_t reserved1[5];                       // Reserved 
+    int32_t headVeh;                            // (1e-5 deg) Heading of vehicle 
+    int16_t magDec;                             // (1e-2 deg) Magnetic declination 
+    uint16_t magAcc;                            // (1e-2 deg) Declination accuracy 
+}
+m8q_ubx_nav_pvt_t; 
+
+
+// UBX parser data 
+typedef struct m8q_ubx_s
+{
+    uint8_t state;                              // Part of the message expected next 
+    uint8_t msg_class;                          // Class of the message being read 
+    uint8_t msg_id;                             // ID of the message being read 
+    uint16_t len;                               // Payload length of the message 
+    uint16_t index;                             // Payload bytes read 
+    uint8_t ck_a;                               // Checksum A of the message 
+    uint8_t ck_b;                               // Checksum B of the message 
+    uint8_t payload[M8Q_UBX_NAV_PVT_LEN];       // NAV-PVT payload being read 
+    m8q_ubx_nav_pvt_t pvt;                      // Last good NAV-PVT message 
+    uint16_t pvt_count;                         // NAV-PVT messages read (wraps) 
+    uint16_t errors;                            // Checksum failures (wraps) 
+}
+m8q_ubx_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Functions 
+
+/**
+ * @brief Initialize the UBX parser 
+ * 
+ * @details Clears the last NAV-PVT message (no fix) and looks for the start of a message. 
+ * 
+ * @param ubx : UBX parser data 
+ */
+void m8q_ubx_init(m8q_ubx_t *ubx); 
+
+
+/**
+ * @brief Parse bytes read from the data stream 
+ * 
+ * @param ubx : UBX parser data 
+ * @param data : bytes read from the data stream 
+ * @param len : number of bytes 
+ * @return uint8_t : number of good NAV-PVT messages found 
+ */
+uint8_t m8q_ubx_parse(
+    m8q_ubx_t *ubx, 
+    const uint8_t *data, 
+    uint16_t len); 
+
+
+/**
+ * @brief Get the navigation status 
+ * 
+ * @details Turns the NAV-PVT fix into the two character navigation status of the PUBX 
+ *          POSITION message (high byte first) so it can be shown the same way: NF (no 
+ *          fix), DR, G2, G3, D3 (differential 3D), RK (GNSS and dead reckoning) or TT 
+ *          (time only). A fix that isn't flagged as valid is NF. 
+ * 
+ * @param pvt : NAV-PVT message 
+ * @return uint16_t : navigation status 
+ */
+uint16_t m8q_ubx_navstat(const m8q_ubx_nav_pvt_t *pvt); 
+
+
+/**
+ * @brief Get the navigation status lock 
+ * 
+ * @param pvt : NAV-PVT message 
+ * @return uint8_t : 1 if there's a valid 2D or 3D position fix, 0 otherwise 
+ */
+uint8_t m8q_ubx_navstat_lock(const m8q_ubx_nav_pvt_t *pvt); 
+
+//=======================================================================================
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif   // _M8Q_UBX_H_ 
@@ -24,6 +24,8 @@ extern "C" {
 
 #include "mpu6050_driver.h"
 #include "timers_driver.h"
+#include "i2c_comm.h"
+#include "i2c_bus.h"
 
 //=======================================================================================
 
@@ -40,6 +42,12 @@ extern "C" {
 #define MPU6050_RAW_TEMP_MAX 28900       // Max raw temp reading before fault (~ 40 degC) 
 #define MPU6050_RAW_TEMP_OFST 27720      // Raw temp reading offset 
 
+// FIFO - each frame holds one accelerometer and one gyroscope sample (big endian) 
+#define MPU6050_FIFO_SIZE 1024           // Device FIFO size (bytes) 
+#define MPU6050_FIFO_FRAME_SIZE 12       // Bytes per FIFO frame (3 accel + 3 gyro axes) 
+#define MPU6050_FIFO_AXES 3              // Axes per sensor in a frame 
+#define MPU6050_FIFO_BASE_RATE 1000      // (Hz) Sample rate before the divider (DLPF on) 
+
 //=======================================================================================
 
 
@@ -116,6 +124,24 @@ typedef struct mpu6050_cntrl_data_s
     // --> bits 9-15: not used 
     MPU6050_FAULT_CODE fault_code;          // Controller fault code 
 
+    // FIFO 
+    I2C_TypeDef *i2c;                       // I2C port the device is on 
+    uint8_t addr;                           // Device I2C address 
+    uint8_t *fifo_buff;                     // FIFO burst read buffer (NULL = FIFO not used) 
+    uint16_t fifo_buff_size;                // FIFO burst read buffer size (bytes) 
+    volatile uint16_t fifo_frames;          // Frames in the buffer from the last burst read 
+    volatile uint16_t fifo_overflow;        // Times the FIFO filled up and was reset 
+    volatile uint32_t fifo_time;            // I2C bus timebase count of the last count read 
+
+    // FIFO reads run in the background on the I2C bus. The transaction callbacks run 
+    // in the I2C interrupts so the busy flag is kept out of the tracker bit fields. 
+    uint8_t fifo_count[BYTE_2];             // FIFO count read buffer 
+    uint8_t fifo_ctrl;                      // FIFO reset write value 
+    i2c_bus_trans_t count_trans;            // FIFO count read 
+    i2c_bus_trans_t data_trans;             // FIFO burst read 
+    i2c_bus_trans_t reset_trans;            // FIFO reset write 
+    volatile uint8_t fifo_busy;             // FIFO read in flight 
+
     // Trackers 
     mpu6050_sleep_mode_t low_power : 1;     // Low power flag 
     uint8_t reset                  : 1;     // Reset state trigger 
@@ -123,6 +149,8 @@ typedef struct mpu6050_cntrl_data_s
     uint8_t read                   : 1;     // Triggers a read in the read ready state 
     uint8_t read_state             : 1;     // Sets which read state to use 
     uint8_t smpl_type              : 3;     // Read function to execute - mpu6050_sample_type_t
+    uint8_t fifo_read              : 1;     // Triggers a FIFO burst read in the read ready state 
+    uint8_t fifo_reset             : 1;     // Triggers a FIFO reset in the read ready state 
 }
 mpu6050_cntrl_data_t; 
 
@@ -187,6 +215,37 @@ void mpu6050_controller_init(
  */
 void mpu6050_controller(device_number_t device_num); 
 
+
+/**
+ * @brief MPU6050 FIFO initialization 
+ * 
+ * @details Sets the device sample rate and enables the device FIFO for the accelerometer 
+ *          and gyroscope so every sample is kept until it's read. The sample rate is 
+ *          MPU6050_FIFO_BASE_RATE / (1 + rate_div) which relies on the digital low pass 
+ *          filter being enabled in the driver init. The FIFO is read in bursts into 
+ *          'buff' when the FIFO read flag is set and the controller is in the read ready 
+ *          state. Must be called after the controller init for the same device. 
+ * 
+ *          The FIFO holds MPU6050_FIFO_SIZE bytes so it has to be read before it fills 
+ *          (85 frames, 85ms at 1kHz). FIFO reads are posted to the I2C bus manager and 
+ *          run in fast mode (400kHz) so high sample rates don't tie up the bus (12 bytes 
+ *          per frame). The I2C bus manager must be initialized first. 
+ * 
+ * @param device_num : device number - used for retrieving the correct data record 
+ * @param i2c : I2C port the device is on 
+ * @param addr : device I2C address 
+ * @param rate_div : sample rate divider 
+ * @param buff : FIFO burst read buffer 
+ * @param buff_size : FIFO burst read buffer size (bytes) 
+ */
+void mpu6050_fifo_init(
+    device_number_t device_num, 
+    I2C_TypeDef *i2c, 
+    mpu6050_i2c_addr_t addr, 
+    uint8_t rate_div, 
+    uint8_t *buff, 
+    uint16_t buff_size); 
+
 //=======================================================================================
 
 
@@ -252,6 +311,36 @@ void mpu6050_set_read_state(
 void mpu6050_set_read_flag(device_number_t device_num); 
 
 
+/**
+ * @brief Set the FIFO read flag 
+ * 
+ * @details Triggers a FIFO burst read in the read ready state. The FIFO count is read 
+ *          then every whole frame in the FIFO (up to what the buffer holds) is read in 
+ *          one I2C transaction. The read is posted to the I2C bus so the controller 
+ *          returns right away and the frames are available once the read finishes. If 
+ *          the FIFO filled up then samples were lost and frame alignment can't be trusted 
+ *          so the FIFO is reset and no frames are returned. The flag is ignored while the 
+ *          last read is still in flight. 
+ * 
+ * @see mpu6050_get_fifo_frames 
+ * 
+ * @param device_num : device number - used for retrieving the correct data record 
+ */
+void mpu6050_set_fifo_flag(device_number_t device_num); 
+
+
+/**
+ * @brief Set the FIFO reset flag 
+ * 
+ * @details Triggers a FIFO reset in the read ready state. The samples in the FIFO and 
+ *          the frames from the last burst read are thrown away. Set with the FIFO read 
+ *          flag the reset happens first. 
+ * 
+ * @param device_num : device number - used for retrieving the correct data record 
+ */
+void mpu6050_set_fifo_reset_flag(device_number_t device_num); 
+
+
 /**
  * @brief MPU6050 set reset flag 
  * 
@@ -308,6 +397,57 @@ MPU6050_STATE mpu6050_get_state(device_number_t device_num);
  */
 MPU6050_FAULT_CODE mpu6050_get_fault_code(device_number_t device_num); 
 
+
+/**
+ * @brief Get the number of frames from the last FIFO burst read 
+ * 
+ * @details Frames are only available once the burst read has finished. This is 0 while 
+ *          a read is in flight. 
+ * 
+ * @param device_num : device number - used for retrieving the correct data record 
+ * @return uint16_t : frames read 
+ */
+uint16_t mpu6050_get_fifo_frames(device_number_t device_num); 
+
+
+/**
+ * @brief Get the time of the last FIFO burst read 
+ * 
+ * @details The I2C bus timebase count when the FIFO count was read for the last burst 
+ *          read. Every frame read was in the FIFO by then, so the last frame was taken 
+ *          at most one sample period before this time. Only valid while there are frames. 
+ * 
+ * @param device_num : device number - used for retrieving the correct data record 
+ * @return uint32_t : timebase count of the FIFO count read 
+ */
+uint32_t mpu6050_get_fifo_time(device_number_t device_num); 
+
+
+/**
+ * @brief Get a frame from the last FIFO burst read 
+ * 
+ * @param device_num : device number - used for retrieving the correct data record 
+ * @param frame : frame index (oldest first) 
+ * @param accel : buffer to store the raw accelerometer axes (MPU6050_FIFO_AXES) 
+ * @param gyro : buffer to store the raw gyroscope axes (MPU6050_FIFO_AXES) 
+ */
+void mpu6050_get_fifo_frame(
+    device_number_t device_num, 
+    uint16_t frame, 
+    int16_t *accel, 
+    int16_t *gyro); 
+
+
+/**
+ * @brief Get the FIFO overflow count 
+ * 
+ * @details The number of times the FIFO filled up and was reset since the FIFO init. 
+ * 
+ * @param device_num : device number - used for retrieving the correct data record 
+ * @return uint16_t : FIFO overflow count 
+ */
+uint16_t mpu6050_get_fifo_overflow(device_number_t device_num); 
+
 //=======================================================================================
 
 #ifdef __cplusplus
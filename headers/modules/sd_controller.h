@@ -23,6 +23,7 @@ extern "C" {
 // Includes 
 
 #include "sd_driver.h" 
+#include "sd_spi.h"
 #include "ff.h"
 
 //=======================================================================================
@@ -39,6 +40,16 @@ extern "C" {
 #define SD_INFO_SIZE 30             // Device info buffer size 
 #define SD_FREE_THRESH 0x0000C350   // Free space threshold before disk full fault (KB) 
 
+// File handles 
+#define SD_NUM_FILES 4              // Files that can be open at once (handle pool size) 
+#define SD_FILE_DEFAULT 0           // Handle of the file used by the single file functions 
+#define SD_HANDLE_NONE 0xFF         // No file handle 
+
+// Write buffer 
+#define SD_SECTOR_SIZE 512          // Volume sector size (bytes) 
+#define SD_BUFF_SECTORS 4           // Write buffer size (sectors) 
+#define SD_BUFF_SIZE (SD_SECTOR_SIZE*SD_BUFF_SECTORS)   // Write buffer size (bytes) 
+
 //=======================================================================================
 
 
@@ -79,6 +90,16 @@ typedef enum {
 //=======================================================================================
 // Structures 
 
+// File handle pool entry 
+typedef struct sd_file_s
+{
+    FIL file;                                    // File object 
+    FSIZE_t open_size;                           // File size when it was opened 
+    uint8_t open : 1;                            // Open file flag 
+}
+sd_file_t; 
+
+
 // SD card controller trackers 
 typedef struct sd_trackers_s 
 {
@@ -89,13 +110,19 @@ typedef struct sd_trackers_s
 
     // File system information 
     FATFS file_sys;                              // File system object 
-    FIL file;                                    // File object 
+    sd_file_t files[SD_NUM_FILES];               // File handle pool 
     FRESULT fresult;                             // Store result of FatFs operation 
     UINT br, bw;                                 // Read and write counters 
     TCHAR path[SD_PATH_SIZE];                    // Path to project directory 
     TCHAR dir[SD_PATH_SIZE];                     // Sub-directory in project directory 
 
-    // Card capacity 
+    // Write buffer - holds data for the default file until whole sectors can be written 
+    uint8_t buff[SD_BUFF_SIZE];                  // Buffered data 
+    UINT buff_len;                               // Number of bytes buffered 
+
+    // Card capacity - the free clusters are read from the volume when it's mounted (or 
+    // on request) then kept up to date from the files and directories created, written 
+    // and deleted 
     FATFS *pfs;                                  // Pointer to file system object 
     DWORD fre_clust;                             // Free clusters 
     DWORD total, free_space;                     // Volume total and free space 
@@ -105,13 +132,14 @@ typedef struct sd_trackers_s
     DWORD serial_num;                            // Volume serial number 
 
     // State trackers 
-    uint8_t mount      : 1;                      // Volume mount flag 
-    uint8_t not_ready  : 1;                      // Not ready flag 
-    uint8_t check      : 1;                      // Check flag 
-    uint8_t eject      : 1;                      // Eject flag 
-    uint8_t open_file  : 1;                      // Open file flag 
-    uint8_t reset      : 1;                      // Reset state trigger 
-    uint8_t startup    : 1;                      // Ensures the init state is run 
+    uint8_t mount       : 1;                     // Volume mount flag 
+    uint8_t not_ready   : 1;                     // Not ready flag 
+    uint8_t check       : 1;                     // Check flag 
+    uint8_t eject       : 1;                     // Eject flag 
+    uint8_t dir_cached  : 1;                     // Set directory is the current directory 
+    uint8_t dir_missing : 1;                     // Set directory failed to resolve 
+    uint8_t reset       : 1;                     // Reset state trigger 
+    uint8_t startup     : 1;                     // Ensures the init state is run 
 }
 sd_trackers_t; 
 
@@ -126,6 +154,7 @@ typedef uint16_t SD_FAULT_CODE;
 typedef DWORD SD_FAULT_MODE; 
 typedef uint8_t SD_FILE_STATUS; 
 typedef int8_t SD_EOF; 
+typedef uint8_t SD_HANDLE; 
 
 //=======================================================================================
 
@@ -231,7 +260,12 @@ void sd_set_reset_flag(void);
 /**
  * @brief Set directory 
  * 
- * @details Updated (overwrites) the directry in the data record. 
+ * @details Updated (overwrites) the directry in the data record. The directory is 
+ *          resolved once (f_chdir) the first time a file in it is used and stays the 
+ *          current directory of the volume until a different directory is set, so files 
+ *          in it are opened by name without building the full path and without FatFs 
+ *          walking the directories from the root each time. Setting the directory that's 
+ *          already set does nothing. 
  * 
  * @param dir : project directory to access 
  */
@@ -283,8 +317,11 @@ FRESULT sd_mkdir(const TCHAR *dir);
  *          then the function will create a file if it does not already exist and open it in 
  *          write mode. See the SD card driver header for possible modes. 
  *           
- *          If a file is already open then there will be no attempt to open another. The result 
- *          can be observed in the return value. 
+ *          The file is opened in the default file handle (SD_FILE_DEFAULT) which the 
+ *          single file functions (sd_close, sd_f_write, sd_puts, etc.) use. If the default 
+ *          file is already open then there will be no attempt to open another. The result 
+ *          can be observed in the return value. Use sd_file_open for other files that need 
+ *          to be open at the same time. 
  * 
  * @param file_name : name of the file to open 
  * @param mode : mode to open the file in (read, write, etc.) 
@@ -300,10 +337,10 @@ FRESULT sd_open(
  * 
  * @details Wrapper function for the FATFS function f_close. 
  *          
- *          If there is an open file then it gets closed, the fault code gets updated if there 
- *          is an issue closing the file and then the volume free space gets updated in the 
- *          controller tracker. If there is no file open then the function will bypass the 
- *          above steps and return FR_OK. 
+ *          If there is an open file then it gets closed. The fault code gets updated if there 
+ *          is an issue closing the file, otherwise the volume free space estimate gets 
+ *          updated from the change in the file size. If there is no file open then the 
+ *          function will bypass the above steps and return FR_OK. 
  * 
  * @return FRESULT : FATFS file function return code 
  */
@@ -334,9 +371,10 @@ FRESULT sd_f_write(
  * @details Wrapper function for the FATFS function f_puts. 
  *          
  *          Attempts to write a string to the open file and updates the fault code if there's 
- *          a write issue. If no file is open then no data will be written and the fault code 
- *          won't be updated. The function returns the number of character encoding units 
- *          written to the file. If the write fails then a negtive number will be returned. 
+ *          a write issue. If no file is open or str is NULL then no data will be written, 
+ *          the fault code won't be updated and -1 is returned. The function returns the 
+ *          number of character encoding units written to the file. If the write fails then 
+ *          a negtive number will be returned. 
  *          
  *          If there is a fault, the fault mode will always read FR_DISK_ERR. f_puts is a 
  *          wrapper of f_write and if there is an error of any kind in f_write then the 
@@ -355,8 +393,9 @@ int16_t sd_puts(const TCHAR *str);
  * @details Wrapper function for the FATFS function f_printf. 
  *          
  *          This function attempts to write a formatted string to the open file and updates 
- *          the fault code if there's a write issue. If no file is open then no data will be 
- *          written and the fault code will not be updated. The formatted string and data 
+ *          the fault code if there's a write issue. If no file is open or fmt_str is NULL 
+ *          then no data will be written, the fault code will not be updated and -1 is 
+ *          returned. The formatted string and data 
  *          type (in this case an unsigned 16-bit integer) must match for this function to 
  *          work as expected. 
  *          
@@ -408,17 +447,257 @@ int8_t sd_printf(
 FRESULT sd_lseek(FSIZE_t offset); 
 
 
+/**
+ * @brief Pre-allocate contiguous space for the open file 
+ * 
+ * @details Wrapper function for the FATFS function f_expand. 
+ * 
+ *          Allocates a contiguous block of clusters of at least 'size' bytes to the open 
+ *          file. Writing into the block doesn't need any new clusters to be allocated so 
+ *          each write avoids a search of the FAT for free clusters and the FAT updates 
+ *          that come with it. The file size is set to 'size' so the file should be 
+ *          truncated with sd_truncate once writing is done. 
+ * 
+ *          The file must be open for writing and still be empty. If there isn't a large 
+ *          enough contiguous block of free space then nothing is allocated and FR_DENIED 
+ *          is returned. This is not treated as a fault because the file can still grow 
+ *          normally as it's written to. If no file is open then FR_INVALID_OBJECT is 
+ *          returned. 
+ * 
+ * @see sd_truncate 
+ * 
+ * @param size : number of bytes to allocate 
+ * @return FRESULT : FATFS file function return code 
+ */
+FRESULT sd_expand(FSIZE_t size); 
+
+
+/**
+ * @brief Truncate the open file at the read/write pointer 
+ * 
+ * @details Wrapper function for the FATFS function f_truncate. 
+ * 
+ *          Writes out anything in the write buffer then sets the file size to the current 
+ *          read/write pointer position, freeing any clusters past it. This is used to 
+ *          trim a file pre-allocated with sd_expand down to the data that was written. 
+ *          The fault code is updated if there's an issue. If no file is open then 
+ *          FR_INVALID_OBJECT is returned. 
+ * 
+ * @see sd_expand 
+ * 
+ * @return FRESULT : FATFS file function return code 
+ */
+FRESULT sd_truncate(void); 
+
+
+/**
+ * @brief Sync the open file 
+ * 
+ * @details Wrapper function for the FATFS function f_sync. 
+ * 
+ *          Writes the file information (size, first cluster) to its directory entry and 
+ *          makes the volume up to date as if the file was closed, but leaves the file 
+ *          open. Data written to the file before a sync is kept if power is lost after 
+ *          it. Data still in the write buffer is not written so the file writes stay 
+ *          sector aligned. Use sd_buff_flush first if that's needed too. The fault code 
+ *          is updated if there's an issue. If no file is open then FR_INVALID_OBJECT is 
+ *          returned. 
+ * 
+ * @return FRESULT : FATFS file function return code 
+ */
+FRESULT sd_sync(void); 
+
+
 /**
  * @brief Delete a file 
  * 
  * @details Attempt to delete the specified file in the path. The status of the operation 
- *          is returned. 
+ *          is returned. The clusters of the file are added back to the free space 
+ *          estimate. An open file can't be deleted (FR_LOCKED). 
  * 
  * @param filename : name of file 
  * @return FRESULT : status of the delete operation 
  */
 FRESULT sd_unlink(const TCHAR* filename); 
 
+
+/**
+ * @brief Buffered write to the open file 
+ * 
+ * @details Copies data into the controller write buffer instead of writing it to the 
+ *          file right away. Data is written to the file with f_write once enough has 
+ *          been buffered to end the write on a sector boundary of the file. After the 
+ *          first write the file position is sector aligned so every following write is 
+ *          exactly SD_BUFF_SECTORS whole sectors. Whole, aligned sectors are written 
+ *          straight to the volume by FatFs which avoids its partial sector read/modify/ 
+ *          write handling and keeps the time of each write predictable. 
+ * 
+ *          Buffered data is written to the file when sd_buff_flush or sd_close is 
+ *          called, and before any unbuffered write, seek or read so the file contents 
+ *          stay in order. Buffered data is lost if power is lost before it's written. 
+ * 
+ *          The fault code is updated if a write to the file fails. If no file is open or 
+ *          buff is NULL then no data is buffered and FR_INVALID_OBJECT is returned. 
+ * 
+ * @see sd_buff_flush 
+ * 
+ * @param buff : void pointer to data to write 
+ * @param btw : number of bytes to write 
+ * @return FRESULT : FATFS file function return code 
+ */
+FRESULT sd_buff_write(
+    const void *buff, 
+    UINT btw); 
+
+
+/**
+ * @brief Buffered write of a string to the open file 
+ * 
+ * @details Same as sd_buff_write but for a null terminated string. The null character 
+ *          is not written. This is the buffered equivalent of sd_puts. 
+ * 
+ * @see sd_buff_write 
+ * 
+ * @param str : pointer to string to write 
+ * @return int16_t : number of characters written or buffered, negative on failure 
+ */
+int16_t sd_buff_puts(const TCHAR *str); 
+
+
+/**
+ * @brief Flush the write buffer 
+ * 
+ * @details Writes any data in the controller write buffer to the open file. This is 
+ *          called by sd_close so it only needs to be called directly if buffered data 
+ *          needs to be written before the file is closed. 
+ * 
+ * @return FRESULT : FATFS file function return code 
+ */
+FRESULT sd_buff_flush(void); 
+
+
+/**
+ * @brief Read the free space from the volume 
+ * 
+ * @details The free space is read from the volume (f_getfree) when it's mounted and 
+ *          after that it's an estimate kept from the size of the files closed, emptied and 
+ *          deleted plus the clusters taken by new directories and directories that grow 
+ *          when a file is made. f_getfree can scan the whole FAT when the volume FSINFO 
+ *          isn't valid so it's kept out of file opens and closes, and it's only read again 
+ *          when the estimate drops below SD_FREE_THRESH. This reads the free space from 
+ *          the volume on request to correct the estimate. The free space is checked 
+ *          against SD_FREE_THRESH and the fault code is updated if it's low or the volume 
+ *          can't be read. 
+ * 
+ * @return FRESULT : FATFS file function return code 
+ */
+FRESULT sd_refresh_free(void); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// File handle functions 
+
+/**
+ * @brief Open a file in a free file handle 
+ * 
+ * @details Wrapper function for the FATFS function f_open. 
+ * 
+ *          Opens a file in the project directory (see sd_open) in the first free handle 
+ *          of the file handle pool so several files can be open at once. Up to 
+ *          SD_NUM_FILES - 1 files can be opened this way. The default file handle is kept 
+ *          for sd_open and the single file functions. The fault code is updated if there 
+ *          is an error opening the file. The handle is used with the other file handle 
+ *          functions and is given back with sd_file_close. 
+ * 
+ *          A file can be open in more than one handle for reading but FatFs file 
+ *          locking (FF_FS_LOCK) stops it from being opened again when either open 
+ *          writes to it. 
+ * 
+ * @param file_name : name of the file to open 
+ * @param mode : mode to open the file in (read, write, etc.) 
+ * @param handle : file handle of the open file, SD_HANDLE_NONE if it wasn't opened 
+ * @return FRESULT : FATFS file function return code, FR_TOO_MANY_OPEN_FILES if there 
+ *                   are no free handles, FR_LOCKED if the file is already open and 
+ *                   either open writes to it 
+ */
+FRESULT sd_file_open(
+    const TCHAR *file_name, 
+    uint8_t mode, 
+    SD_HANDLE *handle); 
+
+
+/**
+ * @brief Close a file handle 
+ * 
+ * @details Wrapper function for the FATFS function f_close. 
+ * 
+ *          Closes the file and frees its handle. The free space estimate is updated from 
+ *          the change in the file size, or the fault code is updated if there's an issue 
+ *          closing the file. Buffered data of the default file is written first. Nothing 
+ *          happens if the handle isn't open. 
+ * 
+ * @param handle : file handle 
+ * @return FRESULT : FATFS file function return code 
+ */
+FRESULT sd_file_close(SD_HANDLE handle); 
+
+
+/**
+ * @brief Write data to a file handle 
+ * 
+ * @details Wrapper function for the FATFS function f_write. Writes are not buffered. The 
+ *          fault code is updated if there's a write issue. 
+ * 
+ * @param handle : file handle 
+ * @param buff : void pointer to data to write 
+ * @param btw : number of bytes to write 
+ * @return FRESULT : FATFS file function return code, FR_INVALID_OBJECT if the handle 
+ *                   isn't open 
+ */
+FRESULT sd_file_write(
+    SD_HANDLE handle, 
+    const void *buff, 
+    UINT btw); 
+
+
+/**
+ * @brief Read data from a file handle 
+ * 
+ * @details Wrapper function for the FATFS function f_read. The read starts at the 
+ *          read/write pointer of the file (see sd_file_lseek). The fault code is updated 
+ *          if there's a read issue. 
+ * 
+ * @param handle : file handle 
+ * @param buff : void pointer to buffer to store read data 
+ * @param btr : number of bytes to read 
+ * @return FRESULT : FATFS file function return code, FR_INVALID_OBJECT if the handle 
+ *                   isn't open 
+ */
+FRESULT sd_file_read(
+    SD_HANDLE handle, 
+    void *buff, 
+    UINT btr); 
+
+
+/**
+ * @brief Move the read/write pointer of a file handle 
+ * 
+ * @details Wrapper function for the FATFS function f_lseek. Same as sd_lseek for the 
+ *          file of the handle. The fault code is updated if there's a seek issue. 
+ * 
+ * @see sd_lseek 
+ * 
+ * @param handle : file handle 
+ * @param offset : byte position in the file to point to 
+ * @return FRESULT : FATFS file function return code, FR_INVALID_OBJECT if the handle 
+ *                   isn't open 
+ */
+FRESULT sd_file_lseek(
+    SD_HANDLE handle, 
+    FSIZE_t offset); 
+
 //=======================================================================================
 
 
@@ -470,7 +749,7 @@ SD_FAULT_MODE sd_get_fault_mode(void);
 /**
  * @brief Get open file flag 
  * 
- * @details Returns the open file flag state. 
+ * @details Returns the open file flag state of the default file (sd_open). 
  * 
  * @return SD_FILE_STATUS : open file flag state 
  */
@@ -519,7 +798,8 @@ FRESULT sd_f_read(
  * @details Wrapper function for the FATFS function f_gets. 
  *          
  *          Attempts to read a string from an open file then updates the fault code if 
- *          it's unsuccessful. If no file is open then nothing will happen. A string 
+ *          it's unsuccessful. If no file is open or buff is NULL then nothing will happen 
+ *          and a NULL pointer is returned. A string 
  *          will be read until an end of line character is seen ('\n'), the end of the 
  *          file is reached or the string length has been reached. The read string is 
  *          terminated with '\0'. If the read is unsuccessful then a NULL pointer is 
@@ -0,0 +1,219 @@
+/**
+ * @file sd_spi.h
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief SD card SPI disk I/O interface 
+ * 
+ * @details FatFs disk I/O (disk_initialize, disk_read, etc.) for an SD card in SPI mode. 
+ *          The card is initialized with a slow SPI clock (<= 400kHz) and the clock is 
+ *          raised once the card is ready. Data blocks are moved by DMA (SPI TX and RX 
+ *          streams) while commands, tokens and responses are sent a byte at a time. 
+ * 
+ *          Writes of more than one sector use a multi-block write (CMD25) after a 
+ *          pre-erase hint (ACMD23) with the sector count. The multi-block write is left 
+ *          open after the call. If the next write starts at the sector after the last 
+ *          one it's added to the open write without another command. Any other command 
+ *          (read, single sector write, status check) or a sync (CTRL_SYNC) ends it. 
+ *          Sequential file writes (contiguous log files flushed from the SD card 
+ *          controller write buffer) then become one long multi-block write, and the 
+ *          card programs each block while the next one is being prepared. 
+ * 
+ *          The protocol (this module) uses the port functions below for the hardware. 
+ *          sd_spi_port.c has the STM32 SPI, DMA, slave select and timer versions. The 
+ *          host SD card simulator (tools/sd_spi_sim) has its own. 
+ * 
+ *          Only SD cards (v1, v2 and high capacity) are supported, not MMC. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _SD_SPI_H_ 
+#define _SD_SPI_H_ 
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=======================================================================================
+// Includes 
+
+#include "dma_driver.h"
+#include "gpio_driver.h"
+#include "diskio.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+// SPI clock (baud rate control) for a 42MHz APB1 clock 
+#define SD_SPI_BR_SLOW 6                 // 42MHz / 128 = 328kHz - card init (<= 400kHz) 
+#define SD_SPI_BR_FAST 0                 // 42MHz / 2 = 21MHz - after init (<= 25MHz) 
+
+// Timeouts (us) 
+#define SD_SPI_INIT_TIMEOUT 1000000      // Card leaving the idle state (ACMD41) 
+#define SD_SPI_TOKEN_TIMEOUT 200000      // Read data token 
+#define SD_SPI_BUSY_TIMEOUT 500000       // Card busy programming a block 
+
+#define SD_SPI_BLOCK_SIZE 512            // Data block size (bytes) 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Enums 
+
+// SPI clock speed 
+typedef enum {
+    SD_SPI_SLOW,               // Card init 
+    SD_SPI_FAST                // Data transfers 
+} sd_spi_speed_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// Transfer counts 
+typedef struct sd_spi_stats_s
+{
+    uint32_t cmds;                              // Commands sent (ACMD counts as 2) 
+    uint32_t write_cmds;                        // Single and multi-block write commands 
+    uint32_t blocks_written;                    // Blocks written 
+    uint32_t blocks_read;                       // Blocks read 
+    uint32_t errors;                            // Failed transfers 
+}
+sd_spi_stats_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Functions 
+
+/**
+ * @brief SD card SPI disk I/O initialization 
+ * 
+ * @details The SPI port and slave select pin must already be initialized (mode 0, 8-bit 
+ *          data) and the DMA streams set up for SPI RX (peripheral to memory) and SPI TX 
+ *          (memory to peripheral), byte size, no circular mode. The stream memory 
+ *          increment and addresses are set for each transfer. The card isn't accessed 
+ *          until FatFs initializes the disk. 
+ * 
+ * @param spi : SPI port the card is on 
+ * @param gpio : GPIO port of the slave select pin 
+ * @param ss_pin : slave select pin 
+ * @param dma : DMA port of the SPI streams 
+ * @param rx_stream : SPI RX DMA stream 
+ * @param tx_stream : SPI TX DMA stream 
+ * @param timer : free running 32-bit 1us timer used for timeouts 
+ */
+void sd_spi_init(
+    SPI_TypeDef *spi, 
+    GPIO_TypeDef *gpio, 
+    gpio_pin_num_t ss_pin, 
+    DMA_TypeDef *dma, 
+    DMA_Stream_TypeDef *rx_stream, 
+    DMA_Stream_TypeDef *tx_stream, 
+    TIM_TypeDef *timer); 
+
+
+/**
+ * @brief Check if a card is there 
+ * 
+ * @details Initializes the card if it isn't already so a newly inserted card is found. 
+ * 
+ * @return uint8_t : TRUE if the card is initialized 
+ */
+uint8_t sd_spi_present(void); 
+
+
+/**
+ * @brief Check if the card still responds 
+ * 
+ * @details Sends a status request (CMD13). If the card doesn't respond it has to be 
+ *          initialized again. An open multi-block write is ended first. 
+ * 
+ * @return uint8_t : TRUE if the card responds 
+ */
+uint8_t sd_spi_ready(void); 
+
+
+/**
+ * @brief Get the transfer counts 
+ * 
+ * @return const sd_spi_stats_t* : transfer counts 
+ */
+const sd_spi_stats_t *sd_spi_get_stats(void); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Port functions 
+
+/**
+ * @brief Select the card (slave select low) 
+ */
+void sd_spi_port_select(void); 
+
+
+/**
+ * @brief Deselect the card (slave select high) 
+ */
+void sd_spi_port_deselect(void); 
+
+
+/**
+ * @brief Send a byte and return the byte received at the same time 
+ * 
+ * @param data : byte to send 
+ * @return uint8_t : byte received 
+ */
+uint8_t sd_spi_port_xchg(uint8_t data); 
+
+
+/**
+ * @brief Send and receive a block of data (DMA) 
+ * 
+ * @details Returns once the whole block is clocked. 
+ * 
+ * @param tx : data to send, NULL to send 0xFF 
+ * @param rx : buffer for the data received, NULL to drop it 
+ * @param len : number of bytes 
+ */
+void sd_spi_port_block(
+    const uint8_t *tx, 
+    uint8_t *rx, 
+    uint16_t len); 
+
+
+/**
+ * @brief Set the SPI clock speed 
+ * 
+ * @param speed : clock speed - sd_spi_speed_t 
+ */
+void sd_spi_port_speed(uint8_t speed); 
+
+
+/**
+ * @brief Get the time 
+ * 
+ * @return uint32_t : free running time (us) 
+ */
+uint32_t sd_spi_port_time(void); 
+
+//=======================================================================================
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif   // _SD_SPI_H_ 
@@ -33,9 +33,17 @@ const char m8q_config_msgs[M8Q_CONFIG_MSG_NUM][M8Q_CONFIG_MSG_MAX_LEN] =
     "$PUBX,40,RMC,0,0,0,0,0,0*",    // RMC disable
     "$PUBX,40,VTG,0,0,0,0,0,0*",    // VTG disable 
 
-    // UBX config messages 
+    // UBX config messages - the settings are saved so the messages not used are 
+    // disabled in case the device was set up for the other output before. 
+#if M8Q_UBX_NAV_PVT
+    "B562,06,01,0800,F1,00,00,00,00,00,00,00*",      // POSITION disable 
+    "B562,06,01,0800,F1,04,00,00,00,00,00,00*",      // TIME disable 
+    "B562,06,01,0800,01,07,01,00,00,00,00,00*",      // NAV-PVT enable 
+#else
     "B562,06,01,0800,F1,00,01,00,00,00,00,00*",      // POSITION enable 
     "B562,06,01,0800,F1,04,0A,00,00,00,00,00*",      // TIME enable 
+    "B562,06,01,0800,01,07,00,00,00,00,00,00*",      // NAV-PVT disable 
+#endif
 
     // Power configuration 
     "B562,06,3B,3000,02,00,00,00,60104201,E8030000,10270000,00000000,"
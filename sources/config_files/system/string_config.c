@@ -34,6 +34,7 @@ mtbdl_fault_dir[] = "faults",
 mtbdl_bike_param_file[] = "bike_params.txt", 
 mtbdl_sys_param_file[] = "sys_params.txt", 
 mtbdl_log_file[] = "log_%u.txt", 
+mtbdl_log_file_bin[] = "log_%u.bin", 
 mtbdl_fault_file[] = "fault.txt"; 
 
 //=======================================================================================
@@ -52,7 +53,7 @@ mtbdl_param_index[] = "File Index: %u\r\n",
 mtbdl_param_accel_rest[] = "IMU Offset: X:%d Y:%d Z:%d\r\n", 
 mtbdl_param_pot_rest[] = "Pot Offset: F:%u S:%u\r\n", 
 mtbdl_param_time[] = "UTC: %s %s\r\n", 
-mtbdl_param_data[] = "Data: T:%ums REV_T:%ums REV_size:%u\r\n", 
+mtbdl_param_data[] = "Data: T:%ums REV_T:%ums REV_size:%u/%u ADC:%ubit\r\n", 
 // Fault information 
 mtbdl_fault_info[] = "Fault code: %u", 
 // Data log information 
@@ -63,7 +64,14 @@ mtbdl_data_log_default[] = "%u, %u, %u, -, -, -, -, -, -, -\r\n",
 mtbdl_data_log_adc[] = "%s%s%s%s%u, %u, %u, -, -, -, -, -, -, -\r\n", 
 mtbdl_data_log_gps[] = "%s%s%s%s%u, %u, %u, -, -, -, -, %s, %s%c, %s%c\r\n", 
 mtbdl_data_log_accel[] = "%s%s%s%s%u, %u, %u, -, %d, %d, %d, -, -, -\r\n", 
-mtbdl_data_log_speed[] = "%s%s%s%s%u, %u, %u, %u, -, -, -, -, -, -\r\n"; 
+mtbdl_data_log_speed[] = "%s%s%s%s%u, %u, %u, %u/%u, -, -, -, -, -, -\r\n", 
+mtbdl_data_log_rev_period[] = "%s%s%s%s%u, %u, %u, %u, -, -, -, -, -, -\r\n", 
+// Data log line pieces used to build the lines above without snprintf (see log_format) 
+mtbdl_data_log_sep[] = ", ", 
+mtbdl_data_log_blank[] = ", -, -, -, -, -, -, -\r\n", 
+// Execution time profiling footer - bins are the upper limit of each bin in us 
+mtbdl_prof_start[] = "Exec time (us): name, count, max, <1, <2, <4, <8, <16, <32, <64, "
+                     "<128, <256, <512, <1024, <2048, <4096, <8192, <16384, 16384+\r\n"; 
 
 //=======================================================================================
 
@@ -19,6 +19,8 @@
 #include "stm32f4xx_hal.h" 
 
 #include "data_logging.h" 
+#include "m8q_controller.h" 
+#include "i2c_bus.h" 
 
 //=======================================================================================
 
@@ -170,6 +172,10 @@ void EXTI9_5_IRQHandler(void)
 void EXTI15_10_IRQHandler(void)
 {
     handler_flags.exti10_15_flag = SET_BIT; 
+
+    // Line 11 is the M8Q TX ready pin. The GPS controller reads the device later. 
+    m8q_txr_handler(); 
+
     exti_pr_clear(EXTI_L10 | EXTI_L11 | EXTI_L12 | EXTI_L13 | EXTI_L14 | EXTI_L15); 
 }
 
@@ -178,6 +184,10 @@ void EXTI15_10_IRQHandler(void)
 void DMA1_Stream0_IRQHandler(void)
 {
     handler_flags.dma1_0_flag = SET_BIT; 
+
+    // I2C1 RX stream - an I2C bus read is done 
+    i2c_bus_dma_handler(); 
+
     dma_clear_int_flags(DMA1); 
 }
 
@@ -242,6 +252,10 @@ void DMA1_Stream7_IRQHandler(void)
 void DMA2_Stream0_IRQHandler(void)
 {
     handler_flags.dma2_0_flag = SET_BIT; 
+
+    // An ADC DMA buffer is full so the samples can be handed off to data logging. 
+    log_data_adc_handler(); 
+
     dma_clear_int_flags(DMA2); 
 }
 
@@ -324,10 +338,6 @@ void TIM1_UP_TIM10_IRQHandler(void)
 void TIM1_TRG_COM_TIM11_IRQHandler(void)
 {
     handler_flags.tim1_trg_tim11_glbl_flag = SET_BIT; 
-
-    // Start the ADC conversion so new data is available for each data logging interval. 
-    log_data_adc_handler(); 
-
     tim_uif_clear(TIM1); 
     tim_uif_clear(TIM11); 
 }
@@ -406,4 +416,20 @@ void USART6_IRQHandler(void)
     dummy_read(USART6->DR); 
 }
 
+
+// I2C1 event 
+void I2C1_EV_IRQHandler(void)
+{
+    handler_flags.i2c1_ev_flag = SET_BIT; 
+    i2c_bus_ev_handler(); 
+}
+
+
+// I2C1 error 
+void I2C1_ER_IRQHandler(void)
+{
+    handler_flags.i2c1_er_flag = SET_BIT; 
+    i2c_bus_er_handler(); 
+}
+
 //=======================================================================================
@@ -31,8 +31,11 @@
 // Data logging 
 #define LOG_MAX_FILES 250               // Max data log file number 
 
-// Timing 
-#define LOG_ADC_DMA_WAIT 1000           // Number of times to wait on ADC DMA to complete 
+// ADC oversampling 
+#define LOG_ADC_OSR_ROUND ((1 << LOG_ADC_OSR_BITS) >> 1)   // Half an LSB of the sum shift 
+
+// Wheel speed - the revolution window sizes are written as 0 when the period is logged 
+#define LOG_REV_WINDOW(window) (LOG_SPEED_CAPTURE ? 0 : (window)) 
 
 //=======================================================================================
 
@@ -40,13 +43,14 @@
 //=======================================================================================
 // Enums 
 
-// Logging streams 
+// Logging streams - the order comes from the log stream schedule (log_schedule.h) and 
+// must match the log stream entries of log_prof_id_t. 
 typedef enum {
-    LOG_STREAM_STANDARD,   // Standard stream 
-    LOG_STREAM_GPS,        // GPS stream 
-    LOG_STREAM_ACCEL,      // Accelerometer stream 
-    LOG_STREAM_SPEED,      // Wheel speed stream 
-    LOG_STREAM_NUM         // Number of logging streams 
+    LOG_STREAM_STANDARD = LOG_SCHED_STANDARD,   // Standard stream 
+    LOG_STREAM_GPS = LOG_SCHED_GPS,             // GPS stream 
+    LOG_STREAM_ACCEL = LOG_SCHED_ACCEL,         // Accelerometer stream 
+    LOG_STREAM_SPEED = LOG_SCHED_SPEED,         // Wheel speed stream 
+    LOG_STREAM_NUM = LOG_SCHED_NUM              // Number of logging streams 
 } log_stream_t; 
 
 //=======================================================================================
@@ -58,15 +62,6 @@ typedef enum {
 // Data record instance 
 static mtbdl_log_t mtbdl_log; 
 
-// Logging schedule data 
-typedef struct log_stream_schedule_s 
-{
-    log_stream_t stream; 
-    uint8_t offset; 
-    uint8_t counter_period; 
-}
-log_stream_schedule_t; 
-
 //=======================================================================================
 
 
@@ -85,14 +80,15 @@ typedef void (*mtbdl_log_stream)(void);
  * @details When data logging, trail markers and ADC values get recorded every sampling 
  *          interval, whereas GPS, IMU and wheel speed data gets recorded at a divided 
  *          rate. This stream is used for recording only trail markers and ADC data, i.e. 
- *          when no other data was scheduled to record in the interval. The 
- *          "stream_table" is used to determine when other sets of data should be 
+ *          when no other stream runs in the log stream slot. The log stream schedule 
+ *          (log_schedule.h) is used to determine when other sets of data should be 
  *          recorded. 
  *          
- *          Note that data is recorded every 10ms but data is only written to the SD card 
- *          every 50ms. This means each SD card write contains 5 sets of data. If this 
- *          function is called it means there was no other scheduled data for the 50ms 
- *          interval. 
+ *          Note that data is recorded every LOG_PERIOD but data is only written to the SD 
+ *          card every LOG_STREAM_PERIOD (50ms). This means each SD card write contains 
+ *          LOG_PERIOD_DIVIDER sets of data (5 at the default sample rate). If this 
+ *          function is called it means there was no other scheduled data for the 
+ *          LOG_STREAM_PERIOD interval. 
  */
 void log_stream_standard(void); 
 
@@ -102,14 +98,22 @@ void log_stream_standard(void);
  * 
  * @details This function is used during data logging and it records all the same data 
  *          as the standard logging stream but with the added addition of GPS position 
- *          and ground speed. The GPS module will be read and the new values recorded 
- *          when this is called. The "stream_table" is used to determine when other sets 
- *          of data should be recorded. 
+ *          and ground speed. The last fix published by the GPS controller is recorded 
+ *          when this is called. The device is read between log stream slots when its TX 
+ *          ready interrupt shows new data (see log_data) so this stream doesn't use the 
+ *          I2C bus. The "stream_table" is used to determine when other sets of data 
+ *          should be recorded. 
  *          
- *          Note that data is recorded every 10ms but data is only written to the SD card 
- *          every 50ms. This means each SD card write contains 5 sets of data. If this 
- *          function is called it means 4 sets of "standard" data were recorded and one 
- *          set that also includes the GPS data. 
+ *          Note that data is recorded every LOG_PERIOD but data is only written to the SD 
+ *          card every LOG_STREAM_PERIOD (50ms). This means each SD card write contains 
+ *          LOG_PERIOD_DIVIDER sets of data (5 at the default sample rate). If this 
+ *          function is called it means one set also includes the GPS data and the 
+ *          others are "standard" data. Other streams of the same slot can add their 
+ *          data to that set too. 
+ * 
+ *          When M8Q_UBX_NAV_PVT is set the GPS data comes from the last UBX NAV-PVT 
+ *          message as integers. Binary logs get a GPS NAV-PVT record in place of the GPS 
+ *          record and text logs show the same fields as before. 
  * 
  * @see log_stream_standard 
  */
@@ -125,10 +129,12 @@ void log_stream_gps(void);
  *          recorded when this is called. The "stream_table" is used to determine when 
  *          other sets of data should be recorded. 
  *          
- *          Note that data is recorded every 10ms but data is only written to the SD card 
- *          every 50ms. This means each SD card write contains 5 sets of data. If this 
- *          function is called it means 4 sets of "standard" data were recorded and one 
- *          set that also includes the IMU data. 
+ *          Note that data is recorded every LOG_PERIOD but data is only written to the SD 
+ *          card every LOG_STREAM_PERIOD (50ms). This means each SD card write contains 
+ *          LOG_PERIOD_DIVIDER sets of data (5 at the default sample rate). If this 
+ *          function is called it means one set also includes the IMU data and the 
+ *          others are "standard" data. Other streams of the same slot can add their 
+ *          data to that set too. 
  * 
  * @see log_stream_standard 
  */
@@ -142,28 +148,213 @@ void log_stream_accel(void);
  *          as the standard logging stream but with the added addition of wheel 
  *          revolution data. Wheel revolutions are recorded through the use of a Hall 
  *          effect sensor and an external interrupt. The number of revolutions counted 
- *          in an interval is recorded in a circular buffer so the X most recent 
- *          intervals can be looked at. Wheel speed/RPM calculations are left for post 
- *          processing because the revolution count and the interval time are known so 
- *          there is no need to spend time doing that here. The "stream_table" is used 
- *          to determine when other sets of data should be recorded. 
+ *          in an interval is recorded in a circular buffer and the revolutions of the 
+ *          most recent intervals are logged for a short and a long window. Wheel 
+ *          speed/RPM calculations are left for post processing because the revolution 
+ *          count and the interval time are known so there is no need to spend time doing 
+ *          that here. The "stream_table" is used to determine when other sets of data 
+ *          should be recorded. 
+ *          
+ *          When LOG_SPEED_CAPTURE is set the revolutions are timestamped with timer input 
+ *          capture instead and the period (us) of the latest revolution is recorded in 
+ *          place of the revolution count. 
  *          
- *          Note that data is recorded every 10ms but data is only written to the SD card 
- *          every 50ms. This means each SD card write contains 5 sets of data. If this 
- *          function is called it means 4 sets of "standard" data were recorded and one 
- *          set that also includes the wheel speed data. 
+ *          Note that data is recorded every LOG_PERIOD but data is only written to the SD 
+ *          card every LOG_STREAM_PERIOD (50ms). This means each SD card write contains 
+ *          LOG_PERIOD_DIVIDER sets of data (5 at the default sample rate). If this 
+ *          function is called it means one set also includes the wheel speed data and the 
+ *          others are "standard" data. Other streams of the same slot can add their 
+ *          data to that set too. 
  * 
  * @see log_stream_standard 
  */
 void log_stream_speed(void); 
 
+
+/**
+ * @brief Append a binary record to the log string 
+ * 
+ * @details Copies a record to the end of the records already in the log string when in 
+ *          binary mode. The record is dropped if there's no room for it, which can only 
+ *          happen if the log string is not written to the SD card each logging period. 
+ * 
+ * @param record : record to append 
+ * @param size : record size (bytes) 
+ */
+void log_record_append(
+    const void *record, 
+    uint16_t size); 
+
+
+/**
+ * @brief Append the interval records to the log string 
+ * 
+ * @details Appends a trail marker record (if the trail marker is set) followed by the ADC 
+ *          record for the current interval. This is the binary mode equivalent of the 
+ *          standard portion of each text log line. In packed mode the interval is added 
+ *          to the ADC block instead and the block record is appended on the last interval 
+ *          of the log stream period. The last interval of the log stream period starts 
+ *          with a time record that holds the time of its ADC sample. 
+ * 
+ * @see log_record_append 
+ */
+void log_record_interval(void); 
+
+
+/**
+ * @brief Start a text log line 
+ * 
+ * @details Writes the trail marker and ADC data of the current interval to the end of the 
+ *          log string in text mode. The rest of the line is written using the log_format 
+ *          writers starting at the returned pointer and finished with log_line_end. 
+ * 
+ *          Lines are appended to the log string one interval at a time until it's written 
+ *          to the SD card. Only the last line of a logging period can hold stream data 
+ *          and the ADC only lines before it are less than half of MTBDL_MAX_STR_LEN, so a 
+ *          full period of lines always fits in the log string even with the longest line 
+ *          (every stream in one slot, about 1.5x MTBDL_MAX_STR_LEN) at the end. 
+ * 
+ * @see log_line_end 
+ * 
+ * @return char* : where the rest of the line goes 
+ */
+char *log_line_start(void); 
+
+
+/**
+ * @brief End a text log line 
+ * 
+ * @details Writes the last blank fields of the line and the line ending, then updates the 
+ *          length of the log string to include the line. 
+ * 
+ * @see log_line_start 
+ * 
+ * @param line : end of the line written so far 
+ * @param fields : number of blank fields at the end of the line 
+ */
+void log_line_end(
+    char *line, 
+    uint8_t fields); 
+
+
+/**
+ * @brief Start the fields of a stream in the slot text line 
+ * 
+ * @details Writes blank fields from the last stream field written up to 'field' and 
+ *          returns where the stream writes its fields. Streams of a slot share one line 
+ *          so they must write their fields in line order. The stream passes the end of 
+ *          what it wrote back in mtbdl_log.line. 
+ * 
+ * @param field : first field of the stream (after the ADC data) 
+ * @param fields : number of fields the stream writes 
+ * @return char* : where the stream fields go 
+ */
+char *log_line_field(
+    uint8_t field, 
+    uint8_t fields); 
+
+
+/**
+ * @brief Get the ADC block last filled by the DMA 
+ * 
+ * @details The ADC DMA stream runs in double buffer mode. This reads which block the 
+ *          DMA is currently filling and returns the other one, which holds the newest 
+ *          complete set of samples. 
+ * 
+ * @return uint8_t : index of the last filled ADC block 
+ */
+uint8_t log_adc_block_done(void); 
+
+
+/**
+ * @brief Get the revolution timestamp the DMA writes next 
+ * 
+ * @details The revolution capture DMA stream runs in circular mode and counts down the 
+ *          timestamps left before it wraps, so the write position is the buffer size 
+ *          minus that count. 
+ * 
+ * @return uint16_t : index of the next revolution timestamp 
+ */
+uint16_t log_rev_head(void); 
+
+
+/**
+ * @brief Log the IMU FIFO samples 
+ * 
+ * @details Writes every sample from the last IMU FIFO burst read in an IMU record after 
+ *          the log data of the log stream period then posts the next burst read through 
+ *          the IMU controller. The read runs in the background on the I2C bus while the 
+ *          next period of ADC data is logged. Only used for binary and packed logs when 
+ *          LOG_IMU_RATE is set. The record notes when the FIFO filled up since the last 
+ *          read so the gap in the samples can be seen, and the time the read finished so 
+ *          the samples can be placed against the ADC samples. 
+ */
+void log_imu_fifo(void); 
+
+
+/**
+ * @brief Sync the log file if it's due 
+ * 
+ * @details Counts the log stream slot and syncs the log file (sd_sync) once a sync is 
+ *          due by time or by log data written (LOG_SYNC_PERIOD, LOG_SYNC_SECTORS), but 
+ *          only if the streams that ran in the slot leave LOG_SYNC_COST of 
+ *          LOG_SLOT_BUDGET. A sync that doesn't fit waits for the next slot with room so 
+ *          no slot gets more than one sync on top of its streams. Called at the end of 
+ *          each log stream slot once the log data is written. 
+ * 
+ * @param streams : streams that ran in the slot (LOG_SCHED_BIT) 
+ */
+void log_sync(uint8_t streams); 
+
+
+/**
+ * @brief Write a sync record 
+ * 
+ * @details Writes a sync record with the next sync sequence number and the offset of 
+ *          the record in the log data, which is the number of log data bytes written 
+ *          before it. Log data ahead of a sync record read back from the card belongs to 
+ *          the log, so the end of a log that wasn't closed can be found. Text logs have 
+ *          no sync records so the text format stays the same, but the offset is still 
+ *          kept for the sync limits. Called for each sync and once ahead of the end of 
+ *          the log. 
+ */
+void log_sync_record(void); 
+
+
+/**
+ * @brief Decimate the oversampled conversions of a sample set 
+ * 
+ * @details Boxcar (first order CIC) decimator in fixed point. The LOG_ADC_OSR 
+ *          conversions of each channel are summed then scaled down to LOG_ADC_RES_BITS 
+ *          of resolution. Averaging out the conversion noise is what provides the extra 
+ *          bits so there must be at least 1 LSB of noise on the ADC inputs. 
+ * 
+ * @param conv : oversampled conversions of one sample set 
+ * @param sample : buffer to store the decimated sample set 
+ */
+void log_adc_decimate(
+    const uint16_t (*conv)[ADC_BUFF_SIZE], 
+    uint16_t *sample); 
+
+
+/**
+ * @brief Enable the ADC sample interrupt 
+ * 
+ * @details Clears any pending ADC DMA interrupt then enables it so sample sets are queued 
+ *          in the ADC ring starting with the next block the DMA fills. 
+ * 
+ * @see log_data_adc_handler 
+ */
+void log_adc_int_enable(void); 
+
 //=======================================================================================
 
 
 //=======================================================================================
 // Variables 
 
-// Log stream table 
+// Log stream table - indexed by log_stream_t. The streams of a slot run from the end of 
+// the table so their text fields are written in line order (speed, accel, GPS). 
 static mtbdl_log_stream stream_table[LOG_STREAM_NUM] = 
 {
     &log_stream_standard, 
@@ -173,26 +364,25 @@ static mtbdl_log_stream stream_table[LOG_STREAM_NUM] =
 }; 
 
 
-// Log stream schedule 
-// Notes: 
-// - The counter period and starting offsets of each stream are chosen so that no two 
-//   streams will run during the same interval. 
-// - The standard log stream runs when no other stream needs to run so it does not 
-//   require a period or offset. 
-// - This table must order log streams in the same order that they are listed in 
-//   log_stream_t so the index corresponds to the correct function pointer. 
-// - A non-standard stream runs on multiples of 50ms periods. The counter period 
-//   determines the multiple. Counter period * 50ms == period of stream execution. 
-// - LOG_PERIOD * LOG_PERIOD_DIVIDER * LOG_X_PERIOD == X Stream period (time) 
-static const log_stream_schedule_t stream_schedule[LOG_STREAM_NUM] = 
-{
-    // { Log stream,      starting offset,  counter period } 
-    {LOG_STREAM_STANDARD, 0,                0}, 
-    {LOG_STREAM_GPS,      LOG_GPS_OFFSET,   LOG_GPS_PERIOD}, 
-    {LOG_STREAM_ACCEL,    LOG_ACCEL_OFFSET, LOG_ACCEL_PERIOD}, 
-    {LOG_STREAM_SPEED,    LOG_SPEED_OFFSET, LOG_SPEED_PERIOD} 
+// Expected log data rate (bytes/s) of each log mode for log file pre-allocation 
+static const uint32_t log_prealloc_rate[LOG_MODE_NUM] = 
+{
+    LOG_PREALLOC_TEXT_RATE,   // LOG_MODE_TEXT 
+    LOG_PREALLOC_BIN_RATE,    // LOG_MODE_BINARY 
+    LOG_PREALLOC_PACK_RATE    // LOG_MODE_PACKED 
 }; 
 
+#if !LOG_SPEED_CAPTURE
+
+// Wheel revolution window lengths (speed stream periods) in the order they're logged 
+static const uint8_t log_rev_windows[LOG_REV_NUM_WINDOWS] = 
+{
+    LOG_REV_WINDOW_SHORT, 
+    LOG_REV_WINDOW_LONG
+}; 
+
+#endif   // !LOG_SPEED_CAPTURE 
+
 //=======================================================================================
 
 
@@ -213,21 +403,23 @@ void log_init(
     mtbdl_log.adc = adc; 
     mtbdl_log.dma = dma; 
     mtbdl_log.dma_stream = dma_stream; 
+    mtbdl_log.timebase = NULL; 
 
     // Log file info 
+    mtbdl_log.log_mode = LOG_MODE_DEFAULT; 
     memset((void *)mtbdl_log.utc_time, CLEAR, sizeof(mtbdl_log.utc_time)); 
     memset((void *)mtbdl_log.utc_date, CLEAR, sizeof(mtbdl_log.utc_date)); 
 
     // ADC data 
-    memset((void *)mtbdl_log.adc_buff, CLEAR, sizeof(mtbdl_log.adc_buff)); 
-    memset((void *)mtbdl_log.adc_period, CLEAR, sizeof(mtbdl_log.adc_period)); 
+    memset((void *)mtbdl_log.adc_block, CLEAR, sizeof(mtbdl_log.adc_block)); 
+    memset((void *)&mtbdl_log.adc_set, CLEAR, sizeof(mtbdl_log.adc_set)); 
+    log_ring_init(&mtbdl_log.adc_ring, 
+                  (void *)mtbdl_log.adc_ring_buff, 
+                  sizeof(mtbdl_log.adc_ring_buff[0]), 
+                  LOG_ADC_RING_SIZE); 
 
     // GPS data 
-    memset((void *)mtbdl_log.lat_str, CLEAR, sizeof(mtbdl_log.lat_str)); 
-    mtbdl_log.NS = CLEAR; 
-    memset((void *)mtbdl_log.lon_str, CLEAR, sizeof(mtbdl_log.lon_str)); 
-    mtbdl_log.EW = CLEAR; 
-    memset((void *)mtbdl_log.sog_str, CLEAR, sizeof(mtbdl_log.sog_str)); 
+    memset((void *)&mtbdl_log.gps, CLEAR, sizeof(mtbdl_log.gps)); 
 
     // Accelerometer data 
     memset((void *)mtbdl_log.accel, CLEAR, sizeof(mtbdl_log.accel)); 
@@ -236,16 +428,24 @@ void log_init(
     mtbdl_log.rev_count = CLEAR; 
     mtbdl_log.rev_buff_index = CLEAR; 
     memset((void *)mtbdl_log.rev_buff, CLEAR, sizeof(mtbdl_log.rev_buff)); 
+    memset((void *)mtbdl_log.rev_sums, CLEAR, sizeof(mtbdl_log.rev_sums)); 
+    mtbdl_log.rev_timer = NULL; 
+    mtbdl_log.rev_dma_stream = NULL; 
+    memset((void *)mtbdl_log.rev_capture, CLEAR, sizeof(mtbdl_log.rev_capture)); 
+    log_rev_init(&mtbdl_log.rev, mtbdl_log.rev_capture, LOG_REV_CAPTURE_SIZE); 
+
+    // IMU FIFO data 
+    memset((void *)mtbdl_log.imu_buff, CLEAR, sizeof(mtbdl_log.imu_buff)); 
+    memset((void *)mtbdl_log.imu_rec, CLEAR, sizeof(mtbdl_log.imu_rec)); 
+    mtbdl_log.imu_overflow = CLEAR; 
 
     // User input data 
     mtbdl_log.trailmark = CLEAR_BIT; 
 
     // Logging counters 
-    mtbdl_log.log_interval_divider = CLEAR; 
-    mtbdl_log.gps_stream_counter = CLEAR; 
-    mtbdl_log.accel_stream_counter = CLEAR; 
-    mtbdl_log.speed_stream_counter = CLEAR; 
-    mtbdl_log.interrupt_counter = CLEAR; 
+    log_schedule_init(&mtbdl_log.schedule); 
+    mtbdl_log.line = NULL; 
+    mtbdl_log.line_field = CLEAR; 
 
     // Calibration data 
     memset((void *)mtbdl_log.cal_buff, CLEAR, sizeof(mtbdl_log.cal_buff)); 
@@ -253,28 +453,91 @@ void log_init(
     mtbdl_log.cal_accel_samples = CLEAR; 
 
     // SD card data 
-    memset((void*)mtbdl_log.data_buff, CLEAR, sizeof(mtbdl_log.data_buff)); 
     memset((void*)mtbdl_log.data_str, CLEAR, sizeof(mtbdl_log.data_str)); 
+    mtbdl_log.data_len = CLEAR; 
     mtbdl_log.data_buff_index = CLEAR; 
     memset((void *)mtbdl_log.filename, CLEAR, sizeof(mtbdl_log.filename)); 
 
+    // Log file sync 
+    mtbdl_log.log_id = CLEAR; 
+    mtbdl_log.data_bytes = CLEAR; 
+    mtbdl_log.sync_slots = CLEAR; 
+    mtbdl_log.sync_offset = CLEAR; 
+    mtbdl_log.sync_seq = CLEAR; 
+
     // Debugging / log checking 
     mtbdl_log.overrun = CLEAR; 
 
     // Configure the DMA stream. The address of the DMA read and write locations are cast 
     // to integers so the DMA registers can be set. The address is cast to size_t first 
-    // before being cast again to uint32_t to satisfy the unit test compiler. 
+    // before being cast again to uint32_t to satisfy the unit test compiler. In double 
+    // buffer mode the DMA fills one block of oversampled sample sets then swaps to the 
+    // other, so the number of data items is the size of one block. 
     size_t 
     peripheral_addr = (size_t)(&mtbdl_log.adc->DR), 
-    memory0_addr = (size_t)mtbdl_log.adc_buff, 
-    memory1_addr = (size_t)NULL; 
+    memory0_addr = (size_t)mtbdl_log.adc_block[BYTE_0], 
+    memory1_addr = (size_t)mtbdl_log.adc_block[BYTE_1]; 
 
     dma_stream_config(
         mtbdl_log.dma_stream, 
         (uint32_t)peripheral_addr, 
         (uint32_t)memory0_addr, 
         (uint32_t)memory1_addr, 
-        (uint16_t)ADC_BUFF_SIZE); 
+        (uint16_t)(LOG_ADC_BLOCK_SIZE * LOG_ADC_OSR * ADC_BUFF_SIZE)); 
+
+    // Interrupt each time a block is full so it can be handed off 
+    dma_int_config(
+        mtbdl_log.dma_stream, 
+        DMA_TCIE_ENABLE, 
+        DMA_HTIE_DISABLE, 
+        DMA_TEIE_DISABLE, 
+        DMA_DMEIE_DISABLE); 
+}
+
+
+// Initialize the timebase 
+void log_timebase_init(TIM_TypeDef *timer)
+{
+    mtbdl_log.timebase = timer; 
+}
+
+
+// Initialize wheel revolution input capture 
+void log_rev_capture_init(
+    TIM_TypeDef *timer, 
+    DMA_Stream_TypeDef *dma_stream)
+{
+    mtbdl_log.rev_timer = timer; 
+    mtbdl_log.rev_dma_stream = dma_stream; 
+
+    // Each capture is copied from CCR1 to the next timestamp in the buffer and the 
+    // stream wraps back to the start when the buffer is full. No interrupts are used 
+    // because the speed stream reads the DMA write position. 
+    size_t 
+    peripheral_addr = (size_t)(&timer->CCR1), 
+    memory0_addr = (size_t)mtbdl_log.rev_capture; 
+
+    dma_stream_config(
+        dma_stream, 
+        (uint32_t)peripheral_addr, 
+        (uint32_t)memory0_addr, 
+        CLEAR,                   // No second buffer (circular mode) 
+        (uint16_t)LOG_REV_CAPTURE_SIZE); 
+}
+
+
+// Initialize the IMU FIFO 
+void log_imu_fifo_init(
+    I2C_TypeDef *i2c, 
+    mpu6050_i2c_addr_t addr)
+{
+    mpu6050_fifo_init(
+        DEVICE_ONE, 
+        i2c, 
+        addr, 
+        (uint8_t)LOG_IMU_RATE_DIV, 
+        mtbdl_log.imu_buff, 
+        (uint16_t)LOG_IMU_BUFF_SIZE); 
 }
 
 //=======================================================================================
@@ -295,10 +558,11 @@ uint8_t log_data_name_prep(void)
         return FALSE; 
     }
 
-    // Number of log files is within the limit - generate a new log file name 
+    // Number of log files is within the limit - generate a new log file name. Binary 
+    // and packed logs get their own extension so they're not mistaken for text logs. 
     snprintf(mtbdl_log.filename, 
              MTBDL_MAX_STR_LEN, 
-             mtbdl_log_file, 
+             (mtbdl_log.log_mode != LOG_MODE_TEXT) ? mtbdl_log_file_bin : mtbdl_log_file, 
              log_index); 
 
     return TRUE; 
@@ -326,14 +590,44 @@ void log_data_file_prep(void)
         // this system), a line is written to indicate the start of the data logging 
         // information. The data log index is then incremented which allows the code to keep 
         // track of the number of log files that have been created. 
+
+        // Pre-allocate a contiguous region for the log sized from the expected ride 
+        // length. This must be done while the file is still empty. Logging then writes 
+        // linearly into clusters that are already allocated instead of searching for and 
+        // linking new ones as the file grows, and the file is truncated to the logged data 
+        // when logging ends. If there isn't enough contiguous space then the file just 
+        // grows normally. 
+        sd_expand((FSIZE_t)LOG_PREALLOC_TIME * log_prealloc_rate[mtbdl_log.log_mode]); 
         
         // Bike and system parameters 
         param_bike_format_write(); 
         param_sys_format_write(); 
 
         // UTC time stamp 
-        m8q_get_time_utc_time(mtbdl_log.utc_time, LOG_TIME_BUFF_LEN); 
-        m8q_get_time_utc_date(mtbdl_log.utc_date, LOG_TIME_BUFF_LEN); 
+        m8q_get_fix(&mtbdl_log.gps); 
+
+#if M8Q_UBX_NAV_PVT
+        // NAV-PVT gives the UTC date and time as numbers so they're written in the same 
+        // hhmmss.ss and ddmmyy form as the PUBX TIME message. 
+        const m8q_ubx_nav_pvt_t *pvt = &mtbdl_log.gps.pvt; 
+        char *utc = (char *)mtbdl_log.utc_time; 
+
+        utc = log_format_u32_pad(utc, pvt->hour, 2); 
+        utc = log_format_u32_pad(utc, pvt->min, 2); 
+        utc = log_format_u32_pad(utc, pvt->sec, 2); 
+        utc = log_format_char(utc, '.'); 
+        log_format_u32_pad(utc, (pvt->nano > 0) ? ((uint32_t)pvt->nano / 10000000) : 0, 2); 
+
+        utc = (char *)mtbdl_log.utc_date; 
+        utc = log_format_u32_pad(utc, pvt->day, 2); 
+        utc = log_format_u32_pad(utc, pvt->month, 2); 
+        log_format_u32_pad(utc, pvt->year % 100, 2); 
+#else
+        memcpy((void *)mtbdl_log.utc_time, (void *)mtbdl_log.gps.utc_time, 
+               sizeof(mtbdl_log.utc_time)); 
+        memcpy((void *)mtbdl_log.utc_date, (void *)mtbdl_log.gps.utc_date, 
+               sizeof(mtbdl_log.utc_date)); 
+#endif
         snprintf(mtbdl_log.data_str, 
                  MTBDL_MAX_STR_LEN, 
                  mtbdl_param_time, 
@@ -342,17 +636,46 @@ void log_data_file_prep(void)
         sd_puts(mtbdl_log.data_str); 
 
         // Logging info 
-        uint16_t rev_period = LOG_PERIOD * LOG_PERIOD_DIVIDER * 
-                              stream_schedule[LOG_STREAM_SPEED].counter_period; 
+        uint16_t rev_period = LOG_PERIOD * LOG_PERIOD_DIVIDER * LOG_SPEED_PERIOD; 
         snprintf(mtbdl_log.data_str, 
                  MTBDL_MAX_STR_LEN, 
                  mtbdl_param_data, 
                  LOG_PERIOD, 
                  rev_period, 
-                 LOG_REV_SAMPLE_SIZE); 
+                 LOG_REV_WINDOW(LOG_REV_WINDOW_SHORT), 
+                 LOG_REV_WINDOW(LOG_REV_WINDOW_LONG), 
+                 LOG_ADC_RES_BITS); 
         sd_puts(mtbdl_log.data_str); 
         
         sd_puts(mtbdl_data_log_start); 
+
+        // The log id ties the sync records to this log. The timebase count when the file 
+        // is made is different for each log. Without a timebase the last id is counted 
+        // up instead. 
+        mtbdl_log.log_id = (mtbdl_log.timebase != NULL) ? 
+                           mtbdl_log.timebase->CNT : (mtbdl_log.log_id + 1); 
+
+        // Binary and packed logs follow the text header with a header record that 
+        // describes the record format and the logging info needed to decode the records. 
+        if (mtbdl_log.log_mode != LOG_MODE_TEXT)
+        {
+            log_rec_header_t header = 
+            {
+                .tag = LOG_REC_HEADER, 
+                .version = LOG_REC_VERSION, 
+                .log_period = LOG_PERIOD, 
+                .period_divider = LOG_PERIOD_DIVIDER, 
+                .rev_period = rev_period, 
+                .rev_windows = { LOG_REV_WINDOW(LOG_REV_WINDOW_SHORT), 
+                                 LOG_REV_WINDOW(LOG_REV_WINDOW_LONG) }, 
+                .adc_res = LOG_ADC_RES_BITS, 
+                .imu_rate = LOG_IMU_RATE, 
+                .id = mtbdl_log.log_id 
+            }; 
+            memcpy((void *)header.magic, (void *)LOG_REC_MAGIC, LOG_REC_MAGIC_LEN); 
+
+            sd_f_write((void *)&header, sizeof(header)); 
+        }
     }
 }
 
@@ -366,34 +689,56 @@ void log_data_prep(void)
     // logging so their data is up to date. 
 
     // ADC data 
-    memset((void *)mtbdl_log.adc_period, CLEAR, sizeof(mtbdl_log.adc_period)); 
+    memset((void *)&mtbdl_log.adc_set, CLEAR, sizeof(mtbdl_log.adc_set)); 
+    log_ring_reset(&mtbdl_log.adc_ring); 
+    log_pack_init(&mtbdl_log.adc_pack, LOG_PACK_KEY_PERIOD); 
     
     // Wheel RPM info 
     mtbdl_log.rev_count = CLEAR; 
     mtbdl_log.rev_buff_index = CLEAR; 
     memset((void *)mtbdl_log.rev_buff, CLEAR, sizeof(mtbdl_log.rev_buff)); 
+    memset((void *)mtbdl_log.rev_sums, CLEAR, sizeof(mtbdl_log.rev_sums)); 
 
     // User input data 
     mtbdl_log.trailmark = CLEAR_BIT; 
 
     // Logging counters 
-    mtbdl_log.log_interval_divider = CLEAR; 
-    mtbdl_log.gps_stream_counter = stream_schedule[LOG_STREAM_GPS].offset; 
-    mtbdl_log.accel_stream_counter = stream_schedule[LOG_STREAM_ACCEL].offset; 
-    mtbdl_log.speed_stream_counter = stream_schedule[LOG_STREAM_SPEED].offset; 
-    mtbdl_log.interrupt_counter = CLEAR; 
+    log_schedule_init(&mtbdl_log.schedule); 
 
     // SD card data 
-    memset((void*)mtbdl_log.data_buff, CLEAR, sizeof(mtbdl_log.data_buff)); 
     memset((void*)mtbdl_log.data_str, CLEAR, sizeof(mtbdl_log.data_str)); 
+    mtbdl_log.data_len = CLEAR; 
     mtbdl_log.data_buff_index = CLEAR; 
 
+    // Log file sync. The first sync is due right away so the directory entry of the log 
+    // file (pre-allocated clusters and the header) is on the card from the start of the 
+    // log, and a log cut short later on still has that much. 
+    mtbdl_log.data_bytes = CLEAR; 
+    mtbdl_log.sync_slots = LOG_SYNC_SLOTS; 
+    mtbdl_log.sync_offset = CLEAR; 
+    mtbdl_log.sync_seq = CLEAR; 
+
     // Debugging / log checking 
     mtbdl_log.overrun = CLEAR; 
+#if LOG_PROF_ENABLE
+    log_prof_reset(); 
+#endif
 
-    // Enable interrupts 
+    // IMU samples from before the log are thrown away 
+#if LOG_IMU_RATE
+    mpu6050_set_fifo_reset_flag(DEVICE_ONE); 
+    mpu6050_controller(DEVICE_ONE); 
+    mtbdl_log.imu_overflow = mpu6050_get_fifo_overflow(DEVICE_ONE); 
+#endif
+
+    // Enable interrupts. Input capture doesn't use an interrupt but edges from before 
+    // the log are skipped. 
+#if LOG_SPEED_CAPTURE
+    log_rev_reset(&mtbdl_log.rev, log_rev_head()); 
+#else
     NVIC_EnableIRQ(mtbdl_log.rpm_irq);   // Wheel speed 
-    NVIC_EnableIRQ(mtbdl_log.log_irq);   // Log sample period 
+#endif
+    log_adc_int_enable();                // ADC samples 
 }
 
 
@@ -416,86 +761,116 @@ void log_data(void)
         mtbdl_log.rev_count++; 
     }
     
-    // 'interrupt_counter' gets incremented in the perodic interrupt callback function 
-    // below. Using this variable instead of just the interrupt handler flag to trigger 
-    // logging streams allows for multiple interrupts to occur while data is being read 
-    // and processed without missing any ADC data. 
-    if (mtbdl_log.interrupt_counter)
+    // ADC data from each interval is queued in the ADC ring by the perodic interrupt 
+    // callback function below. One interval is popped and recorded each time this runs. 
+    // Using the ring instead of just the interrupt handler flag to trigger logging 
+    // streams allows for many interrupts to occur while data is being read, processed 
+    // and written without missing any ADC data. Data is only lost if the ring fills up, 
+    // which is counted by the ring and reported as an overrun at the end of the log. 
+    if (log_ring_pop(&mtbdl_log.adc_ring, (void *)&mtbdl_log.adc_set))
     {
-        // This is decremented here specifically so data overruns can be detected. 
-        mtbdl_log.interrupt_counter--; 
-
-        if (mtbdl_log.log_interval_divider >= LOG_PERIOD_DIVIDER)
+        if (mtbdl_log.data_buff_index >= (LOG_PERIOD_DIVIDER - 1))
         {
-            mtbdl_log.log_interval_divider = CLEAR; 
-
-            // If the code enters this process and the interrupt counter is greater than 
-            // 0 then it means interrupts have occured without the data being processed 
-            // and therefore means we've lost data. This logging process (that involves 
-            // the use of 'interrupt_counter' and 'log_interval_divider') is designed to 
-            // give time for longer processes to complete without dropping any data from 
-            // each logging interval. 'overrun' keeps track of how many times the code 
-            // has lost data during a logging session. 
-            if (mtbdl_log.interrupt_counter)
-            {
-                mtbdl_log.overrun++; 
-            }
+            // Pick the streams of this slot from the log stream schedule, run them, 
+            // then write data from the previous X intervals to the SD card. Streams 
+            // that line up run together as long as they fit in the slot budget, which 
+            // keeps the time spent in one interval bounded for the tight sampling window 
+            // that needs to be maintained. Streams that don't fit are deferred. 
 
-            // Increment the stream counters, check the schedule for a stream to call, 
-            // execute the scheduled stream, then write data from the previous X intervals 
-            // to the SD card. All counters must be incremented together before the stream 
-            // selection so that they're guarenteed to count. Streams are coordinated 
-            // using the 'stream_schedule' table which ensures multiple devices (excluding 
-            // ADC reads) are not read from at the same interval. This is due to the 
-            // tight sampling window that needs to be maintained. 
+            uint8_t streams = log_schedule_select(&mtbdl_log.schedule); 
 
-            log_stream_t log_stream = LOG_STREAM_STANDARD; 
-
-            mtbdl_log.gps_stream_counter++; 
-            mtbdl_log.accel_stream_counter++; 
-            mtbdl_log.speed_stream_counter++; 
-
-            if (mtbdl_log.gps_stream_counter >= 
-                stream_schedule[LOG_STREAM_GPS].counter_period)
+            if (!streams)
             {
-                mtbdl_log.gps_stream_counter = CLEAR; 
-                log_stream = LOG_STREAM_GPS; 
+                LOG_PROF_START(prof_stream); 
+                log_stream_standard(); 
+                LOG_PROF_STOP(prof_stream, LOG_PROF_STANDARD); 
             }
-            else if (mtbdl_log.accel_stream_counter >= 
-                     stream_schedule[LOG_STREAM_ACCEL].counter_period)
+            else 
             {
-                mtbdl_log.accel_stream_counter = CLEAR; 
-                log_stream = LOG_STREAM_ACCEL; 
+                // Every stream adds to the same interval. Text streams share one line. 
+                if (mtbdl_log.log_mode != LOG_MODE_TEXT)
+                {
+                    log_record_interval(); 
+                }
+                else 
+                {
+                    mtbdl_log.line = log_line_start(); 
+                    mtbdl_log.line_field = CLEAR; 
+                }
+
+                for (uint8_t i = LOG_STREAM_NUM - 1; i > LOG_STREAM_STANDARD; i--)
+                {
+                    if (streams & (SET_BIT << i))
+                    {
+                        LOG_PROF_START(prof_stream); 
+                        stream_table[i](); 
+                        LOG_PROF_STOP(prof_stream, (log_prof_id_t)i); 
+                    }
+                }
+
+                if (mtbdl_log.log_mode == LOG_MODE_TEXT)
+                {
+                    log_line_end(mtbdl_log.line, 
+                                 LOG_FORMAT_LINE_FIELDS - mtbdl_log.line_field); 
+                }
             }
-            else if (mtbdl_log.speed_stream_counter >= 
-                     stream_schedule[LOG_STREAM_SPEED].counter_period)
+
+            // Log data goes through the SD card write buffer so the card only sees 
+            // whole sector writes while logging. 
+            LOG_PROF_START(prof_write); 
+            sd_buff_write((void *)mtbdl_log.data_str, mtbdl_log.data_len); 
+            LOG_PROF_STOP(prof_write, LOG_PROF_SD_WRITE); 
+            mtbdl_log.data_bytes += mtbdl_log.data_len; 
+            mtbdl_log.data_len = CLEAR; 
+
+            // IMU samples are read once per log stream period regardless of the stream 
+#if LOG_IMU_RATE
+            if (mtbdl_log.log_mode != LOG_MODE_TEXT)
             {
-                mtbdl_log.speed_stream_counter = CLEAR; 
-                log_stream = LOG_STREAM_SPEED; 
+                LOG_PROF_START(prof_imu); 
+                log_imu_fifo(); 
+                LOG_PROF_STOP(prof_imu, LOG_PROF_IMU); 
             }
+#endif
 
-            stream_table[log_stream](); 
+            // The log file is synced last so the sync covers the data of this slot that 
+            // made it out of the SD card write buffer 
+#if LOG_SYNC_ENABLE
+            log_sync(streams); 
+#endif
 
-            sd_puts(mtbdl_log.data_str); 
             mtbdl_log.data_buff_index = CLEAR; 
         }
         else 
         {
-            // For every interrupt that occurs that doesn't trigger a logging stream, the 
-            // latest ADC data is formatted and stored so that it can be compiled and 
-            // written to the SD card when a logging stream occurs later. A buffer that 
-            // can store multiple intervals of ADC data is used so that old intervals can 
-            // still be formatted and recorded even if interrupts have triggered new ADC 
-            // conversions before this has had a chance to run. 
-
-            snprintf(mtbdl_log.data_buff[mtbdl_log.data_buff_index], 
-                     MTBDL_MAX_STR_LEN, 
-                     mtbdl_data_log_default, 
-                     mtbdl_log.trailmark, 
-                     mtbdl_log.adc_period[mtbdl_log.data_buff_index][ADC_FORK], 
-                     mtbdl_log.adc_period[mtbdl_log.data_buff_index][ADC_SHOCK]); 
+            // For every interval that doesn't trigger a logging stream, the ADC data is 
+            // formatted and appended to the log string so that it can be written to the 
+            // SD card when a logging stream occurs later. 
+
+            if (mtbdl_log.log_mode != LOG_MODE_TEXT)
+            {
+                log_record_interval(); 
+            }
+            else 
+            {
+                log_line_end(log_line_start(), LOG_FORMAT_LINE_FIELDS); 
+            }
 
             mtbdl_log.data_buff_index++; 
+
+            // The GPS is read here, between log stream slots, once the TX ready interrupt 
+            // shows the device has data. The read lands in an interval that only logs ADC 
+            // data instead of adding to the GPS stream slot. In UBX NAV-PVT mode the read 
+            // is only posted to the I2C bus and runs in the background. Otherwise the time 
+            // it takes is covered by the ADC ring the same as a slow SD card write. 
+            if (m8q_get_data_ready())
+            {
+                LOG_PROF_START(prof_gps); 
+                m8q_set_read_flag(); 
+                m8q_controller(); 
+                m8q_set_idle_flag(); 
+                LOG_PROF_STOP(prof_gps, LOG_PROF_M8Q); 
+            }
         }
         
         // The trail marker flag gets cleared at the end so that it's status can be used 
@@ -508,83 +883,271 @@ void log_data(void)
 // Data logging ADC interrupt callback 
 void log_data_adc_handler(void)
 {
-    handler_flags.tim1_trg_tim11_glbl_flag = CLEAR_BIT; 
-    mtbdl_log.interrupt_counter++; 
+    handler_flags.dma2_0_flag = CLEAR_BIT; 
+
+    // Decimate and queue each interval of ADC data from the block that was just filled. 
+    // Decimating here keeps the oversampling out of the logging time of each sample. If 
+    // the ring is full then the data is dropped and counted by the ring. 
+    // 
+    // The block is timed here, as close to its last conversion as software gets, and 
+    // the sample sets before it are one sample period apart. Each sample set carries 
+    // its own time through the ring so the time stays with the sample even when sample 
+    // sets are dropped. 
+    uint32_t time = mtbdl_log.timebase->CNT - (LOG_ADC_BLOCK_SIZE - 1) * LOG_PERIOD_US; 
+    uint8_t block = log_adc_block_done(); 
+    log_adc_set_t set; 
+
+    for (uint8_t i = CLEAR; i < LOG_ADC_BLOCK_SIZE; i++, time += LOG_PERIOD_US)
+    {
+        log_adc_decimate(mtbdl_log.adc_block[block][i], set.sample); 
+        set.time = time; 
+        log_ring_push(&mtbdl_log.adc_ring, (const void *)&set); 
+    }
+}
 
-    if (mtbdl_log.log_interval_divider < LOG_PERIOD_DIVIDER)
+
+// Get the ADC block last filled by the DMA 
+uint8_t log_adc_block_done(void)
+{
+    // In double buffer mode the current target (CT) bit shows which block the DMA is 
+    // filling. It changes as soon as a block is full so the other block is the newest 
+    // complete one. 
+    return (mtbdl_log.dma_stream->CR & DMA_SxCR_CT) ? BYTE_0 : BYTE_1; 
+}
+
+
+// Get the revolution timestamp the DMA writes next 
+uint16_t log_rev_head(void)
+{
+    return (uint16_t)((LOG_REV_CAPTURE_SIZE - mtbdl_log.rev_dma_stream->NDTR) % 
+                      LOG_REV_CAPTURE_SIZE); 
+}
+
+
+// Log the IMU FIFO samples 
+void log_imu_fifo(void)
+{
+    log_rec_imu_t record = { .tag = LOG_REC_IMU }; 
+    int16_t accel[MPU6050_FIFO_AXES], gyro[MPU6050_FIFO_AXES]; 
+    uint16_t len = sizeof(record), overflow; 
+
+    // The samples are from the burst read posted last period. A read that's still in 
+    // flight has no frames yet and its samples are logged next period. 
+    record.count = (uint8_t)mpu6050_get_fifo_frames(DEVICE_ONE); 
+    record.time = mpu6050_get_fifo_time(DEVICE_ONE); 
+    overflow = mpu6050_get_fifo_overflow(DEVICE_ONE); 
+    record.lost = (overflow != mtbdl_log.imu_overflow); 
+    mtbdl_log.imu_overflow = overflow; 
+
+    if (record.count || record.lost)
     {
-        mtbdl_log.adc_period[mtbdl_log.log_interval_divider][ADC_SOC] = 
-            mtbdl_log.adc_buff[ADC_SOC]; 
-        
-        mtbdl_log.adc_period[mtbdl_log.log_interval_divider][ADC_FORK] = 
-            mtbdl_log.adc_buff[ADC_FORK]; 
-        
-        mtbdl_log.adc_period[mtbdl_log.log_interval_divider][ADC_SHOCK] = 
-            mtbdl_log.adc_buff[ADC_SHOCK]; 
+        // Samples are stored in the record in device axis order (little endian) 
+        for (uint8_t i = CLEAR; i < record.count; i++)
+        {
+            mpu6050_get_fifo_frame(DEVICE_ONE, i, accel, gyro); 
+            memcpy((void *)&mtbdl_log.imu_rec[len], (void *)accel, sizeof(accel)); 
+            len += sizeof(accel); 
+            memcpy((void *)&mtbdl_log.imu_rec[len], (void *)gyro, sizeof(gyro)); 
+            len += sizeof(gyro); 
+        }
+
+        memcpy((void *)mtbdl_log.imu_rec, (void *)&record, sizeof(record)); 
+        sd_buff_write((void *)mtbdl_log.imu_rec, len); 
+        mtbdl_log.data_bytes += len; 
+    }
+
+    // The buffer is free again so the next burst read can be posted 
+    mpu6050_set_fifo_flag(DEVICE_ONE); 
+    mpu6050_controller(DEVICE_ONE); 
+}
+
+
+// Sync the log file if it's due 
+void log_sync(uint8_t streams)
+{
+    if (mtbdl_log.sync_slots < LOG_SYNC_SLOTS)
+    {
+        mtbdl_log.sync_slots++; 
+    }
+
+    if ((mtbdl_log.sync_slots < LOG_SYNC_SLOTS) && 
+        ((mtbdl_log.data_bytes - mtbdl_log.sync_offset) < LOG_SYNC_BYTES))
+    {
+        return; 
+    }
+
+    // The sync is treated like a stream that's always deferred until a slot has room 
+    // for it. This keeps the time of each slot bounded: the streams never go over the 
+    // slot budget and a sync is only added where they leave LOG_SYNC_COST of it. 
+    if ((log_schedule_cost(streams) + LOG_SYNC_COST) > LOG_SLOT_BUDGET)
+    {
+        return; 
+    }
+
+    // The sync record goes out with the next write of the SD card write buffer so it 
+    // shows the log data up to it is on the card once it's read back. A failed sync is 
+    // recorded in the SD card controller fault code. The limits start over either way 
+    // so a card fault doesn't turn into a sync every slot. 
+    log_sync_record(); 
+
+    LOG_PROF_START(prof_sync); 
+    sd_sync(); 
+    LOG_PROF_STOP(prof_sync, LOG_PROF_SD_SYNC); 
 
-        mtbdl_log.log_interval_divider++; 
+    mtbdl_log.sync_slots = CLEAR; 
+}
+
+
+// Write a sync record 
+void log_sync_record(void)
+{
+    mtbdl_log.sync_offset = mtbdl_log.data_bytes; 
+
+    if (mtbdl_log.log_mode == LOG_MODE_TEXT)
+    {
+        return; 
+    }
+
+    log_rec_sync_t record = 
+    {
+        .tag = LOG_REC_SYNC, 
+        .seq = mtbdl_log.sync_seq, 
+        .offset = mtbdl_log.sync_offset, 
+        .id = mtbdl_log.log_id 
+    }; 
+
+    sd_buff_write((void *)&record, sizeof(record)); 
+    mtbdl_log.data_bytes += sizeof(record); 
+    mtbdl_log.sync_seq++; 
+}
+
+
+// Decimate the oversampled conversions of a sample set 
+void log_adc_decimate(
+    const uint16_t (*conv)[ADC_BUFF_SIZE], 
+    uint16_t *sample)
+{
+    // Summing LOG_ADC_OSR conversions adds 2*LOG_ADC_OSR_BITS bits to the range but 
+    // only half of those are real resolution, so the sum is shifted down by the other 
+    // half (rounded). The largest sum fits in 16 bits after the shift. 
+    uint32_t sum[ADC_BUFF_SIZE]; 
+
+    memset((void *)sum, CLEAR, sizeof(sum)); 
+
+    for (uint8_t i = CLEAR; i < LOG_ADC_OSR; i++)
+    {
+        for (uint8_t j = CLEAR; j < ADC_BUFF_SIZE; j++)
+        {
+            sum[j] += conv[i][j]; 
+        }
+    }
+
+    for (uint8_t j = CLEAR; j < ADC_BUFF_SIZE; j++)
+    {
+        sample[j] = (uint16_t)((sum[j] + LOG_ADC_OSR_ROUND) >> LOG_ADC_OSR_BITS); 
     }
+}
+
 
-    adc_start(mtbdl_log.adc); 
+// Enable the ADC sample interrupt 
+void log_adc_int_enable(void)
+{
+    // The DMA keeps running while the interrupt is disabled so a transfer complete can 
+    // already be pending. It's cleared so the first block handed off is one that 
+    // finishes after logging starts. 
+    dma_clear_int_flags(mtbdl_log.dma); 
+    NVIC_ClearPendingIRQ(mtbdl_log.log_irq); 
+    NVIC_EnableIRQ(mtbdl_log.log_irq); 
 }
 
 
 // Standard logging stream 
 void log_stream_standard(void)
 {
-    // Format standard (ADC) log string 
-    snprintf(mtbdl_log.data_str, 
-             LOG_MAX_LOG_LEN, 
-             mtbdl_data_log_adc, 
-             mtbdl_log.data_buff[BYTE_0], 
-             mtbdl_log.data_buff[BYTE_1], 
-             mtbdl_log.data_buff[BYTE_2], 
-             mtbdl_log.data_buff[BYTE_3], 
-             mtbdl_log.trailmark, 
-             mtbdl_log.adc_period[mtbdl_log.data_buff_index][ADC_FORK], 
-             mtbdl_log.adc_period[mtbdl_log.data_buff_index][ADC_SHOCK]); 
+    if (mtbdl_log.log_mode != LOG_MODE_TEXT)
+    {
+        log_record_interval(); 
+        return; 
+    }
+
+    // Format standard (ADC) log line 
+    log_line_end(log_line_start(), LOG_FORMAT_LINE_FIELDS); 
 }
 
 
 // GPS logging stream 
 void log_stream_gps(void)
 {
-    // In this data logging stream the GPS device is read from and the results are 
-    // formatted so they can be saved in the log file. The GPS controller is used to 
-    // update the GPS data. This involves putting the device into a read state, reading 
-    // from the device, then putting the device back into an idle state. This is done 
-    // so that the controller will not read from the device (and therefore consume time 
-    // during another stream) while not in the GPS stream. It's also necessary to call 
-    // the controller directly so we can get the new data now. The controller is used 
-    // here to update data instead of directly using the device driver to be consistant 
-    // with how the rest of the code is written. 
-
-    m8q_set_read_flag(); 
-    m8q_controller(); 
-    m8q_set_idle_flag(); 
-
-    m8q_get_position_lat_str(mtbdl_log.lat_str, LOG_GPS_BUFF_LEN); 
-    mtbdl_log.NS = m8q_get_position_NS(); 
-    m8q_get_position_lon_str(mtbdl_log.lon_str, LOG_GPS_BUFF_LEN); 
-    mtbdl_log.EW = m8q_get_position_EW(); 
-    m8q_get_position_sog_str(mtbdl_log.sog_str, LOG_GPS_BUFF_LEN); 
-
-    // Format GPS data log string 
-    snprintf(mtbdl_log.data_str, 
-             LOG_MAX_LOG_LEN, 
-             mtbdl_data_log_gps, 
-             mtbdl_log.data_buff[BYTE_0], 
-             mtbdl_log.data_buff[BYTE_1], 
-             mtbdl_log.data_buff[BYTE_2], 
-             mtbdl_log.data_buff[BYTE_3], 
-             mtbdl_log.trailmark, 
-             mtbdl_log.adc_period[mtbdl_log.data_buff_index][ADC_FORK], 
-             mtbdl_log.adc_period[mtbdl_log.data_buff_index][ADC_SHOCK], 
-             (char *)mtbdl_log.sog_str, 
-             (char *)mtbdl_log.lat_str, 
-             (char)mtbdl_log.NS, 
-             (char *)mtbdl_log.lon_str, 
-             (char)mtbdl_log.EW); 
+    // In this data logging stream the last GPS fix is formatted so it can be saved in 
+    // the log file. The device isn't read here. The GPS controller reads it between log 
+    // stream slots after the TX ready interrupt (see log_data) and publishes each new 
+    // fix, so this only copies the last one and never waits on the I2C bus. 
+
+    m8q_get_fix(&mtbdl_log.gps); 
+
+#if M8Q_UBX_NAV_PVT
+
+    // NAV-PVT gives the position and speed as integers. Binary logs keep them as is and 
+    // text logs write them in the same form as the PUBX POSITION strings. 
+    const m8q_ubx_nav_pvt_t *pvt = &mtbdl_log.gps.pvt; 
+    uint32_t speed = (pvt->gSpeed > 0) ? (uint32_t)pvt->gSpeed : 0; 
+
+    if (mtbdl_log.log_mode != LOG_MODE_TEXT)
+    {
+        log_rec_gps_pvt_t record = 
+        {
+            .tag = LOG_REC_GPS_PVT, 
+            .itow = pvt->iTOW, 
+            .lat = pvt->lat, 
+            .lon = pvt->lon, 
+            .speed = speed, 
+            .fix = pvt->fixType, 
+            .num_sv = pvt->numSV, 
+            .time = mtbdl_log.gps.time 
+        }; 
+
+        log_record_append((void *)&record, sizeof(record)); 
+        return; 
+    }
+
+    // Format GPS data log fields 
+    char *line = log_line_field(LOG_FORMAT_GPS_FIELD, LOG_FORMAT_GPS_FIELDS); 
+    line = log_format_sep(line); 
+    line = log_format_milli(line, LOG_FORMAT_KMH_MILLI(speed)); 
+    line = log_format_sep(line); 
+    line = log_format_coord(line, pvt->lat, LOG_FORMAT_LAT_DEG_LEN, 'N', 'S'); 
+    line = log_format_sep(line); 
+    mtbdl_log.line = log_format_coord(line, pvt->lon, LOG_FORMAT_LON_DEG_LEN, 'E', 'W'); 
+
+#else
+
+    if (mtbdl_log.log_mode != LOG_MODE_TEXT)
+    {
+        log_rec_gps_t record = { .tag = LOG_REC_GPS }; 
+
+        memcpy((void *)record.sog, (void *)mtbdl_log.gps.sog_str, LOG_REC_STR_LEN); 
+        memcpy((void *)record.lat, (void *)mtbdl_log.gps.lat_str, LOG_REC_STR_LEN); 
+        record.NS = (char)mtbdl_log.gps.NS; 
+        memcpy((void *)record.lon, (void *)mtbdl_log.gps.lon_str, LOG_REC_STR_LEN); 
+        record.EW = (char)mtbdl_log.gps.EW; 
+        record.time = mtbdl_log.gps.time; 
+
+        log_record_append((void *)&record, sizeof(record)); 
+        return; 
+    }
+
+    // Format GPS data log fields 
+    char *line = log_line_field(LOG_FORMAT_GPS_FIELD, LOG_FORMAT_GPS_FIELDS); 
+    line = log_format_sep(line); 
+    line = log_format_str(line, (char *)mtbdl_log.gps.sog_str, M8Q_FIX_STR_LEN); 
+    line = log_format_sep(line); 
+    line = log_format_str(line, (char *)mtbdl_log.gps.lat_str, M8Q_FIX_STR_LEN); 
+    line = log_format_char(line, (char)mtbdl_log.gps.NS); 
+    line = log_format_sep(line); 
+    line = log_format_str(line, (char *)mtbdl_log.gps.lon_str, M8Q_FIX_STR_LEN); 
+    mtbdl_log.line = log_format_char(line, (char)mtbdl_log.gps.EW); 
+
+#endif   // M8Q_UBX_NAV_PVT 
 }
 
 
@@ -603,66 +1166,238 @@ void log_stream_accel(void)
 
     mpu6050_set_read_flag(DEVICE_ONE); 
     mpu6050_controller(DEVICE_ONE); 
+    uint32_t time = mtbdl_log.timebase->CNT; 
 
     mpu6050_get_accel_axis(DEVICE_ONE, mtbdl_log.accel); 
 
-    // Format accelerometer data log string 
-    snprintf(mtbdl_log.data_str, 
-             LOG_MAX_LOG_LEN, 
-             mtbdl_data_log_accel, 
-             mtbdl_log.data_buff[BYTE_0], 
-             mtbdl_log.data_buff[BYTE_1], 
-             mtbdl_log.data_buff[BYTE_2], 
-             mtbdl_log.data_buff[BYTE_3], 
-             mtbdl_log.trailmark, 
-             mtbdl_log.adc_period[mtbdl_log.data_buff_index][ADC_FORK], 
-             mtbdl_log.adc_period[mtbdl_log.data_buff_index][ADC_SHOCK], 
-             mtbdl_log.accel[X_AXIS], 
-             mtbdl_log.accel[Y_AXIS], 
-             mtbdl_log.accel[Z_AXIS]); 
+    if (mtbdl_log.log_mode != LOG_MODE_TEXT)
+    {
+        log_rec_accel_t record = 
+        {
+            .tag = LOG_REC_ACCEL, 
+            .x = mtbdl_log.accel[X_AXIS], 
+            .y = mtbdl_log.accel[Y_AXIS], 
+            .z = mtbdl_log.accel[Z_AXIS], 
+            .time = time 
+        }; 
+
+        log_record_append((void *)&record, sizeof(record)); 
+        return; 
+    }
+
+    // Format accelerometer data log fields 
+    char *line = log_line_field(LOG_FORMAT_ACCEL_FIELD, NUM_AXES); 
+
+    for (uint8_t i = X_AXIS; i < NUM_AXES; i++)
+    {
+        line = log_format_sep(line); 
+        line = log_format_i16(line, mtbdl_log.accel[i]); 
+    }
+
+    mtbdl_log.line = line; 
 }
 
 
 // Wheel speed logging stream 
 void log_stream_speed(void)
 {
+#if LOG_SPEED_CAPTURE
+
+    // With input capture the period of each wheel revolution since the last speed 
+    // stream is logged in place of the revolution count. New timestamps are read from 
+    // the capture buffer then the period is checked against the current timer count so 
+    // a wheel that is slowing down or has stopped shows up before its next revolution. 
+    // Text logs show that period when there are no new revolutions. 
+
+    uint32_t periods[LOG_REV_MAX_PERIODS]; 
+    uint8_t count = (uint8_t)log_rev_update(&mtbdl_log.rev, log_rev_head(), 
+                                            periods, LOG_REV_MAX_PERIODS); 
+    uint32_t period = log_rev_period(&mtbdl_log.rev, mtbdl_log.rev_timer->CNT); 
+
+    if (mtbdl_log.log_mode != LOG_MODE_TEXT)
+    {
+        // The periods are appended with the record so they're dropped together if the 
+        // log string is full 
+        uint8_t record[sizeof(log_rec_rev_period_t) + sizeof(periods)]; 
+        log_rec_rev_period_t rev = 
+        {
+            .tag = LOG_REC_REV_PERIOD, 
+            .count = count, 
+            .period = period 
+        }; 
+        uint16_t len = sizeof(rev) + count * sizeof(periods[0]); 
+
+        memcpy((void *)record, (void *)&rev, sizeof(rev)); 
+        memcpy((void *)&record[sizeof(rev)], (void *)periods, len - sizeof(rev)); 
+        log_record_append((void *)record, len); 
+        return; 
+    }
+
+    // Format wheel speed data log field - the periods are separated with a '/' 
+    char *line = log_line_field(LOG_FORMAT_SPEED_FIELD, 1); 
+    line = log_format_sep(line); 
+
+    if (!count)
+    {
+        mtbdl_log.line = log_format_u32(line, period); 
+        return; 
+    }
+
+    line = log_format_u32(line, periods[0]); 
+
+    for (uint8_t i = 1; i < count; i++)
+    {
+        line = log_format_char(line, '/'); 
+        line = log_format_u32(line, periods[i]); 
+    }
+
+    mtbdl_log.line = line; 
+
+#else
+
     // In this data logging stream the wheel revolutions from the previous speed logging 
-    // interval are recored in a circular buffer. The revolutions from each index of the 
-    // buffer are summed together and recorded in the log file. This provides a 
-    // revolution count across the X most recent intervals which can be used along with 
-    // the total time of X intervals to estimate an RPM in post processing. The time of 
-    // a single interval along with the buffer size is written at the top of each log 
-    // file. The oldest piece of data in the buffer gets overwritten by the newest at 
-    // each interval. 
+    // interval are recored in a circular buffer. The revolutions across the X most 
+    // recent intervals of each revolution window are recorded in the log file, which 
+    // can be used along with the total time of X intervals to estimate an RPM in post 
+    // processing. The time of a single interval along with the window sizes is written 
+    // at the top of each log file. The oldest piece of data in the buffer gets 
+    // overwritten by the newest at each interval. 
+    // 
+    // Each window keeps a running sum instead of re-summing the buffer. The newest 
+    // interval is added and the interval that just left the window is subtracted, so the 
+    // cost doesn't depend on the window length. 
 
     // This is used because mtbdl_log.rev_count gets updated by an interrupt. 
-    uint8_t revs = CLEAR; 
-
-    mtbdl_log.rev_buff[mtbdl_log.rev_buff_index++] = mtbdl_log.rev_count; 
+    uint8_t revs = mtbdl_log.rev_count; 
+    uint8_t index = mtbdl_log.rev_buff_index; 
     mtbdl_log.rev_count = CLEAR; 
 
-    if (mtbdl_log.rev_buff_index >= LOG_REV_SAMPLE_SIZE)
+    for (uint8_t i = CLEAR; i < LOG_REV_NUM_WINDOWS; i++)
+    {
+        uint8_t oldest = (index + LOG_REV_SAMPLE_SIZE - log_rev_windows[i]) %
+                         LOG_REV_SAMPLE_SIZE; 
+        mtbdl_log.rev_sums[i] += revs; 
+        mtbdl_log.rev_sums[i] -= mtbdl_log.rev_buff[oldest]; 
+    }
+
+    mtbdl_log.rev_buff[index++] = revs; 
+    mtbdl_log.rev_buff_index = (index >= LOG_REV_SAMPLE_SIZE) ? CLEAR : index; 
+
+    if (mtbdl_log.log_mode != LOG_MODE_TEXT)
     {
-        mtbdl_log.rev_buff_index = CLEAR; 
+        log_rec_speed_t record = { .tag = LOG_REC_SPEED }; 
+        memcpy((void *)record.revs, (void *)mtbdl_log.rev_sums, sizeof(record.revs)); 
+
+        log_record_append((void *)&record, sizeof(record)); 
+        return; 
     }
 
-    for (uint8_t i = CLEAR; i < LOG_REV_SAMPLE_SIZE; i++)
+    // Format wheel speed data log field - the window sums are separated with a '/' 
+    char *line = log_line_field(LOG_FORMAT_SPEED_FIELD, 1); 
+    line = log_format_sep(line); 
+    line = log_format_u16(line, mtbdl_log.rev_sums[0]); 
+
+    for (uint8_t i = 1; i < LOG_REV_NUM_WINDOWS; i++)
     {
-        revs += mtbdl_log.rev_buff[i]; 
+        line = log_format_char(line, '/'); 
+        line = log_format_u16(line, mtbdl_log.rev_sums[i]); 
     }
 
-    // Format wheel speed data log string 
-    snprintf(mtbdl_log.data_str, 
-             LOG_MAX_LOG_LEN, 
-             mtbdl_data_log_speed, 
-             mtbdl_log.data_buff[BYTE_0], 
-             mtbdl_log.data_buff[BYTE_1], 
-             mtbdl_log.data_buff[BYTE_2], 
-             mtbdl_log.data_buff[BYTE_3], 
-             mtbdl_log.trailmark, 
-             mtbdl_log.adc_period[mtbdl_log.data_buff_index][ADC_FORK], 
-             mtbdl_log.adc_period[mtbdl_log.data_buff_index][ADC_SHOCK], 
-             revs); 
+    mtbdl_log.line = line; 
+
+#endif   // LOG_SPEED_CAPTURE
+}
+
+
+// Append a binary record to the log string 
+void log_record_append(
+    const void *record, 
+    uint16_t size)
+{
+    if ((mtbdl_log.data_len + size) <= LOG_MAX_LOG_LEN)
+    {
+        memcpy((void *)&mtbdl_log.data_str[mtbdl_log.data_len], record, size); 
+        mtbdl_log.data_len += size; 
+    }
+}
+
+
+// Append the interval records to the log string 
+void log_record_interval(void)
+{
+    // The time of the last sample of each log stream period goes ahead of its records. 
+    // The other samples of the period are timed from it offline. 
+    if (mtbdl_log.data_buff_index >= (LOG_PERIOD_DIVIDER - 1))
+    {
+        log_rec_time_t time = { .tag = LOG_REC_TIME, .time = mtbdl_log.adc_set.time }; 
+        log_record_append((void *)&time, sizeof(time)); 
+    }
+
+    // Packed mode packs the samples of each log stream period into one block which is 
+    // appended with the last sample of the period, ahead of the stream records. 
+    if (mtbdl_log.log_mode == LOG_MODE_PACKED)
+    {
+        uint16_t sample[LOG_REC_PACK_CHANNELS] = 
+        {
+            mtbdl_log.adc_set.sample[ADC_FORK], 
+            mtbdl_log.adc_set.sample[ADC_SHOCK]
+        }; 
+
+        log_pack_sample(&mtbdl_log.adc_pack, sample, mtbdl_log.trailmark); 
+
+        if (mtbdl_log.data_buff_index >= (LOG_PERIOD_DIVIDER - 1))
+        {
+            uint8_t block[LOG_PACK_MAX_RECORD_LEN]; 
+            log_record_append((void *)block, log_pack_block(&mtbdl_log.adc_pack, block)); 
+        }
+
+        return; 
+    }
+
+    if (mtbdl_log.trailmark)
+    {
+        log_rec_trailmark_t trailmark = { .tag = LOG_REC_TRAILMARK }; 
+        log_record_append((void *)&trailmark, sizeof(trailmark)); 
+    }
+
+    log_rec_adc_t record = 
+    {
+        .tag = LOG_REC_ADC, 
+        .fork = mtbdl_log.adc_set.sample[ADC_FORK], 
+        .shock = mtbdl_log.adc_set.sample[ADC_SHOCK] 
+    }; 
+    log_record_append((void *)&record, sizeof(record)); 
+}
+
+
+// Start a text log line 
+char *log_line_start(void)
+{
+    return log_format_line_start(&mtbdl_log.data_str[mtbdl_log.data_len], 
+                                 mtbdl_log.trailmark, 
+                                 mtbdl_log.adc_set.sample[ADC_FORK], 
+                                 mtbdl_log.adc_set.sample[ADC_SHOCK]); 
+}
+
+
+// End a text log line 
+void log_line_end(
+    char *line, 
+    uint8_t fields)
+{
+    line = log_format_line_end(line, fields); 
+    mtbdl_log.data_len = (uint16_t)(line - mtbdl_log.data_str); 
+}
+
+
+// Start the fields of a stream in the slot text line 
+char *log_line_field(
+    uint8_t field, 
+    uint8_t fields)
+{
+    char *line = log_format_line_blank(mtbdl_log.line, field - mtbdl_log.line_field); 
+    mtbdl_log.line_field = field + fields; 
+    return line; 
 }
 
 
@@ -670,22 +1405,63 @@ void log_stream_speed(void)
 void log_data_end(void)
 {
     // Disable interrupts 
+#if !LOG_SPEED_CAPTURE
     NVIC_DisableIRQ(mtbdl_log.rpm_irq);   // Wheel speed 
-    NVIC_DisableIRQ(mtbdl_log.log_irq);   // Log sample period 
+#endif
+    NVIC_DisableIRQ(mtbdl_log.log_irq);   // ADC samples 
 
     // If there is an open log file, terminate and close it then update the log index now 
     // that a new log file has been created, written to and stored. The code checks for 
     // an open log file first because this function is called in the post run state which 
-    // is executed even when low power or fault events occur. 
+    // is executed even when low power or fault events occur. Closing the file flushes 
+    // the SD card write buffer so no buffered log data is lost. 
 
     if (sd_get_file_status())
     {
-        snprintf(mtbdl_log.data_str, 
-                 LOG_MAX_LOG_LEN, 
-                 mtbdl_data_log_end, 
-                 mtbdl_log.overrun); 
-        sd_puts(mtbdl_log.data_str); 
+        // The overrun is the number of ADC sample sets that were dropped because the 
+        // ADC ring was full. It saturates to fit the log file format. 
+        uint32_t drops = log_ring_get_drops(&mtbdl_log.adc_ring); 
+        mtbdl_log.overrun = (drops > UINT8_MAX) ? UINT8_MAX : (uint8_t)drops; 
+
+        // The end record of a binary or packed log directly follows a sync record so 
+        // it can be told apart from an end left on the card by an older log 
+        log_sync_record(); 
+
+        if (mtbdl_log.log_mode != LOG_MODE_TEXT)
+        {
+            log_rec_end_t record = { .tag = LOG_REC_END, .overrun = mtbdl_log.overrun }; 
+            sd_buff_write((void *)&record, sizeof(record)); 
+        }
+        else 
+        {
+            snprintf(mtbdl_log.data_str, 
+                     LOG_MAX_LOG_LEN, 
+                     mtbdl_data_log_end, 
+                     mtbdl_log.overrun); 
+            sd_buff_puts(mtbdl_log.data_str); 
+        }
+
+#if LOG_PROF_ENABLE
+        // The execution time histograms are written as text after the end of the log in 
+        // every log mode so they don't change the log format. 
+        sd_buff_puts(mtbdl_prof_start); 
 
+        for (uint8_t i = CLEAR; i < LOG_PROF_NUM; i++)
+        {
+            if (log_prof_format(mtbdl_log.data_str, LOG_MAX_LOG_LEN, (log_prof_id_t)i))
+            {
+                sd_buff_puts(mtbdl_log.data_str); 
+            }
+        }
+#endif
+
+        // Trim any pre-allocated space past the end of the log. If power is lost before 
+        // this point then the file keeps the size it had at the last sync (see log_sync), 
+        // which is the pre-allocated size if it was pre-allocated. Whatever was on the 
+        // card before is then left past the log data. A binary or packed log ends at the 
+        // last sync record that made it to the card, the same as a log without an end 
+        // record. 
+        sd_truncate(); 
         sd_close(); 
         param_update_log_index(PARAM_LOG_INDEX_INC); 
     }
@@ -701,12 +1477,11 @@ void log_data_end(void)
 void log_calibration_prep(void)
 {
     // ADC data 
-    memset((void *)mtbdl_log.adc_period, CLEAR, sizeof(mtbdl_log.adc_period)); 
+    memset((void *)&mtbdl_log.adc_set, CLEAR, sizeof(mtbdl_log.adc_set)); 
+    log_ring_reset(&mtbdl_log.adc_ring); 
 
     // Logging counters 
-    mtbdl_log.log_interval_divider = CLEAR; 
-    mtbdl_log.accel_stream_counter = stream_schedule[LOG_STREAM_ACCEL].offset; 
-    mtbdl_log.interrupt_counter = CLEAR; 
+    log_schedule_init(&mtbdl_log.schedule); 
     
     // Calibration data 
     memset((void *)mtbdl_log.cal_buff, CLEAR, sizeof(mtbdl_log.cal_buff)); 
@@ -714,50 +1489,44 @@ void log_calibration_prep(void)
     mtbdl_log.cal_accel_samples = CLEAR; 
 
     // SD card data 
-    memset((void*)mtbdl_log.data_buff, CLEAR, sizeof(mtbdl_log.data_buff)); 
     memset((void*)mtbdl_log.data_str, CLEAR, sizeof(mtbdl_log.data_str)); 
+    mtbdl_log.data_len = CLEAR; 
     mtbdl_log.data_buff_index = CLEAR; 
 
-    // Enable log sample period interrupts 
-    NVIC_EnableIRQ(mtbdl_log.log_irq); 
+    // Enable ADC sample interrupts 
+    log_adc_int_enable(); 
 }
 
 
 // Calibration 
 void log_calibration(void)
 {
-    if (mtbdl_log.interrupt_counter)
+    if (log_ring_pop(&mtbdl_log.adc_ring, (void *)&mtbdl_log.adc_set))
     {
-        if (mtbdl_log.log_interval_divider >= LOG_PERIOD_DIVIDER)
+        mtbdl_log.cal_buff[PARAM_SYS_SET_FORK_REST] += 
+            (int32_t)mtbdl_log.adc_set.sample[ADC_FORK]; 
+        mtbdl_log.cal_buff[PARAM_SYS_SET_SHOCK_REST] += 
+            (int32_t)mtbdl_log.adc_set.sample[ADC_SHOCK]; 
+        mtbdl_log.cal_adc_samples++; 
+
+        if (++mtbdl_log.data_buff_index >= LOG_PERIOD_DIVIDER)
         {
-            mtbdl_log.log_interval_divider = CLEAR; 
+            mtbdl_log.data_buff_index = CLEAR; 
 
-            if (++mtbdl_log.accel_stream_counter >= 
-                    stream_schedule[LOG_STREAM_ACCEL].counter_period)
+            if (log_schedule_due(&mtbdl_log.schedule, LOG_SCHED_ACCEL))
             {
-                mtbdl_log.accel_stream_counter = CLEAR; 
                 mtbdl_log.cal_accel_samples++; 
 
-                log_stream_accel(); 
+                // Only the accelerometer read of the stream is needed, nothing is logged 
+                mpu6050_set_read_flag(DEVICE_ONE); 
+                mpu6050_controller(DEVICE_ONE); 
+                mpu6050_get_accel_axis(DEVICE_ONE, mtbdl_log.accel); 
 
                 mtbdl_log.cal_buff[PARAM_SYS_SET_AX_REST] += (int32_t)mtbdl_log.accel[X_AXIS]; 
                 mtbdl_log.cal_buff[PARAM_SYS_SET_AY_REST] += (int32_t)mtbdl_log.accel[Y_AXIS]; 
                 mtbdl_log.cal_buff[PARAM_SYS_SET_AZ_REST] += (int32_t)mtbdl_log.accel[Z_AXIS]; 
             }
         }
-
-        mtbdl_log.cal_buff[PARAM_SYS_SET_FORK_REST] += 
-            (int32_t)mtbdl_log.adc_period[mtbdl_log.data_buff_index][ADC_FORK]; 
-        mtbdl_log.cal_buff[PARAM_SYS_SET_SHOCK_REST] += 
-            (int32_t)mtbdl_log.adc_period[mtbdl_log.data_buff_index][ADC_SHOCK]; 
-        
-        if (++mtbdl_log.data_buff_index >= LOG_PERIOD_DIVIDER)
-        {
-            mtbdl_log.data_buff_index = CLEAR; 
-        }
-
-        mtbdl_log.cal_adc_samples++; 
-        mtbdl_log.interrupt_counter--; 
     }
 }
 
@@ -765,7 +1534,7 @@ void log_calibration(void)
 // Calibration calculation 
 void log_calibration_calculation(void)
 {
-    // Disable log sample period interrupts 
+    // Disable ADC sample interrupts 
     NVIC_DisableIRQ(mtbdl_log.log_irq); 
 
     // Average the samples taken during calibration and update the system parameters with 
@@ -780,17 +1549,19 @@ void log_calibration_calculation(void)
     mtbdl_log.accel[Z_AXIS] = 
         (int16_t)(mtbdl_log.cal_buff[PARAM_SYS_SET_AZ_REST] / mtbdl_log.cal_accel_samples); 
     
-    mtbdl_log.adc_buff[ADC_FORK] = 
+    mtbdl_log.adc_set.sample[ADC_FORK] = 
         (uint16_t)(mtbdl_log.cal_buff[PARAM_SYS_SET_FORK_REST] / mtbdl_log.cal_adc_samples); 
     
-    mtbdl_log.adc_buff[ADC_SHOCK] = 
+    mtbdl_log.adc_set.sample[ADC_SHOCK] = 
         (uint16_t)(mtbdl_log.cal_buff[PARAM_SYS_SET_SHOCK_REST] / mtbdl_log.cal_adc_samples); 
 
     param_update_system_setting(PARAM_SYS_SET_AX_REST, (void *)&mtbdl_log.accel[X_AXIS]); 
     param_update_system_setting(PARAM_SYS_SET_AY_REST, (void *)&mtbdl_log.accel[Y_AXIS]); 
     param_update_system_setting(PARAM_SYS_SET_AZ_REST, (void *)&mtbdl_log.accel[Z_AXIS]); 
-    param_update_system_setting(PARAM_SYS_SET_FORK_REST, (void *)&mtbdl_log.adc_buff[ADC_FORK]); 
-    param_update_system_setting(PARAM_SYS_SET_SHOCK_REST, (void *)&mtbdl_log.adc_buff[ADC_SHOCK]); 
+    param_update_system_setting(PARAM_SYS_SET_FORK_REST, 
+                                (void *)&mtbdl_log.adc_set.sample[ADC_FORK]); 
+    param_update_system_setting(PARAM_SYS_SET_SHOCK_REST, 
+                                (void *)&mtbdl_log.adc_set.sample[ADC_SHOCK]); 
 
     param_write_sys_params(SD_MODE_OEW); 
 }
@@ -807,6 +1578,16 @@ void log_set_trailmark(void)
     mtbdl_log.trailmark = SET_BIT; 
 }
 
+
+// Set the log file format 
+void log_set_mode(log_mode_t mode)
+{
+    if (mode < LOG_MODE_NUM)
+    {
+        mtbdl_log.log_mode = mode; 
+    }
+}
+
 //=======================================================================================
 
 
@@ -816,18 +1597,36 @@ void log_set_trailmark(void)
 // Get battery voltage (ADC value) 
 uint16_t log_get_batt_voltage(void)
 {
-    // Update the current ADC values if the data logging periodic interrupt is not 
-    // enabled (i.e. if data logging or calibration is not happening). 
-    if (!NVIC_GetEnableIRQ(mtbdl_log.log_irq))
-    {
-        uint16_t timeout = LOG_ADC_DMA_WAIT; 
+    // The timer keeps triggering ADC conversions and the DMA keeps filling the ADC blocks 
+    // whether or not data is being logged, so the newest complete sample is at the end 
+    // of the block the DMA just finished. 
+    uint8_t block = log_adc_block_done(); 
+    uint16_t sample[ADC_BUFF_SIZE]; 
 
-        dma_clear_int_flags(mtbdl_log.dma); 
-        adc_start(mtbdl_log.adc); 
-        while(!dma_get_tc_status(mtbdl_log.dma, mtbdl_log.dma_stream) && --timeout); 
-    }
+    log_adc_decimate(mtbdl_log.adc_block[block][LOG_ADC_BLOCK_SIZE - 1], sample); 
+
+    return sample[ADC_SOC]; 
+}
 
-    return mtbdl_log.adc_buff[ADC_SOC]; 
+
+// Get the ADC ring count 
+uint32_t log_get_adc_ring_count(void)
+{
+    return log_ring_get_count(&mtbdl_log.adc_ring); 
+}
+
+
+// Get the ADC ring high water mark 
+uint32_t log_get_adc_ring_hwm(void)
+{
+    return log_ring_get_hwm(&mtbdl_log.adc_ring); 
+}
+
+
+// Get the ADC ring drop count 
+uint32_t log_get_adc_ring_drops(void)
+{
+    return log_ring_get_drops(&mtbdl_log.adc_ring); 
 }
 
 //=======================================================================================
@@ -257,6 +257,15 @@ void hd44780u_controller(void)
     // Local variables 
     hd44780u_states_t next_state = hd44780u_device_trackers.state; 
 
+    // The screen only uses the I2C bus when it's idle so screen writes never hold up a 
+    // sensor read. The controller runs on a later call instead. 
+    if (!i2c_bus_idle())
+    {
+        return; 
+    }
+
+    i2c_bus_lock(); 
+
     // Check the driver status 
     hd44780u_device_trackers.fault_code |= hd44780u_get_status(); 
 
@@ -477,6 +486,8 @@ void hd44780u_controller(void)
     // Go to state function 
     (state_table[next_state])(&hd44780u_device_trackers); 
 
+    i2c_bus_unlock(); 
+
     // Update the state 
     hd44780u_device_trackers.state = next_state; 
 }
@@ -629,7 +640,9 @@ void hd44780u_clear_pwr_save_flag(void)
 void hd44780u_wake_up(void)
 {
     hd44780u_device_trackers.sleep_timer.time_start = SET_BIT; 
+    i2c_bus_lock(); 
     hd44780u_backlight_on(); 
+    i2c_bus_unlock(); 
 }
 
 
@@ -0,0 +1,522 @@
+/**
+ * @file i2c_bus.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief I2C bus manager 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include "i2c_bus.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define I2C_BUS_W_OFFSET 0               // Address offset for a write 
+#define I2C_BUS_R_OFFSET 1               // Address offset for a read 
+
+// Interrupts and DMA requests used by a transaction - off between transactions so 
+// blocking driver calls aren't interrupted 
+#define I2C_BUS_CR2_MASK (I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN | \
+                          I2C_CR2_DMAEN | I2C_CR2_LAST)
+
+// Error flags that end a transaction 
+#define I2C_BUS_ERR_MASK (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR) 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Enums 
+
+// Transaction steps 
+typedef enum {
+    I2C_BUS_PHASE_REG,         // Start, device address then register address 
+    I2C_BUS_PHASE_WRITE,       // Data written after the register address 
+    I2C_BUS_PHASE_READ         // Repeated start, device address then DMA read 
+} i2c_bus_phase_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Variables 
+
+// I2C bus trackers 
+typedef struct i2c_bus_trackers_s
+{
+    // Peripherals 
+    I2C_TypeDef *i2c;                           // I2C port 
+    DMA_TypeDef *dma;                           // DMA port of the RX stream 
+    DMA_Stream_TypeDef *dma_stream;             // RX DMA stream 
+    TIM_TypeDef *timer;                         // Timebase (NULL = none) 
+
+    // Standard mode timing the port was initialized with 
+    uint32_t ccr_sm;                            // Clock control 
+    uint32_t trise_sm;                          // Rise time 
+
+    // Queue 
+    i2c_bus_trans_t *volatile head;             // Next transaction (highest priority) 
+    i2c_bus_trans_t *volatile active;           // Transaction in flight 
+    volatile uint8_t phase;                     // Step of the transaction in flight 
+    uint16_t index;                             // Data bytes written 
+    volatile uint8_t locked;                    // Bus held by a blocking driver 
+    uint8_t speed;                              // Current bus speed 
+    uint16_t errors;                            // Failed transactions (wraps) 
+}
+i2c_bus_trackers_t; 
+
+
+// Instance of the bus trackers 
+static i2c_bus_trackers_t i2c_bus; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Function prototypes 
+
+/**
+ * @brief Start the next transaction 
+ * 
+ * @details Does nothing if a transaction is in flight, the bus is locked or the queue 
+ *          is empty. 
+ */
+void i2c_bus_start(void); 
+
+
+/**
+ * @brief Set the bus speed 
+ * 
+ * @details The port is disabled to change the timing so this is only done between 
+ *          transactions. 
+ * 
+ * @param speed : bus speed - i2c_bus_speed_t 
+ */
+void i2c_bus_set_speed(uint8_t speed); 
+
+
+/**
+ * @brief Start the read of the transaction in flight 
+ * 
+ * @details Called once the device address is sent after the repeated start. The DMA 
+ *          takes the data and the LAST bit has the last byte not acknowledged. A single 
+ *          byte isn't acknowledged and is stopped right away. 
+ * 
+ * @param trans : transaction in flight 
+ */
+void i2c_bus_read_start(i2c_bus_trans_t *trans); 
+
+
+/**
+ * @brief Finish the transaction in flight 
+ * 
+ * @details Calls the transaction callback then starts the next transaction. 
+ * 
+ * @param status : transaction status - i2c_bus_status_t 
+ */
+void i2c_bus_finish(uint8_t status); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Control functions 
+
+// I2C bus manager initialization 
+void i2c_bus_init(
+    I2C_TypeDef *i2c, 
+    DMA_TypeDef *dma, 
+    DMA_Stream_TypeDef *dma_stream, 
+    TIM_TypeDef *timer)
+{
+    if ((i2c == NULL) || (dma == NULL) || (dma_stream == NULL))
+    {
+        return; 
+    }
+
+    i2c_bus.i2c = i2c; 
+    i2c_bus.dma = dma; 
+    i2c_bus.dma_stream = dma_stream; 
+    i2c_bus.timer = timer; 
+
+    i2c_bus.ccr_sm = i2c->CCR; 
+    i2c_bus.trise_sm = i2c->TRISE; 
+
+    i2c_bus.head = NULL; 
+    i2c_bus.active = NULL; 
+    i2c_bus.phase = I2C_BUS_PHASE_REG; 
+    i2c_bus.index = CLEAR; 
+    i2c_bus.locked = CLEAR_BIT; 
+    i2c_bus.speed = I2C_BUS_SM; 
+    i2c_bus.errors = CLEAR; 
+
+    i2c->CR2 &= ~I2C_BUS_CR2_MASK; 
+
+    dma_int_config(
+        dma_stream, 
+        DMA_TCIE_ENABLE, 
+        DMA_HTIE_DISABLE, 
+        DMA_TEIE_ENABLE, 
+        DMA_DMEIE_DISABLE); 
+}
+
+
+// Post a transaction 
+uint8_t i2c_bus_post(i2c_bus_trans_t *trans)
+{
+    i2c_bus_trans_t **link = (i2c_bus_trans_t **)&i2c_bus.head; 
+    uint32_t primask; 
+
+    if ((trans == NULL) || (i2c_bus.i2c == NULL) || 
+        (trans->len && (trans->data == NULL)) || 
+        ((trans->dir == I2C_BUS_READ) && !trans->len))
+    {
+        return FALSE; 
+    }
+
+    // The queue is shared with the interrupts 
+    primask = __get_PRIMASK(); 
+    __disable_irq(); 
+
+    if ((trans->status == I2C_BUS_QUEUED) || (trans->status == I2C_BUS_BUSY))
+    {
+        __set_PRIMASK(primask); 
+        return FALSE; 
+    }
+
+    // After the transactions of the same or higher priority 
+    while ((*link != NULL) && ((*link)->prio <= trans->prio))
+    {
+        link = &(*link)->next; 
+    }
+
+    trans->status = I2C_BUS_QUEUED; 
+    trans->next = *link; 
+    *link = trans; 
+
+    __set_PRIMASK(primask); 
+
+    i2c_bus_start(); 
+
+    return TRUE; 
+}
+
+
+// Check if the bus is idle 
+uint8_t i2c_bus_idle(void)
+{
+    return (i2c_bus.active == NULL) && (i2c_bus.head == NULL) && !i2c_bus.locked; 
+}
+
+
+// Get the timebase count 
+uint32_t i2c_bus_time(void)
+{
+    return (i2c_bus.timer != NULL) ? i2c_bus.timer->CNT : 0; 
+}
+
+
+// Lock the bus for blocking driver calls 
+void i2c_bus_lock(void)
+{
+    uint32_t timeout = I2C_BUS_TIMEOUT, primask; 
+
+    if (i2c_bus.i2c == NULL)
+    {
+        return; 
+    }
+
+    // Set first so the transaction in flight doesn't start the next one 
+    i2c_bus.locked = SET_BIT; 
+
+    while (i2c_bus.active != NULL)
+    {
+        if (!timeout--)
+        {
+            primask = __get_PRIMASK(); 
+            __disable_irq(); 
+
+            if (i2c_bus.active != NULL)
+            {
+                i2c_bus.dma_stream->CR &= ~DMA_SxCR_EN; 
+                i2c_bus.i2c->CR1 |= I2C_CR1_STOP; 
+                i2c_bus_finish(I2C_BUS_ERROR); 
+            }
+
+            __set_PRIMASK(primask); 
+        }
+    }
+
+    // Blocking drivers run in standard mode 
+    while (i2c_bus.i2c->CR1 & I2C_CR1_STOP); 
+    i2c_bus_set_speed(I2C_BUS_SM); 
+}
+
+
+// Unlock the bus 
+void i2c_bus_unlock(void)
+{
+    i2c_bus.locked = CLEAR_BIT; 
+    i2c_bus_start(); 
+}
+
+
+// Start the next transaction 
+void i2c_bus_start(void)
+{
+    I2C_TypeDef *i2c = i2c_bus.i2c; 
+    i2c_bus_trans_t *trans; 
+    uint32_t primask; 
+
+    // Only one caller (main code or the interrupts) can take the next transaction 
+    primask = __get_PRIMASK(); 
+    __disable_irq(); 
+
+    trans = i2c_bus.head; 
+
+    if ((i2c_bus.active != NULL) || i2c_bus.locked || (trans == NULL))
+    {
+        __set_PRIMASK(primask); 
+        return; 
+    }
+
+    i2c_bus.head = trans->next; 
+    trans->next = NULL; 
+    trans->status = I2C_BUS_BUSY; 
+    i2c_bus.active = trans; 
+
+    __set_PRIMASK(primask); 
+
+    // The stop condition of the last transaction has to go out before the next start 
+    while (i2c->CR1 & I2C_CR1_STOP); 
+    i2c_bus_set_speed(trans->speed); 
+
+    i2c_bus.phase = I2C_BUS_PHASE_REG; 
+    i2c_bus.index = CLEAR; 
+
+    i2c->CR2 |= I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN; 
+    i2c->CR1 |= I2C_CR1_START; 
+}
+
+
+// Set the bus speed 
+void i2c_bus_set_speed(uint8_t speed)
+{
+    I2C_TypeDef *i2c = i2c_bus.i2c; 
+
+    if (speed == i2c_bus.speed)
+    {
+        return; 
+    }
+
+    i2c->CR1 &= ~I2C_CR1_PE; 
+
+    if (speed == I2C_BUS_FM)
+    {
+        i2c->CCR = I2C_CCR_FS | I2C_BUS_CCR_FM; 
+        i2c->TRISE = I2C_BUS_TRISE_FM; 
+    }
+    else 
+    {
+        i2c->CCR = i2c_bus.ccr_sm; 
+        i2c->TRISE = i2c_bus.trise_sm; 
+    }
+
+    i2c->CR1 |= I2C_CR1_PE; 
+    i2c_bus.speed = speed; 
+}
+
+
+// Start the read of the transaction in flight 
+void i2c_bus_read_start(i2c_bus_trans_t *trans)
+{
+    I2C_TypeDef *i2c = i2c_bus.i2c; 
+    size_t
+    peripheral_addr = (size_t)(&i2c->DR), 
+    memory0_addr = (size_t)trans->data; 
+
+    dma_clear_int_flags(i2c_bus.dma); 
+    dma_stream_config(
+        i2c_bus.dma_stream, 
+        (uint32_t)peripheral_addr, 
+        (uint32_t)memory0_addr, 
+        CLEAR,                   // No second buffer 
+        trans->len); 
+    dma_stream_enable(i2c_bus.dma_stream); 
+
+    // The DMA transfer complete interrupt finishes the read so the events are turned off 
+    i2c->CR2 = (i2c->CR2 & ~(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN)) |
+               I2C_CR2_DMAEN | I2C_CR2_LAST; 
+
+    if (trans->len == BYTE_1)
+    {
+        i2c->CR1 &= ~I2C_CR1_ACK; 
+        dummy_read(i2c->SR2); 
+        i2c->CR1 |= I2C_CR1_STOP; 
+    }
+    else 
+    {
+        i2c->CR1 |= I2C_CR1_ACK; 
+        dummy_read(i2c->SR2); 
+    }
+}
+
+
+// Finish the transaction in flight 
+void i2c_bus_finish(uint8_t status)
+{
+    i2c_bus_trans_t *trans = i2c_bus.active; 
+
+    i2c_bus.i2c->CR2 &= ~I2C_BUS_CR2_MASK; 
+    i2c_bus.active = NULL; 
+
+    if (status == I2C_BUS_ERROR)
+    {
+        i2c_bus.errors++; 
+    }
+
+    trans->time = i2c_bus_time(); 
+    trans->status = status; 
+
+    if (trans->callback != NULL)
+    {
+        trans->callback(trans); 
+    }
+
+    i2c_bus_start(); 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Interrupt callbacks 
+
+// I2C event interrupt callback 
+void i2c_bus_ev_handler(void)
+{
+    I2C_TypeDef *i2c = i2c_bus.i2c; 
+    i2c_bus_trans_t *trans = i2c_bus.active; 
+    uint32_t sr1 = i2c->SR1; 
+
+    if (trans == NULL)
+    {
+        i2c->CR2 &= ~I2C_BUS_CR2_MASK; 
+        return; 
+    }
+
+    // Start condition sent - send the device address 
+    if (sr1 & I2C_SR1_SB)
+    {
+        i2c->DR = trans->addr + ((i2c_bus.phase == I2C_BUS_PHASE_READ) ? 
+                                 I2C_BUS_R_OFFSET : I2C_BUS_W_OFFSET); 
+    }
+
+    // Device address acknowledged 
+    else if (sr1 & I2C_SR1_ADDR)
+    {
+        if (i2c_bus.phase == I2C_BUS_PHASE_READ)
+        {
+            i2c_bus_read_start(trans); 
+        }
+        else 
+        {
+            dummy_read(i2c->SR2); 
+        }
+    }
+
+    // Data register empty - register address then the data to write 
+    else if ((i2c_bus.phase != I2C_BUS_PHASE_READ) && (sr1 & (I2C_SR1_TXE | I2C_SR1_BTF)))
+    {
+        if (i2c_bus.phase == I2C_BUS_PHASE_REG)
+        {
+            i2c->DR = trans->reg; 
+            i2c_bus.phase = I2C_BUS_PHASE_WRITE; 
+        }
+        else if ((trans->dir == I2C_BUS_WRITE) && (i2c_bus.index < trans->len))
+        {
+            i2c->DR = trans->data[i2c_bus.index++]; 
+        }
+        else if (sr1 & I2C_SR1_BTF)
+        {
+            // The last byte is out. A read restarts in read mode, a write is done. 
+            if (trans->dir == I2C_BUS_READ)
+            {
+                i2c_bus.phase = I2C_BUS_PHASE_READ; 
+                i2c->CR1 |= I2C_CR1_START; 
+            }
+            else 
+            {
+                i2c->CR1 |= I2C_CR1_STOP; 
+                i2c_bus_finish(I2C_BUS_DONE); 
+            }
+        }
+        else 
+        {
+            // Nothing left to write - wait for the last byte to go out 
+            i2c->CR2 &= ~I2C_CR2_ITBUFEN; 
+        }
+    }
+}
+
+
+// I2C error interrupt callback 
+void i2c_bus_er_handler(void)
+{
+    I2C_TypeDef *i2c = i2c_bus.i2c; 
+    uint32_t sr1 = i2c->SR1; 
+
+    // Error flags are cleared by writing zero 
+    i2c->SR1 = sr1 & ~I2C_BUS_ERR_MASK; 
+
+    if (!(sr1 & I2C_BUS_ERR_MASK) || (i2c_bus.active == NULL))
+    {
+        return; 
+    }
+
+    // The bus is released after a lost arbitration so only the other errors need a stop 
+    i2c_bus.dma_stream->CR &= ~DMA_SxCR_EN; 
+
+    if (!(sr1 & I2C_SR1_ARLO))
+    {
+        i2c->CR1 |= I2C_CR1_STOP; 
+    }
+
+    i2c_bus_finish(I2C_BUS_ERROR); 
+}
+
+
+// I2C RX DMA stream interrupt callback 
+void i2c_bus_dma_handler(void)
+{
+    I2C_TypeDef *i2c = i2c_bus.i2c; 
+    i2c_bus_trans_t *trans = i2c_bus.active; 
+
+    if ((trans == NULL) || (i2c_bus.phase != I2C_BUS_PHASE_READ))
+    {
+        return; 
+    }
+
+    // A single byte read was already stopped 
+    if (trans->len > BYTE_1)
+    {
+        i2c->CR1 |= I2C_CR1_STOP; 
+    }
+
+    i2c_bus_finish(dma_get_tc_status(i2c_bus.dma, i2c_bus.dma_stream) ? 
+                   I2C_BUS_DONE : I2C_BUS_ERROR); 
+}
+
+//=======================================================================================
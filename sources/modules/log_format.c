@@ -0,0 +1,292 @@
+/**
+ * @file log_format.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Data log text formatting 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include "log_format.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Variables 
+
+// Two digit lookup table - the digits of 'n' (0-99) start at index 2*n 
+static const char log_format_digits[] = 
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899"; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Number and string writers 
+
+// Write an unsigned 8-bit number 
+char *log_format_u8(
+    char *str, 
+    uint8_t value)
+{
+    return log_format_u16(str, value); 
+}
+
+
+// Write an unsigned 16-bit number 
+char *log_format_u16(
+    char *str, 
+    uint16_t value)
+{
+    // The number of digits is found first so the digits can be written from the end of 
+    // the number back to the start, two at a time. This takes one divide per two digits 
+    // instead of one per digit and needs no reversing. 
+
+    uint8_t len = (value >= 10000) ? 5 : (value >= 1000) ? 4 : (value >= 100) ? 3 : 
+                  (value >= 10) ? 2 : 1; 
+    char *end = str + len; 
+    uint16_t pair; 
+
+    *end = '\0'; 
+
+    while (value >= 100)
+    {
+        pair = (uint16_t)((value % 100) << 1); 
+        value /= 100; 
+        *(--end) = log_format_digits[pair + 1]; 
+        *(--end) = log_format_digits[pair]; 
+    }
+
+    if (value >= 10)
+    {
+        pair = (uint16_t)(value << 1); 
+        *(--end) = log_format_digits[pair + 1]; 
+        *(--end) = log_format_digits[pair]; 
+    }
+    else 
+    {
+        *(--end) = (char)('0' + value); 
+    }
+
+    return str + len; 
+}
+
+
+// Write an unsigned 32-bit number 
+char *log_format_u32(
+    char *str, 
+    uint32_t value)
+{
+    // Same as log_format_u16 but with up to 10 digits 
+
+    uint8_t len = 1; 
+    char *end; 
+    uint32_t pair; 
+
+    for (uint32_t limit = 10; (len < LOG_FORMAT_U32_MAX_LEN) && (value >= limit); 
+         limit *= 10)
+    {
+        len++; 
+    }
+
+    end = str + len; 
+    *end = '\0'; 
+
+    while (value >= 100)
+    {
+        pair = (value % 100) << 1; 
+        value /= 100; 
+        *(--end) = log_format_digits[pair + 1]; 
+        *(--end) = log_format_digits[pair]; 
+    }
+
+    if (value >= 10)
+    {
+        pair = value << 1; 
+        *(--end) = log_format_digits[pair + 1]; 
+        *(--end) = log_format_digits[pair]; 
+    }
+    else 
+    {
+        *(--end) = (char)('0' + value); 
+    }
+
+    return str + len; 
+}
+
+
+// Write a zero padded unsigned 32-bit number 
+char *log_format_u32_pad(
+    char *str, 
+    uint32_t value, 
+    uint8_t width)
+{
+    uint8_t len = 1; 
+
+    for (uint32_t limit = 10; (len < LOG_FORMAT_U32_MAX_LEN) && (value >= limit); 
+         limit *= 10)
+    {
+        len++; 
+    }
+
+    while (width-- > len)
+    {
+        *str++ = '0'; 
+    }
+
+    return log_format_u32(str, value); 
+}
+
+
+// Write a number in thousandths 
+char *log_format_milli(
+    char *str, 
+    uint32_t value)
+{
+    str = log_format_u32(str, value / 1000); 
+    str = log_format_char(str, '.'); 
+    return log_format_u32_pad(str, value % 1000, 3); 
+}
+
+
+// Write a GPS coordinate 
+char *log_format_coord(
+    char *str, 
+    int32_t value, 
+    uint8_t deg_len, 
+    char pos, 
+    char neg)
+{
+    // Minutes are kept in 1e-5 minute units. 1e-7 degrees is 6e-4 minutes so the 
+    // fraction of a degree is scaled by 60/100 (rounded). The largest fraction rounds 
+    // to 59.99999 minutes so rounding never carries into the degrees. 
+
+    uint32_t coord = (value < 0) ? (uint32_t)(-(int64_t)value) : (uint32_t)value; 
+    uint32_t deg = coord / LOG_FORMAT_COORD_SCALE; 
+    uint32_t min = ((coord % LOG_FORMAT_COORD_SCALE) * 60 + 50) / 100; 
+
+    str = log_format_u32_pad(str, deg, deg_len); 
+    str = log_format_u32_pad(str, min / 100000, 2); 
+    str = log_format_char(str, '.'); 
+    str = log_format_u32_pad(str, min % 100000, 5); 
+    return log_format_char(str, (value < 0) ? neg : pos); 
+}
+
+
+// Write a signed 16-bit number 
+char *log_format_i16(
+    char *str, 
+    int16_t value)
+{
+    if (value < 0)
+    {
+        *str++ = '-'; 
+        return log_format_u16(str, (uint16_t)(-(int32_t)value)); 
+    }
+
+    return log_format_u16(str, (uint16_t)value); 
+}
+
+
+// Write a string 
+char *log_format_str(
+    char *str, 
+    const char *src, 
+    uint16_t max_len)
+{
+    while (max_len-- && (*src != '\0'))
+    {
+        *str++ = *src++; 
+    }
+
+    *str = '\0'; 
+
+    return str; 
+}
+
+
+// Write a character 
+char *log_format_char(
+    char *str, 
+    char c)
+{
+    if (c != '\0')
+    {
+        *str++ = c; 
+    }
+
+    *str = '\0'; 
+
+    return str; 
+}
+
+
+// Write a field separator 
+char *log_format_sep(char *str)
+{
+    return log_format_str(str, mtbdl_data_log_sep, LOG_FORMAT_FIELD_LEN); 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Data log line writers 
+
+// Write the start of a data log line 
+char *log_format_line_start(
+    char *str, 
+    uint8_t trailmark, 
+    uint16_t fork, 
+    uint16_t shock)
+{
+    str = log_format_u8(str, trailmark); 
+    str = log_format_sep(str); 
+    str = log_format_u16(str, fork); 
+    str = log_format_sep(str); 
+    return log_format_u16(str, shock); 
+}
+
+
+// Write blank data log line fields 
+char *log_format_line_blank(
+    char *str, 
+    uint8_t fields)
+{
+    // The blank line string holds every field after the ADC data with no data so blank 
+    // fields are taken from the start of it. 
+    return log_format_str(str, mtbdl_data_log_blank, fields * LOG_FORMAT_FIELD_LEN); 
+}
+
+
+// Write the end of a data log line 
+char *log_format_line_end(
+    char *str, 
+    uint8_t fields)
+{
+    // The end of the blank line string holds the last fields and the line ending 
+    return log_format_str(
+        str, 
+        &mtbdl_data_log_blank[(LOG_FORMAT_LINE_FIELDS - fields) * LOG_FORMAT_FIELD_LEN], 
+        UINT16_MAX); 
+}
+
+//=======================================================================================
@@ -0,0 +1,253 @@
+/**
+ * @file log_pack.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Packed ADC samples 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include "log_pack.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define LOG_PACK_VARINT_BITS 7           // Number bits in each varint byte 
+#define LOG_PACK_VARINT_MASK 0x7F        // Number bits of a varint byte 
+#define LOG_PACK_VARINT_MORE 0x80        // More bytes follow flag of a varint byte 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Value encoding 
+
+// Zig-zag encode a signed number 
+uint32_t log_pack_zigzag(int32_t value)
+{
+    // The sign is moved to the lowest bit. Shifting a negative number right fills it 
+    // with 1s so the other bits are inverted for negative numbers. 
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31); 
+}
+
+
+// Zig-zag decode a number 
+int32_t log_unpack_zigzag(uint32_t value)
+{
+    return (int32_t)((value >> 1) ^ (~(value & 1) + 1)); 
+}
+
+
+// Write a varint 
+uint8_t *log_pack_varint(
+    uint8_t *buff, 
+    uint32_t value)
+{
+    while (value > LOG_PACK_VARINT_MASK)
+    {
+        *buff++ = (uint8_t)(value & LOG_PACK_VARINT_MASK) | LOG_PACK_VARINT_MORE; 
+        value >>= LOG_PACK_VARINT_BITS; 
+    }
+
+    *buff++ = (uint8_t)value; 
+
+    return buff; 
+}
+
+
+// Read a varint 
+const uint8_t *log_unpack_varint(
+    const uint8_t *buff, 
+    const uint8_t *end, 
+    uint32_t *value)
+{
+    uint32_t result = 0; 
+
+    for (uint8_t i = 0; (i < LOG_PACK_VARINT_MAX_LEN) && (buff < end); i++)
+    {
+        uint8_t byte = *buff++; 
+
+        result |= (uint32_t)(byte & LOG_PACK_VARINT_MASK) << (i * LOG_PACK_VARINT_BITS); 
+
+        if (!(byte & LOG_PACK_VARINT_MORE))
+        {
+            *value = result; 
+            return buff; 
+        }
+    }
+
+    return NULL; 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Packing 
+
+// Initialize packing 
+void log_pack_init(
+    log_pack_t *pack, 
+    uint8_t key_period)
+{
+    memset((void *)pack, 0, sizeof(log_pack_t)); 
+    pack->key_period = key_period ? key_period : 1; 
+    pack->trailmark = LOG_REC_NO_TRAILMARK; 
+}
+
+
+// Add a sample to the block 
+void log_pack_sample(
+    log_pack_t *pack, 
+    const uint16_t *sample, 
+    uint8_t trailmark)
+{
+    if (pack->count >= LOG_PACK_MAX_SAMPLES)
+    {
+        return; 
+    }
+
+    uint8_t *data = &pack->data[pack->size]; 
+
+    // A keyframe starts with its sample index and resets the predictor so its first 
+    // sample is written as is. 
+    if ((pack->count == 0) && (pack->key_count == 0))
+    {
+        data = log_pack_varint(data, pack->index); 
+        memset((void *)pack->prev, 0, sizeof(pack->prev)); 
+    }
+
+    for (uint8_t i = 0; i < LOG_REC_PACK_CHANNELS; i++)
+    {
+        int32_t delta = (int32_t)sample[i] - (int32_t)pack->prev[i]; 
+        data = log_pack_varint(data, log_pack_zigzag(delta)); 
+        pack->prev[i] = sample[i]; 
+    }
+
+    if (trailmark)
+    {
+        pack->trailmark = pack->count; 
+    }
+
+    pack->size = (uint16_t)(data - pack->data); 
+    pack->count++; 
+    pack->index++; 
+}
+
+
+// Finish the block 
+uint16_t log_pack_block(
+    log_pack_t *pack, 
+    uint8_t *buff)
+{
+    if (pack->count == 0)
+    {
+        return 0; 
+    }
+
+    log_rec_adc_pack_t record = 
+    {
+        .tag = (pack->key_count == 0) ? LOG_REC_ADC_KEY : LOG_REC_ADC_DELTA, 
+        .count = pack->count, 
+        .trailmark = pack->trailmark, 
+        .size = pack->size 
+    }; 
+
+    memcpy((void *)buff, (void *)&record, sizeof(record)); 
+    memcpy((void *)&buff[sizeof(record)], (void *)pack->data, pack->size); 
+
+    if (++pack->key_count >= pack->key_period)
+    {
+        pack->key_count = 0; 
+    }
+
+    uint16_t size = (uint16_t)(sizeof(record) + pack->size); 
+
+    pack->size = 0; 
+    pack->count = 0; 
+    pack->trailmark = LOG_REC_NO_TRAILMARK; 
+
+    return size; 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Unpacking 
+
+// Initialize unpacking 
+void log_unpack_init(log_unpack_t *unpack)
+{
+    memset((void *)unpack, 0, sizeof(log_unpack_t)); 
+}
+
+
+// Unpack a block 
+int log_unpack_block(
+    log_unpack_t *unpack, 
+    const log_rec_adc_pack_t *record, 
+    const uint8_t *data, 
+    uint16_t (*samples)[LOG_REC_PACK_CHANNELS])
+{
+    const uint8_t *end = data + record->size; 
+    uint32_t value; 
+
+    if (record->count > LOG_PACK_MAX_SAMPLES)
+    {
+        return -1; 
+    }
+
+    if (record->tag == LOG_REC_ADC_KEY)
+    {
+        if ((data = log_unpack_varint(data, end, &value)) == NULL)
+        {
+            return -1; 
+        }
+
+        unpack->index = value; 
+        unpack->synced = 1; 
+        memset((void *)unpack->prev, 0, sizeof(unpack->prev)); 
+    }
+    else if ((record->tag != LOG_REC_ADC_DELTA) || !unpack->synced)
+    {
+        return -1; 
+    }
+
+    for (uint8_t i = 0; i < record->count; i++)
+    {
+        for (uint8_t j = 0; j < LOG_REC_PACK_CHANNELS; j++)
+        {
+            if ((data = log_unpack_varint(data, end, &value)) == NULL)
+            {
+                return -1; 
+            }
+
+            unpack->prev[j] = (uint16_t)(unpack->prev[j] + log_unpack_zigzag(value)); 
+            samples[i][j] = unpack->prev[j]; 
+        }
+    }
+
+    // All the packed data must be used 
+    if (data != end)
+    {
+        return -1; 
+    }
+
+    unpack->index += record->count; 
+
+    return record->count; 
+}
+
+//=======================================================================================
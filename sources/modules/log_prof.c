@@ -0,0 +1,152 @@
+/**
+ * @file log_prof.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Execution time profiling 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include "log_prof.h"
+#include "string_config.h"
+
+#include <stdio.h>
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Variables 
+
+// Histograms 
+static log_prof_hist_t log_prof_hist[LOG_PROF_NUM]; 
+
+
+// Histogram names - must be in the same order as log_prof_id_t 
+static const char *const log_prof_names[LOG_PROF_NUM] = 
+{
+    "standard", 
+    "gps", 
+    "accel", 
+    "speed", 
+    "imu", 
+    "sd_write", 
+    "sd_puts", 
+    "sd_sync", 
+    "hd44780u", 
+    "sd_ctrl", 
+    "mpu6050", 
+    "m8q"
+}; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Histograms 
+
+// Clear every histogram 
+void log_prof_reset(void)
+{
+    memset((void *)log_prof_hist, 0, sizeof(log_prof_hist)); 
+}
+
+
+// Get the histogram bin of a time 
+uint8_t log_prof_bin(uint32_t cycles)
+{
+    uint32_t us = cycles / LOG_PROF_CLOCK_MHZ; 
+    uint8_t bin = 0; 
+
+    while (us && (bin < (LOG_PROF_NUM_BINS - 1)))
+    {
+        us >>= 1; 
+        bin++; 
+    }
+
+    return bin; 
+}
+
+
+// Record a time 
+void log_prof_record(
+    log_prof_id_t id, 
+    uint32_t cycles)
+{
+    if (id >= LOG_PROF_NUM)
+    {
+        return; 
+    }
+
+    log_prof_hist_t *hist = &log_prof_hist[id]; 
+    uint32_t *bin = &hist->bins[log_prof_bin(cycles)]; 
+
+    if (hist->count < UINT32_MAX)
+    {
+        hist->count++; 
+    }
+
+    if (*bin < UINT32_MAX)
+    {
+        (*bin)++; 
+    }
+
+    if (cycles > hist->max)
+    {
+        hist->max = cycles; 
+    }
+}
+
+
+// Get a histogram 
+const log_prof_hist_t *log_prof_get(log_prof_id_t id)
+{
+    return (id < LOG_PROF_NUM) ? &log_prof_hist[id] : NULL; 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Log footer 
+
+// Write a histogram as a log footer line 
+uint16_t log_prof_format(
+    char *str, 
+    uint16_t len, 
+    log_prof_id_t id)
+{
+    if (id >= LOG_PROF_NUM)
+    {
+        return 0; 
+    }
+
+    const log_prof_hist_t *hist = &log_prof_hist[id]; 
+    int size = snprintf(str, len, "%s%s%lu%s%lu", 
+                        log_prof_names[id], 
+                        mtbdl_data_log_sep, (unsigned long)hist->count, 
+                        mtbdl_data_log_sep, (unsigned long)(hist->max / LOG_PROF_CLOCK_MHZ)); 
+
+    for (uint8_t i = 0; (i < LOG_PROF_NUM_BINS) && (size >= 0) && (size < len); i++)
+    {
+        size += snprintf(&str[size], len - size, "%s%lu", 
+                         mtbdl_data_log_sep, (unsigned long)hist->bins[i]); 
+    }
+
+    if ((size >= 0) && (size < len))
+    {
+        size += snprintf(&str[size], len - size, "\r\n"); 
+    }
+
+    return ((size >= 0) && (size < len)) ? (uint16_t)size : 0; 
+}
+
+//=======================================================================================
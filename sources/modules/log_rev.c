@@ -0,0 +1,120 @@
+/**
+ * @file log_rev.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Wheel revolution capture 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include "log_rev.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Functions 
+
+// Initialize revolution capture data 
+void log_rev_init(
+    log_rev_t *rev, 
+    const volatile uint32_t *buff, 
+    uint16_t size)
+{
+    rev->buff = buff; 
+    rev->size = size; 
+    log_rev_reset(rev, 0); 
+}
+
+
+// Reset the revolution period 
+void log_rev_reset(
+    log_rev_t *rev, 
+    uint16_t head)
+{
+    rev->tail = (head < rev->size) ? head : 0; 
+    rev->last = 0; 
+    rev->period = 0; 
+    rev->edges = 0; 
+}
+
+
+// Read new revolution timestamps 
+uint16_t log_rev_update(
+    log_rev_t *rev, 
+    uint16_t head, 
+    uint32_t *periods, 
+    uint16_t max)
+{
+    uint16_t revs = 0; 
+
+    if (head >= rev->size)
+    {
+        head = 0; 
+    }
+
+    while ((rev->tail != head) && ((periods == NULL) || (revs < max)))
+    {
+        uint32_t time = rev->buff[rev->tail]; 
+        uint32_t period = time - rev->last; 
+
+        if (++rev->tail >= rev->size)
+        {
+            rev->tail = 0; 
+        }
+
+        if (!rev->edges)
+        {
+            rev->edges++; 
+            rev->last = time; 
+            continue; 
+        }
+
+        if (period < LOG_REV_MIN_PERIOD)
+        {
+            continue; 
+        }
+
+        // An edge after a stop only restarts the period 
+        rev->period = (period < LOG_REV_STOP_TIME) ? period : 0; 
+        rev->edges = rev->period ? 2 : 1; 
+        rev->last = time; 
+
+        if (rev->period)
+        {
+            if (periods != NULL)
+            {
+                periods[revs] = rev->period; 
+            }
+            revs++; 
+        }
+    }
+
+    return revs; 
+}
+
+
+// Get the revolution period 
+uint32_t log_rev_period(
+    const log_rev_t *rev, 
+    uint32_t now)
+{
+    uint32_t since = now - rev->last; 
+
+    if ((rev->edges < 2) || (since >= LOG_REV_STOP_TIME))
+    {
+        return 0; 
+    }
+
+    return (since > rev->period) ? since : rev->period; 
+}
+
+//=======================================================================================
@@ -0,0 +1,151 @@
+/**
+ * @file log_ring.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Single producer single consumer sample ring 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include "log_ring.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Initialization 
+
+// Initialize a ring 
+uint8_t log_ring_init(
+    log_ring_t *ring, 
+    void *buff, 
+    uint32_t item_size, 
+    uint32_t size)
+{
+    if ((ring == NULL) || (buff == NULL) || !LOG_RING_SIZE_VALID(size))
+    {
+        if (ring != NULL)
+        {
+            memset((void *)ring, CLEAR, sizeof(log_ring_t)); 
+        }
+        return FALSE; 
+    }
+
+    ring->buff = (uint8_t *)buff; 
+    ring->item_size = item_size; 
+    ring->size = size; 
+    ring->mask = size - 1; 
+    log_ring_reset(ring); 
+
+    return TRUE; 
+}
+
+
+// Reset a ring 
+void log_ring_reset(log_ring_t *ring)
+{
+    ring->head = CLEAR; 
+    ring->tail = CLEAR; 
+    ring->hwm = CLEAR; 
+    ring->drops = CLEAR; 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Producer / consumer 
+
+// Push an item onto a ring 
+uint8_t log_ring_push(
+    log_ring_t *ring, 
+    const void *item)
+{
+    // The producer owns the head so it can be read without ordering. The tail must be 
+    // read with acquire ordering so the consumer is done with a slot before it's 
+    // overwritten. 
+    uint32_t head = ring->head; 
+    uint32_t count = head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE); 
+
+    if (count >= ring->size)
+    {
+        ring->drops++; 
+        return FALSE; 
+    }
+
+    memcpy((void *)&ring->buff[(head & ring->mask) * ring->item_size], 
+           item, 
+           ring->item_size); 
+
+    // Publish the item. Release ordering makes sure the copy above is complete before 
+    // the consumer can see the new head. 
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE); 
+
+    if (++count > ring->hwm)
+    {
+        ring->hwm = count; 
+    }
+
+    return TRUE; 
+}
+
+
+// Pop an item from a ring 
+uint8_t log_ring_pop(
+    log_ring_t *ring, 
+    void *item)
+{
+    uint32_t tail = ring->tail; 
+
+    if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == tail)
+    {
+        return FALSE; 
+    }
+
+    memcpy(item, 
+           (void *)&ring->buff[(tail & ring->mask) * ring->item_size], 
+           ring->item_size); 
+
+    // Free the slot. Release ordering makes sure the copy above is complete before the 
+    // producer can reuse the slot. 
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE); 
+
+    return TRUE; 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Getters 
+
+// Get the number of items in a ring 
+uint32_t log_ring_get_count(log_ring_t *ring)
+{
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - 
+           __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE); 
+}
+
+
+// Get the ring high water mark 
+uint32_t log_ring_get_hwm(log_ring_t *ring)
+{
+    return ring->hwm; 
+}
+
+
+// Get the ring drop count 
+uint32_t log_ring_get_drops(log_ring_t *ring)
+{
+    return ring->drops; 
+}
+
+//=======================================================================================
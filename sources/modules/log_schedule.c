@@ -0,0 +1,189 @@
+/**
+ * @file log_schedule.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Log stream schedule 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include "log_schedule.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Schedule checks 
+
+// Per stream checks - each row of the table must be valid on its own 
+#define LOG_SCHED_CHECK(stream, offset, period, cost, share) \
+    _Static_assert((period) >= 1 && (period) <= 255, \
+                   #stream " stream period must be 1-255 slots"); \
+    _Static_assert((offset) < (period), \
+                   #stream " stream offset must be less than its period"); \
+    _Static_assert((cost) <= LOG_SLOT_BUDGET, \
+                   #stream " stream cost doesn't fit in LOG_SLOT_BUDGET"); \
+    _Static_assert(((share) == 0) || ((share) == 1), \
+                   #stream " stream share must be 0 or 1"); 
+
+LOG_SCHEDULE(LOG_SCHED_CHECK)
+
+// Stream sets are kept in 8 bits 
+_Static_assert(LOG_SCHED_NUM <= 8, "Too many log streams for a stream set"); 
+
+// Every stream must be in the hyperperiod and every pair of streams must be checked 
+_Static_assert(LOG_SCHED_HYPER_STREAMS == (LOG_SCHED_NUM - 1), 
+               "A log stream is missing from the hyperperiod (log_schedule.h)"); 
+_Static_assert(LOG_SCHED_PAIRS == ((LOG_SCHED_NUM - 1) * (LOG_SCHED_NUM - 2) / 2), 
+               "A log stream pair is missing from the collision checks (log_schedule.h)"); 
+
+// Collisions - streams are only due in the same slot if they're allowed to share it 
+_Static_assert(LOG_SCHED_COLLISIONS == 0, 
+               "Log streams are due in the same slot but aren't allowed to share it"); 
+
+// Worst case slot work. A slot never runs more than LOG_SLOT_BUDGET of streams (costs 
+// are checked above and the selection stops at the budget), but over a hyperperiod the 
+// streams must fit in the budget of all its slots, otherwise deferred streams pile up. 
+#define LOG_SCHED_WORK(stream, offset, period, cost, share) \
+    + ((uint64_t)(cost) * (LOG_SCHED_HYPERPERIOD / (period)))
+
+_Static_assert((0 LOG_SCHEDULE(LOG_SCHED_WORK)) <= 
+               ((uint64_t)LOG_SLOT_BUDGET * LOG_SCHED_HYPERPERIOD), 
+               "The log streams need more time than LOG_SLOT_BUDGET gives each slot"); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// Schedule table entry 
+typedef struct log_sched_entry_s
+{
+    uint8_t offset;                             // Counter starting value 
+    uint8_t period;                             // Counter period (slots) 
+    uint16_t cost;                              // (us) Worst case stream time 
+}
+log_sched_entry_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Variables 
+
+// Schedule table by stream (the standard stream runs when no other stream needs to run 
+// so it doesn't need a period, offset or cost) 
+#define LOG_SCHED_ENTRY(stream, offset, period, cost, share) \
+    [LOG_SCHED_##stream] = { (offset), (period), (cost) }, 
+
+static const log_sched_entry_t log_sched_table[LOG_SCHED_NUM] = 
+{
+    [LOG_SCHED_STANDARD] = { 0, 0, 0 }, 
+    LOG_SCHEDULE(LOG_SCHED_ENTRY)
+}; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Functions 
+
+// Initialize the schedule 
+void log_schedule_init(log_schedule_t *sched)
+{
+    for (uint8_t i = 0; i < LOG_SCHED_NUM; i++)
+    {
+        sched->counter[i] = log_sched_table[i].offset; 
+    }
+
+    sched->deferred = 0; 
+}
+
+
+// Pick the streams of a slot 
+uint8_t log_schedule_select(log_schedule_t *sched)
+{
+    // The counters of all streams are incremented together before the selection so 
+    // they're guaranteed to count and a deferred stream keeps its place in the schedule. 
+    uint8_t due = 0, deferred = sched->deferred, streams = 0; 
+    uint16_t budget = LOG_SLOT_BUDGET; 
+
+    for (uint8_t i = LOG_SCHED_STANDARD + 1; i < LOG_SCHED_NUM; i++)
+    {
+        if (log_schedule_due(sched, (log_sched_stream_t)i))
+        {
+            due |= LOG_SCHED_BIT(i); 
+        }
+    }
+
+    // Deferred streams are picked first so a stream is never deferred for long. Every 
+    // stream fits in an empty slot (checked at compile time). 
+    const uint8_t waiting[2] = { deferred, due }; 
+
+    for (uint8_t pass = 0; pass < 2; pass++)
+    {
+        for (uint8_t i = LOG_SCHED_STANDARD + 1; i < LOG_SCHED_NUM; i++)
+        {
+            uint8_t stream = LOG_SCHED_BIT(i); 
+
+            if ((waiting[pass] & stream) && !(streams & stream) && 
+                (log_sched_table[i].cost <= budget))
+            {
+                budget -= log_sched_table[i].cost; 
+                streams |= stream; 
+            }
+        }
+    }
+
+    sched->deferred = (deferred | due) & ~streams; 
+
+    return streams; 
+}
+
+
+// Count a slot for one stream 
+uint8_t log_schedule_due(
+    log_schedule_t *sched, 
+    log_sched_stream_t stream)
+{
+    if ((stream == LOG_SCHED_STANDARD) || (stream >= LOG_SCHED_NUM))
+    {
+        return 0; 
+    }
+
+    if (++sched->counter[stream] >= log_sched_table[stream].period)
+    {
+        sched->counter[stream] = 0; 
+        return 1; 
+    }
+
+    return 0; 
+}
+
+
+// Get the cost of a set of streams 
+uint32_t log_schedule_cost(uint8_t streams)
+{
+    uint32_t cost = 0; 
+
+    for (uint8_t i = LOG_SCHED_STANDARD + 1; i < LOG_SCHED_NUM; i++)
+    {
+        if (streams & LOG_SCHED_BIT(i))
+        {
+            cost += log_sched_table[i].cost; 
+        }
+    }
+
+    return cost; 
+}
+
+//=======================================================================================
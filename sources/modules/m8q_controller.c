@@ -27,6 +27,11 @@
 #define M8Q_LOW_PWR_EXIT_DELAY 150000   // time to wait when exiting low power mode (us) 
 #define M8Q_STATUS_FAULT_MASK 0x001A    // Identifies fault statuses - bitmask for m8q_status_t 
 
+// Data stream reads over the I2C bus (UBX NAV-PVT mode) 
+#define M8Q_I2C_ADDR 0x84               // Device I2C address (8-bit write address) 
+#define M8Q_DS_SIZE_REG 0xFD            // Data stream size register (high byte first) 
+#define M8Q_DS_REG 0xFF                 // Data stream register 
+
 //=======================================================================================
 
 
@@ -48,6 +53,27 @@ typedef struct m8q_trackers_s
     uint32_t time_cnt;                      // Time delay counter instance 
     uint8_t  time_start;                    // Time delay counter start flag 
 
+#if M8Q_UBX_NAV_PVT
+    // UBX NAV-PVT data 
+    m8q_ubx_t ubx;                          // UBX message parser 
+    uint8_t ubx_buff[M8Q_UBX_BUFF_SIZE];    // Data stream read buffer 
+
+    // The data stream is read in the background on the I2C bus. The transaction 
+    // callbacks run in the I2C interrupts. 
+    uint8_t ds_size[BYTE_2];                // Data stream size read buffer 
+    i2c_bus_trans_t size_trans;             // Data stream size read 
+    i2c_bus_trans_t ds_trans;               // Data stream read 
+    volatile uint8_t ds_busy;               // Data stream read in flight 
+    volatile uint8_t ds_fault;              // Data stream read failed 
+#endif
+
+    // Published fix. The sequence count is odd while the fix is being written. 
+    m8q_fix_t fix;                          // Last fix read from the device 
+    volatile uint32_t fix_seq;              // Fix sequence count 
+
+    // Set from the TX ready interrupt so it's kept out of the state flag bit fields 
+    volatile uint8_t data_ready;            // Device data ready flag 
+
     // State flags 
     uint8_t init          : 1;              // Init state trigger 
     uint8_t read          : 1;              // Read state trigger 
@@ -83,6 +109,60 @@ static m8q_trackers_t m8q_device_trackers;
 void m8q_fault_check(m8q_trackers_t *m8q_device); 
 
 
+/**
+ * @brief Publish the fix 
+ * 
+ * @details Copies the data just read from the device into the published fix. The fix 
+ *          sequence count is made odd before the copy and even again after it so a 
+ *          reader can tell if it copied the fix while it was being written. 
+ * 
+ * @see m8q_get_fix 
+ * 
+ * @param m8q_device : controller tracking information 
+ * @param time : I2C bus timebase count when the read finished 
+ */
+void m8q_fix_publish(
+    m8q_trackers_t *m8q_device, 
+    uint32_t time); 
+
+
+#if M8Q_UBX_NAV_PVT
+/**
+ * @brief Data stream size read callback 
+ * 
+ * @details Called from the I2C interrupts. Posts the data stream read if there's data. 
+ *          A stream larger than the buffer is read in more than one read. The TX ready 
+ *          pin stays set until the stream is read so the rest is read next time. 
+ * 
+ * @param trans : data stream size read transaction 
+ */
+void m8q_ds_size_cb(i2c_bus_trans_t *trans); 
+
+
+/**
+ * @brief Data stream read callback 
+ * 
+ * @details Called from the I2C interrupts. Parses the NAV-PVT messages out of the data 
+ *          read and publishes the fix if one was found. 
+ * 
+ * @param trans : data stream read transaction 
+ */
+void m8q_ds_read_cb(i2c_bus_trans_t *trans); 
+
+
+/**
+ * @brief Finish a data stream read 
+ * 
+ * @details The TX ready interrupt only happens on the rising edge of the pin so if the 
+ *          pin is still set (data came in during the read or the read failed) the data 
+ *          ready flag is set again so the rest is read next time. 
+ * 
+ * @param m8q_device : controller tracking information 
+ */
+void m8q_ds_read_done(m8q_trackers_t *m8q_device); 
+#endif
+
+
 /**
  * @brief M8Q controller initialization state 
  * 
@@ -101,10 +181,18 @@ void m8q_init_state(m8q_trackers_t *m8q_device);
 /**
  * @brief M8Q controller read state 
  * 
- * @details Checks the TX ready pin to see if the device has data waiting. If so then 
- *          the device driver read function is called to read and sort the data. This 
- *          state can be entered from the init, idle and low power exit states if the 
- *          read flag is set. 
+ * @details Reads the device once the TX ready interrupt has set the data ready flag. 
+ *          The device driver read function is called to read and sort the data and the 
+ *          new fix is published. The TX ready interrupt only happens on the rising edge 
+ *          of the pin, so if the pin is still set after reading (data came in during the 
+ *          read or the read failed) the flag is set again so the rest is read next time. 
+ *          This state can be entered from the init, idle and low power exit states if 
+ *          the read flag is set. 
+ * 
+ *          In UBX NAV-PVT mode the data stream is read as is and the controller parses 
+ *          the NAV-PVT messages out of it instead of the driver parsing text messages. 
+ *          The reads are posted to the I2C bus so this state returns right away and the 
+ *          fix is published from the read callback once the read finishes. 
  * 
  * @see m8q_set_read_flag 
  * 
@@ -247,6 +335,33 @@ void m8q_controller_init(TIM_TypeDef *timer)
     m8q_device_trackers.time_cnt_total = CLEAR; 
     m8q_device_trackers.time_cnt = CLEAR; 
     m8q_device_trackers.time_start = SET_BIT; 
+#if M8Q_UBX_NAV_PVT
+    m8q_ubx_init(&m8q_device_trackers.ubx); 
+
+    // Data stream reads. The device supports fast mode. 
+    m8q_device_trackers.size_trans = (i2c_bus_trans_t){
+        .addr = M8Q_I2C_ADDR, 
+        .reg = M8Q_DS_SIZE_REG, 
+        .dir = I2C_BUS_READ, 
+        .prio = I2C_BUS_PRIO_NORMAL, 
+        .speed = I2C_BUS_FM, 
+        .data = m8q_device_trackers.ds_size, 
+        .len = BYTE_2, 
+        .callback = m8q_ds_size_cb, 
+        .context = (void *)&m8q_device_trackers 
+    }; 
+
+    m8q_device_trackers.ds_trans = m8q_device_trackers.size_trans; 
+    m8q_device_trackers.ds_trans.reg = M8Q_DS_REG; 
+    m8q_device_trackers.ds_trans.data = m8q_device_trackers.ubx_buff; 
+    m8q_device_trackers.ds_trans.callback = m8q_ds_read_cb; 
+    m8q_device_trackers.ds_busy = CLEAR; 
+    m8q_device_trackers.ds_fault = CLEAR; 
+#endif
+    memset((void *)&m8q_device_trackers.fix, CLEAR, sizeof(m8q_fix_t)); 
+    m8q_device_trackers.fix.navstat = (uint16_t)(('N' << SHIFT_8) | 'F');   // No fix 
+    m8q_device_trackers.fix_seq = CLEAR; 
+    m8q_device_trackers.data_ready = CLEAR; 
 
     // State flags 
     m8q_device_trackers.init = SET_BIT; 
@@ -394,6 +509,97 @@ void m8q_fault_check(m8q_trackers_t *m8q_device)
     m8q_device->device_status = CLEAR; 
 }
 
+
+// Publish the fix 
+void m8q_fix_publish(
+    m8q_trackers_t *m8q_device, 
+    uint32_t time)
+{
+    m8q_fix_t *fix = &m8q_device->fix; 
+
+    m8q_device->fix_seq++; 
+    __DMB(); 
+
+    fix->time = time; 
+
+#if M8Q_UBX_NAV_PVT
+    memcpy((void *)&fix->pvt, (void *)&m8q_device->ubx.pvt, sizeof(fix->pvt)); 
+    fix->navstat = m8q_ubx_navstat(&fix->pvt); 
+    fix->lock = m8q_ubx_navstat_lock(&fix->pvt); 
+#else
+    m8q_get_position_lat_str(fix->lat_str, M8Q_FIX_STR_LEN); 
+    fix->NS = m8q_get_position_NS(); 
+    m8q_get_position_lon_str(fix->lon_str, M8Q_FIX_STR_LEN); 
+    fix->EW = m8q_get_position_EW(); 
+    m8q_get_position_sog_str(fix->sog_str, M8Q_FIX_STR_LEN); 
+    m8q_get_time_utc_time(fix->utc_time, M8Q_FIX_TIME_LEN); 
+    m8q_get_time_utc_date(fix->utc_date, M8Q_FIX_TIME_LEN); 
+    fix->navstat = m8q_get_position_navstat(); 
+    fix->lock = m8q_get_position_navstat_lock(); 
+#endif
+
+    __DMB(); 
+    m8q_device->fix_seq++; 
+}
+
+
+#if M8Q_UBX_NAV_PVT
+// Data stream size read callback 
+void m8q_ds_size_cb(i2c_bus_trans_t *trans)
+{
+    m8q_trackers_t *m8q_device = (m8q_trackers_t *)trans->context; 
+    uint16_t stream_size = 
+        (uint16_t)((m8q_device->ds_size[BYTE_0] << SHIFT_8) | m8q_device->ds_size[BYTE_1]); 
+
+    if (trans->status != I2C_BUS_DONE)
+    {
+        m8q_device->ds_fault = SET_BIT; 
+    }
+    else if (stream_size)
+    {
+        m8q_device->ds_trans.len = (stream_size > M8Q_UBX_BUFF_SIZE) ? 
+                                   M8Q_UBX_BUFF_SIZE : stream_size; 
+
+        if (i2c_bus_post(&m8q_device->ds_trans))
+        {
+            return; 
+        }
+    }
+
+    m8q_ds_read_done(m8q_device); 
+}
+
+
+// Data stream read callback 
+void m8q_ds_read_cb(i2c_bus_trans_t *trans)
+{
+    m8q_trackers_t *m8q_device = (m8q_trackers_t *)trans->context; 
+
+    if (trans->status != I2C_BUS_DONE)
+    {
+        m8q_device->ds_fault = SET_BIT; 
+    }
+    else if (m8q_ubx_parse(&m8q_device->ubx, m8q_device->ubx_buff, trans->len))
+    {
+        m8q_fix_publish(m8q_device, trans->time); 
+    }
+
+    m8q_ds_read_done(m8q_device); 
+}
+
+
+// Finish a data stream read 
+void m8q_ds_read_done(m8q_trackers_t *m8q_device)
+{
+    m8q_device->ds_busy = CLEAR; 
+
+    if (m8q_get_tx_ready())
+    {
+        m8q_device->data_ready = SET_BIT; 
+    }
+}
+#endif
+
 //=======================================================================================
 
 
@@ -405,18 +611,71 @@ void m8q_init_state(m8q_trackers_t *m8q_device)
 {
     m8q_device->init = CLEAR_BIT; 
     m8q_device->reset = CLEAR_BIT; 
+
+    // The pin may already be set with no edge to come so the first read checks it 
+    m8q_device->data_ready = SET_BIT; 
 }
 
 
 // Read state 
 void m8q_read_state(m8q_trackers_t *m8q_device)
 {
+#if M8Q_UBX_NAV_PVT
+    // A failed read in the background is checked the same as a failed driver read 
+    if (m8q_device->ds_fault)
+    {
+        m8q_device->ds_fault = CLEAR; 
+        m8q_device_trackers.device_status = (SET_BIT << M8Q_READ_FAULT); 
+    }
+
+    // The read callback checks the pin again once the read in flight is done 
+    if (!m8q_device->data_ready || m8q_device->ds_busy)
+    {
+        return; 
+    }
+#else
     M8Q_STATUS read_status; 
+    uint32_t read_time; 
+
+    if (!m8q_device->data_ready)
+    {
+        return; 
+    }
+#endif
+
+    // Cleared before the read so an interrupt during the read isn't lost 
+    m8q_device->data_ready = CLEAR; 
 
     if (m8q_get_tx_ready())
     {
+#if M8Q_UBX_NAV_PVT
+        // The stream size is read first so only the bytes in the stream are read and 
+        // parsed. 
+        m8q_device->ds_busy = SET_BIT; 
+
+        if (!i2c_bus_post(&m8q_device->size_trans))
+        {
+            m8q_device->ds_busy = CLEAR; 
+            m8q_device->data_ready = SET_BIT; 
+        }
+#else
+        i2c_bus_lock(); 
         read_status = m8q_read_data(); 
+        read_time = i2c_bus_time(); 
+        i2c_bus_unlock(); 
+
+        if (read_status == M8Q_OK)
+        {
+            m8q_fix_publish(m8q_device, read_time); 
+        }
+
         m8q_device_trackers.device_status = (SET_BIT << read_status); 
+
+        if (m8q_get_tx_ready())
+        {
+            m8q_device->data_ready = SET_BIT; 
+        }
+#endif
     }
 }
 
@@ -462,7 +721,9 @@ void m8q_low_pwr_exit_state(m8q_trackers_t *m8q_device)
     // the state. 
     if (exit_flag)
     {
+        i2c_bus_lock(); 
         read_status = m8q_read_ds(&dummy_buff, BYTE_1); 
+        i2c_bus_unlock(); 
         m8q_device_trackers.device_status = (SET_BIT << read_status); 
         exit_flag = CLEAR; 
 
@@ -558,4 +819,59 @@ M8Q_FAULT_CODE m8q_get_fault_code(void)
     return m8q_device_trackers.fault_code; 
 }
 
+
+// Get the navigation status 
+uint16_t m8q_get_navstat(void)
+{
+    // Single aligned fields are read whole so they don't need the sequence check 
+    return m8q_device_trackers.fix.navstat; 
+}
+
+
+// Get the navigation status lock 
+uint8_t m8q_get_navstat_lock(void)
+{
+    return m8q_device_trackers.fix.lock; 
+}
+
+
+// Get the data ready flag 
+uint8_t m8q_get_data_ready(void)
+{
+    return m8q_device_trackers.data_ready; 
+}
+
+
+// Get the last GPS fix 
+void m8q_get_fix(m8q_fix_t *fix)
+{
+    uint32_t seq; 
+
+    if (fix == NULL)
+    {
+        return; 
+    }
+
+    do
+    {
+        seq = m8q_device_trackers.fix_seq; 
+        __DMB(); 
+        memcpy((void *)fix, (void *)&m8q_device_trackers.fix, sizeof(m8q_fix_t)); 
+        __DMB(); 
+    }
+    while ((seq & SET_BIT) || (seq != m8q_device_trackers.fix_seq)); 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Interrupt callbacks 
+
+// TX ready interrupt callback 
+void m8q_txr_handler(void)
+{
+    m8q_device_trackers.data_ready = SET_BIT; 
+}
+
 //=======================================================================================
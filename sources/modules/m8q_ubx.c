@@ -0,0 +1,224 @@
+/**
+ * @file m8q_ubx.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief SAM-M8Q UBX message parser 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include "m8q_ubx.h"
+
+#include <string.h>
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Enums 
+
+// Parser states - the part of the message expected next 
+typedef enum {
+    M8Q_UBX_STATE_SYNC_1, 
+    M8Q_UBX_STATE_SYNC_2, 
+    M8Q_UBX_STATE_CLASS, 
+    M8Q_UBX_STATE_ID, 
+    M8Q_UBX_STATE_LEN_1, 
+    M8Q_UBX_STATE_LEN_2, 
+    M8Q_UBX_STATE_PAYLOAD, 
+    M8Q_UBX_STATE_CK_A, 
+    M8Q_UBX_STATE_CK_B
+} m8q_ubx_state_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Function prototypes 
+
+/**
+ * @brief Check if the message being read is NAV-PVT 
+ * 
+ * @param ubx : UBX parser data 
+ * @return uint8_t : 1 if the class, ID and length match NAV-PVT, 0 otherwise 
+ */
+uint8_t m8q_ubx_is_pvt(const m8q_ubx_t *ubx); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Functions 
+
+// Initialize the UBX parser 
+void m8q_ubx_init(m8q_ubx_t *ubx)
+{
+    memset((void *)ubx, 0, sizeof(m8q_ubx_t)); 
+    ubx->state = M8Q_UBX_STATE_SYNC_1; 
+}
+
+
+// Parse bytes read from the data stream 
+uint8_t m8q_ubx_parse(
+    m8q_ubx_t *ubx, 
+    const uint8_t *data, 
+    uint16_t len)
+{
+    uint8_t found = 0; 
+
+    while (len--)
+    {
+        uint8_t byte = *data++; 
+
+        // The checksum covers the class, ID, length and payload 
+        if ((ubx->state >= M8Q_UBX_STATE_CLASS) && (ubx->state <= M8Q_UBX_STATE_PAYLOAD))
+        {
+            ubx->ck_a += byte; 
+            ubx->ck_b += ubx->ck_a; 
+        }
+
+        switch (ubx->state)
+        {
+            case M8Q_UBX_STATE_SYNC_1: 
+                if (byte == M8Q_UBX_SYNC_1)
+                {
+                    ubx->state = M8Q_UBX_STATE_SYNC_2; 
+                }
+                break; 
+
+            case M8Q_UBX_STATE_SYNC_2: 
+                if (byte == M8Q_UBX_SYNC_2)
+                {
+                    ubx->ck_a = ubx->ck_b = 0; 
+                    ubx->state = M8Q_UBX_STATE_CLASS; 
+                }
+                else 
+                {
+                    ubx->state = (byte == M8Q_UBX_SYNC_1) ? 
+                                 M8Q_UBX_STATE_SYNC_2 : M8Q_UBX_STATE_SYNC_1; 
+                }
+                break; 
+
+            case M8Q_UBX_STATE_CLASS: 
+                ubx->msg_class = byte; 
+                ubx->state = M8Q_UBX_STATE_ID; 
+                break; 
+
+            case M8Q_UBX_STATE_ID: 
+                ubx->msg_id = byte; 
+                ubx->state = M8Q_UBX_STATE_LEN_1; 
+                break; 
+
+            case M8Q_UBX_STATE_LEN_1: 
+                ubx->len = byte; 
+                ubx->state = M8Q_UBX_STATE_LEN_2; 
+                break; 
+
+            case M8Q_UBX_STATE_LEN_2: 
+                ubx->len |= (uint16_t)(byte << 8); 
+                ubx->index = 0; 
+                ubx->state = ubx->len ? M8Q_UBX_STATE_PAYLOAD : M8Q_UBX_STATE_CK_A; 
+                break; 
+
+            case M8Q_UBX_STATE_PAYLOAD: 
+                // Only a NAV-PVT payload is kept, the rest are just checksummed 
+                if (m8q_ubx_is_pvt(ubx))
+                {
+                    ubx->payload[ubx->index] = byte; 
+                }
+
+                if (++ubx->index >= ubx->len)
+                {
+                    ubx->state = M8Q_UBX_STATE_CK_A; 
+                }
+                break; 
+
+            case M8Q_UBX_STATE_CK_A: 
+                if (byte == ubx->ck_a)
+                {
+                    ubx->state = M8Q_UBX_STATE_CK_B; 
+                }
+                else 
+                {
+                    ubx->errors++; 
+                    ubx->state = M8Q_UBX_STATE_SYNC_1; 
+                }
+                break; 
+
+            case M8Q_UBX_STATE_CK_B: 
+                if (byte != ubx->ck_b)
+                {
+                    ubx->errors++; 
+                }
+                else if (m8q_ubx_is_pvt(ubx))
+                {
+                    memcpy((void *)&ubx->pvt, (void *)ubx->payload, M8Q_UBX_NAV_PVT_LEN); 
+                    ubx->pvt_count++; 
+                    found++; 
+                }
+
+                ubx->state = M8Q_UBX_STATE_SYNC_1; 
+                break; 
+
+            default: 
+                ubx->state = M8Q_UBX_STATE_SYNC_1; 
+                break; 
+        }
+    }
+
+    return found; 
+}
+
+
+// Check if the message being read is NAV-PVT 
+uint8_t m8q_ubx_is_pvt(const m8q_ubx_t *ubx)
+{
+    return (ubx->msg_class == M8Q_UBX_CLASS_NAV) && (ubx->msg_id == M8Q_UBX_ID_NAV_PVT) && 
+           (ubx->len == M8Q_UBX_NAV_PVT_LEN); 
+}
+
+
+// Get the navigation status 
+uint16_t m8q_ubx_navstat(const m8q_ubx_nav_pvt_t *pvt)
+{
+    if (!(pvt->flags & M8Q_UBX_PVT_GNSS_FIX_OK))
+    {
+        return ('N' << 8) | 'F'; 
+    }
+
+    switch (pvt->fixType)
+    {
+        case M8Q_UBX_FIX_DR: 
+            return ('D' << 8) | 'R'; 
+        case M8Q_UBX_FIX_2D: 
+            return ('G' << 8) | '2'; 
+        case M8Q_UBX_FIX_3D: 
+            return (pvt->flags & M8Q_UBX_PVT_DIFF_SOLN) ? (('D' << 8) | '3') : 
+                                                           (('G' << 8) | '3'); 
+        case M8Q_UBX_FIX_GNSS_DR: 
+            return ('R' << 8) | 'K'; 
+        case M8Q_UBX_FIX_TIME: 
+            return ('T' << 8) | 'T'; 
+        default: 
+            return ('N' << 8) | 'F'; 
+    }
+}
+
+
+// Get the navigation status lock 
+uint8_t m8q_ubx_navstat_lock(const m8q_ubx_nav_pvt_t *pvt)
+{
+    return (pvt->flags & M8Q_UBX_PVT_GNSS_FIX_OK) && 
+           ((pvt->fixType == M8Q_UBX_FIX_2D) || (pvt->fixType == M8Q_UBX_FIX_3D) || 
+            (pvt->fixType == M8Q_UBX_FIX_GNSS_DR)); 
+}
+
+//=======================================================================================
@@ -20,6 +20,27 @@
 //=======================================================================================
 
 
+//=======================================================================================
+// Macros 
+
+// FIFO registers 
+#define MPU6050_SMPLRT_DIV_REG 0x19      // Sample rate divider 
+#define MPU6050_FIFO_EN_REG 0x23         // FIFO enable (which sensors go in the FIFO) 
+#define MPU6050_USER_CTRL_REG 0x6A       // User control 
+#define MPU6050_FIFO_COUNT_REG 0x72      // FIFO count (high byte first) 
+#define MPU6050_FIFO_R_W_REG 0x74        // FIFO read/write 
+
+// FIFO register values 
+#define MPU6050_FIFO_EN_SENSORS 0x78     // Gyroscope X, Y, Z and accelerometer in the FIFO 
+#define MPU6050_USER_FIFO_EN 0x40        // Enable the FIFO 
+#define MPU6050_USER_FIFO_RESET 0x04     // Reset the FIFO (clears itself) 
+
+// I2C 
+#define MPU6050_I2C_W_OFFSET 0           // Address offset for a write 
+
+//=======================================================================================
+
+
 //=======================================================================================
 // Function prototypes 
 
@@ -119,6 +140,62 @@ void mpu6050_reset_state(mpu6050_cntrl_data_t *mpu6050_device);
  */
 void mpu6050_temp_check(mpu6050_cntrl_data_t *mpu6050_device); 
 
+
+/**
+ * @brief Write a device register 
+ * 
+ * @param mpu6050_device : pointer to device data record 
+ * @param reg : register address 
+ * @param value : value to write 
+ */
+void mpu6050_reg_write(
+    mpu6050_cntrl_data_t *mpu6050_device, 
+    uint8_t reg, 
+    uint8_t value); 
+
+
+/**
+ * @brief FIFO burst read 
+ * 
+ * @details Posts the FIFO count read to the I2C bus. The burst read is posted from the 
+ *          count read callback once the number of frames is known. 
+ * 
+ * @param mpu6050_device : pointer to device data record 
+ */
+void mpu6050_fifo_read(mpu6050_cntrl_data_t *mpu6050_device); 
+
+
+/**
+ * @brief FIFO reset 
+ * 
+ * @details Posts a write to the I2C bus that empties the FIFO and leaves it enabled. 
+ * 
+ * @param mpu6050_device : pointer to device data record 
+ */
+void mpu6050_fifo_reset(mpu6050_cntrl_data_t *mpu6050_device); 
+
+
+/**
+ * @brief FIFO count read callback 
+ * 
+ * @details Called from the I2C interrupts. Reading the FIFO read/write register doesn't 
+ *          move the register address so the burst read of it reads the number of bytes 
+ *          asked for from the FIFO. 
+ * 
+ * @param trans : FIFO count read transaction 
+ */
+void mpu6050_fifo_count_cb(i2c_bus_trans_t *trans); 
+
+
+/**
+ * @brief FIFO burst read callback 
+ * 
+ * @details Called from the I2C interrupts. 
+ * 
+ * @param trans : FIFO burst read transaction 
+ */
+void mpu6050_fifo_data_cb(i2c_bus_trans_t *trans); 
+
 //=======================================================================================
 
 
@@ -190,6 +267,82 @@ void mpu6050_controller_init(
     cntrl_data_ptr->read = CLEAR_BIT; 
     cntrl_data_ptr->read_state = MPU6050_READ_CONT; 
     cntrl_data_ptr->smpl_type = MPU6050_READ_ALL; 
+    cntrl_data_ptr->fifo_read = CLEAR_BIT; 
+    cntrl_data_ptr->fifo_reset = CLEAR_BIT; 
+
+    // FIFO - not used until the FIFO init 
+    cntrl_data_ptr->i2c = NULL; 
+    cntrl_data_ptr->addr = CLEAR; 
+    cntrl_data_ptr->fifo_buff = NULL; 
+    cntrl_data_ptr->fifo_buff_size = CLEAR; 
+    cntrl_data_ptr->fifo_frames = CLEAR; 
+    cntrl_data_ptr->fifo_overflow = CLEAR; 
+    cntrl_data_ptr->fifo_time = CLEAR; 
+    cntrl_data_ptr->fifo_busy = CLEAR; 
+}
+
+
+// MPU6050 FIFO initialization 
+void mpu6050_fifo_init(
+    device_number_t device_num, 
+    I2C_TypeDef *i2c, 
+    mpu6050_i2c_addr_t addr, 
+    uint8_t rate_div, 
+    uint8_t *buff, 
+    uint16_t buff_size)
+{
+    // Get the controller data record 
+    mpu6050_cntrl_data_t *cntrl_data_ptr = 
+        (mpu6050_cntrl_data_t *)get_linked_list_entry(device_num, mpu6050_cntrl_data_ptr); 
+
+    // Check for NULL pointers and a buffer that can't hold a frame 
+    if ((cntrl_data_ptr == NULL) || (i2c == NULL) || (buff == NULL) || 
+        (buff_size < MPU6050_FIFO_FRAME_SIZE)) return; 
+
+    cntrl_data_ptr->i2c = i2c; 
+    cntrl_data_ptr->addr = (uint8_t)addr; 
+    cntrl_data_ptr->fifo_buff = buff; 
+    cntrl_data_ptr->fifo_buff_size = buff_size; 
+    cntrl_data_ptr->fifo_frames = CLEAR; 
+    cntrl_data_ptr->fifo_overflow = CLEAR; 
+    cntrl_data_ptr->fifo_time = CLEAR; 
+    cntrl_data_ptr->fifo_busy = CLEAR; 
+    cntrl_data_ptr->fifo_read = CLEAR_BIT; 
+    cntrl_data_ptr->fifo_reset = CLEAR_BIT; 
+    cntrl_data_ptr->fifo_ctrl = MPU6050_USER_FIFO_EN | MPU6050_USER_FIFO_RESET; 
+
+    // FIFO transactions. The device supports fast mode and the FIFO is read ahead of the 
+    // other devices since samples are lost if it fills up. 
+    cntrl_data_ptr->count_trans = (i2c_bus_trans_t){
+        .addr = cntrl_data_ptr->addr, 
+        .reg = MPU6050_FIFO_COUNT_REG, 
+        .dir = I2C_BUS_READ, 
+        .prio = I2C_BUS_PRIO_HIGH, 
+        .speed = I2C_BUS_FM, 
+        .data = cntrl_data_ptr->fifo_count, 
+        .len = BYTE_2, 
+        .callback = mpu6050_fifo_count_cb, 
+        .context = (void *)cntrl_data_ptr 
+    }; 
+
+    cntrl_data_ptr->data_trans = cntrl_data_ptr->count_trans; 
+    cntrl_data_ptr->data_trans.reg = MPU6050_FIFO_R_W_REG; 
+    cntrl_data_ptr->data_trans.data = buff; 
+    cntrl_data_ptr->data_trans.callback = mpu6050_fifo_data_cb; 
+
+    cntrl_data_ptr->reset_trans = cntrl_data_ptr->count_trans; 
+    cntrl_data_ptr->reset_trans.reg = MPU6050_USER_CTRL_REG; 
+    cntrl_data_ptr->reset_trans.dir = I2C_BUS_WRITE; 
+    cntrl_data_ptr->reset_trans.data = &cntrl_data_ptr->fifo_ctrl; 
+    cntrl_data_ptr->reset_trans.len = BYTE_1; 
+    cntrl_data_ptr->reset_trans.callback = NULL; 
+
+    // Set the sample rate, choose the FIFO data then enable it 
+    i2c_bus_lock(); 
+    mpu6050_reg_write(cntrl_data_ptr, MPU6050_SMPLRT_DIV_REG, rate_div); 
+    mpu6050_reg_write(cntrl_data_ptr, MPU6050_FIFO_EN_REG, MPU6050_FIFO_EN_SENSORS); 
+    i2c_bus_unlock(); 
+    mpu6050_fifo_reset(cntrl_data_ptr); 
 }
 
 
@@ -366,7 +519,9 @@ void mpu6050_init_state(mpu6050_cntrl_data_t *mpu6050_device)
 
     // Run self-test 
     uint8_t st_result = CLEAR; 
+    i2c_bus_lock(); 
     mpu6050_self_test(mpu6050_device->device_num, &st_result);
+    i2c_bus_unlock(); 
 
     // Provide time for device data to update so self-test data is not used for calibration 
     tim_delay_ms(mpu6050_device->timer, MPU6050_ST_DELAY); 
@@ -384,7 +539,9 @@ void mpu6050_read_cont_state(mpu6050_cntrl_data_t *mpu6050_device)
                     &mpu6050_device->time_cnt, 
                     &mpu6050_device->time_start))
     {
+        i2c_bus_lock(); 
         read_table[mpu6050_device->smpl_type](mpu6050_device->device_num); 
+        i2c_bus_unlock(); 
         mpu6050_temp_check(mpu6050_device); 
     }
 }
@@ -396,10 +553,35 @@ void mpu6050_read_ready_state(mpu6050_cntrl_data_t *mpu6050_device)
     // Read from the device on request 
     if (mpu6050_device->read)
     {
+        i2c_bus_lock(); 
         read_table[mpu6050_device->smpl_type](mpu6050_device->device_num); 
+        i2c_bus_unlock(); 
         mpu6050_device->read = CLEAR_BIT; 
         mpu6050_temp_check(mpu6050_device); 
     }
+
+    // Reset the FIFO on request. Posted ahead of a FIFO read so it happens first. 
+    if (mpu6050_device->fifo_reset)
+    {
+        if (mpu6050_device->fifo_buff != NULL)
+        {
+            mpu6050_device->fifo_frames = CLEAR; 
+            mpu6050_fifo_reset(mpu6050_device); 
+        }
+
+        mpu6050_device->fifo_reset = CLEAR_BIT; 
+    }
+
+    // Read the FIFO on request 
+    if (mpu6050_device->fifo_read)
+    {
+        if (mpu6050_device->fifo_buff != NULL)
+        {
+            mpu6050_fifo_read(mpu6050_device); 
+        }
+
+        mpu6050_device->fifo_read = CLEAR_BIT; 
+    }
 }
 
 
@@ -407,9 +589,11 @@ void mpu6050_read_ready_state(mpu6050_cntrl_data_t *mpu6050_device)
 void mpu6050_low_power_trans_state(mpu6050_cntrl_data_t *mpu6050_device)
 {
     // Write the low power flag status to the power management register 
+    i2c_bus_lock(); 
     mpu6050_low_pwr_config(
         mpu6050_device->device_num, 
         mpu6050_device->low_power); 
+    i2c_bus_unlock(); 
 
     // Reset the non-blocking delay 
     mpu6050_device->time_start = SET_BIT; 
@@ -438,9 +622,11 @@ void mpu6050_reset_state(mpu6050_cntrl_data_t *mpu6050_device)
 
     // Reset the low power flag and make sure to exit sleep mode 
     mpu6050_device->low_power = MPU6050_SLEEP_MODE_DISABLE; 
+    i2c_bus_lock(); 
     mpu6050_low_pwr_config(
         mpu6050_device->device_num, 
         mpu6050_device->low_power); 
+    i2c_bus_unlock(); 
 
     // Reset the non-blocking delay 
     mpu6050_device->time_start = SET_BIT; 
@@ -462,6 +648,113 @@ void mpu6050_temp_check(mpu6050_cntrl_data_t *mpu6050_device)
     }
 }
 
+
+// Write a device register 
+void mpu6050_reg_write(
+    mpu6050_cntrl_data_t *mpu6050_device, 
+    uint8_t reg, 
+    uint8_t value)
+{
+    uint8_t data[BYTE_2] = { reg, value }; 
+
+    i2c_start(mpu6050_device->i2c); 
+    i2c_write_addr(mpu6050_device->i2c, mpu6050_device->addr + MPU6050_I2C_W_OFFSET); 
+    i2c_clear_addr(mpu6050_device->i2c); 
+    i2c_write(mpu6050_device->i2c, data, BYTE_2); 
+    i2c_stop(mpu6050_device->i2c); 
+}
+
+
+// FIFO burst read 
+void mpu6050_fifo_read(mpu6050_cntrl_data_t *mpu6050_device)
+{
+    // The last read hasn't finished 
+    if (mpu6050_device->fifo_busy)
+    {
+        return; 
+    }
+
+    mpu6050_device->fifo_frames = CLEAR; 
+    mpu6050_device->fifo_busy = SET_BIT; 
+
+    if (!i2c_bus_post(&mpu6050_device->count_trans))
+    {
+        mpu6050_device->fifo_busy = CLEAR; 
+    }
+}
+
+
+// FIFO reset 
+void mpu6050_fifo_reset(mpu6050_cntrl_data_t *mpu6050_device)
+{
+    // A reset that's already queued does the same thing 
+    i2c_bus_post(&mpu6050_device->reset_trans); 
+}
+
+
+// FIFO count read callback 
+void mpu6050_fifo_count_cb(i2c_bus_trans_t *trans)
+{
+    mpu6050_cntrl_data_t *mpu6050_device = (mpu6050_cntrl_data_t *)trans->context; 
+    const uint8_t *count_bytes = mpu6050_device->fifo_count; 
+    uint16_t count, frames, max_frames; 
+
+    if (trans->status != I2C_BUS_DONE)
+    {
+        mpu6050_device->fifo_busy = CLEAR; 
+        return; 
+    }
+
+    count = (uint16_t)((count_bytes[BYTE_0] << SHIFT_8) | count_bytes[BYTE_1]); 
+
+    // A full FIFO drops its oldest bytes to make room, which isn't a whole number of 
+    // frames, so the data can't be lined up with the frames anymore. 
+    if (count >= MPU6050_FIFO_SIZE)
+    {
+        mpu6050_fifo_reset(mpu6050_device); 
+        mpu6050_device->fifo_overflow++; 
+        mpu6050_device->fifo_busy = CLEAR; 
+        return; 
+    }
+
+    // Only whole frames are read. A frame being written or frames that don't fit in the 
+    // buffer are left in the FIFO for the next read. 
+    frames = count / MPU6050_FIFO_FRAME_SIZE; 
+    max_frames = mpu6050_device->fifo_buff_size / MPU6050_FIFO_FRAME_SIZE; 
+
+    if (frames > max_frames)
+    {
+        frames = max_frames; 
+    }
+
+    if (frames)
+    {
+        mpu6050_device->data_trans.len = frames * MPU6050_FIFO_FRAME_SIZE; 
+
+        if (i2c_bus_post(&mpu6050_device->data_trans))
+        {
+            return; 
+        }
+    }
+
+    mpu6050_device->fifo_busy = CLEAR; 
+}
+
+
+// FIFO burst read callback 
+void mpu6050_fifo_data_cb(i2c_bus_trans_t *trans)
+{
+    mpu6050_cntrl_data_t *mpu6050_device = (mpu6050_cntrl_data_t *)trans->context; 
+
+    if (trans->status == I2C_BUS_DONE)
+    {
+        mpu6050_device->fifo_frames = trans->len / MPU6050_FIFO_FRAME_SIZE; 
+        mpu6050_device->fifo_time = mpu6050_device->count_trans.time; 
+    }
+
+    mpu6050_device->fifo_busy = CLEAR; 
+}
+
 //=======================================================================================
 
 
@@ -546,6 +839,34 @@ void mpu6050_set_read_flag(device_number_t device_num)
 }
 
 
+// Set the FIFO read flag 
+void mpu6050_set_fifo_flag(device_number_t device_num)
+{
+    // Get the controller data record 
+    mpu6050_cntrl_data_t *cntrl_data_ptr = 
+        (mpu6050_cntrl_data_t *)get_linked_list_entry(device_num, mpu6050_cntrl_data_ptr); 
+
+    // Check that the data record is valid 
+    if (cntrl_data_ptr == NULL) return; 
+
+    cntrl_data_ptr->fifo_read = SET_BIT; 
+}
+
+
+// Set the FIFO reset flag 
+void mpu6050_set_fifo_reset_flag(device_number_t device_num)
+{
+    // Get the controller data record 
+    mpu6050_cntrl_data_t *cntrl_data_ptr = 
+        (mpu6050_cntrl_data_t *)get_linked_list_entry(device_num, mpu6050_cntrl_data_ptr); 
+
+    // Check that the data record is valid 
+    if (cntrl_data_ptr == NULL) return; 
+
+    cntrl_data_ptr->fifo_reset = SET_BIT; 
+}
+
+
 // Set reset flag 
 void mpu6050_set_reset_flag(device_number_t device_num)
 {
@@ -598,4 +919,83 @@ MPU6050_FAULT_CODE mpu6050_get_fault_code(device_number_t device_num)
     return cntrl_data_ptr->fault_code; 
 }
 
+
+// Get the number of frames from the last FIFO burst read 
+uint16_t mpu6050_get_fifo_frames(device_number_t device_num)
+{
+    // Get the controller data record 
+    mpu6050_cntrl_data_t *cntrl_data_ptr = 
+        (mpu6050_cntrl_data_t *)get_linked_list_entry(device_num, mpu6050_cntrl_data_ptr); 
+
+    // Check that the data record is valid 
+    if (cntrl_data_ptr == NULL)
+    {
+        return 0; 
+    }
+
+    // The buffer is being filled while a read is in flight 
+    return cntrl_data_ptr->fifo_busy ? 0 : cntrl_data_ptr->fifo_frames; 
+}
+
+
+// Get the time of the last FIFO burst read 
+uint32_t mpu6050_get_fifo_time(device_number_t device_num)
+{
+    // Get the controller data record 
+    mpu6050_cntrl_data_t *cntrl_data_ptr = 
+        (mpu6050_cntrl_data_t *)get_linked_list_entry(device_num, mpu6050_cntrl_data_ptr); 
+
+    // Check that the data record is valid 
+    if (cntrl_data_ptr == NULL)
+    {
+        return 0; 
+    }
+
+    return cntrl_data_ptr->fifo_time; 
+}
+
+
+// Get a frame from the last FIFO burst read 
+void mpu6050_get_fifo_frame(
+    device_number_t device_num, 
+    uint16_t frame, 
+    int16_t *accel, 
+    int16_t *gyro)
+{
+    // Get the controller data record 
+    mpu6050_cntrl_data_t *cntrl_data_ptr = 
+        (mpu6050_cntrl_data_t *)get_linked_list_entry(device_num, mpu6050_cntrl_data_ptr); 
+
+    // Check that the data record and frame are valid 
+    if ((cntrl_data_ptr == NULL) || (accel == NULL) || (gyro == NULL) || 
+        (frame >= cntrl_data_ptr->fifo_frames)) return; 
+
+    // Frames hold the accelerometer then gyroscope axes, high byte first 
+    const uint8_t *accel_data = &cntrl_data_ptr->fifo_buff[frame*MPU6050_FIFO_FRAME_SIZE]; 
+    const uint8_t *gyro_data = accel_data + BYTE_2*MPU6050_FIFO_AXES; 
+
+    for (uint8_t i = CLEAR; i < MPU6050_FIFO_AXES; i++)
+    {
+        accel[i] = (int16_t)((accel_data[BYTE_2*i] << SHIFT_8) | accel_data[BYTE_2*i + 1]); 
+        gyro[i] = (int16_t)((gyro_data[BYTE_2*i] << SHIFT_8) | gyro_data[BYTE_2*i + 1]); 
+    }
+}
+
+
+// Get the FIFO overflow count 
+uint16_t mpu6050_get_fifo_overflow(device_number_t device_num)
+{
+    // Get the controller data record 
+    mpu6050_cntrl_data_t *cntrl_data_ptr = 
+        (mpu6050_cntrl_data_t *)get_linked_list_entry(device_num, mpu6050_cntrl_data_ptr); 
+
+    // Check that the data record is valid 
+    if (cntrl_data_ptr == NULL)
+    {
+        return 0; 
+    }
+
+    return cntrl_data_ptr->fifo_overflow; 
+}
+
 //=======================================================================================
@@ -16,6 +16,19 @@
 // Includes 
 
 #include "sd_controller.h"
+#include "log_prof.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+// FatFs file locking stops a file from being open in two handles when either of them 
+// writes to it, so it has to cover every handle 
+#if FF_FS_LOCK < SD_NUM_FILES
+#error "FF_FS_LOCK (ffconf.h) must be at least SD_NUM_FILES"
+#endif
 
 //=======================================================================================
 
@@ -185,14 +198,157 @@ FRESULT sd_getlabel(sd_trackers_t *sd_device);
  * @brief Get free space 
  * 
  * @details Checks the free space of the volume. This function is called after successful 
- *          mounting of the volume in the "init" state. The free space is checked against 
- *          a threshold to ensure there is sufficient space for the system to record data. 
- *          If the free space is below the threshold then the fault flag is set. 
+ *          mounting of the volume in the "init" state and when the free space estimate 
+ *          needs to be corrected. The free space is checked against a threshold to 
+ *          ensure there is sufficient space for the system to record data. If the free 
+ *          space is below the threshold then the fault flag is set. 
+ * 
+ *          The volume count includes the clusters of files that are open, so their 
+ *          current sizes become the starting point for the estimate when they're closed. 
  * 
  * @return FRESULT : FATFS file function return code 
  */
 FRESULT sd_getfree(sd_trackers_t *sd_device); 
 
+
+/**
+ * @brief Update the free space estimate 
+ * 
+ * @details Adjusts the free clusters by the clusters a file gained or lost going from 
+ *          'old_size' to 'new_size' bytes. Directories only grow when a file or directory 
+ *          is created and those clusters are charged when it's made. The free space is 
+ *          read from the volume before the low free space fault is set. 
+ * 
+ * @param sd_device : device tracker that defines control characteristics 
+ * @param old_size : file size before (bytes) 
+ * @param new_size : file size after (bytes) 
+ */
+void sd_free_update(
+    sd_trackers_t *sd_device, 
+    FSIZE_t old_size, 
+    FSIZE_t new_size); 
+
+
+/**
+ * @brief Check if a new file took a new directory cluster 
+ * 
+ * @details A directory grows a cluster at a time when its entries are full and the new 
+ *          cluster is used from its first entry. Long file names aren't used so each file 
+ *          takes one entry, which means the directory grew if the entry of the new file is 
+ *          the first one of a cluster. It can also be the first entry of a cluster that 
+ *          was already there if the file that had it was deleted, so the estimate can 
+ *          read a cluster low but never high. A fixed size root directory (FAT12/16) sits 
+ *          before the data area and can't grow. 
+ * 
+ * @param file : file object of the file that was just made 
+ * @return uint8_t : TRUE if the directory of the file grew 
+ */
+uint8_t sd_dir_grew(FIL *file); 
+
+
+/**
+ * @brief Build the path of the set directory 
+ * 
+ * @details Writes the path from the volume root to the set directory (project 
+ *          directory plus the sub-directory if there is one). The path starts with "/" 
+ *          so it doesn't depend on the current directory of the volume. 'path' and 'dir' 
+ *          are each less than SD_PATH_SIZE long so the path plus its two "/" and the 
+ *          terminator fits in SD_PATH_SIZE*2 + 1. 
+ * 
+ * @param sd_device : device tracker that defines control characteristics 
+ * @param dir_path : buffer for the path, at least SD_PATH_SIZE*2 + 1 long 
+ */
+void sd_dir_path(
+    sd_trackers_t *sd_device, 
+    TCHAR *dir_path); 
+
+
+/**
+ * @brief Make the set directory the current directory of the volume 
+ * 
+ * @details Resolves the set directory once with f_chdir so FatFs keeps its start 
+ *          cluster. File names are then given to FatFs as they are and it finds them 
+ *          from the start cluster instead of walking the directories from the root. Not a 
+ *          fault if the directory doesn't exist yet, but the failure is saved so it isn't 
+ *          tried again until sd_set_dir or sd_mkdir changes the directory or the volume is 
+ *          mounted again. 
+ * 
+ * @param sd_device : device tracker that defines control characteristics 
+ * @return FRESULT : FATFS file function return code 
+ */
+FRESULT sd_dir_resolve(sd_trackers_t *sd_device); 
+
+
+/**
+ * @brief Get the path of a file in the set directory 
+ * 
+ * @details Returns 'file_name' as is when the set directory is the current directory 
+ *          of the volume (see sd_dir_resolve). Otherwise the full path is built in 
+ *          'file_dir' from the volume root. The directory is only resolved if it hasn't 
+ *          already failed to resolve for the set directory. 
+ * 
+ * @param sd_device : device tracker that defines control characteristics 
+ * @param file_name : name of the file in the set directory 
+ * @param file_dir : buffer for the full path, at least SD_PATH_SIZE*3 long 
+ * @return const TCHAR* : path to give FatFs 
+ */
+const TCHAR *sd_file_path(
+    sd_trackers_t *sd_device, 
+    const TCHAR *file_name, 
+    TCHAR *file_dir); 
+
+
+/**
+ * @brief Open a file in a file handle 
+ * 
+ * @details Builds the path of the file from the project and sub-directories then opens 
+ *          the file in the file object of the handle. The fault code is updated if the 
+ *          file can't be opened. The handle must not already be open. 
+ * 
+ * @param sd_device : device tracker that defines control characteristics 
+ * @param handle : file handle to open the file in 
+ * @param file_name : name of the file to open 
+ * @param mode : mode to open the file in (read, write, etc.) 
+ * @return FRESULT : FATFS file function return code 
+ */
+FRESULT sd_file_open_handle(
+    sd_trackers_t *sd_device, 
+    SD_HANDLE handle, 
+    const TCHAR *file_name, 
+    uint8_t mode); 
+
+
+/**
+ * @brief Get an open file handle 
+ * 
+ * @param handle : file handle 
+ * @return sd_file_t* : file handle entry, NULL if the handle is not valid or not open 
+ */
+sd_file_t *sd_file_get(SD_HANDLE handle); 
+
+
+/**
+ * @brief Close every open file 
+ * 
+ * @details Used when the volume is about to be unmounted (eject and reset). 
+ * 
+ * @param sd_device : device tracker that defines control characteristics 
+ */
+void sd_close_files(sd_trackers_t *sd_device); 
+
+
+/**
+ * @brief Write the write buffer contents to the open file 
+ * 
+ * @details Writes the buffered data to the open file and empties the buffer. The fault 
+ *          code is updated if the write fails. The buffer is emptied either way so a 
+ *          failed write can't block new data. 
+ * 
+ * @param sd_device : device tracker that defines control characteristics 
+ * @return FRESULT : FATFS file function return code 
+ */
+FRESULT sd_buff_write_file(sd_trackers_t *sd_device); 
+
 //=======================================================================================
 
 
@@ -240,8 +396,22 @@ void sd_controller_init(const char *path)
     sd_device_trackers.not_ready = CLEAR_BIT; 
     sd_device_trackers.check = CLEAR_BIT; 
     sd_device_trackers.eject = CLEAR_BIT; 
-    sd_device_trackers.open_file = CLEAR_BIT; 
+    sd_device_trackers.dir_cached = CLEAR_BIT; 
+    sd_device_trackers.dir_missing = CLEAR_BIT; 
     sd_device_trackers.startup = SET_BIT; 
+
+    // Write buffer 
+    sd_device_trackers.buff_len = CLEAR; 
+
+    // Card capacity 
+    sd_device_trackers.fre_clust = CLEAR; 
+
+    // File handle pool 
+    for (SD_HANDLE i = CLEAR; i < SD_NUM_FILES; i++)
+    {
+        sd_device_trackers.files[i].open = CLEAR_BIT; 
+        sd_device_trackers.files[i].open_size = CLEAR; 
+    }
 }
 
 
@@ -433,7 +603,7 @@ void sd_init_state(sd_trackers_t *sd_device)
 void sd_not_ready_state(sd_trackers_t *sd_device)
 {
     // Check if the volume is present 
-    if (sd_get_existance() == (DISK_STATUS)TRUE) 
+    if (sd_spi_present())
     {
         // Present - clear the not ready flag so we can try remounting 
         sd_device->not_ready = CLEAR_BIT; 
@@ -452,7 +622,7 @@ void sd_access_state(sd_trackers_t *sd_device)
 void sd_access_check_state(sd_trackers_t *sd_device) 
 {
     // Check for the presence of the volume 
-    if (sd_ready_rec() == (DISK_STATUS)FALSE)
+    if (!sd_spi_ready())
     {
         // If not seen then set the not_ready flag 
         sd_device->not_ready = SET_BIT; 
@@ -463,8 +633,8 @@ void sd_access_check_state(sd_trackers_t *sd_device)
 // SD card controller eject state 
 void sd_eject_state(sd_trackers_t *sd_device)
 {
-    // Attempt to close the open file 
-    sd_close(); 
+    // Attempt to close the open files 
+    sd_close_files(sd_device); 
 
     // Unmount the volume 
     sd_unmount(sd_device); 
@@ -481,11 +651,13 @@ void sd_fault_state(sd_trackers_t *sd_device)
 // SD card controller reset state 
 void sd_reset_state(sd_trackers_t *sd_device) 
 {
-    // Attempt to close a file 
-    sd_close(); 
+    // Attempt to close the open files 
+    sd_close_files(sd_device); 
 
     // Reset sub directory 
     memset((void *)sd_device_trackers.dir, CLEAR, SD_PATH_SIZE); 
+    sd_device->dir_cached = CLEAR_BIT; 
+    sd_device->dir_missing = CLEAR_BIT; 
 
     // Unmount the volume 
     sd_unmount(sd_device); 
@@ -513,6 +685,10 @@ FRESULT sd_mount(sd_trackers_t *sd_device)
         sd_device->mount = SET_BIT; 
     }
 
+    // Mounting starts the volume in the root directory 
+    sd_device->dir_cached = CLEAR_BIT; 
+    sd_device->dir_missing = CLEAR_BIT; 
+
     return sd_device_trackers.fresult; 
 }
 
@@ -523,6 +699,8 @@ FRESULT sd_unmount(sd_trackers_t *sd_device)
     // Unmount, clear the init status so it can be re-mounted, and clear the mount bit 
     f_unmount(""); 
     sd_device->mount = CLEAR_BIT; 
+    sd_device->dir_cached = CLEAR_BIT; 
+    sd_device->dir_missing = CLEAR_BIT; 
 
     return FR_OK; 
 }
@@ -567,6 +745,14 @@ FRESULT sd_getfree(sd_trackers_t *sd_device)
             sd_device->fault_code |= (SET_BIT << SD_FAULT_FREE); 
         }
 
+        // The clusters open files hold now are counted 
+        for (SD_HANDLE i = CLEAR; i < SD_NUM_FILES; i++)
+        {
+            if (sd_device->files[i].open)
+            {
+                sd_device->files[i].open_size = f_size(&sd_device->files[i].file); 
+            }
+        }
     }
     else   // Communication fault 
     {
@@ -577,6 +763,224 @@ FRESULT sd_getfree(sd_trackers_t *sd_device)
     return sd_device->fresult; 
 }
 
+
+// Update the free space estimate 
+void sd_free_update(
+    sd_trackers_t *sd_device, 
+    FSIZE_t old_size, 
+    FSIZE_t new_size)
+{
+    FSIZE_t clust_size = (FSIZE_t)sd_device->file_sys.csize * SD_SECTOR_SIZE; 
+
+    if (!sd_device->mount || !clust_size)
+    {
+        return; 
+    }
+
+    // Clusters held by each file size 
+    DWORD old_clust = (DWORD)((old_size / clust_size) + ((old_size % clust_size) != 0)); 
+    DWORD new_clust = (DWORD)((new_size / clust_size) + ((new_size % clust_size) != 0)); 
+
+    if (new_clust > old_clust)
+    {
+        DWORD used = new_clust - old_clust; 
+        sd_device->fre_clust = (used < sd_device->fre_clust) ? 
+                               (sd_device->fre_clust - used) : 0; 
+    }
+    else 
+    {
+        sd_device->fre_clust += old_clust - new_clust; 
+
+        if (sd_device->fre_clust > (sd_device->file_sys.n_fatent - 2))
+        {
+            sd_device->fre_clust = sd_device->file_sys.n_fatent - 2; 
+        }
+    }
+
+    sd_device->free_space = (uint32_t)((sd_device->fre_clust * 
+                                        sd_device->file_sys.csize) >> SHIFT_1); 
+
+    // Make sure the volume is really low before setting the fault 
+    if (sd_device->free_space < SD_FREE_THRESH)
+    {
+        sd_getfree(sd_device); 
+    }
+}
+
+
+// Check if a new file took a new directory cluster 
+uint8_t sd_dir_grew(FIL *file)
+{
+    FATFS *fs = file->obj.fs; 
+
+    if (file->dir_sect < fs->database)
+    {
+        return FALSE; 
+    }
+
+    return (((file->dir_sect - fs->database) % fs->csize) == 0) && 
+           (file->dir_ptr == fs->win); 
+}
+
+
+// Write the write buffer contents to the open file 
+FRESULT sd_buff_write_file(sd_trackers_t *sd_device) 
+{
+    sd_device->fresult = f_write(&sd_device->files[SD_FILE_DEFAULT].file, 
+                                 sd_device->buff, 
+                                 sd_device->buff_len, 
+                                 &sd_device->bw); 
+    sd_device->buff_len = CLEAR; 
+
+    if (sd_device->fresult)
+    {
+        sd_device->fault_mode |= (SET_BIT << sd_device->fresult); 
+        sd_device->fault_code |= (SET_BIT << SD_FAULT_WRITE); 
+    }
+
+    return sd_device->fresult; 
+}
+
+
+// Build the path of the set directory 
+void sd_dir_path(
+    sd_trackers_t *sd_device, 
+    TCHAR *dir_path)
+{
+    strcpy(dir_path, "/"); 
+    strcat(dir_path, sd_device->path); 
+
+    // 'dir' is empty when the project directory is used 
+    if (*sd_device->dir != NULL_CHAR)
+    {
+        strcat(dir_path, "/"); 
+        strcat(dir_path, sd_device->dir); 
+    }
+}
+
+
+// Make the set directory the current directory of the volume 
+FRESULT sd_dir_resolve(sd_trackers_t *sd_device)
+{
+    TCHAR dir_path[SD_PATH_SIZE*2 + 1]; 
+
+    sd_dir_path(sd_device, dir_path); 
+
+    if (f_chdir(dir_path) == FR_OK)
+    {
+        sd_device->dir_cached = SET_BIT; 
+        return FR_OK; 
+    }
+
+    // Not tried again until the directory or the volume changes 
+    sd_device->dir_missing = SET_BIT; 
+
+    return FR_NO_PATH; 
+}
+
+
+// Get the path of a file in the set directory 
+const TCHAR *sd_file_path(
+    sd_trackers_t *sd_device, 
+    const TCHAR *file_name, 
+    TCHAR *file_dir)
+{
+    if (sd_device->dir_cached || 
+        (!sd_device->dir_missing && (sd_dir_resolve(sd_device) == FR_OK)))
+    {
+        return file_name; 
+    }
+
+    // The directory can't be resolved (ex. it doesn't exist yet) so FatFs has to walk 
+    // the full path. The failed resolve is remembered so it isn't repeated for every 
+    // file. 
+    sd_dir_path(sd_device, file_dir); 
+    strcat(file_dir, "/"); 
+    strcat(file_dir, file_name); 
+
+    return file_dir; 
+}
+
+
+// Open a file in a file handle 
+FRESULT sd_file_open_handle(
+    sd_trackers_t *sd_device, 
+    SD_HANDLE handle, 
+    const TCHAR *file_name, 
+    uint8_t mode)
+{
+    // Check for NULL pointers and strings 
+    if ((file_name == NULL) || (*file_name == NULL_CHAR))
+    {
+        return FR_INVALID_OBJECT; 
+    }
+
+    sd_file_t *file = &sd_device->files[handle]; 
+    TCHAR file_dir[SD_PATH_SIZE*3]; 
+    FILINFO file_info; 
+    FRESULT file_stat = FR_OK; 
+    const TCHAR *file_path = sd_file_path(sd_device, file_name, file_dir); 
+
+    // A create mode either makes the file or opens the existing one (FA_CREATE_ALWAYS 
+    // empties it) so check which it will be for the free space estimate 
+    file_info.fsize = CLEAR; 
+    if (mode & (FA_CREATE_NEW | FA_CREATE_ALWAYS | FA_OPEN_ALWAYS))
+    {
+        file_stat = f_stat(file_path, &file_info); 
+    }
+
+    sd_device->fresult = f_open(&file->file, file_path, mode); 
+
+    if (sd_device->fresult == FR_OK)
+    {
+        file->open = SET_BIT; 
+        file->open_size = f_size(&file->file); 
+
+        if (file_stat == FR_NO_FILE)
+        {
+            // The file was made - charge a cluster if its directory had to grow 
+            if (sd_dir_grew(&file->file))
+            {
+                sd_free_update(sd_device, CLEAR, SD_SECTOR_SIZE); 
+            }
+        }
+        else if (mode & FA_CREATE_ALWAYS) 
+        {
+            // The existing file was emptied so its clusters are free 
+            sd_free_update(sd_device, file_info.fsize, CLEAR); 
+        }
+    }
+    else   // Open fault - record the fault types 
+    {
+        sd_device->fault_mode |= (SET_BIT << sd_device->fresult); 
+        sd_device->fault_code |= (SET_BIT << SD_FAULT_OPEN); 
+    }
+
+    return sd_device->fresult; 
+}
+
+
+// Get an open file handle 
+sd_file_t *sd_file_get(SD_HANDLE handle)
+{
+    if ((handle >= SD_NUM_FILES) || !sd_device_trackers.files[handle].open)
+    {
+        return NULL; 
+    }
+
+    return &sd_device_trackers.files[handle]; 
+}
+
+
+// Close every open file 
+void sd_close_files(sd_trackers_t *sd_device)
+{
+    for (SD_HANDLE i = CLEAR; i < SD_NUM_FILES; i++)
+    {
+        sd_file_close(i); 
+    }
+}
+
 //=======================================================================================
 
 
@@ -621,9 +1025,18 @@ void sd_set_reset_flag(void)
 // Set directory 
 void sd_set_dir(const TCHAR *dir)
 {
-    // Reset the saved directory and set the new directory 
+    // Nothing changes if the directory is already set so it stays resolved 
+    if (!strcmp(sd_device_trackers.dir, dir))
+    {
+        return; 
+    }
+
+    // Reset the saved directory and set the new directory. It's resolved when it's next 
+    // used. 
     memset((void *)sd_device_trackers.dir, CLEAR, SD_PATH_SIZE); 
     strcpy(sd_device_trackers.dir, dir); 
+    sd_device_trackers.dir_cached = CLEAR_BIT; 
+    sd_device_trackers.dir_missing = CLEAR_BIT; 
 }
 
 
@@ -636,21 +1049,15 @@ FRESULT sd_mkdir(const TCHAR *dir)
         return FR_INVALID_OBJECT; 
     }
     
-    TCHAR sub_dir[SD_PATH_SIZE*2]; 
+    TCHAR sub_dir[SD_PATH_SIZE*2 + 1]; 
 
-    // Record 'dir' for future use and establish 'path' as the base of the sub directory 
+    // Record 'dir' for future use and build the sub directory path. 'dir' will be empty 
+    // for the project directory such as in the "init" state. 
     sd_set_dir(dir); 
-    strcpy(sub_dir, sd_device_trackers.path); 
+    sd_dir_path(&sd_device_trackers, sub_dir); 
 
-    // If 'dir' is not a null character then prepare the sub-directory to be concatenated. 
-    // 'dir' will be a null character when it's empty such as in the "init" state. 
-    if (*sd_device_trackers.dir != NULL_CHAR)
-    {
-        strcat(sub_dir, "/"); 
-    }
-
-    // Concatenate 'dir' to complete the sub directory string 
-    strcat(sub_dir, sd_device_trackers.dir); 
+    // The directory may exist now so it can be resolved again 
+    sd_device_trackers.dir_missing = CLEAR_BIT; 
 
     // Check for the existance of the directory 
     sd_device_trackers.fresult = f_stat(sub_dir, (FILINFO *)NULL); 
@@ -666,6 +1073,14 @@ FRESULT sd_mkdir(const TCHAR *dir)
             sd_device_trackers.fault_mode |= (SET_BIT << sd_device_trackers.fresult); 
             sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_DIR); 
         }
+        else 
+        {
+            // The new directory takes a cluster. Its entry can also grow the parent 
+            // directory, which can't be seen from here, so a cluster is charged for that 
+            // too. Directories are only made when they're missing so this is rare. 
+            FSIZE_t clust_size = (FSIZE_t)sd_device_trackers.file_sys.csize * SD_SECTOR_SIZE; 
+            sd_free_update(&sd_device_trackers, CLEAR, 2 * clust_size); 
+        }
     }
 
     return sd_device_trackers.fresult; 
@@ -677,76 +1092,20 @@ FRESULT sd_open(
     const TCHAR *file_name, 
     uint8_t mode) 
 {
-    // Check for NULL pointers and strings 
-    if ((file_name == NULL) || (*file_name == NULL_CHAR)) 
-    {
-        return FR_INVALID_OBJECT; 
-    }
-
-    TCHAR file_dir[SD_PATH_SIZE*3]; 
-
-    // Attempt to open file if a file is not already open 
-    if (!sd_device_trackers.open_file) 
+    // Only one file is opened through the single file functions 
+    if (sd_device_trackers.files[SD_FILE_DEFAULT].open)
     {
-        // Establish 'path' as the root of the file directory 
-        strcpy(file_dir, sd_device_trackers.path); 
-
-        // If 'dir' is not a null character then concatenate it to the file directory 
-        if (*sd_device_trackers.dir != NULL_CHAR)
-        {
-            strcat(file_dir, "/"); 
-            strcat(file_dir, sd_device_trackers.dir); 
-        }
-
-        strcat(file_dir, "/"); 
-        strcat(file_dir, file_name); 
-        
-        sd_device_trackers.fresult = f_open(&sd_device_trackers.file, 
-                                               file_dir, 
-                                               mode); 
-
-        if (sd_device_trackers.fresult == FR_OK) 
-        {
-            sd_device_trackers.open_file = SET_BIT; 
-        }
-        else   // Open fault - record the fault types 
-        {
-            sd_device_trackers.fault_mode |= (SET_BIT << sd_device_trackers.fresult); 
-            sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_OPEN); 
-        }
-
-        return sd_device_trackers.fresult; 
+        return FR_TOO_MANY_OPEN_FILES; 
     }
 
-    return FR_TOO_MANY_OPEN_FILES; 
+    return sd_file_open_handle(&sd_device_trackers, SD_FILE_DEFAULT, file_name, mode); 
 }
 
 
 // Close the open file 
 FRESULT sd_close(void) 
 {
-    // Attempt to close a file if it's open 
-    if (sd_device_trackers.open_file) 
-    {
-        sd_device_trackers.fresult = f_close(&sd_device_trackers.file); 
-
-        if (sd_device_trackers.fresult) 
-        {
-            // Close file fault 
-            sd_device_trackers.fault_mode |= (SET_BIT << sd_device_trackers.fresult); 
-            sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_CLOSE); 
-        }
-
-        // Clear the open file flag regardless of the fault code 
-        sd_device_trackers.open_file = CLEAR_BIT; 
-
-        // Update the free space 
-        sd_getfree(&sd_device_trackers); 
-
-        return sd_device_trackers.fresult; 
-    }
-
-    return FR_OK; 
+    return sd_file_close(SD_FILE_DEFAULT); 
 }
 
 
@@ -755,42 +1114,37 @@ FRESULT sd_f_write(
     const void *buff, 
     UINT btw) 
 {
-    // Check for void pointer? 
-    // Check for open file? 
-
-    // Write to the file 
-    sd_device_trackers.fresult = f_write(&sd_device_trackers.file, 
-                                            buff, 
-                                            btw, 
-                                            &sd_device_trackers.bw); 
-
-    // Set fault code if there is an access error and a file is open 
-    if (sd_device_trackers.fresult && sd_device_trackers.open_file) 
-    {
-        sd_device_trackers.fault_mode |= (SET_BIT << sd_device_trackers.fresult); 
-        sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_WRITE); 
-    }
-
-    return sd_device_trackers.fresult; 
+    return sd_file_write(SD_FILE_DEFAULT, buff, btw); 
 }
 
 
 // Write a string to the open file 
 int16_t sd_puts(const TCHAR *str) 
 {
-    // Check for void pointer? 
-    // Check for open file? 
+    sd_file_t *file = sd_file_get(SD_FILE_DEFAULT); 
+
+    if ((file == NULL) || (str == NULL))
+    {
+        return -1; 
+    }
+
+    LOG_PROF_START(prof_start); 
+
+    // Keep the file contents in order 
+    sd_buff_flush(); 
 
     // Writes a string to the file 
-    int16_t puts_return = f_puts(str, &sd_device_trackers.file); 
+    int16_t puts_return = f_puts(str, &file->file); 
 
-    // Set fault code if there is a function error and a file is open 
-    if ((puts_return < 0) && sd_device_trackers.open_file) 
+    // Set fault code if there is a function error 
+    if (puts_return < 0)
     {
         sd_device_trackers.fault_mode |= (SET_BIT << FR_DISK_ERR); 
         sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_WRITE); 
     }
 
+    LOG_PROF_STOP(prof_start, LOG_PROF_SD_PUTS); 
+
     return puts_return; 
 }
 
@@ -800,16 +1154,23 @@ int8_t sd_printf(
     const TCHAR *fmt_str, 
     uint16_t fmt_value) 
 {
-    // Check for void pointer? 
-    // Check for open file? 
+    sd_file_t *file = sd_file_get(SD_FILE_DEFAULT); 
+
+    if ((file == NULL) || (fmt_str == NULL))
+    {
+        return -1; 
+    }
+
+    // Keep the file contents in order 
+    sd_buff_flush(); 
 
     // Writes a formatted string to the file 
-    int8_t printf_return = f_printf(&sd_device_trackers.file, 
+    int8_t printf_return = f_printf(&file->file, 
                                     fmt_str, 
                                     fmt_value); 
 
-    // Set fault code if there is a function error and a file is open 
-    if ((printf_return < 0) && sd_device_trackers.open_file) 
+    // Set fault code if there is a function error 
+    if (printf_return < 0)
     {
         sd_device_trackers.fault_mode |= (SET_BIT << FR_DISK_ERR); 
         sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_WRITE); 
@@ -822,14 +1183,76 @@ int8_t sd_printf(
 // Navigate within the open file 
 FRESULT sd_lseek(FSIZE_t offset) 
 {
-    // Move to the specified position in the file 
-    sd_device_trackers.fresult = f_lseek(&sd_device_trackers.file, offset); 
+    return sd_file_lseek(SD_FILE_DEFAULT, offset); 
+}
+
+
+// Pre-allocate contiguous space for the open file 
+FRESULT sd_expand(FSIZE_t size) 
+{
+    sd_file_t *file = sd_file_get(SD_FILE_DEFAULT); 
 
-    // Set fault code if there is an access error and a file is open 
-    if (sd_device_trackers.fresult && sd_device_trackers.open_file) 
+    if (file == NULL)
+    {
+        return FR_INVALID_OBJECT; 
+    }
+
+    // Allocate the clusters now (opt == 1) so writes don't have to 
+    sd_device_trackers.fresult = f_expand(&file->file, size, SET_BIT); 
+
+    // Not enough contiguous space is not a fault - the file just won't be pre-allocated 
+    if (sd_device_trackers.fresult && (sd_device_trackers.fresult != FR_DENIED))
     {
         sd_device_trackers.fault_mode |= (SET_BIT << sd_device_trackers.fresult); 
-        sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_SEEK); 
+        sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_WRITE); 
+    }
+
+    return sd_device_trackers.fresult; 
+}
+
+
+// Truncate the open file at the read/write pointer 
+FRESULT sd_truncate(void) 
+{
+    sd_file_t *file = sd_file_get(SD_FILE_DEFAULT); 
+
+    if (file == NULL)
+    {
+        return FR_INVALID_OBJECT; 
+    }
+
+    // The file has to end after any buffered data 
+    sd_buff_flush(); 
+
+    sd_device_trackers.fresult = f_truncate(&file->file); 
+
+    // Set fault code if there is an access error 
+    if (sd_device_trackers.fresult)
+    {
+        sd_device_trackers.fault_mode |= (SET_BIT << sd_device_trackers.fresult); 
+        sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_WRITE); 
+    }
+
+    return sd_device_trackers.fresult; 
+}
+
+
+// Sync the open file 
+FRESULT sd_sync(void)
+{
+    sd_file_t *file = sd_file_get(SD_FILE_DEFAULT); 
+
+    if (file == NULL)
+    {
+        return FR_INVALID_OBJECT; 
+    }
+
+    sd_device_trackers.fresult = f_sync(&file->file); 
+
+    if (sd_device_trackers.fresult)
+    {
+        sd_device_trackers.fault_mode |= (SET_BIT << sd_device_trackers.fresult); 
+        sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_WRITE); 
     }
 
     return sd_device_trackers.fresult; 
@@ -846,28 +1269,286 @@ FRESULT sd_unlink(const TCHAR* filename)
     }
 
     TCHAR file_dir[SD_PATH_SIZE*3]; 
+    FILINFO file_info; 
+    const TCHAR *file_path = sd_file_path(&sd_device_trackers, filename, file_dir); 
 
-    // Establish 'path' as the root of the file directory 
-    strcpy(file_dir, sd_device_trackers.path); 
+    // The file size gives the clusters freed by the delete 
+    file_info.fsize = CLEAR; 
+    f_stat(file_path, &file_info); 
+
+    // Attempt to delete the specified file 
+    sd_device_trackers.fresult = f_unlink(file_path); 
 
-    // If 'dir' is not a null character then concatenate it to the file directory 
-    if (*sd_device_trackers.dir != NULL_CHAR)
+    // Set the fault code if the file failed to be deleted 
+    if (sd_device_trackers.fresult)
     {
-        strcat(file_dir, "/"); 
-        strcat(file_dir, sd_device_trackers.dir); 
+        sd_device_trackers.fault_mode |= (SET_BIT << sd_device_trackers.fresult); 
+        sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_DIR); 
+    }
+    else 
+    {
+        sd_free_update(&sd_device_trackers, file_info.fsize, 0); 
     }
 
-    strcat(file_dir, "/"); 
-    strcat(file_dir, filename); 
+    return sd_device_trackers.fresult; 
+}
 
-    // Attempt to delete the specified file 
-    sd_device_trackers.fresult = f_unlink(file_dir); 
 
-    // Set the fault code if the file failed to be deleted 
+// Buffered write to the open file 
+FRESULT sd_buff_write(
+    const void *buff, 
+    UINT btw) 
+{
+    sd_file_t *file = sd_file_get(SD_FILE_DEFAULT); 
+
+    if ((file == NULL) || (buff == NULL))
+    {
+        return FR_INVALID_OBJECT; 
+    }
+
+    const uint8_t *data = (const uint8_t *)buff; 
+    FRESULT fresult = FR_OK; 
+
+    while (btw)
+    {
+        // The buffer is written once it holds enough data to end the write on a sector 
+        // boundary of the file. This is a full buffer unless the file position is not 
+        // yet sector aligned (e.g. after a text header has been written). 
+        UINT limit = SD_BUFF_SIZE - 
+                     (UINT)(f_tell(&file->file) % SD_SECTOR_SIZE); 
+        UINT space = limit - sd_device_trackers.buff_len; 
+        UINT len = (btw < space) ? btw : space; 
+
+        memcpy((void *)&sd_device_trackers.buff[sd_device_trackers.buff_len], 
+               (void *)data, 
+               len); 
+        sd_device_trackers.buff_len += len; 
+        data += len; 
+        btw -= len; 
+
+        if (sd_device_trackers.buff_len >= limit)
+        {
+            if (sd_buff_write_file(&sd_device_trackers) != FR_OK)
+            {
+                fresult = sd_device_trackers.fresult; 
+            }
+        }
+    }
+
+    return fresult; 
+}
+
+
+// Buffered write of a string to the open file 
+int16_t sd_buff_puts(const TCHAR *str) 
+{
+    if (str == NULL)
+    {
+        return -1; 
+    }
+
+    UINT len = (UINT)strlen(str); 
+
+    if (sd_buff_write((void *)str, len) != FR_OK)
+    {
+        return -1; 
+    }
+
+    return (int16_t)len; 
+}
+
+
+// Flush the write buffer 
+FRESULT sd_buff_flush(void) 
+{
+    sd_file_t *file = &sd_device_trackers.files[SD_FILE_DEFAULT]; 
+
+    if (sd_device_trackers.buff_len && file->open)
+    {
+        return sd_buff_write_file(&sd_device_trackers); 
+    }
+
+    return FR_OK; 
+}
+
+
+// Read the free space from the volume 
+FRESULT sd_refresh_free(void)
+{
+    if (!sd_device_trackers.mount)
+    {
+        return FR_NOT_READY; 
+    }
+
+    return sd_getfree(&sd_device_trackers); 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// File handle functions 
+
+// Open a file in a free file handle 
+FRESULT sd_file_open(
+    const TCHAR *file_name, 
+    uint8_t mode, 
+    SD_HANDLE *handle)
+{
+    if (handle == NULL)
+    {
+        return FR_INVALID_OBJECT; 
+    }
+
+    *handle = SD_HANDLE_NONE; 
+
+    // The default handle is left for the single file functions 
+    for (SD_HANDLE i = SD_FILE_DEFAULT + 1; i < SD_NUM_FILES; i++)
+    {
+        if (!sd_device_trackers.files[i].open)
+        {
+            if (sd_file_open_handle(&sd_device_trackers, i, file_name, mode) == FR_OK)
+            {
+                *handle = i; 
+            }
+
+            return sd_device_trackers.fresult; 
+        }
+    }
+
+    return FR_TOO_MANY_OPEN_FILES; 
+}
+
+
+// Close a file handle 
+FRESULT sd_file_close(SD_HANDLE handle)
+{
+    sd_file_t *file = sd_file_get(handle); 
+
+    // Nothing to do if the file isn't open 
+    if (file == NULL)
+    {
+        return FR_OK; 
+    }
+
+    // Write out anything left in the write buffer first 
+    if (handle == SD_FILE_DEFAULT)
+    {
+        sd_buff_flush(); 
+    }
+
+    FSIZE_t size = f_size(&file->file); 
+    sd_device_trackers.fresult = f_close(&file->file); 
+
     if (sd_device_trackers.fresult)
     {
+        // Close file fault 
         sd_device_trackers.fault_mode |= (SET_BIT << sd_device_trackers.fresult); 
-        sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_DIR); 
+        sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_CLOSE); 
+    }
+    else 
+    {
+        // Update the free space estimate from what was written. It's left alone if the 
+        // close failed since what made it to the volume isn't known. 
+        sd_free_update(&sd_device_trackers, file->open_size, size); 
+    }
+
+    // Clear the open file flag regardless of the fault code 
+    file->open = CLEAR_BIT; 
+
+    return sd_device_trackers.fresult; 
+}
+
+
+// Write to a file handle 
+FRESULT sd_file_write(
+    SD_HANDLE handle, 
+    const void *buff, 
+    UINT btw)
+{
+    sd_file_t *file = sd_file_get(handle); 
+
+    if ((file == NULL) || (buff == NULL))
+    {
+        return FR_INVALID_OBJECT; 
+    }
+
+    // Keep the file contents in order 
+    if (handle == SD_FILE_DEFAULT)
+    {
+        sd_buff_flush(); 
+    }
+
+    sd_device_trackers.fresult = f_write(&file->file, buff, btw, &sd_device_trackers.bw); 
+
+    // Set fault code if there is an access error 
+    if (sd_device_trackers.fresult)
+    {
+        sd_device_trackers.fault_mode |= (SET_BIT << sd_device_trackers.fresult); 
+        sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_WRITE); 
+    }
+
+    return sd_device_trackers.fresult; 
+}
+
+
+// Read from a file handle 
+FRESULT sd_file_read(
+    SD_HANDLE handle, 
+    void *buff, 
+    UINT btr)
+{
+    sd_file_t *file = sd_file_get(handle); 
+
+    if ((file == NULL) || (buff == NULL))
+    {
+        return FR_INVALID_OBJECT; 
+    }
+
+    // Make sure buffered data can be read back 
+    if (handle == SD_FILE_DEFAULT)
+    {
+        sd_buff_flush(); 
+    }
+
+    sd_device_trackers.fresult = f_read(&file->file, buff, btr, &sd_device_trackers.br); 
+
+    // Set fault code if there is an access error 
+    if (sd_device_trackers.fresult)
+    {
+        sd_device_trackers.fault_mode |= (SET_BIT << sd_device_trackers.fresult); 
+        sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_READ); 
+    }
+
+    return sd_device_trackers.fresult; 
+}
+
+
+// Move the read/write pointer of a file handle 
+FRESULT sd_file_lseek(
+    SD_HANDLE handle, 
+    FSIZE_t offset)
+{
+    sd_file_t *file = sd_file_get(handle); 
+
+    if (file == NULL)
+    {
+        return FR_INVALID_OBJECT; 
+    }
+
+    // Buffered data belongs at the current position 
+    if (handle == SD_FILE_DEFAULT)
+    {
+        sd_buff_flush(); 
+    }
+
+    sd_device_trackers.fresult = f_lseek(&file->file, offset); 
+
+    // Set fault code if there is an access error 
+    if (sd_device_trackers.fresult)
+    {
+        sd_device_trackers.fault_mode |= (SET_BIT << sd_device_trackers.fresult); 
+        sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_SEEK); 
     }
 
     return sd_device_trackers.fresult; 
@@ -903,7 +1584,7 @@ SD_FAULT_MODE sd_get_fault_mode(void)
 // Get open file flag 
 SD_FILE_STATUS sd_get_file_status(void)
 {
-    return sd_device_trackers.open_file; 
+    return sd_device_trackers.files[SD_FILE_DEFAULT].open; 
 }
 
 
@@ -919,21 +1600,8 @@ FRESULT sd_get_exists(const TCHAR *str)
     // Local variables 
     TCHAR directory[SD_PATH_SIZE*3]; 
 
-    // Establish 'path' as the root of the file directory 
-    strcpy(directory, sd_device_trackers.path); 
-
-    // If 'dir' is not a null character then concatenate it to the file directory 
-    if (*sd_device_trackers.dir != NULL_CHAR)
-    {
-        strcat(directory, "/"); 
-        strcat(directory, sd_device_trackers.dir); 
-    }
-
-    strcat(directory, "/"); 
-    strcat(directory, str); 
-
     // Check for the existance of the directory 
-    return f_stat(directory, (FILINFO *)NULL); 
+    return f_stat(sd_file_path(&sd_device_trackers, str, directory), (FILINFO *)NULL); 
 }
 
 
@@ -942,20 +1610,7 @@ FRESULT sd_f_read(
     void *buff, 
     UINT btr) 
 {
-    // Read from the file 
-    sd_device_trackers.fresult = f_read(&sd_device_trackers.file, 
-                                           buff, 
-                                           btr, 
-                                           &sd_device_trackers.br); 
-    
-    // Set fault code if there is an access error and a file is open 
-    if (sd_device_trackers.fresult && sd_device_trackers.open_file) 
-    {
-        sd_device_trackers.fault_mode |= (SET_BIT << sd_device_trackers.fresult); 
-        sd_device_trackers.fault_code |= SD_FAULT_READ; 
-    }
-
-    return sd_device_trackers.fresult; 
+    return sd_file_read(SD_FILE_DEFAULT, buff, btr); 
 }
 
 
@@ -964,14 +1619,21 @@ TCHAR* sd_gets(
     TCHAR *buff, 
     uint16_t len)
 {
+    sd_file_t *file = sd_file_get(SD_FILE_DEFAULT); 
+
+    if ((file == NULL) || (buff == NULL))
+    {
+        return NULL; 
+    }
+
     // Read a string from the file 
-    TCHAR *gets_return = f_gets(buff, len, &sd_device_trackers.file); 
+    TCHAR *gets_return = f_gets(buff, len, &file->file); 
 
-    // Set fault code if there was a read operation error and a file is open 
-    if ((gets_return == NULL) && (!sd_eof()) && sd_device_trackers.open_file) 
+    // Set fault code if there was a read operation error 
+    if ((gets_return == NULL) && (!sd_eof()))
     {
         sd_device_trackers.fault_mode |= (SET_BIT << FR_DISK_ERR); 
-        sd_device_trackers.fault_code |= SD_FAULT_READ; 
+        sd_device_trackers.fault_code |= (SET_BIT << SD_FAULT_READ); 
     }
 
     return gets_return; 
@@ -981,7 +1643,7 @@ TCHAR* sd_gets(
 // Test for end of file on open file 
 SD_EOF sd_eof(void) 
 {
-    return (SD_EOF)f_eof(&sd_device_trackers.file); 
+    return (SD_EOF)f_eof(&sd_device_trackers.files[SD_FILE_DEFAULT].file); 
 }
 
 //=======================================================================================
@@ -0,0 +1,773 @@
+/**
+ * @file sd_spi.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief SD card SPI disk I/O 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include "sd_spi.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+// Commands - ACMD<n> is sent as CMD55 then CMD<n> 
+#define SD_SPI_ACMD 0x80                 // Application specific command flag 
+#define SD_SPI_CMD0 0                    // GO_IDLE_STATE 
+#define SD_SPI_CMD8 8                    // SEND_IF_COND 
+#define SD_SPI_CMD9 9                    // SEND_CSD 
+#define SD_SPI_CMD12 12                  // STOP_TRANSMISSION 
+#define SD_SPI_CMD13 13                  // SEND_STATUS 
+#define SD_SPI_CMD16 16                  // SET_BLOCKLEN 
+#define SD_SPI_CMD17 17                  // READ_SINGLE_BLOCK 
+#define SD_SPI_CMD18 18                  // READ_MULTIPLE_BLOCK 
+#define SD_SPI_CMD24 24                  // WRITE_BLOCK 
+#define SD_SPI_CMD25 25                  // WRITE_MULTIPLE_BLOCK 
+#define SD_SPI_CMD55 55                  // APP_CMD 
+#define SD_SPI_CMD58 58                  // READ_OCR 
+#define SD_SPI_ACMD13 (SD_SPI_ACMD | 13) // SD_STATUS 
+#define SD_SPI_ACMD23 (SD_SPI_ACMD | 23) // SET_WR_BLK_ERASE_COUNT 
+#define SD_SPI_ACMD41 (SD_SPI_ACMD | 41) // SD_SEND_OP_COND 
+
+// Command frame 
+#define SD_SPI_CMD_START 0x40            // Start and transmission bits 
+#define SD_SPI_CRC_CMD0 0x95             // CRC of CMD0 (arg 0) 
+#define SD_SPI_CRC_CMD8 0x87             // CRC of CMD8 (arg 0x1AA) 
+#define SD_SPI_CRC_NONE 0x01             // Stop bit - CRC isn't checked in SPI mode 
+#define SD_SPI_CMD8_ARG 0x000001AA       // 2.7-3.6V and check pattern 
+#define SD_SPI_ACMD41_HCS 0x40000000     // Host supports high capacity cards 
+#define SD_SPI_OCR_CCS 0x40              // Card capacity status (block addressing) 
+#define SD_SPI_NCR 10                    // Max bytes before a command response 
+
+// Responses and tokens 
+#define SD_SPI_R1_READY 0x00             // No errors 
+#define SD_SPI_R1_IDLE 0x01              // In the idle state (init) 
+#define SD_SPI_R1_INVALID 0x80           // Start bit clear in a valid response 
+#define SD_SPI_FILL 0xFF                 // Bus idle 
+#define SD_SPI_TOKEN_SINGLE 0xFE         // Start of a read block or single block write 
+#define SD_SPI_TOKEN_MULTI 0xFC          // Start of a multi-block write block 
+#define SD_SPI_TOKEN_STOP 0xFD           // End of a multi-block write 
+#define SD_SPI_DATA_RESP_MASK 0x1F       // Data response bits 
+#define SD_SPI_DATA_ACCEPTED 0x05        // Data response - block accepted 
+
+// Card type 
+#define SD_SPI_CT_SD1 0x01               // SD v1 
+#define SD_SPI_CT_SD2 0x02               // SD v2 
+#define SD_SPI_CT_BLOCK 0x04             // Block addressing (high capacity) 
+
+// Register sizes (bytes) 
+#define SD_SPI_CSD_SIZE 16               // Card specific data 
+#define SD_SPI_STATUS_SIZE 64            // SD status 
+#define SD_SPI_OCR_SIZE 4                // Operating conditions (and CMD8 response) 
+
+#define SD_SPI_INIT_CLOCKS 10            // Bytes clocked with the card deselected at init 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Variables 
+
+// SD card trackers 
+typedef struct sd_spi_trackers_s
+{
+    volatile DSTATUS stat;                      // Disk status 
+    uint8_t type;                               // Card type flags 
+    uint8_t stream : 1;                         // Multi-block write open 
+    LBA_t next;                                 // Next sector of the open write 
+    sd_spi_stats_t stats;                       // Transfer counts 
+}
+sd_spi_trackers_t; 
+
+
+// Instance of the SD card trackers 
+static sd_spi_trackers_t sd_spi = { .stat = STA_NOINIT }; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Function prototypes 
+
+/**
+ * @brief Wait for the card to be ready 
+ * 
+ * @details The card holds its output low while busy. 
+ * 
+ * @param timeout : max wait (us) 
+ * @return uint8_t : TRUE if ready 
+ */
+uint8_t sd_spi_wait_ready(uint32_t timeout); 
+
+
+/**
+ * @brief Select the card and wait for it to be ready 
+ * 
+ * @return uint8_t : TRUE if ready, FALSE if the card is still busy (deselected) 
+ */
+uint8_t sd_spi_select(void); 
+
+
+/**
+ * @brief Deselect the card 
+ * 
+ * @details One more byte is clocked so the card releases its output. 
+ */
+void sd_spi_deselect(void); 
+
+
+/**
+ * @brief Send a command 
+ * 
+ * @details Ends an open multi-block write and selects the card first except for 
+ *          CMD12, which stops a multi-block read. The card is left selected. 
+ * 
+ * @param cmd : command index (SD_SPI_ACMD set for an application specific command) 
+ * @param arg : command argument 
+ * @return uint8_t : R1 response, 0xFF if the card didn't respond 
+ */
+uint8_t sd_spi_cmd(
+    uint8_t cmd, 
+    uint32_t arg); 
+
+
+/**
+ * @brief Read a data block 
+ * 
+ * @param buff : buffer for the data 
+ * @param len : data size (bytes) 
+ * @return uint8_t : TRUE if read 
+ */
+uint8_t sd_spi_block_read(
+    uint8_t *buff, 
+    uint16_t len); 
+
+
+/**
+ * @brief Write a data block 
+ * 
+ * @details Waits for the card to finish the last block first. The card programs the 
+ *          block after it's accepted and doesn't hold up the caller. 
+ * 
+ * @param buff : block data 
+ * @param token : start token - single or multi-block write 
+ * @return uint8_t : TRUE if the card accepted the block 
+ */
+uint8_t sd_spi_block_write(
+    const uint8_t *buff, 
+    uint8_t token); 
+
+
+/**
+ * @brief End the open multi-block write 
+ * 
+ * @details Does nothing if there's no open write. The card is busy programming 
+ *          afterwards, which the next select waits for. 
+ */
+void sd_spi_stream_stop(void); 
+
+
+/**
+ * @brief Get the card size from the CSD register 
+ * 
+ * @param csd : CSD register 
+ * @return LBA_t : number of sectors 
+ */
+LBA_t sd_spi_csd_sectors(const uint8_t *csd); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// FatFs disk functions 
+
+// Disk init 
+DSTATUS disk_initialize(BYTE pdrv)
+{
+    uint8_t type = CLEAR, res, ocr[SD_SPI_OCR_SIZE]; 
+    uint32_t start; 
+
+    if (pdrv)
+    {
+        return STA_NOINIT; 
+    }
+
+    // Init clocks the card slowly. A card reset in a write no longer has it open. 
+    sd_spi.stream = CLEAR_BIT; 
+    sd_spi_port_speed(SD_SPI_SLOW); 
+    sd_spi_port_deselect(); 
+
+    for (uint8_t i = CLEAR; i < SD_SPI_INIT_CLOCKS; i++)
+    {
+        sd_spi_port_xchg(SD_SPI_FILL); 
+    }
+
+    if (sd_spi_cmd(SD_SPI_CMD0, CLEAR) == SD_SPI_R1_IDLE)
+    {
+        start = sd_spi_port_time(); 
+
+        if (sd_spi_cmd(SD_SPI_CMD8, SD_SPI_CMD8_ARG) == SD_SPI_R1_IDLE)
+        {
+            // SD v2 - the card has to take 2.7-3.6V and echo the check pattern 
+            for (uint8_t i = CLEAR; i < SD_SPI_OCR_SIZE; i++)
+            {
+                ocr[i] = sd_spi_port_xchg(SD_SPI_FILL); 
+            }
+
+            if ((ocr[2] == (uint8_t)(SD_SPI_CMD8_ARG >> 8)) && 
+                (ocr[3] == (uint8_t)SD_SPI_CMD8_ARG))
+            {
+                do
+                {
+                    res = sd_spi_cmd(SD_SPI_ACMD41, SD_SPI_ACMD41_HCS); 
+                }
+                while ((res == SD_SPI_R1_IDLE) && 
+                       ((sd_spi_port_time() - start) < SD_SPI_INIT_TIMEOUT)); 
+
+                if ((res == SD_SPI_R1_READY) && 
+                    (sd_spi_cmd(SD_SPI_CMD58, CLEAR) == SD_SPI_R1_READY))
+                {
+                    for (uint8_t i = CLEAR; i < SD_SPI_OCR_SIZE; i++)
+                    {
+                        ocr[i] = sd_spi_port_xchg(SD_SPI_FILL); 
+                    }
+
+                    type = (ocr[0] & SD_SPI_OCR_CCS) ? 
+                           (SD_SPI_CT_SD2 | SD_SPI_CT_BLOCK) : SD_SPI_CT_SD2; 
+                }
+            }
+        }
+        else 
+        {
+            // SD v1 - an MMC card rejects ACMD41 
+            do
+            {
+                res = sd_spi_cmd(SD_SPI_ACMD41, CLEAR); 
+            }
+            while ((res == SD_SPI_R1_IDLE) && 
+                   ((sd_spi_port_time() - start) < SD_SPI_INIT_TIMEOUT)); 
+
+            if ((res == SD_SPI_R1_READY) && 
+                (sd_spi_cmd(SD_SPI_CMD16, SD_SPI_BLOCK_SIZE) == SD_SPI_R1_READY))
+            {
+                type = SD_SPI_CT_SD1; 
+            }
+        }
+    }
+
+    sd_spi_deselect(); 
+    sd_spi.type = type; 
+
+    if (type)
+    {
+        sd_spi.stat &= ~STA_NOINIT; 
+        sd_spi_port_speed(SD_SPI_FAST); 
+    }
+    else 
+    {
+        sd_spi.stat = STA_NOINIT; 
+    }
+
+    return sd_spi.stat; 
+}
+
+
+// Disk status 
+DSTATUS disk_status(BYTE pdrv)
+{
+    return pdrv ? STA_NOINIT : sd_spi.stat; 
+}
+
+
+// Disk read 
+DRESULT disk_read(
+    BYTE pdrv, 
+    BYTE *buff, 
+    LBA_t sector, 
+    UINT count)
+{
+    uint32_t addr; 
+
+    if (pdrv || !count)
+    {
+        return RES_PARERR; 
+    }
+
+    if (sd_spi.stat & STA_NOINIT)
+    {
+        return RES_NOTRDY; 
+    }
+
+    addr = (sd_spi.type & SD_SPI_CT_BLOCK) ? sector : (sector * SD_SPI_BLOCK_SIZE); 
+
+    if (count == 1)
+    {
+        if ((sd_spi_cmd(SD_SPI_CMD17, addr) == SD_SPI_R1_READY) && 
+            sd_spi_block_read(buff, SD_SPI_BLOCK_SIZE))
+        {
+            sd_spi.stats.blocks_read++; 
+            count = CLEAR; 
+        }
+    }
+    else if (sd_spi_cmd(SD_SPI_CMD18, addr) == SD_SPI_R1_READY)
+    {
+        do
+        {
+            if (!sd_spi_block_read(buff, SD_SPI_BLOCK_SIZE))
+            {
+                break; 
+            }
+
+            sd_spi.stats.blocks_read++; 
+            buff += SD_SPI_BLOCK_SIZE; 
+        }
+        while (--count); 
+
+        sd_spi_cmd(SD_SPI_CMD12, CLEAR); 
+    }
+
+    sd_spi_deselect(); 
+
+    if (count)
+    {
+        sd_spi.stats.errors++; 
+        return RES_ERROR; 
+    }
+
+    return RES_OK; 
+}
+
+
+// Disk write 
+DRESULT disk_write(
+    BYTE pdrv, 
+    const BYTE *buff, 
+    LBA_t sector, 
+    UINT count)
+{
+    uint32_t addr; 
+
+    if (pdrv || !count)
+    {
+        return RES_PARERR; 
+    }
+
+    if (sd_spi.stat & STA_NOINIT)
+    {
+        return RES_NOTRDY; 
+    }
+
+    if (sd_spi.stream && (sector == sd_spi.next))
+    {
+        // The sectors follow the open multi-block write 
+        sd_spi_port_select(); 
+    }
+    else 
+    {
+        addr = (sd_spi.type & SD_SPI_CT_BLOCK) ? sector : (sector * SD_SPI_BLOCK_SIZE); 
+        sd_spi.stats.write_cmds++; 
+
+        if (count == 1)
+        {
+            if ((sd_spi_cmd(SD_SPI_CMD24, addr) == SD_SPI_R1_READY) && 
+                sd_spi_block_write(buff, SD_SPI_TOKEN_SINGLE))
+            {
+                sd_spi.stats.blocks_written++; 
+                count = CLEAR; 
+            }
+
+            sd_spi_deselect(); 
+
+            if (count)
+            {
+                sd_spi.stats.errors++; 
+                return RES_ERROR; 
+            }
+
+            return RES_OK; 
+        }
+
+        // The pre-erase count is only a hint so the write can carry on past it 
+        sd_spi_cmd(SD_SPI_ACMD23, count); 
+
+        if (sd_spi_cmd(SD_SPI_CMD25, addr) != SD_SPI_R1_READY)
+        {
+            sd_spi_deselect(); 
+            sd_spi.stats.errors++; 
+            return RES_ERROR; 
+        }
+
+        sd_spi.stream = SET_BIT; 
+    }
+
+    do
+    {
+        if (!sd_spi_block_write(buff, SD_SPI_TOKEN_MULTI))
+        {
+            break; 
+        }
+
+        sd_spi.stats.blocks_written++; 
+        buff += SD_SPI_BLOCK_SIZE; 
+        sector++; 
+    }
+    while (--count); 
+
+    sd_spi.next = sector; 
+    sd_spi_deselect(); 
+
+    if (count)
+    {
+        // A block wasn't taken so the write is ended 
+        sd_spi_stream_stop(); 
+        sd_spi.stats.errors++; 
+        return RES_ERROR; 
+    }
+
+    return RES_OK; 
+}
+
+
+// Disk control 
+DRESULT disk_ioctl(
+    BYTE pdrv, 
+    BYTE cmd, 
+    void *buff)
+{
+    DRESULT res = RES_ERROR; 
+    uint8_t reg[SD_SPI_STATUS_SIZE]; 
+
+    if (pdrv)
+    {
+        return RES_PARERR; 
+    }
+
+    if (sd_spi.stat & STA_NOINIT)
+    {
+        return RES_NOTRDY; 
+    }
+
+    switch (cmd)
+    {
+        case CTRL_SYNC: 
+            // Finish the open multi-block write and wait for the card to program it 
+            sd_spi_stream_stop(); 
+
+            if (sd_spi_select())
+            {
+                res = RES_OK; 
+            }
+            break; 
+
+        case GET_SECTOR_COUNT: 
+            if ((sd_spi_cmd(SD_SPI_CMD9, CLEAR) == SD_SPI_R1_READY) && 
+                sd_spi_block_read(reg, SD_SPI_CSD_SIZE))
+            {
+                *(LBA_t *)buff = sd_spi_csd_sectors(reg); 
+                res = RES_OK; 
+            }
+            break; 
+
+        case GET_BLOCK_SIZE: 
+            // Erase block size (sectors). v2 cards give the allocation unit size in the 
+            // SD status (R2 response) and v1 cards the erase sector size in the CSD. 
+            if (sd_spi.type & SD_SPI_CT_SD2)
+            {
+                if (sd_spi_cmd(SD_SPI_ACMD13, CLEAR) == SD_SPI_R1_READY)
+                {
+                    sd_spi_port_xchg(SD_SPI_FILL); 
+
+                    if (sd_spi_block_read(reg, SD_SPI_STATUS_SIZE))
+                    {
+                        *(DWORD *)buff = 16UL << (reg[10] >> 4); 
+                        res = RES_OK; 
+                    }
+                }
+            }
+            else if ((sd_spi_cmd(SD_SPI_CMD9, CLEAR) == SD_SPI_R1_READY) && 
+                     sd_spi_block_read(reg, SD_SPI_CSD_SIZE))
+            {
+                *(DWORD *)buff = ((((reg[10] & 0x3F) << 1) | 
+                                   ((reg[11] & 0x80) >> 7)) + 1) << 
+                                 ((reg[13] >> 6) - 1); 
+                res = RES_OK; 
+            }
+            break; 
+
+        default: 
+            res = RES_PARERR; 
+            break; 
+    }
+
+    sd_spi_deselect(); 
+
+    return res; 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Card functions 
+
+// Check if a card is there 
+uint8_t sd_spi_present(void)
+{
+    if (sd_spi.stat & STA_NOINIT)
+    {
+        disk_initialize(CLEAR); 
+    }
+
+    return !(sd_spi.stat & STA_NOINIT); 
+}
+
+
+// Check if the card still responds 
+uint8_t sd_spi_ready(void)
+{
+    uint8_t res; 
+
+    if (sd_spi.stat & STA_NOINIT)
+    {
+        return FALSE; 
+    }
+
+    // R2 response - the second byte (card status) isn't needed 
+    res = sd_spi_cmd(SD_SPI_CMD13, CLEAR); 
+    sd_spi_port_xchg(SD_SPI_FILL); 
+    sd_spi_deselect(); 
+
+    if (res != SD_SPI_R1_READY)
+    {
+        sd_spi.stat |= STA_NOINIT; 
+        return FALSE; 
+    }
+
+    return TRUE; 
+}
+
+
+// Get the transfer counts 
+const sd_spi_stats_t *sd_spi_get_stats(void)
+{
+    return &sd_spi.stats; 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Protocol functions 
+
+// Wait for the card to be ready 
+uint8_t sd_spi_wait_ready(uint32_t timeout)
+{
+    uint32_t start = sd_spi_port_time(); 
+
+    do
+    {
+        if (sd_spi_port_xchg(SD_SPI_FILL) == SD_SPI_FILL)
+        {
+            return TRUE; 
+        }
+    }
+    while ((sd_spi_port_time() - start) < timeout); 
+
+    return FALSE; 
+}
+
+
+// Select the card and wait for it to be ready 
+uint8_t sd_spi_select(void)
+{
+    sd_spi_port_select(); 
+
+    if (sd_spi_wait_ready(SD_SPI_BUSY_TIMEOUT))
+    {
+        return TRUE; 
+    }
+
+    sd_spi_deselect(); 
+
+    return FALSE; 
+}
+
+
+// Deselect the card 
+void sd_spi_deselect(void)
+{
+    sd_spi_port_deselect(); 
+    sd_spi_port_xchg(SD_SPI_FILL); 
+}
+
+
+// Send a command 
+uint8_t sd_spi_cmd(
+    uint8_t cmd, 
+    uint32_t arg)
+{
+    uint8_t res, crc = SD_SPI_CRC_NONE, n = SD_SPI_NCR; 
+
+    if (cmd & SD_SPI_ACMD)
+    {
+        cmd &= ~SD_SPI_ACMD; 
+        res = sd_spi_cmd(SD_SPI_CMD55, CLEAR); 
+
+        if (res > SD_SPI_R1_IDLE)
+        {
+            return res; 
+        }
+    }
+
+    if (cmd != SD_SPI_CMD12)
+    {
+        sd_spi_stream_stop(); 
+        sd_spi_deselect(); 
+
+        if (!sd_spi_select())
+        {
+            return SD_SPI_FILL; 
+        }
+    }
+
+    if (cmd == SD_SPI_CMD0)
+    {
+        crc = SD_SPI_CRC_CMD0; 
+    }
+    else if (cmd == SD_SPI_CMD8)
+    {
+        crc = SD_SPI_CRC_CMD8; 
+    }
+
+    sd_spi_port_xchg(SD_SPI_CMD_START | cmd); 
+    sd_spi_port_xchg((uint8_t)(arg >> 24)); 
+    sd_spi_port_xchg((uint8_t)(arg >> 16)); 
+    sd_spi_port_xchg((uint8_t)(arg >> 8)); 
+    sd_spi_port_xchg((uint8_t)arg); 
+    sd_spi_port_xchg(crc); 
+    sd_spi.stats.cmds++; 
+
+    // A stuff byte follows CMD12 
+    if (cmd == SD_SPI_CMD12)
+    {
+        sd_spi_port_xchg(SD_SPI_FILL); 
+    }
+
+    do
+    {
+        res = sd_spi_port_xchg(SD_SPI_FILL); 
+    }
+    while ((res & SD_SPI_R1_INVALID) && --n); 
+
+    return res; 
+}
+
+
+// Read a data block 
+uint8_t sd_spi_block_read(
+    uint8_t *buff, 
+    uint16_t len)
+{
+    uint32_t start = sd_spi_port_time(); 
+    uint8_t token; 
+
+    do
+    {
+        token = sd_spi_port_xchg(SD_SPI_FILL); 
+    }
+    while ((token == SD_SPI_FILL) && 
+           ((sd_spi_port_time() - start) < SD_SPI_TOKEN_TIMEOUT)); 
+
+    if (token != SD_SPI_TOKEN_SINGLE)
+    {
+        return FALSE; 
+    }
+
+    sd_spi_port_block(NULL, buff, len); 
+
+    // CRC isn't checked in SPI mode 
+    sd_spi_port_xchg(SD_SPI_FILL); 
+    sd_spi_port_xchg(SD_SPI_FILL); 
+
+    return TRUE; 
+}
+
+
+// Write a data block 
+uint8_t sd_spi_block_write(
+    const uint8_t *buff, 
+    uint8_t token)
+{
+    if (!sd_spi_wait_ready(SD_SPI_BUSY_TIMEOUT))
+    {
+        return FALSE; 
+    }
+
+    sd_spi_port_xchg(token); 
+    sd_spi_port_block(buff, NULL, SD_SPI_BLOCK_SIZE); 
+
+    // CRC isn't checked in SPI mode 
+    sd_spi_port_xchg(SD_SPI_FILL); 
+    sd_spi_port_xchg(SD_SPI_FILL); 
+
+    return ((sd_spi_port_xchg(SD_SPI_FILL) & SD_SPI_DATA_RESP_MASK) == 
+            SD_SPI_DATA_ACCEPTED); 
+}
+
+
+// End the open multi-block write 
+void sd_spi_stream_stop(void)
+{
+    if (!sd_spi.stream)
+    {
+        return; 
+    }
+
+    sd_spi.stream = CLEAR_BIT; 
+
+    if (sd_spi_select())
+    {
+        sd_spi_port_xchg(SD_SPI_TOKEN_STOP); 
+        sd_spi_port_xchg(SD_SPI_FILL); 
+    }
+
+    sd_spi_deselect(); 
+}
+
+
+// Get the card size from the CSD register 
+LBA_t sd_spi_csd_sectors(const uint8_t *csd)
+{
+    uint32_t c_size; 
+    uint8_t n; 
+
+    if ((csd[0] >> 6) == 1)
+    {
+        // CSD v2 - (C_SIZE + 1) * 512KB 
+        c_size = (uint32_t)csd[9] | ((uint32_t)csd[8] << 8) |
+                 ((uint32_t)(csd[7] & 0x3F) << 16); 
+        return (LBA_t)(c_size + 1) << 10; 
+    }
+
+    // CSD v1 - (C_SIZE + 1) * 2^(C_SIZE_MULT + 2) * 2^READ_BL_LEN bytes 
+    n = (csd[5] & 0x0F) + ((csd[10] & 0x80) >> 7) + 
+        ((csd[9] & 0x03) << 1) + 2; 
+    c_size = ((uint32_t)csd[8] >> 6) | ((uint32_t)csd[7] << 2) |
+             ((uint32_t)(csd[6] & 0x03) << 10); 
+
+    return (LBA_t)(c_size + 1) << (n - 9); 
+}
+
+//=======================================================================================
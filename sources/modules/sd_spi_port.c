@@ -0,0 +1,255 @@
+/**
+ * @file sd_spi_port.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief SD card SPI disk I/O - STM32 port 
+ * 
+ * @details SPI, DMA, slave select and timer access for the SD card SPI disk I/O. The 
+ *          SPI DMA requests are only on during a block transfer. The streams run 
+ *          without interrupts and a transfer is done when the RX stream turns itself 
+ *          off, so the DMA interrupt flags (cleared for the whole DMA port by other 
+ *          stream handlers) aren't needed. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include "sd_spi.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define SD_SPI_PORT_FILL 0xFF            // Byte sent when only receiving 
+
+// DMA stream flags - streams 0-3 are in the low registers and 4-7 in the high registers 
+#define SD_SPI_PORT_STREAMS 4            // Streams per flag register 
+#define SD_SPI_PORT_FLAGS 0x3D           // Flags of stream 0 (FEIF to TCIF) 
+#define SD_SPI_PORT_STREAM0 0x10         // Stream 0 register offset in the DMA port 
+#define SD_SPI_PORT_STREAM_SIZE 0x18     // Stream register block size 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Variables 
+
+// SD card port trackers 
+typedef struct sd_spi_port_trackers_s
+{
+    // Peripherals 
+    SPI_TypeDef *spi;                           // SPI port 
+    GPIO_TypeDef *gpio;                         // Slave select GPIO port 
+    gpio_pin_num_t ss_pin;                      // Slave select pin 
+    DMA_Stream_TypeDef *rx_stream;              // SPI RX DMA stream 
+    DMA_Stream_TypeDef *tx_stream;              // SPI TX DMA stream 
+    TIM_TypeDef *timer;                         // Timeout timer 
+
+    // Stream flag clear registers and flags 
+    volatile uint32_t *rx_ifcr;                 // RX stream flag clear register 
+    volatile uint32_t *tx_ifcr;                 // TX stream flag clear register 
+    uint32_t rx_flags;                          // RX stream flags 
+    uint32_t tx_flags;                          // TX stream flags 
+}
+sd_spi_port_trackers_t; 
+
+
+// Instance of the port trackers 
+static sd_spi_port_trackers_t sd_spi_port; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Function prototypes 
+
+/**
+ * @brief Get the flag clear register and flags of a DMA stream 
+ * 
+ * @param dma : DMA port of the stream 
+ * @param stream : DMA stream 
+ * @param flags : buffer for the stream flags 
+ * @return volatile uint32_t* : flag clear register of the stream 
+ */
+volatile uint32_t *sd_spi_port_flags(
+    DMA_TypeDef *dma, 
+    DMA_Stream_TypeDef *stream, 
+    uint32_t *flags); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Control functions 
+
+// SD card SPI disk I/O initialization 
+void sd_spi_init(
+    SPI_TypeDef *spi, 
+    GPIO_TypeDef *gpio, 
+    gpio_pin_num_t ss_pin, 
+    DMA_TypeDef *dma, 
+    DMA_Stream_TypeDef *rx_stream, 
+    DMA_Stream_TypeDef *tx_stream, 
+    TIM_TypeDef *timer)
+{
+    if ((spi == NULL) || (gpio == NULL) || (dma == NULL) || (rx_stream == NULL) || 
+        (tx_stream == NULL) || (timer == NULL))
+    {
+        return; 
+    }
+
+    sd_spi_port.spi = spi; 
+    sd_spi_port.gpio = gpio; 
+    sd_spi_port.ss_pin = ss_pin; 
+    sd_spi_port.rx_stream = rx_stream; 
+    sd_spi_port.tx_stream = tx_stream; 
+    sd_spi_port.timer = timer; 
+
+    sd_spi_port.rx_ifcr = sd_spi_port_flags(dma, rx_stream, &sd_spi_port.rx_flags); 
+    sd_spi_port.tx_ifcr = sd_spi_port_flags(dma, tx_stream, &sd_spi_port.tx_flags); 
+
+    spi->CR2 &= ~(SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN); 
+    sd_spi_port_speed(SD_SPI_SLOW); 
+    sd_spi_port_deselect(); 
+}
+
+
+// Get the flag clear register and flags of a DMA stream 
+volatile uint32_t *sd_spi_port_flags(
+    DMA_TypeDef *dma, 
+    DMA_Stream_TypeDef *stream, 
+    uint32_t *flags)
+{
+    static const uint8_t shift[SD_SPI_PORT_STREAMS] = { 0, 6, 16, 22 }; 
+    uint32_t index = ((uint32_t)((size_t)stream - (size_t)dma) - SD_SPI_PORT_STREAM0) / 
+                     SD_SPI_PORT_STREAM_SIZE; 
+
+    *flags = (uint32_t)SD_SPI_PORT_FLAGS << shift[index % SD_SPI_PORT_STREAMS]; 
+
+    return (index < SD_SPI_PORT_STREAMS) ? &dma->LIFCR : &dma->HIFCR; 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Port functions 
+
+// Select the card 
+void sd_spi_port_select(void)
+{
+    gpio_write(sd_spi_port.gpio, sd_spi_port.ss_pin, GPIO_LOW); 
+}
+
+
+// Deselect the card 
+void sd_spi_port_deselect(void)
+{
+    gpio_write(sd_spi_port.gpio, sd_spi_port.ss_pin, GPIO_HIGH); 
+}
+
+
+// Send a byte and return the byte received at the same time 
+uint8_t sd_spi_port_xchg(uint8_t data)
+{
+    SPI_TypeDef *spi = sd_spi_port.spi; 
+
+    while (!(spi->SR & SPI_SR_TXE)); 
+    spi->DR = data; 
+    while (!(spi->SR & SPI_SR_RXNE)); 
+
+    return (uint8_t)spi->DR; 
+}
+
+
+// Send and receive a block of data 
+void sd_spi_port_block(
+    const uint8_t *tx, 
+    uint8_t *rx, 
+    uint16_t len)
+{
+    static const uint8_t fill = SD_SPI_PORT_FILL; 
+    static uint8_t sink; 
+    SPI_TypeDef *spi = sd_spi_port.spi; 
+    DMA_Stream_TypeDef *rx_stream = sd_spi_port.rx_stream; 
+    DMA_Stream_TypeDef *tx_stream = sd_spi_port.tx_stream; 
+
+    // The data only moves through memory on the side that has a buffer. The other side 
+    // sends the fill byte or drops what's received. 
+    *sd_spi_port.rx_ifcr = sd_spi_port.rx_flags; 
+    *sd_spi_port.tx_ifcr = sd_spi_port.tx_flags; 
+
+    dma_stream_config(
+        rx_stream, 
+        (uint32_t)(size_t)(&spi->DR), 
+        (uint32_t)(size_t)((rx != NULL) ? rx : &sink), 
+        CLEAR,                   // No second buffer 
+        len); 
+    dma_stream_config(
+        tx_stream, 
+        (uint32_t)(size_t)(&spi->DR), 
+        (uint32_t)(size_t)((tx != NULL) ? tx : &fill), 
+        CLEAR,                   // No second buffer 
+        len); 
+
+    if (rx != NULL)
+    {
+        rx_stream->CR |= DMA_SxCR_MINC; 
+    }
+    else 
+    {
+        rx_stream->CR &= ~DMA_SxCR_MINC; 
+    }
+
+    if (tx != NULL)
+    {
+        tx_stream->CR |= DMA_SxCR_MINC; 
+    }
+    else 
+    {
+        tx_stream->CR &= ~DMA_SxCR_MINC; 
+    }
+
+    // RX goes first so no received byte is missed 
+    dma_stream_enable(rx_stream); 
+    dma_stream_enable(tx_stream); 
+    spi->CR2 |= SPI_CR2_RXDMAEN; 
+    spi->CR2 |= SPI_CR2_TXDMAEN; 
+
+    // The RX stream turns off after the last byte is received 
+    while (rx_stream->CR & DMA_SxCR_EN); 
+
+    spi->CR2 &= ~(SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN); 
+}
+
+
+// Set the SPI clock speed 
+void sd_spi_port_speed(uint8_t speed)
+{
+    SPI_TypeDef *spi = sd_spi_port.spi; 
+    uint32_t br = (speed == SD_SPI_FAST) ? SD_SPI_BR_FAST : SD_SPI_BR_SLOW; 
+
+    // The clock can only be changed with the port off 
+    while (spi->SR & SPI_SR_BSY); 
+    spi->CR1 &= ~SPI_CR1_SPE; 
+    spi->CR1 = (spi->CR1 & ~SPI_CR1_BR) | (br << SPI_CR1_BR_Pos); 
+    spi->CR1 |= SPI_CR1_SPE; 
+}
+
+
+// Get the time 
+uint32_t sd_spi_port_time(void)
+{
+    return sd_spi_port.timer->CNT; 
+}
+
+//=======================================================================================
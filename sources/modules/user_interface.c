@@ -23,6 +23,7 @@
 #include "hd44780u_config.h"
 #include "battery_config.h"
 #include "hd44780u_controller.h"
+#include "m8q_controller.h"
 
 //=======================================================================================
 
@@ -378,9 +379,10 @@ void ui_soc_update(void)
     if (soc_calc_counter++ >= UI_SOC_CALC_PERIOD)
     {
         // Read the battery voltage and calculate the current SOC using battery specific 
-        // information. 
+        // information. The battery voltage is oversampled so it's scaled to the 10-bit 
+        // resolution of the battery information. 
         soc_calc_counter = CLEAR; 
-        mtbdl_ui.soc = battery_soc_calc(log_get_batt_voltage()); 
+        mtbdl_ui.soc = battery_soc_calc(log_get_batt_voltage() >> LOG_ADC_OSR_BITS); 
     }
 }
 
@@ -429,7 +431,7 @@ void ui_gps_led_status_update(void)
 
     // Monitor the GPS position lock status and update the LED and screen message 
     // for feedback. 
-    if (m8q_get_position_navstat_lock())
+    if (m8q_get_navstat_lock())
     {
         ui_led_state_update(WS2812_LED_1); 
 
@@ -482,7 +484,7 @@ void ui_set_idle_msg(void)
         msg[i] = mtbdl_idle_msg[i]; 
     }
 
-    mtbdl_ui.navstat = m8q_get_position_navstat(); 
+    mtbdl_ui.navstat = m8q_get_navstat(); 
 
     // Format the messages with data 
     // snprintf will NULL terminate the string at the screen line length so in order to use 
@@ -532,7 +534,7 @@ void ui_set_run_prep_msg(void)
         msg[i] = mtbdl_run_prep_msg[i]; 
     }
 
-    mtbdl_ui.navstat = m8q_get_position_navstat(); 
+    mtbdl_ui.navstat = m8q_get_navstat(); 
 
     // Format the message with data 
     snprintf(msg[HD44780U_L1].msg, 
@@ -648,6 +650,19 @@ uint8_t ui_tx_prep(void)
     // Check for the existance of the specified file number 
     if (sd_get_exists(mtbdl_ui.filename) == FR_NO_FILE)
     {
+        // Binary logs share the log index but can't be sent line by line. They're 
+        // decoded on a host after being copied off the SD card so the index is left 
+        // as is if the log exists in binary form. 
+        snprintf(mtbdl_ui.filename, 
+                 MTBDL_MAX_STR_LEN, 
+                 mtbdl_log_file_bin, 
+                 (log_index - UI_LOG_INDEX_OFFSET)); 
+
+        if (sd_get_exists(mtbdl_ui.filename) == FR_OK)
+        {
+            return FALSE; 
+        }
+
         // If the file does not exist then decrement the file index. At the top of this 
         // function we already check if the index is 0 which means if we get to this 
         // point then the index is greater than 0. 
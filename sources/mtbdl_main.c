@@ -792,10 +792,21 @@ void mtbdl_app(void)
     mtbdl_trackers.state = next_state; 
 
     // Call device controllers 
+    LOG_PROF_START(prof_start); 
     hd44780u_controller(); 
+    LOG_PROF_STOP(prof_start, LOG_PROF_HD44780U); 
+
+    LOG_PROF_START(prof_sd); 
     sd_controller(); 
+    LOG_PROF_STOP(prof_sd, LOG_PROF_SD_CTRL); 
+
+    LOG_PROF_START(prof_mpu6050); 
     mpu6050_controller(DEVICE_ONE); 
+    LOG_PROF_STOP(prof_mpu6050, LOG_PROF_MPU6050); 
+
+    LOG_PROF_START(prof_m8q); 
     m8q_controller(); 
+    LOG_PROF_STOP(prof_m8q, LOG_PROF_M8Q); 
 }
 
 
@@ -2456,11 +2467,14 @@ void mtbdl_fault_state_entry(mtbdl_trackers_t *mtbdl)
 
     // Write the fault code to a file on the SD card 
     char fault_str_buff[MTBDL_MAX_STR_LEN]; 
+    SD_HANDLE fault_file; 
     sd_set_dir(mtbdl_fault_dir); 
-    sd_open(mtbdl_bike_param_file, SD_MODE_W); 
-    snprintf(fault_str_buff, MTBDL_MAX_STR_LEN, mtbdl_fault_info, mtbdl->fault_code); 
-    sd_puts(fault_str_buff); 
-    sd_close(); 
+    if (sd_file_open(mtbdl_fault_file, SD_MODE_W, &fault_file) == FR_OK)
+    {
+        snprintf(fault_str_buff, MTBDL_MAX_STR_LEN, mtbdl_fault_info, mtbdl->fault_code); 
+        sd_file_write(fault_file, fault_str_buff, (UINT)strlen(fault_str_buff)); 
+        sd_file_close(fault_file); 
+    }
 
     // Set user button LED colours 
     ui_led_colour_set(WS2812_LED_7, mtbdl_led_clear); 
@@ -68,14 +68,43 @@ void mtbdl_init()
         TIM_UP_INT_ENABLE); 
     tim_enable(TIM10); 
 
-    // Periodic (counter update) interrupt timer for data log timing. The interrupt is 
-    // further configured at the end of the setup. 
-    tim_9_to_11_counter_init(
-        TIM11, 
-        TIM_84MHZ_100US_PSC, 
-        0x0064,  // ARR=100, (100 counts)*(100us/count) = 10ms 
-        TIM_UP_INT_ENABLE); 
-    tim_enable(TIM11); 
+    // Data log sample timer. The counter update event is used as the trigger output 
+    // (TRGO) which starts each ADC conversion sequence in hardware so the sample timing 
+    // doesn't depend on interrupts or CPU load. No interrupt is used. The period is set 
+    // by the suspension sample rate (LOG_SUS_RATE) and the oversampling ratio 
+    // (LOG_ADC_OSR) so there are LOG_ADC_OSR conversions every sample period. The timer 
+    // counts at the full 84MHz so the period is exact for every supported rate. The 
+    // timer is enabled at the end of the setup once the ADC DMA stream is running. 
+    RCC->APB1ENR |= RCC_APB1ENR_TIM2EN; 
+    TIM2->PSC = CLEAR; 
+    TIM2->ARR = ((84000 * LOG_PERIOD) / LOG_ADC_OSR) - 1;   // (84 counts/us)*(1000us/ms) 
+    TIM2->CR2 = TIM_CR2_MMS_1;    // TRGO on counter update 
+    TIM2->EGR = TIM_EGR_UG;       // Load the prescaler 
+
+    // Timebase. Free running 32-bit 1us counter that times the ADC samples and the 
+    // GPS and IMU reads in the log (wraps every 71.6 minutes). No interrupt is used. The 
+    // timer is enabled at the end of the setup. 
+    RCC->APB1ENR |= RCC_APB1ENR_TIM5EN; 
+    TIM5->PSC = 84 - 1;           // (84MHz / 84) = 1 count/us 
+    TIM5->ARR = 0xFFFFFFFF;       // Max ARR value 
+    TIM5->EGR = TIM_EGR_UG;       // Load the prescaler 
+
+#if LOG_SPEED_CAPTURE
+    // Wheel revolution capture on the timebase. Channel 1 captures the falling edge of 
+    // the Hall effect sensor on PA0 (AF2) and each capture requests a DMA transfer of 
+    // the timestamp (see log_rev_capture_init). The input filter needs 8 samples in a 
+    // row at 84MHz to see an edge so short glitches are rejected. 
+    GPIOA->MODER = (GPIOA->MODER & ~(0x3UL << 0)) | (0x2UL << 0);   // Alternate function 
+    GPIOA->PUPDR = (GPIOA->PUPDR & ~(0x3UL << 0)) | (0x1UL << 0);   // Pull-up 
+    GPIOA->AFR[0] = (GPIOA->AFR[0] & ~(0xFUL << 0)) | (0x2UL << 0); // AF2 (TIM5_CH1) 
+    TIM5->CCMR1 = TIM_CCMR1_CC1S_0 | TIM_CCMR1_IC1F_1 | TIM_CCMR1_IC1F_0;   // TI1, N=8 
+    TIM5->CCER = TIM_CCER_CC1P | TIM_CCER_CC1E;   // Capture on the falling edge 
+    TIM5->DIER = TIM_DIER_CC1DE;  // DMA request on capture 
+#endif
+
+    // Cycle counter used to time code when execution time profiling is enabled 
+    // (LOG_PROF_ENABLE). This does nothing otherwise. 
+    LOG_PROF_INIT(); 
 
     //==================================================
 
@@ -99,7 +128,8 @@ void mtbdl_init()
     //==================================================
     // SPI setup 
 
-    // For SD card 
+    // For SD card. The SD card disk I/O sets the clock from here on (slow for card init 
+    // then fast). 
     spi_init(
         SPI2, 
         GPIOB, 
@@ -166,7 +196,7 @@ void mtbdl_init()
         ADC1, 
         ADC1_COMMON, 
         ADC_PCLK2_4, 
-        ADC_RES_10, 
+        ADC_RES_10,            // LOG_ADC_CONV_BITS 
         ADC_PARAM_ENABLE,      // ADC_EOC_EACH 
         ADC_PARAM_DISABLE,     // ADC_EOC_INT_DISABLE 
         ADC_PARAM_ENABLE,      // ADC_SCAN_ENABLE 
@@ -188,6 +218,9 @@ void mtbdl_init()
     // Set the sequence length (called once and only for more than one channel) 
     adc_seq_len_set(ADC1, (adc_seq_num_t)ADC_BUFF_SIZE); 
 
+    // Start the conversion sequence on the rising edge of the TIM2 trigger output 
+    ADC1->CR2 |= (ADC_CR2_EXTEN_0 | ADC_CR2_EXTSEL_2 | ADC_CR2_EXTSEL_1); 
+
     // Turn the ADC on 
     adc_on(ADC1); 
 
@@ -204,7 +237,7 @@ void mtbdl_init()
         DMA_DIR_PM, 
         DMA_CM_ENABLE,
         DMA_PRIOR_VHI, 
-        DMA_DBM_DISABLE,        // Double buffer mode configuration 
+        DMA_DBM_ENABLE,         // Double buffer mode configuration 
         DMA_ADDR_INCREMENT, 
         DMA_ADDR_FIXED, 
         DMA_DATA_SIZE_HALF, 
@@ -224,6 +257,75 @@ void mtbdl_init()
         DMA_DATA_SIZE_BYTE, 
         DMA_DATA_SIZE_BYTE);
 
+    // DMA1 stream init - I2C1 RX - I2C bus manager reads (IMU and GPS) 
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN; 
+    dma_stream_init(
+        DMA1, 
+        DMA1_Stream0, 
+        DMA_CHNL_1, 
+        DMA_DIR_PM, 
+        DMA_CM_DISABLE,       // One stream transfer per read 
+        DMA_PRIOR_HI, 
+        DMA_DBM_DISABLE, 
+        DMA_ADDR_INCREMENT, 
+        DMA_ADDR_FIXED,       // No peripheral increment - copy from DR only 
+        DMA_DATA_SIZE_BYTE, 
+        DMA_DATA_SIZE_BYTE); 
+
+    // I2C bus manager - must come before the devices on I2C1 that post transactions. 
+    // Finished transactions are timed with the timebase. 
+    i2c_bus_init(I2C1, DMA1, DMA1_Stream0, TIM5); 
+
+    // I2C bus manager interrupts (I2C1 event, error and RX DMA). These are enabled here 
+    // instead of at the end because device setup below already posts transactions. 
+    nvic_config(I2C1_EV_IRQn, EXTI_PRIORITY_2); 
+    nvic_config(I2C1_ER_IRQn, EXTI_PRIORITY_2); 
+    nvic_config(DMA1_Stream0_IRQn, EXTI_PRIORITY_2); 
+
+    // DMA1 stream init - SPI2 RX - SD card data blocks 
+    dma_stream_init(
+        DMA1, 
+        DMA1_Stream3, 
+        DMA_CHNL_0, 
+        DMA_DIR_PM, 
+        DMA_CM_DISABLE,       // One stream transfer per block 
+        DMA_PRIOR_HI, 
+        DMA_DBM_DISABLE, 
+        DMA_ADDR_INCREMENT,   // Set for each block - off when the data is dropped 
+        DMA_ADDR_FIXED,       // No peripheral increment - copy from DR only 
+        DMA_DATA_SIZE_BYTE, 
+        DMA_DATA_SIZE_BYTE); 
+
+    // DMA1 stream init - SPI2 TX - SD card data blocks 
+    dma_stream_init(
+        DMA1, 
+        DMA1_Stream4, 
+        DMA_CHNL_0, 
+        DMA_DIR_MP, 
+        DMA_CM_DISABLE,       // One stream transfer per block 
+        DMA_PRIOR_HI, 
+        DMA_DBM_DISABLE, 
+        DMA_ADDR_INCREMENT,   // Set for each block - off when sending the fill byte 
+        DMA_ADDR_FIXED,       // No peripheral increment - copy to DR only 
+        DMA_DATA_SIZE_BYTE, 
+        DMA_DATA_SIZE_BYTE); 
+
+#if LOG_SPEED_CAPTURE
+    // DMA1 stream init - TIM5 channel 1 - wheel revolution capture 
+    dma_stream_init(
+        DMA1, 
+        DMA1_Stream2, 
+        DMA_CHNL_6, 
+        DMA_DIR_PM, 
+        DMA_CM_ENABLE,
+        DMA_PRIOR_HI, 
+        DMA_DBM_DISABLE, 
+        DMA_ADDR_INCREMENT,   // Next timestamp in the buffer 
+        DMA_ADDR_FIXED,       // No peripheral increment - copy from CCR1 only 
+        DMA_DATA_SIZE_WORD, 
+        DMA_DATA_SIZE_WORD);
+#endif
+
     // Configure the DMA stream 
     // The ADC DMA stream is configured in the data logging module init function. This 
     // is done so the ADC buffer in the data logging module can be used. The stream 
@@ -240,6 +342,7 @@ void mtbdl_init()
     // Initialize external interrupts 
     exti_init(); 
 
+#if !LOG_SPEED_CAPTURE
     // Wheel revolutions interrupt configuration 
     exti_config(
         GPIOB, 
@@ -251,6 +354,7 @@ void mtbdl_init()
         EXTI_EVENT_MASKED, 
         EXTI_RISE_TRIG_DISABLE, 
         EXTI_FALL_TRIG_ENABLE); 
+#endif
 
     // Further interrupt setup is done at the end. 
 
@@ -308,6 +412,20 @@ void mtbdl_init()
     m8q_pwr_pin_init(GPIOC, PIN_10); 
     m8q_txr_pin_init(GPIOC, PIN_11); 
 
+    // TX ready interrupt configuration. The pin is set (active high) when the data waiting 
+    // in the device passes the TX ready threshold of the port configuration so the 
+    // controller only reads the device when it has data. 
+    exti_config(
+        GPIOC, 
+        EXTI_PC, 
+        PIN_11, 
+        PUPDR_NO, 
+        EXTI_L11, 
+        EXTI_INT_NOT_MASKED, 
+        EXTI_EVENT_MASKED, 
+        EXTI_RISE_TRIG_ENABLE, 
+        EXTI_FALL_TRIG_DISABLE); 
+
     // Controller 
     m8q_controller_init(TIM9); 
     
@@ -332,8 +450,8 @@ void mtbdl_init()
     //==================================================
     // SD card setup 
 
-    // User initialization 
-    sd_user_init(SPI2, GPIOB, TIM9, GPIOX_PIN_12);
+    // Disk I/O - SPI2 with DMA1 streams 3 (RX) and 4 (TX). Timeouts use the timebase. 
+    sd_spi_init(SPI2, GPIOB, GPIOX_PIN_12, DMA1, DMA1_Stream3, DMA1_Stream4, TIM5); 
 
     // Controller init 
     sd_controller_init(mtbdl_dir);
@@ -403,10 +521,23 @@ void mtbdl_init()
     // This function handles DMA stream init so that the correct ADC buffer can be used. 
     log_init(
         EXTI0_IRQn, 
-        TIM1_TRG_COM_TIM11_IRQn, 
+        DMA2_Stream0_IRQn, 
         ADC1, 
         DMA2, 
         DMA2_Stream0); 
+
+    // Log data times 
+    log_timebase_init(TIM5); 
+
+#if LOG_SPEED_CAPTURE
+    // Wheel revolution timestamps from TIM5 channel 1 
+    log_rev_capture_init(TIM5, DMA1_Stream2); 
+#endif
+
+#if LOG_IMU_RATE
+    // MPU-6050 FIFO - the IMU controller is set up above 
+    log_imu_fifo_init(I2C1, MPU6050_ADDR_1); 
+#endif
     
     //==================================================
 
@@ -425,22 +556,37 @@ void mtbdl_init()
     dma_stream_enable(DMA2_Stream0);    // ADC1 
     dma_stream_enable(DMA2_Stream2);    // UART1 - HC-05 
 
+    // Start the ADC sample timer now that the ADC DMA stream is ready for data 
+    tim_enable(TIM2); 
+
+    // Start the timebase. With input capture this also starts capturing wheel 
+    // revolutions. 
+#if LOG_SPEED_CAPTURE
+    dma_stream_enable(DMA1_Stream2);    // TIM5 channel 1 
+#endif
+    tim_enable(TIM5); 
+
     // Periodic interrupt (button and LED updates): Enable the interrupt handler 
     nvic_config(TIM1_UP_TIM10_IRQn, EXTI_PRIORITY_2); 
 
-    // Periodic interrupt (data logging): Set the interrupt priority and disable until 
+    // ADC DMA interrupt (data logging): Set the interrupt priority and disable until 
     // data logging starts 
-    NVIC_SetPriority(TIM1_TRG_COM_TIM11_IRQn, EXTI_PRIORITY_1); 
-    NVIC_DisableIRQ(TIM1_TRG_COM_TIM11_IRQn); 
+    NVIC_SetPriority(DMA2_Stream0_IRQn, EXTI_PRIORITY_1); 
+    NVIC_DisableIRQ(DMA2_Stream0_IRQn); 
 
+#if !LOG_SPEED_CAPTURE
     // External interrupt (wheel speed sensor): Set the interrupt priority and disable 
     // until data logging starts 
     NVIC_SetPriority(EXTI0_IRQn, EXTI_PRIORITY_0); 
     NVIC_DisableIRQ(EXTI0_IRQn); 
+#endif
 
     // UART1 RX interrupt (HC-05 receive) 
     nvic_config(USART1_IRQn, EXTI_PRIORITY_3);
 
+    // External interrupt (M8Q TX ready): The handler only flags that the device has data 
+    nvic_config(EXTI15_10_IRQn, EXTI_PRIORITY_3); 
+
     //==================================================
 }
 
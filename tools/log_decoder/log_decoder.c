@@ -0,0 +1,1011 @@
+/**
+ * @file log_decoder.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Binary data log decoder 
+ * 
+ * @details Host tool that converts a binary data log (log_<n>.bin) into the text data 
+ *          log format. The text header is copied as is and each record is formatted 
+ *          using the same writers the data logging module uses in text mode, so the 
+ *          output matches what the system would have written in text mode. Packed logs 
+ *          are decoded the same way with each ADC block unpacked into ADC records. Text 
+ *          after the end record (the profiling footer) is copied as is. 
+ * 
+ *          Sync records are checked against the header record before anything is 
+ *          decoded to find where the log data ends (see log_record.h). Records are only 
+ *          decoded up to the last sync record that checks out, or up to the end record 
+ *          if it directly follows it, so stale data past the end of a log that wasn't 
+ *          closed isn't decoded as part of it. Sync records have no place in the text 
+ *          format and aren't written. 
+ * 
+ *          IMU records have no place in the text format so their samples are written to 
+ *          a separate IMU log if one is given, one sample per line. A line of blank 
+ *          fields marks where samples were lost. 
+ * 
+ *          Record times have no place in the text format either so they're written to a 
+ *          separate time log if one is given, one line per time with the record it came 
+ *          from, the ADC sample it was logged with and the unwrapped timebase time. ADC 
+ *          times also show how far the sample is from where the sample rate puts it 
+ *          (counted from the first ADC time), which shows gaps and jitter in the log. 
+ * 
+ *          Usage: log_decoder <binary log> [text log] [IMU log] [time log] 
+ * 
+ *          Output goes to stdout if no text log file is given. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "log_record.h"
+#include "log_pack.h"
+#include "log_format.h"
+#include "string_config.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define LOG_DECODER_LINE_LEN 320         // Max length of a text header or data log line 
+#define LOG_DECODER_REV_MAX 16           // Max periods in a revolution period record 
+#define LOG_DECODER_IMU_HEADER "IMU rate: %uHz\r\nax, ay, az, gx, gy, gz\r\n" 
+#define LOG_DECODER_IMU_SAMPLE "%d, %d, %d, %d, %d, %d\r\n" 
+#define LOG_DECODER_IMU_LOST "-, -, -, -, -, -\r\n" 
+#define LOG_DECODER_TIME_HEADER "Sample period: %uus\r\nrecord, sample, time, offset\r\n" 
+#define LOG_DECODER_TIME_ADC "ADC, %llu, %llu, %lld\r\n" 
+#define LOG_DECODER_TIME_STREAM "%s, %llu, %llu, -\r\n" 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Enums 
+
+// Stream records that follow the pending ADC record (bits) 
+typedef enum {
+    LOG_DECODER_SPEED = 0x01,    // Wheel speed (revolution window sums) 
+    LOG_DECODER_REV = 0x02,      // Wheel revolution period 
+    LOG_DECODER_ACCEL = 0x04,    // Accelerometer 
+    LOG_DECODER_GPS = 0x08,      // GPS (PUBX strings) 
+    LOG_DECODER_PVT = 0x10       // GPS (UBX NAV-PVT) 
+} log_decoder_stream_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// Decoder data 
+typedef struct log_decoder_s
+{
+    FILE *in;                                   // Binary log file 
+    FILE *out;                                  // Text log output 
+    FILE *imu;                                  // IMU log output (NULL if not used) 
+    FILE *time;                                 // Time log output (NULL if not used) 
+    uint8_t trailmark;                          // Trail marker for the next ADC record 
+    uint8_t adc_pending;                        // ADC record waiting for stream records 
+    log_rec_adc_t adc;                          // Pending ADC record 
+    uint8_t streams;                            // Stream records of the pending ADC record 
+    log_rec_speed_t speed;                      // Pending wheel speed record 
+    log_rec_rev_period_t rev;                   // Pending revolution period record 
+    uint32_t rev_periods[LOG_DECODER_REV_MAX];  // Periods of the revolution period record 
+    log_rec_accel_t accel;                      // Pending accelerometer record 
+    log_rec_gps_t gps;                          // Pending GPS record 
+    log_rec_gps_pvt_t pvt;                      // Pending GPS NAV-PVT record 
+    log_unpack_t unpack;                        // ADC block unpacking 
+    uint64_t samples;                           // ADC samples decoded 
+    uint8_t time_pending;                       // Time record for the next ADC sample 
+    uint32_t time_count;                        // Timebase count of the time record 
+    uint8_t time_valid;                         // A time has been decoded 
+    uint32_t time_last;                         // Last timebase count decoded 
+    uint64_t time_us;                           // (us) Last time decoded, unwrapped 
+    uint64_t time_first;                        // (us) First ADC time 
+    uint64_t sample_first;                      // ADC sample of the first ADC time 
+    uint32_t sample_period;                     // (us) Time between ADC samples 
+    long data_start;                            // File offset of the first data record 
+    long data_end;                              // File offset where the log data ends 
+    char line[LOG_DECODER_LINE_LEN];            // Formatted log line 
+}
+log_decoder_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Prototypes 
+
+/**
+ * @brief Copy the text header 
+ * 
+ * @details Copies the text header of the log to the output up to and including the line 
+ *          that signifies the start of the data log. 
+ * 
+ * @param decoder : decoder data 
+ * @return int : 0 if the start of the data log was found, -1 otherwise 
+ */
+static int log_decoder_header(log_decoder_t *decoder); 
+
+
+/**
+ * @brief Read the payload of a record 
+ * 
+ * @details Reads the rest of a record after its tag has been read. The tag is stored at 
+ *          the start of the record. 
+ * 
+ * @param decoder : decoder data 
+ * @param record : buffer to store the record 
+ * @param size : record size (bytes) 
+ * @param tag : record tag that has already been read 
+ * @return int : 0 if the whole record was read, -1 otherwise 
+ */
+static int log_decoder_read(
+    log_decoder_t *decoder, 
+    void *record, 
+    size_t size, 
+    uint8_t tag); 
+
+
+/**
+ * @brief Write the pending ADC record 
+ * 
+ * @details Writes the pending ADC record (if there is one) and the stream records that 
+ *          followed it as one log line. Stream fields are written in line order (speed, 
+ *          accelerometer, GPS) with blank fields for the streams that weren't there. 
+ *          This is called when the record that follows is not a stream record. 
+ * 
+ * @param decoder : decoder data 
+ */
+static void log_decoder_flush(log_decoder_t *decoder); 
+
+
+/**
+ * @brief Read a stream record 
+ * 
+ * @details Reads a stream record into the decoder and adds it to the streams of the 
+ *          pending ADC record. Every stream record follows the ADC record of its 
+ *          interval and a stream only has one record in an interval. 
+ * 
+ * @param decoder : decoder data 
+ * @param record : where to store the record 
+ * @param size : record size (bytes) 
+ * @param tag : record tag that has already been read 
+ * @param stream : stream of the record 
+ * @return int : 0 if the record was read, -1 otherwise 
+ */
+static int log_decoder_stream(
+    log_decoder_t *decoder, 
+    void *record, 
+    size_t size, 
+    uint8_t tag, 
+    uint8_t stream); 
+
+
+/**
+ * @brief Decode a packed ADC block 
+ * 
+ * @details Unpacks the samples of a block and handles each one like an ADC record. The 
+ *          last sample is left pending for the stream record that may follow the block. 
+ * 
+ * @param decoder : decoder data 
+ * @param tag : record tag that has already been read 
+ * @return int : 0 if the block was decoded, -1 otherwise 
+ */
+static int log_decoder_block(
+    log_decoder_t *decoder, 
+    uint8_t tag); 
+
+
+/**
+ * @brief Decode an IMU record 
+ * 
+ * @details Reads the samples that follow the record and writes them to the IMU log. 
+ * 
+ * @param decoder : decoder data 
+ * @param tag : record tag that has already been read 
+ * @return int : 0 if the record was decoded, -1 otherwise 
+ */
+static int log_decoder_imu(
+    log_decoder_t *decoder, 
+    uint8_t tag); 
+
+
+/**
+ * @brief Unwrap a timebase count 
+ * 
+ * @details Times are close together in the log so the difference to the last time 
+ *          decoded is always much less than the timebase wrap (71.6 minutes). 
+ * 
+ * @param decoder : decoder data 
+ * @param count : timebase count 
+ * @return uint64_t : (us) time from the start of the timebase 
+ */
+static uint64_t log_decoder_unwrap(
+    log_decoder_t *decoder, 
+    uint32_t count); 
+
+
+/**
+ * @brief Write a stream record time 
+ * 
+ * @param decoder : decoder data 
+ * @param name : record name 
+ * @param count : timebase count of the record 
+ */
+static void log_decoder_time(
+    log_decoder_t *decoder, 
+    const char *name, 
+    uint32_t count); 
+
+
+/**
+ * @brief Write the time of the last ADC sample 
+ * 
+ * @details Writes the time of the pending time record (if there is one) for the last ADC 
+ *          sample decoded. 
+ * 
+ * @param decoder : decoder data 
+ */
+static void log_decoder_adc_time(log_decoder_t *decoder); 
+
+
+/**
+ * @brief Find where the log data ends 
+ * 
+ * @details Walks the records after the header record using the size of each one and 
+ *          checks each sync record: the id must match the header record, the sequence 
+ *          numbers must count up from 0 and the offset must be where the record starts 
+ *          in the log data. The log data ends after the last sync record that checks 
+ *          out, or after the end record if it directly follows that sync record. The 
+ *          walk stops at the first record that can't be read or doesn't check out. The 
+ *          file is left at the start of the log data. 
+ * 
+ * @param decoder : decoder data 
+ * @param header : header record of the log 
+ */
+static void log_decoder_scan(
+    log_decoder_t *decoder, 
+    const log_rec_header_t *header); 
+
+
+/**
+ * @brief Decode the data log records 
+ * 
+ * @param decoder : decoder data 
+ * @return int : 0 if the end record was found, -1 otherwise 
+ */
+static int log_decoder_records(log_decoder_t *decoder); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Decoder 
+
+int main(
+    int argc, 
+    char *argv[])
+{
+    log_decoder_t decoder; 
+    int status; 
+
+    if ((argc < 2) || (argc > 5))
+    {
+        fprintf(stderr, "Usage: %s <binary log> [text log] [IMU log] [time log]\n", 
+                argv[0]); 
+        return 1; 
+    }
+
+    memset((void *)&decoder, 0, sizeof(decoder)); 
+
+    decoder.in = fopen(argv[1], "rb"); 
+    if (decoder.in == NULL)
+    {
+        fprintf(stderr, "Can't open %s\n", argv[1]); 
+        return 1; 
+    }
+
+    decoder.out = (argc >= 3) ? fopen(argv[2], "wb") : stdout; 
+    if (decoder.out == NULL)
+    {
+        fprintf(stderr, "Can't open %s\n", argv[2]); 
+        fclose(decoder.in); 
+        return 1; 
+    }
+
+    if (argc >= 4)
+    {
+        decoder.imu = fopen(argv[3], "wb"); 
+        if (decoder.imu == NULL)
+        {
+            fprintf(stderr, "Can't open %s\n", argv[3]); 
+            fclose(decoder.in); 
+            fclose(decoder.out); 
+            return 1; 
+        }
+    }
+
+    if (argc == 5)
+    {
+        decoder.time = fopen(argv[4], "wb"); 
+        if (decoder.time == NULL)
+        {
+            fprintf(stderr, "Can't open %s\n", argv[4]); 
+            fclose(decoder.in); 
+            fclose(decoder.out); 
+            fclose(decoder.imu); 
+            return 1; 
+        }
+    }
+
+    status = log_decoder_header(&decoder); 
+
+    if (status)
+    {
+        fprintf(stderr, "Data log start not found\n"); 
+    }
+    else 
+    {
+        status = log_decoder_records(&decoder); 
+    }
+
+    fclose(decoder.in); 
+    if (decoder.out != stdout)
+    {
+        fclose(decoder.out); 
+    }
+    if (decoder.imu != NULL)
+    {
+        fclose(decoder.imu); 
+    }
+    if (decoder.time != NULL)
+    {
+        fclose(decoder.time); 
+    }
+
+    return status ? 1 : 0; 
+}
+
+
+// Copy the text header 
+static int log_decoder_header(log_decoder_t *decoder)
+{
+    char line[LOG_DECODER_LINE_LEN]; 
+
+    while (fgets(line, sizeof(line), decoder->in) != NULL)
+    {
+        fputs(line, decoder->out); 
+
+        if (strcmp(line, mtbdl_data_log_start) == 0)
+        {
+            return 0; 
+        }
+    }
+
+    return -1; 
+}
+
+
+// Read the payload of a record 
+static int log_decoder_read(
+    log_decoder_t *decoder, 
+    void *record, 
+    size_t size, 
+    uint8_t tag)
+{
+    uint8_t *bytes = (uint8_t *)record; 
+
+    bytes[0] = tag; 
+
+    if (fread((void *)&bytes[1], 1, size - 1, decoder->in) != (size - 1))
+    {
+        fprintf(stderr, "Truncated record (tag %u)\n", tag); 
+        return -1; 
+    }
+
+    return 0; 
+}
+
+
+// Write the pending ADC record 
+static void log_decoder_flush(log_decoder_t *decoder)
+{
+    char sog[LOG_REC_STR_LEN + 1], lat[LOG_REC_STR_LEN + 1], lon[LOG_REC_STR_LEN + 1]; 
+    char *line, NS, EW; 
+    uint8_t field = 0; 
+
+    if (!decoder->adc_pending)
+    {
+        return; 
+    }
+
+    line = log_format_line_start(decoder->line, 
+                                 decoder->trailmark, 
+                                 decoder->adc.fork, 
+                                 decoder->adc.shock); 
+
+    if (decoder->streams & LOG_DECODER_SPEED)
+    {
+        line = log_format_sep(line); 
+        line = log_format_u16(line, decoder->speed.revs[0]); 
+
+        for (uint8_t i = 1; i < LOG_REC_REV_WINDOWS; i++)
+        {
+            line = log_format_char(line, '/'); 
+            line = log_format_u16(line, decoder->speed.revs[i]); 
+        }
+
+        field = LOG_FORMAT_SPEED_FIELD + 1; 
+    }
+    else if (decoder->streams & LOG_DECODER_REV)
+    {
+        // The period at the record is only shown when no revolutions were finished 
+        line = log_format_sep(line); 
+
+        if (!decoder->rev.count)
+        {
+            line = log_format_u32(line, decoder->rev.period); 
+        }
+
+        for (uint8_t i = 0; i < decoder->rev.count; i++)
+        {
+            if (i)
+            {
+                line = log_format_char(line, '/'); 
+            }
+            line = log_format_u32(line, decoder->rev_periods[i]); 
+        }
+
+        field = LOG_FORMAT_SPEED_FIELD + 1; 
+    }
+
+    if (decoder->streams & LOG_DECODER_ACCEL)
+    {
+        line = log_format_line_blank(line, LOG_FORMAT_ACCEL_FIELD - field); 
+        line = log_format_sep(line); 
+        line = log_format_i16(line, decoder->accel.x); 
+        line = log_format_sep(line); 
+        line = log_format_i16(line, decoder->accel.y); 
+        line = log_format_sep(line); 
+        line = log_format_i16(line, decoder->accel.z); 
+        field = LOG_FORMAT_ACCEL_FIELD + 3; 
+    }
+
+    if (decoder->streams & (LOG_DECODER_GPS | LOG_DECODER_PVT))
+    {
+        if (decoder->streams & LOG_DECODER_GPS)
+        {
+            memcpy(sog, decoder->gps.sog, LOG_REC_STR_LEN); 
+            memcpy(lat, decoder->gps.lat, LOG_REC_STR_LEN); 
+            memcpy(lon, decoder->gps.lon, LOG_REC_STR_LEN); 
+            sog[LOG_REC_STR_LEN] = lat[LOG_REC_STR_LEN] = lon[LOG_REC_STR_LEN] = 0; 
+            NS = decoder->gps.NS; 
+            EW = decoder->gps.EW; 
+        }
+        else 
+        {
+            // Written the same as the PUBX POSITION strings the text log shows 
+            char *end_char; 
+
+            log_format_milli(sog, LOG_FORMAT_KMH_MILLI(decoder->pvt.speed)); 
+            end_char = log_format_coord(lat, decoder->pvt.lat, LOG_FORMAT_LAT_DEG_LEN, 
+                                        'N', 'S'); 
+            NS = *(--end_char); 
+            *end_char = '\0'; 
+            end_char = log_format_coord(lon, decoder->pvt.lon, LOG_FORMAT_LON_DEG_LEN, 
+                                        'E', 'W'); 
+            EW = *(--end_char); 
+            *end_char = '\0'; 
+        }
+
+        line = log_format_line_blank(line, LOG_FORMAT_GPS_FIELD - field); 
+        line = log_format_sep(line); 
+        line = log_format_str(line, sog, LOG_REC_STR_LEN); 
+        line = log_format_sep(line); 
+        line = log_format_str(line, lat, LOG_REC_STR_LEN); 
+        line = log_format_char(line, NS); 
+        line = log_format_sep(line); 
+        line = log_format_str(line, lon, LOG_REC_STR_LEN); 
+        line = log_format_char(line, EW); 
+        field = LOG_FORMAT_GPS_FIELD + LOG_FORMAT_GPS_FIELDS; 
+    }
+
+    log_format_line_end(line, LOG_FORMAT_LINE_FIELDS - field); 
+    fputs(decoder->line, decoder->out); 
+
+    decoder->adc_pending = 0; 
+    decoder->trailmark = 0; 
+    decoder->streams = 0; 
+}
+
+
+// Read a stream record 
+static int log_decoder_stream(
+    log_decoder_t *decoder, 
+    void *record, 
+    size_t size, 
+    uint8_t tag, 
+    uint8_t stream)
+{
+    if (log_decoder_read(decoder, record, size, tag) || !decoder->adc_pending || 
+        (decoder->streams & stream))
+    {
+        return -1; 
+    }
+
+    decoder->streams |= stream; 
+    return 0; 
+}
+
+
+// Decode a packed ADC block 
+static int log_decoder_block(
+    log_decoder_t *decoder, 
+    uint8_t tag)
+{
+    log_rec_adc_pack_t record; 
+    uint8_t data[LOG_PACK_MAX_LEN]; 
+    uint16_t samples[LOG_PACK_MAX_SAMPLES][LOG_REC_PACK_CHANNELS]; 
+    uint32_t index = decoder->unpack.index; 
+    int count; 
+
+    if (log_decoder_read(decoder, &record, sizeof(record), tag))
+    {
+        return -1; 
+    }
+
+    if ((record.size > LOG_PACK_MAX_LEN) || 
+        (fread((void *)data, 1, record.size, decoder->in) != record.size))
+    {
+        fprintf(stderr, "Truncated or invalid ADC block\n"); 
+        return -1; 
+    }
+
+    count = log_unpack_block(&decoder->unpack, &record, data, samples); 
+
+    if (count < 0)
+    {
+        fprintf(stderr, "Undecodable ADC block at offset %ld\n", 
+                ftell(decoder->in) - (long)(sizeof(record) + record.size)); 
+        return -1; 
+    }
+
+    // A keyframe gives the index of its first sample so dropped blocks can be seen 
+    if ((tag == LOG_REC_ADC_KEY) && (index != (decoder->unpack.index - count)))
+    {
+        fprintf(stderr, "ADC samples %u to %u missing\n", 
+                (unsigned int)index, (unsigned int)(decoder->unpack.index - count - 1)); 
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        log_decoder_flush(decoder); 
+
+        if (i == record.trailmark)
+        {
+            decoder->trailmark = 1; 
+        }
+
+        decoder->adc.fork = samples[i][0]; 
+        decoder->adc.shock = samples[i][1]; 
+        decoder->adc_pending = 1; 
+        decoder->samples++; 
+    }
+
+    // A time record ahead of the block belongs to its last sample 
+    log_decoder_adc_time(decoder); 
+
+    return 0; 
+}
+
+
+// Decode an IMU record 
+static int log_decoder_imu(
+    log_decoder_t *decoder, 
+    uint8_t tag)
+{
+    log_rec_imu_t record; 
+    log_rec_imu_sample_t sample; 
+
+    if (log_decoder_read(decoder, &record, sizeof(record), tag))
+    {
+        return -1; 
+    }
+
+    if (record.count)
+    {
+        log_decoder_time(decoder, "IMU", record.time); 
+    }
+
+    if ((decoder->imu != NULL) && record.lost)
+    {
+        fputs(LOG_DECODER_IMU_LOST, decoder->imu); 
+    }
+
+    for (uint8_t i = 0; i < record.count; i++)
+    {
+        if (fread((void *)&sample, 1, sizeof(sample), decoder->in) != sizeof(sample))
+        {
+            fprintf(stderr, "Truncated IMU record\n"); 
+            return -1; 
+        }
+
+        if (decoder->imu != NULL)
+        {
+            fprintf(decoder->imu, LOG_DECODER_IMU_SAMPLE, 
+                    sample.accel[0], sample.accel[1], sample.accel[2], 
+                    sample.gyro[0], sample.gyro[1], sample.gyro[2]); 
+        }
+    }
+
+    return 0; 
+}
+
+
+// Unwrap a timebase count 
+static uint64_t log_decoder_unwrap(
+    log_decoder_t *decoder, 
+    uint32_t count)
+{
+    if (!decoder->time_valid)
+    {
+        decoder->time_valid = 1; 
+        decoder->time_us = count; 
+    }
+    else 
+    {
+        // Times can be a little older than the last one (ex. a GPS read before the ADC 
+        // sample it's logged with) so the difference is signed 
+        decoder->time_us += (int64_t)(int32_t)(count - decoder->time_last); 
+    }
+
+    decoder->time_last = count; 
+    return decoder->time_us; 
+}
+
+
+// Write a stream record time 
+static void log_decoder_time(
+    log_decoder_t *decoder, 
+    const char *name, 
+    uint32_t count)
+{
+    uint64_t time = log_decoder_unwrap(decoder, count); 
+
+    if (decoder->time != NULL)
+    {
+        fprintf(decoder->time, LOG_DECODER_TIME_STREAM, name, 
+                (unsigned long long)(decoder->samples - 1), (unsigned long long)time); 
+    }
+}
+
+
+// Write the time of the last ADC sample 
+static void log_decoder_adc_time(log_decoder_t *decoder)
+{
+    if (!decoder->time_pending || !decoder->samples)
+    {
+        return; 
+    }
+
+    uint64_t sample = decoder->samples - 1; 
+    uint8_t first = !decoder->time_valid; 
+    uint64_t time = log_decoder_unwrap(decoder, decoder->time_count); 
+
+    decoder->time_pending = 0; 
+
+    if (first)
+    {
+        decoder->time_first = time; 
+        decoder->sample_first = sample; 
+    }
+
+    // Where the sample rate puts the sample compared to the first ADC time 
+    int64_t offset = (int64_t)(time - decoder->time_first) - 
+                     (int64_t)((sample - decoder->sample_first) * decoder->sample_period); 
+
+    if (decoder->time != NULL)
+    {
+        fprintf(decoder->time, LOG_DECODER_TIME_ADC, (unsigned long long)sample, 
+                (unsigned long long)time, (long long)offset); 
+    }
+}
+
+
+// Find where the log data ends 
+static void log_decoder_scan(
+    log_decoder_t *decoder, 
+    const log_rec_header_t *header)
+{
+    // Size of each record without the data that follows it, 0 for tags that can't be in 
+    // the log data 
+    static const uint8_t sizes[LOG_REC_NUM] = 
+    {
+        [LOG_REC_ADC] = sizeof(log_rec_adc_t), 
+        [LOG_REC_GPS] = sizeof(log_rec_gps_t), 
+        [LOG_REC_ACCEL] = sizeof(log_rec_accel_t), 
+        [LOG_REC_SPEED] = sizeof(log_rec_speed_t), 
+        [LOG_REC_TRAILMARK] = sizeof(log_rec_trailmark_t), 
+        [LOG_REC_END] = sizeof(log_rec_end_t), 
+        [LOG_REC_ADC_KEY] = sizeof(log_rec_adc_pack_t), 
+        [LOG_REC_ADC_DELTA] = sizeof(log_rec_adc_pack_t), 
+        [LOG_REC_REV_PERIOD] = sizeof(log_rec_rev_period_t), 
+        [LOG_REC_IMU] = sizeof(log_rec_imu_t), 
+        [LOG_REC_GPS_PVT] = sizeof(log_rec_gps_pvt_t), 
+        [LOG_REC_TIME] = sizeof(log_rec_time_t), 
+        [LOG_REC_SYNC] = sizeof(log_rec_sync_t) 
+    }; 
+
+    union
+    {
+        uint8_t bytes[sizeof(log_rec_gps_t)]; 
+        log_rec_adc_pack_t pack; 
+        log_rec_rev_period_t rev; 
+        log_rec_imu_t imu; 
+        log_rec_sync_t sync; 
+    } record; 
+
+    uint32_t seq = 0; 
+    uint8_t synced = 0, done = 0; 
+    long file_end, start, extra; 
+    int tag; 
+
+    fseek(decoder->in, 0, SEEK_END); 
+    file_end = ftell(decoder->in); 
+    fseek(decoder->in, decoder->data_start, SEEK_SET); 
+    decoder->data_end = decoder->data_start; 
+
+    while (!done && ((tag = fgetc(decoder->in)) != EOF))
+    {
+        start = ftell(decoder->in) - 1; 
+        extra = 0; 
+
+        if ((tag >= LOG_REC_NUM) || !sizes[tag] || 
+            (fread((void *)&record.bytes[1], 1, sizes[tag] - 1, decoder->in) != 
+             (size_t)(sizes[tag] - 1)))
+        {
+            break; 
+        }
+
+        switch (tag)
+        {
+            case LOG_REC_ADC_KEY: 
+            case LOG_REC_ADC_DELTA: 
+                extra = record.pack.size; 
+                break; 
+
+            case LOG_REC_REV_PERIOD: 
+                extra = (long)record.rev.count * sizeof(uint32_t); 
+                break; 
+
+            case LOG_REC_IMU: 
+                extra = (long)record.imu.count * sizeof(log_rec_imu_sample_t); 
+                break; 
+
+            case LOG_REC_SYNC: 
+                if ((record.sync.id != header->id) || (record.sync.seq != seq) || 
+                    (record.sync.offset != (uint32_t)(start - decoder->data_start)))
+                {
+                    done = 1; 
+                    break; 
+                }
+                seq++; 
+                decoder->data_end = ftell(decoder->in); 
+                break; 
+
+            case LOG_REC_END: 
+                if (synced)
+                {
+                    decoder->data_end = ftell(decoder->in); 
+                }
+                done = 1; 
+                break; 
+
+            default: 
+                break; 
+        }
+
+        synced = (tag == LOG_REC_SYNC); 
+
+        if ((ftell(decoder->in) + extra) > file_end)
+        {
+            break; 
+        }
+
+        fseek(decoder->in, extra, SEEK_CUR); 
+    }
+
+    fseek(decoder->in, decoder->data_start, SEEK_SET); 
+}
+
+
+// Decode the data log records 
+static int log_decoder_records(log_decoder_t *decoder)
+{
+    // Stream records always follow the ADC record of the interval they were read in so 
+    // each ADC record is held until a record that isn't a stream record is read. The 
+    // ADC record and the stream records after it (a slot can have several) are written 
+    // as one line. 
+
+    log_rec_header_t header; 
+    log_rec_time_t time; 
+    log_rec_sync_t sync; 
+    log_rec_end_t end; 
+    int tag; 
+
+    // The first record must be a header that matches this version of the decoder 
+    tag = fgetc(decoder->in); 
+
+    if ((tag != LOG_REC_HEADER) || 
+        log_decoder_read(decoder, &header, sizeof(header), (uint8_t)tag) || 
+        memcmp(header.magic, LOG_REC_MAGIC, LOG_REC_MAGIC_LEN) || 
+        (header.version != LOG_REC_VERSION))
+    {
+        fprintf(stderr, "Unsupported or missing header record\n"); 
+        return -1; 
+    }
+
+    if (decoder->imu != NULL)
+    {
+        fprintf(decoder->imu, LOG_DECODER_IMU_HEADER, (unsigned int)header.imu_rate); 
+    }
+
+    decoder->sample_period = (uint32_t)header.log_period * 1000; 
+
+    if (decoder->time != NULL)
+    {
+        fprintf(decoder->time, LOG_DECODER_TIME_HEADER, 
+                (unsigned int)decoder->sample_period); 
+    }
+
+    decoder->data_start = ftell(decoder->in); 
+    log_decoder_scan(decoder, &header); 
+
+    while ((ftell(decoder->in) < decoder->data_end) && ((tag = fgetc(decoder->in)) != EOF))
+    {
+        switch (tag)
+        {
+            case LOG_REC_ADC: 
+                log_decoder_flush(decoder); 
+                if (log_decoder_read(decoder, &decoder->adc, sizeof(log_rec_adc_t), tag))
+                {
+                    return -1; 
+                }
+                decoder->adc_pending = 1; 
+                decoder->samples++; 
+                log_decoder_adc_time(decoder); 
+                break; 
+
+            case LOG_REC_TIME: 
+                log_decoder_flush(decoder); 
+                if (log_decoder_read(decoder, &time, sizeof(time), tag))
+                {
+                    return -1; 
+                }
+                decoder->time_pending = 1; 
+                decoder->time_count = time.time; 
+                break; 
+
+            case LOG_REC_ADC_KEY: 
+            case LOG_REC_ADC_DELTA: 
+                if (log_decoder_block(decoder, (uint8_t)tag))
+                {
+                    return -1; 
+                }
+                break; 
+
+            case LOG_REC_TRAILMARK: 
+                log_decoder_flush(decoder); 
+                decoder->trailmark = 1; 
+                break; 
+
+            case LOG_REC_GPS: 
+                if (log_decoder_stream(decoder, &decoder->gps, sizeof(log_rec_gps_t), 
+                                       tag, LOG_DECODER_GPS))
+                {
+                    return -1; 
+                }
+                log_decoder_time(decoder, "GPS", decoder->gps.time); 
+                break; 
+
+            case LOG_REC_GPS_PVT: 
+                if (log_decoder_stream(decoder, &decoder->pvt, sizeof(log_rec_gps_pvt_t), 
+                                       tag, LOG_DECODER_PVT))
+                {
+                    return -1; 
+                }
+                log_decoder_time(decoder, "GPS", decoder->pvt.time); 
+                break; 
+
+            case LOG_REC_ACCEL: 
+                if (log_decoder_stream(decoder, &decoder->accel, sizeof(log_rec_accel_t), 
+                                       tag, LOG_DECODER_ACCEL))
+                {
+                    return -1; 
+                }
+                log_decoder_time(decoder, "Accel", decoder->accel.time); 
+                break; 
+
+            case LOG_REC_SPEED: 
+                if (log_decoder_stream(decoder, &decoder->speed, sizeof(log_rec_speed_t), 
+                                       tag, LOG_DECODER_SPEED))
+                {
+                    return -1; 
+                }
+                break; 
+
+            case LOG_REC_REV_PERIOD: 
+                if (log_decoder_stream(decoder, &decoder->rev, 
+                                       sizeof(log_rec_rev_period_t), tag, LOG_DECODER_REV))
+                {
+                    return -1; 
+                }
+                if ((decoder->rev.count > LOG_DECODER_REV_MAX) || 
+                    (fread((void *)decoder->rev_periods, sizeof(uint32_t), 
+                           decoder->rev.count, decoder->in) != decoder->rev.count))
+                {
+                    fprintf(stderr, "Truncated or invalid revolution period record\n"); 
+                    return -1; 
+                }
+                break; 
+
+            case LOG_REC_IMU: 
+                if (log_decoder_imu(decoder, tag))
+                {
+                    return -1; 
+                }
+                break; 
+
+            case LOG_REC_SYNC: 
+                // Only marks how much of the file is log data (see log_decoder_scan) 
+                if (log_decoder_read(decoder, &sync, sizeof(sync), tag))
+                {
+                    return -1; 
+                }
+                break; 
+
+            case LOG_REC_END: 
+                log_decoder_flush(decoder); 
+                if (log_decoder_read(decoder, &end, sizeof(end), tag))
+                {
+                    return -1; 
+                }
+                snprintf(decoder->line, MTBDL_MAX_STR_LEN, mtbdl_data_log_end, end.overrun); 
+                fputs(decoder->line, decoder->out); 
+
+                // Anything after the end record (the execution time profiling footer) is 
+                // text so it's copied as is 
+                while ((tag = fgetc(decoder->in)) != EOF)
+                {
+                    fputc(tag, decoder->out); 
+                }
+                return 0; 
+
+            default: 
+                fprintf(stderr, "Unknown record tag %d at offset %ld\n", 
+                        tag, ftell(decoder->in) - 1); 
+                return -1; 
+        }
+    }
+
+    // The log was not terminated (e.g. power was lost while logging). Write what's there 
+    // up to the last sync record. Anything after it can be data left on the card. 
+    log_decoder_flush(decoder); 
+    fprintf(stderr, "End record not found - log data decoded up to file offset %ld\n", 
+            decoder->data_end); 
+    return -1; 
+}
+
+//=======================================================================================
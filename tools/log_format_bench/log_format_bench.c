@@ -0,0 +1,460 @@
+/**
+ * @file log_format_bench.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Data log text formatting benchmark 
+ * 
+ * @details Host tool that compares the cost of building data log lines with snprintf 
+ *          and the mtbdl_data_log_* formats against the log_format writers. Each line 
+ *          type is built the way the data logging module builds it, both ways, from the 
+ *          same pseudo random data. The output of both is compared byte for byte before 
+ *          anything is timed. 
+ * 
+ *          Time is reported in CPU timestamp counter cycles on x86 hosts and nanoseconds 
+ *          otherwise. Host numbers only show the relative cost of the two methods since 
+ *          the target's newlib snprintf and Cortex-M4 timings are different. 
+ * 
+ *          Usage: log_format_bench [iterations] 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "log_format.h"
+#include "string_config.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define BENCH_ITERATIONS 1000000      // Default number of lines built per line type 
+#define BENCH_DATA_SETS 256           // Number of pseudo random data sets (power of 2) 
+#define BENCH_STR_LEN 256             // Line buffer size 
+#define BENCH_PERIOD_LINES 4          // ADC only lines before a stream line in a period 
+#define BENCH_SEED 0x4D544244         // Pseudo random data seed 
+#define BENCH_NUM_AXES 3              // Accelerometer axes 
+#define BENCH_REV_WINDOWS 2           // Wheel revolution windows (short, long) 
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BENCH_UNIT "cycles" 
+#else
+#define BENCH_UNIT "ns" 
+#endif
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Enums 
+
+// Line types 
+typedef enum {
+    BENCH_LINE_DEFAULT, 
+    BENCH_LINE_GPS, 
+    BENCH_LINE_ACCEL, 
+    BENCH_LINE_SPEED, 
+    BENCH_LINE_PERIOD, 
+    BENCH_LINE_NUM
+} bench_line_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// Data for one line 
+typedef struct bench_data_s
+{
+    uint8_t trailmark; 
+    uint16_t fork; 
+    uint16_t shock; 
+    int16_t accel[BENCH_NUM_AXES]; 
+    uint16_t revs[BENCH_REV_WINDOWS]; 
+    char sog[LOG_FORMAT_U16_MAX_LEN + 3]; 
+    char lat[LOG_FORMAT_U16_MAX_LEN + 7]; 
+    char lon[LOG_FORMAT_U16_MAX_LEN + 7]; 
+    char NS; 
+    char EW; 
+}
+bench_data_t; 
+
+
+// Line builder 
+typedef char *(*bench_builder)(char *str, const bench_data_t *data); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Prototypes 
+
+/**
+ * @brief Read the time counter 
+ * 
+ * @return uint64_t : timestamp counter (x86) or monotonic time in ns 
+ */
+static uint64_t bench_time(void); 
+
+
+/**
+ * @brief Fill the data sets with pseudo random values 
+ * 
+ * @param data : data sets 
+ */
+static void bench_data_make(bench_data_t *data); 
+
+
+// Line builders - snprintf. Each returns the end of the line like log_format does. 
+static char *bench_snprintf_default(char *str, const bench_data_t *data); 
+static char *bench_snprintf_gps(char *str, const bench_data_t *data); 
+static char *bench_snprintf_accel(char *str, const bench_data_t *data); 
+static char *bench_snprintf_speed(char *str, const bench_data_t *data); 
+static char *bench_snprintf_period(char *str, const bench_data_t *data); 
+
+// Line builders - log_format 
+static char *bench_format_default(char *str, const bench_data_t *data); 
+static char *bench_format_gps(char *str, const bench_data_t *data); 
+static char *bench_format_accel(char *str, const bench_data_t *data); 
+static char *bench_format_speed(char *str, const bench_data_t *data); 
+static char *bench_format_period(char *str, const bench_data_t *data); 
+
+
+/**
+ * @brief Time a line builder 
+ * 
+ * @param builder : line builder to time 
+ * @param data : data sets 
+ * @param iterations : number of lines to build 
+ * @return double : average time per line 
+ */
+static double bench_run(
+    bench_builder builder, 
+    const bench_data_t *data, 
+    uint32_t iterations); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Variables 
+
+static const char *bench_line_names[BENCH_LINE_NUM] = 
+{
+    "default", 
+    "gps", 
+    "accel", 
+    "speed", 
+    "period (4 default + speed)"
+}; 
+
+static const bench_builder bench_snprintf_table[BENCH_LINE_NUM] = 
+{
+    &bench_snprintf_default, 
+    &bench_snprintf_gps, 
+    &bench_snprintf_accel, 
+    &bench_snprintf_speed, 
+    &bench_snprintf_period
+}; 
+
+static const bench_builder bench_format_table[BENCH_LINE_NUM] = 
+{
+    &bench_format_default, 
+    &bench_format_gps, 
+    &bench_format_accel, 
+    &bench_format_speed, 
+    &bench_format_period
+}; 
+
+// Keeps the compiler from optimizing the builders away 
+static volatile char bench_sink; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Benchmark 
+
+int main(
+    int argc, 
+    char *argv[])
+{
+    static bench_data_t data[BENCH_DATA_SETS]; 
+    char expected[BENCH_STR_LEN], actual[BENCH_STR_LEN]; 
+    uint32_t iterations = BENCH_ITERATIONS; 
+    double time_snprintf, time_format; 
+    int status = 0; 
+
+    if (argc > 2)
+    {
+        fprintf(stderr, "Usage: %s [iterations]\n", argv[0]); 
+        return 1; 
+    }
+
+    if (argc == 2)
+    {
+        iterations = (uint32_t)strtoul(argv[1], NULL, 10); 
+    }
+
+    bench_data_make(data); 
+
+    // Check the output matches before timing anything 
+    for (uint8_t line = 0; line < BENCH_LINE_NUM; line++)
+    {
+        for (uint16_t i = 0; i < BENCH_DATA_SETS; i++)
+        {
+            char *end_snprintf = bench_snprintf_table[line](expected, &data[i]); 
+            char *end_format = bench_format_table[line](actual, &data[i]); 
+
+            if (((end_snprintf - expected) != (end_format - actual)) || 
+                strcmp(expected, actual))
+            {
+                fprintf(stderr, "Mismatch (%s, data set %u):\n", bench_line_names[line], i); 
+                fprintf(stderr, "  snprintf:   %s  log_format: %s", expected, actual); 
+                status = 1; 
+                break; 
+            }
+        }
+    }
+
+    if (status)
+    {
+        return status; 
+    }
+
+    printf("%u lines per line type, %s per line\n\n", iterations, BENCH_UNIT); 
+    printf("%-28s %12s %12s %8s\n", "line", "snprintf", "log_format", "speedup"); 
+
+    for (uint8_t line = 0; line < BENCH_LINE_NUM; line++)
+    {
+        time_snprintf = bench_run(bench_snprintf_table[line], data, iterations); 
+        time_format = bench_run(bench_format_table[line], data, iterations); 
+
+        printf("%-28s %12.1f %12.1f %7.1fx\n", 
+               bench_line_names[line], 
+               time_snprintf, 
+               time_format, 
+               (time_format > 0.0) ? (time_snprintf / time_format) : 0.0); 
+    }
+
+    return 0; 
+}
+
+
+// Read the time counter 
+static uint64_t bench_time(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc(); 
+#else
+    struct timespec ts; 
+    clock_gettime(CLOCK_MONOTONIC, &ts); 
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec; 
+#endif
+}
+
+
+// Fill the data sets with pseudo random values 
+static void bench_data_make(bench_data_t *data)
+{
+    srand(BENCH_SEED); 
+
+    for (uint16_t i = 0; i < BENCH_DATA_SETS; i++)
+    {
+        data[i].trailmark = (uint8_t)((rand() % 50) == 0); 
+        data[i].fork = (uint16_t)(rand() % 4096); 
+        data[i].shock = (uint16_t)(rand() % 4096); 
+
+        for (uint8_t j = 0; j < BENCH_NUM_AXES; j++)
+        {
+            data[i].accel[j] = (int16_t)((rand() % 65536) - 32768); 
+        }
+
+        data[i].revs[0] = (uint16_t)(rand() % 100); 
+        data[i].revs[1] = (uint16_t)(data[i].revs[0] + (rand() % 300)); 
+        snprintf(data[i].sog, sizeof(data[i].sog), "%u.%03u", 
+                 (unsigned int)(rand() % 60), (unsigned int)(rand() % 1000)); 
+        snprintf(data[i].lat, sizeof(data[i].lat), "%04u.%05u", 
+                 (unsigned int)(rand() % 9000), (unsigned int)(rand() % 100000)); 
+        snprintf(data[i].lon, sizeof(data[i].lon), "%05u.%05u", 
+                 (unsigned int)(rand() % 18000), (unsigned int)(rand() % 100000)); 
+        data[i].NS = (rand() & 1) ? 'N' : 'S'; 
+        data[i].EW = (rand() & 1) ? 'E' : 'W'; 
+    }
+}
+
+
+// Default line - snprintf 
+static char *bench_snprintf_default(char *str, const bench_data_t *data)
+{
+    int len = snprintf(str, BENCH_STR_LEN, mtbdl_data_log_default, 
+                       data->trailmark, data->fork, data->shock); 
+    return str + len; 
+}
+
+
+// GPS line - snprintf 
+static char *bench_snprintf_gps(char *str, const bench_data_t *data)
+{
+    int len = snprintf(str, BENCH_STR_LEN, mtbdl_data_log_gps, "", "", "", "", 
+                       data->trailmark, data->fork, data->shock, 
+                       data->sog, data->lat, data->NS, data->lon, data->EW); 
+    return str + len; 
+}
+
+
+// Accelerometer line - snprintf 
+static char *bench_snprintf_accel(char *str, const bench_data_t *data)
+{
+    int len = snprintf(str, BENCH_STR_LEN, mtbdl_data_log_accel, "", "", "", "", 
+                       data->trailmark, data->fork, data->shock, 
+                       data->accel[0], data->accel[1], data->accel[2]); 
+    return str + len; 
+}
+
+
+// Wheel speed line - snprintf 
+static char *bench_snprintf_speed(char *str, const bench_data_t *data)
+{
+    int len = snprintf(str, BENCH_STR_LEN, mtbdl_data_log_speed, "", "", "", "", 
+                       data->trailmark, data->fork, data->shock, 
+                       data->revs[0], data->revs[1]); 
+    return str + len; 
+}
+
+
+// Full logging period - snprintf (the way the data logging module used to build it) 
+static char *bench_snprintf_period(char *str, const bench_data_t *data)
+{
+    char lines[BENCH_PERIOD_LINES][MTBDL_MAX_STR_LEN]; 
+    int len; 
+
+    for (uint8_t i = 0; i < BENCH_PERIOD_LINES; i++)
+    {
+        snprintf(lines[i], MTBDL_MAX_STR_LEN, mtbdl_data_log_default, 
+                 data->trailmark, data->fork, data->shock); 
+    }
+
+    len = snprintf(str, BENCH_STR_LEN, mtbdl_data_log_speed, 
+                   lines[0], lines[1], lines[2], lines[3], 
+                   data->trailmark, data->fork, data->shock, 
+                   data->revs[0], data->revs[1]); 
+    return str + len; 
+}
+
+
+// Default line - log_format 
+static char *bench_format_default(char *str, const bench_data_t *data)
+{
+    str = log_format_line_start(str, data->trailmark, data->fork, data->shock); 
+    return log_format_line_end(str, LOG_FORMAT_LINE_FIELDS); 
+}
+
+
+// GPS line - log_format 
+static char *bench_format_gps(char *str, const bench_data_t *data)
+{
+    str = log_format_line_start(str, data->trailmark, data->fork, data->shock); 
+    str = log_format_line_blank(str, LOG_FORMAT_GPS_FIELD); 
+    str = log_format_sep(str); 
+    str = log_format_str(str, data->sog, sizeof(data->sog)); 
+    str = log_format_sep(str); 
+    str = log_format_str(str, data->lat, sizeof(data->lat)); 
+    str = log_format_char(str, data->NS); 
+    str = log_format_sep(str); 
+    str = log_format_str(str, data->lon, sizeof(data->lon)); 
+    str = log_format_char(str, data->EW); 
+    return log_format_line_end(str, 
+        LOG_FORMAT_LINE_FIELDS - LOG_FORMAT_GPS_FIELD - LOG_FORMAT_GPS_FIELDS); 
+}
+
+
+// Accelerometer line - log_format 
+static char *bench_format_accel(char *str, const bench_data_t *data)
+{
+    str = log_format_line_start(str, data->trailmark, data->fork, data->shock); 
+    str = log_format_line_blank(str, LOG_FORMAT_ACCEL_FIELD); 
+
+    for (uint8_t i = 0; i < BENCH_NUM_AXES; i++)
+    {
+        str = log_format_sep(str); 
+        str = log_format_i16(str, data->accel[i]); 
+    }
+
+    return log_format_line_end(str, 
+        LOG_FORMAT_LINE_FIELDS - LOG_FORMAT_ACCEL_FIELD - BENCH_NUM_AXES); 
+}
+
+
+// Wheel speed line - log_format 
+static char *bench_format_speed(char *str, const bench_data_t *data)
+{
+    str = log_format_line_start(str, data->trailmark, data->fork, data->shock); 
+    str = log_format_line_blank(str, LOG_FORMAT_SPEED_FIELD); 
+    str = log_format_sep(str); 
+    str = log_format_u16(str, data->revs[0]); 
+    str = log_format_char(str, '/'); 
+    str = log_format_u16(str, data->revs[1]); 
+    return log_format_line_end(str, LOG_FORMAT_LINE_FIELDS - LOG_FORMAT_SPEED_FIELD - 1); 
+}
+
+
+// Full logging period - log_format (lines appended in place) 
+static char *bench_format_period(char *str, const bench_data_t *data)
+{
+    for (uint8_t i = 0; i < BENCH_PERIOD_LINES; i++)
+    {
+        str = bench_format_default(str, data); 
+    }
+
+    return bench_format_speed(str, data); 
+}
+
+
+// Time a line builder 
+static double bench_run(
+    bench_builder builder, 
+    const bench_data_t *data, 
+    uint32_t iterations)
+{
+    char str[BENCH_STR_LEN]; 
+    uint64_t start, end; 
+
+    if (iterations == 0)
+    {
+        return 0.0; 
+    }
+
+    start = bench_time(); 
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        bench_sink = *builder(str, &data[i & (BENCH_DATA_SETS - 1)]); 
+        bench_sink = str[0]; 
+    }
+
+    end = bench_time(); 
+
+    return (double)(end - start) / (double)iterations; 
+}
+
+//=======================================================================================
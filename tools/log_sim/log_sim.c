@@ -0,0 +1,811 @@
+/**
+ * @file log_sim.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Data logging simulator 
+ * 
+ * @details Host tool that runs the data logging module (data_logging.c) through a full 
+ *          log as fast as the host can go. Time is simulated: the ADC DMA blocks, wheel 
+ *          revolutions and GPS fixes (TX ready interrupts) happen on a virtual clock at 
+ *          the rates they would on the system, and each call to log_data moves the clock 
+ *          forward by the time the devices it used would take (SD card writes, GPS and 
+ *          accelerometer reads) plus the rest of the main loop. Samples queue in the ADC 
+ *          ring while the clock moves the same way they would during a slow write on the 
+ *          system, so device latencies and write stalls show up as ring use and overruns. 
+ * 
+ *          Sensor data is either synthetic (sine waves with noise) or replayed from a 
+ *          recorded text log. Recorded logs are replayed one data line per sample and 
+ *          repeated if they're shorter than the simulated time. 
+ * 
+ *          Reports the simulated and host time, samples, bytes written, overruns, ADC 
+ *          ring use and the host time and device time of each log_data call that logged 
+ *          a sample. The device time of the calls that synced the log file is kept apart 
+ *          from the rest so the time a sync adds to a log stream slot can be seen. 
+ * 
+ *          Usage: log_sim [options] 
+ *            -t <s>      simulated time (default 3600) 
+ *            -m <mode>   log mode: text, binary or packed (default text) 
+ *            -i <file>   replay a recorded text log instead of synthetic data 
+ *            -o <file>   write the log to a file 
+ *            -s <us>     SD card write time per sector (default 250) 
+ *            -p <ms>     time between SD card write stalls, 0 for none (default 10000) 
+ *            -S <us>     SD card write stall time (default 100000) 
+ *            -y <us>     log file sync time (default 1600) 
+ *            -g <us>     GPS read time (default 3000) 
+ *            -a <us>     accelerometer read time (default 500) 
+ *            -b <us>     IMU FIFO read time per byte (default 90) 
+ *            -l <us>     main loop time besides log_data (default 100) 
+ *            -w <km/h>   wheel speed (default 20) 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include "log_sim.h"
+#include "data_logging.h"
+#include "string_config.h"
+#include "stm32f4xx_it.h"
+#include "dma_driver_mock.h"
+#include "m8q_driver_mock.h"
+#include "m8q_controller.h"
+#include "mpu6050_driver_mock.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define SIM_US_PER_MS 1000 
+#define SIM_US_PER_S 1000000 
+#define SIM_TIME 3600                   // (s) Default simulated time 
+#define SIM_SD_SECTOR 250               // (us) Default SD card sector write time 
+#define SIM_SD_STALL_PERIOD 10000       // (ms) Default time between SD card write stalls 
+#define SIM_SD_STALL 100000             // (us) Default SD card write stall time 
+#define SIM_SD_SYNC 1600                // (us) Default log file sync time 
+#define SIM_GPS_READ 3000               // (us) Default GPS read time 
+#define SIM_GPS_FIX_PERIOD 1000         // (ms) Time between GPS fixes (TX ready interrupts) 
+#define SIM_ACCEL_READ 500              // (us) Default accelerometer read time 
+#define SIM_I2C_BYTE 23                 // (us) Default IMU FIFO read time per byte (400kHz) 
+#define SIM_LOOP 100                    // (us) Default main loop time 
+#define SIM_WHEEL_SPEED 20.0            // (km/h) Default wheel speed 
+#define SIM_WHEEL_DIAMETER 29.0         // (in) Wheel diameter 
+#define SIM_M_PER_IN 0.0254             // Meters per inch 
+#define SIM_TRAILMARK_PERIOD 60         // (s) Time between synthetic trail markers 
+#define SIM_NUM_BINS 24                 // Host time histogram bins (powers of 2 in ns) 
+#define SIM_LINE_LEN 256                // Recorded log line buffer size 
+#define SIM_SEED 0x4D544244             // Synthetic data noise seed 
+
+#define SIM_ADC_MAX ((1 << LOG_ADC_RES_BITS) - 1)   // Max logged ADC value 
+#define SIM_BLOCK_TIME (LOG_ADC_BLOCK_SIZE * LOG_PERIOD * SIM_US_PER_MS)   // (us) DMA block 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// One sample of sensor data 
+typedef struct sim_sample_s
+{
+    uint8_t trailmark; 
+    uint16_t fork; 
+    uint16_t shock; 
+    int16_t accel[NUM_AXES]; 
+}
+sim_sample_t; 
+
+
+// Recorded log 
+typedef struct sim_recording_s
+{
+    sim_sample_t *samples; 
+    uint32_t num_samples; 
+}
+sim_recording_t; 
+
+
+// Results 
+typedef struct sim_results_s
+{
+    uint64_t samples;                           // Samples logged 
+    uint64_t log_calls;                         // log_data calls that logged a sample 
+    uint64_t host_total;                        // (ns) Total host time in log_data 
+    uint64_t host_min;                          // (ns) Fastest log_data call 
+    uint64_t host_max;                          // (ns) Slowest log_data call 
+    uint64_t host_bins[SIM_NUM_BINS];           // log_data calls in each host time bin 
+    uint32_t device_max;                        // (us) Longest device time of a call 
+    uint32_t sync_device_max;                   // (us) Longest device time of a sync call 
+    uint32_t other_device_max;                  // (us) Longest device time of the others 
+    uint32_t drops;                             // ADC sample sets dropped 
+    uint32_t ring_hwm;                          // Most ADC sample sets queued 
+}
+sim_results_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Variables 
+
+// DMA stream registers. Only the current target bit is used. 
+static DMA_Stream_TypeDef sim_dma_stream; 
+
+// Timebase registers. The count follows the simulated clock. 
+static TIM_TypeDef sim_timebase; 
+
+// Mode names - must be in the same order as log_mode_t 
+static const char *const sim_mode_names[LOG_MODE_NUM] = 
+{
+    "text", 
+    "binary", 
+    "packed"
+}; 
+
+// GPS data - the GPS isn't simulated beyond the time it takes to read 
+static char
+sim_lat[] = "4916.45000", 
+sim_ns[] = "N", 
+sim_lon[] = "12311.12000", 
+sim_ew[] = "W", 
+sim_sog[] = "0.004"; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Prototypes 
+
+/**
+ * @brief Read the host time 
+ * 
+ * @return uint64_t : monotonic time (ns) 
+ */
+static uint64_t sim_host_time(void); 
+
+
+/**
+ * @brief Load a recorded text log 
+ * 
+ * @details Reads every data line after the data log start line. Lines that don't start 
+ *          with the trail marker and ADC values are skipped. 
+ * 
+ * @param path : recorded log file 
+ * @param recording : where to store the samples 
+ * @return int : 0 if at least one sample was loaded 
+ */
+static int sim_recording_load(
+    const char *path, 
+    sim_recording_t *recording); 
+
+
+/**
+ * @brief Get the sensor data of a sample 
+ * 
+ * @param recording : recorded log, NULL for synthetic data 
+ * @param index : sample index 
+ * @param sample : sensor data 
+ */
+static void sim_sample_get(
+    const sim_recording_t *recording, 
+    uint64_t index, 
+    sim_sample_t *sample); 
+
+
+/**
+ * @brief Fill the DMA buffer being written with the next block of samples 
+ * 
+ * @details Each logged ADC value is spread over the LOG_ADC_OSR conversions of its 
+ *          sample so the decimator gets back the same value. 
+ * 
+ * @param recording : recorded log, NULL for synthetic data 
+ * @param index : index of the first sample in the block 
+ */
+static void sim_block_fill(
+    const sim_recording_t *recording, 
+    uint64_t index); 
+
+
+/**
+ * @brief Record the times of a log_data call 
+ * 
+ * @param results : results 
+ * @param host : host time (ns) 
+ * @param device : device time (us) 
+ * @param sync : 1 if the call synced the log file 
+ */
+static void sim_results_record(
+    sim_results_t *results, 
+    uint64_t host, 
+    uint32_t device, 
+    uint8_t sync); 
+
+
+/**
+ * @brief Print the results 
+ * 
+ * @param results : results 
+ * @param sim_time : simulated time (us) 
+ * @param host_time : host time (ns) 
+ */
+static void sim_results_print(
+    const sim_results_t *results, 
+    uint64_t sim_time, 
+    uint64_t host_time); 
+
+
+/**
+ * @brief Print the usage 
+ * 
+ * @param name : program name 
+ */
+static void sim_usage(const char *name); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Simulator 
+
+int main(
+    int argc, 
+    char *argv[])
+{
+    log_sim_latency_t latency = 
+    {
+        .sd_sector = SIM_SD_SECTOR, 
+        .sd_stall_period = SIM_SD_STALL_PERIOD, 
+        .sd_stall = SIM_SD_STALL, 
+        .sd_sync = SIM_SD_SYNC, 
+        .gps_read = SIM_GPS_READ, 
+        .accel_read = SIM_ACCEL_READ, 
+        .i2c_byte = SIM_I2C_BYTE, 
+        .loop = SIM_LOOP 
+    }; 
+    static sim_results_t results; 
+    sim_recording_t recording = { NULL, 0 }, *replay = NULL; 
+    const char *in_path = NULL, *out_path = NULL; 
+    FILE *out = NULL; 
+    uint64_t duration = (uint64_t)SIM_TIME * SIM_US_PER_S; 
+    double wheel_speed = SIM_WHEEL_SPEED; 
+    log_mode_t mode = LOG_MODE_TEXT; 
+
+    //==================================================
+    // Options 
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *opt = argv[i], *arg = (i + 1 < argc) ? argv[i + 1] : NULL; 
+
+        if ((opt[0] != '-') || (opt[1] == '\0') || (opt[2] != '\0') || (arg == NULL))
+        {
+            sim_usage(argv[0]); 
+            return 1; 
+        }
+
+        i++; 
+
+        switch (opt[1])
+        {
+            case 't': 
+                duration = (uint64_t)strtoul(arg, NULL, 10) * SIM_US_PER_S; 
+                break; 
+            case 'm': 
+                for (mode = LOG_MODE_TEXT; mode < LOG_MODE_NUM; mode++)
+                {
+                    if (!strcmp(arg, sim_mode_names[mode]))
+                    {
+                        break; 
+                    }
+                }
+                if (mode >= LOG_MODE_NUM)
+                {
+                    sim_usage(argv[0]); 
+                    return 1; 
+                }
+                break; 
+            case 'i': 
+                in_path = arg; 
+                break; 
+            case 'o': 
+                out_path = arg; 
+                break; 
+            case 's': 
+                latency.sd_sector = (uint32_t)strtoul(arg, NULL, 10); 
+                break; 
+            case 'p': 
+                latency.sd_stall_period = (uint32_t)strtoul(arg, NULL, 10); 
+                break; 
+            case 'S': 
+                latency.sd_stall = (uint32_t)strtoul(arg, NULL, 10); 
+                break; 
+            case 'y': 
+                latency.sd_sync = (uint32_t)strtoul(arg, NULL, 10); 
+                break; 
+            case 'g': 
+                latency.gps_read = (uint32_t)strtoul(arg, NULL, 10); 
+                break; 
+            case 'a': 
+                latency.accel_read = (uint32_t)strtoul(arg, NULL, 10); 
+                break; 
+            case 'b': 
+                latency.i2c_byte = (uint32_t)strtoul(arg, NULL, 10); 
+                break; 
+            case 'l': 
+                latency.loop = (uint32_t)strtoul(arg, NULL, 10); 
+                break; 
+            case 'w': 
+                wheel_speed = strtod(arg, NULL); 
+                break; 
+            default: 
+                sim_usage(argv[0]); 
+                return 1; 
+        }
+    }
+
+    if (in_path != NULL)
+    {
+        if (sim_recording_load(in_path, &recording))
+        {
+            fprintf(stderr, "No data log samples in %s\n", in_path); 
+            return 1; 
+        }
+
+        replay = &recording; 
+    }
+
+    if (out_path != NULL)
+    {
+        out = fopen(out_path, "wb"); 
+
+        if (out == NULL)
+        {
+            fprintf(stderr, "Can't open %s\n", out_path); 
+            free(recording.samples); 
+            return 1; 
+        }
+    }
+
+    //==================================================
+
+    //==================================================
+    // Log setup 
+
+    log_sim_devices_init(&latency, out); 
+    m8q_mock_init(); 
+    mpu6050_mock_init(); 
+    m8q_mock_set_position_lat(sim_lat, sizeof(sim_lat)); 
+    m8q_mock_set_position_ns(sim_ns, sizeof(sim_ns)); 
+    m8q_mock_set_position_lon(sim_lon, sizeof(sim_lon)); 
+    m8q_mock_set_position_ew(sim_ew, sizeof(sim_ew)); 
+    m8q_mock_set_position_sog(sim_sog, sizeof(sim_sog)); 
+
+    // The GPS controller reads the device from power on so there's a fix before logging 
+    m8q_txr_handler(); 
+    m8q_set_read_flag(); 
+    m8q_controller(); 
+    m8q_set_idle_flag(); 
+
+    log_init(EXTI0_IRQn, DMA2_Stream0_IRQn, ADC1, DMA2, &sim_dma_stream); 
+    log_timebase_init(&sim_timebase); 
+#if LOG_IMU_RATE
+    log_imu_fifo_init(I2C1, MPU6050_ADDR_1); 
+#endif
+
+    // The DMA addresses are 32 bits so the log data must be in the low 4GB of the host 
+    // address space (see the makefile). 
+    if ((dma_mock_get_mem_addr(1) - dma_mock_get_mem_addr(0)) != 
+        (dma_mock_get_data_items() * sizeof(uint16_t)))
+    {
+        fprintf(stderr, "DMA buffer addresses don't fit in 32 bits\n"); 
+        return 1; 
+    }
+
+    log_set_mode(mode); 
+
+    if (!log_data_name_prep())
+    {
+        fprintf(stderr, "No log file available\n"); 
+        return 1; 
+    }
+
+    log_data_file_prep(); 
+    log_data_prep(); 
+
+    //==================================================
+
+    //==================================================
+    // Logging 
+
+    // The wheel revolution period is 0 when the wheel isn't turning 
+    uint64_t rev_period = (wheel_speed > 0.0) ? 
+        (uint64_t)((M_PI * SIM_WHEEL_DIAMETER * SIM_M_PER_IN) / (wheel_speed / 3.6) * 
+                   SIM_US_PER_S) : 0; 
+
+    uint64_t
+    now = 0, 
+    next_block = SIM_BLOCK_TIME, 
+    next_rev = rev_period ? rev_period : UINT64_MAX, 
+    next_fix = (uint64_t)SIM_GPS_FIX_PERIOD * SIM_US_PER_MS, 
+    next_mark = (replay == NULL) ? (uint64_t)SIM_TRAILMARK_PERIOD * SIM_US_PER_S : 
+                                   UINT64_MAX, 
+    block_index = 0, 
+    host_start = sim_host_time(); 
+
+    results.host_min = UINT64_MAX; 
+
+    while (now < duration)
+    {
+        // Events since the last log_data call 
+        while (next_block <= now)
+        {
+            // The DMA fills one buffer then swaps to the other and interrupts. The 
+            // interrupt runs when the block is done, not when log_data gets to it. 
+            sim_block_fill(replay, block_index); 
+            sim_dma_stream.CR ^= DMA_SxCR_CT; 
+            sim_timebase.CNT = (uint32_t)next_block; 
+            log_data_adc_handler(); 
+            block_index += LOG_ADC_BLOCK_SIZE; 
+            next_block += SIM_BLOCK_TIME; 
+        }
+
+        while (next_rev <= now)
+        {
+            handler_flags.exti0_flag = SET_BIT; 
+            next_rev += rev_period; 
+        }
+
+        // The GPS sets its TX ready pin once each fix is ready to read 
+        while (next_fix <= now)
+        {
+            m8q_txr_handler(); 
+            next_fix += (uint64_t)SIM_GPS_FIX_PERIOD * SIM_US_PER_MS; 
+        }
+
+        while (next_mark <= now)
+        {
+            log_set_trailmark(); 
+            next_mark += (uint64_t)SIM_TRAILMARK_PERIOD * SIM_US_PER_S; 
+        }
+
+        // Skip ahead to the next event when nothing is queued 
+        if (!log_get_adc_ring_count())
+        {
+            log_data(); 
+            now = next_block; 
+            now = (next_rev < now) ? next_rev : now; 
+            now = (next_fix < now) ? next_fix : now; 
+            now = (next_mark < now) ? next_mark : now; 
+            continue; 
+        }
+
+        log_sim_devices_set_time(now); 
+        sim_timebase.CNT = (uint32_t)now; 
+
+        uint32_t syncs = log_sim_devices_get()->sd_syncs; 
+        uint64_t start = sim_host_time(); 
+        log_data(); 
+        uint64_t host = sim_host_time() - start; 
+
+        uint32_t device = log_sim_devices_elapsed(); 
+        sim_results_record(&results, host, device, 
+                           (uint8_t)(log_sim_devices_get()->sd_syncs != syncs)); 
+        now += device + latency.loop; 
+    }
+
+    results.samples = block_index; 
+    results.drops = log_get_adc_ring_drops(); 
+    results.ring_hwm = log_get_adc_ring_hwm(); 
+
+    log_data_end(); 
+
+    uint64_t host_time = sim_host_time() - host_start; 
+
+    //==================================================
+
+    sim_results_print(&results, now, host_time); 
+
+    if (out != NULL)
+    {
+        fclose(out); 
+    }
+
+    free(recording.samples); 
+
+    return 0; 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Sensor data 
+
+// Read the host time 
+static uint64_t sim_host_time(void)
+{
+    struct timespec ts; 
+    clock_gettime(CLOCK_MONOTONIC, &ts); 
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec; 
+}
+
+
+// Load a recorded text log 
+static int sim_recording_load(
+    const char *path, 
+    sim_recording_t *recording)
+{
+    FILE *in = fopen(path, "r"); 
+    char line[SIM_LINE_LEN]; 
+    uint32_t size = 0; 
+    uint8_t data = 0; 
+
+    if (in == NULL)
+    {
+        return 1; 
+    }
+
+    while (fgets(line, sizeof(line), in) != NULL)
+    {
+        unsigned int trailmark, fork, shock; 
+        int ax, ay, az; 
+        sim_sample_t *sample; 
+
+        if (!data)
+        {
+            // The start line ends with "\r\n" which may be read as "\n" 
+            data = !strncmp(line, mtbdl_data_log_start, strlen(mtbdl_data_log_start) - 2); 
+            continue; 
+        }
+
+        if (sscanf(line, "%u, %u, %u, ", &trailmark, &fork, &shock) != 3)
+        {
+            continue; 
+        }
+
+        if (recording->num_samples >= size)
+        {
+            size = size ? (size * 2) : 1024; 
+            sample = realloc(recording->samples, size * sizeof(sim_sample_t)); 
+
+            if (sample == NULL)
+            {
+                break; 
+            }
+
+            recording->samples = sample; 
+        }
+
+        sample = &recording->samples[recording->num_samples++]; 
+        memset((void *)sample, 0, sizeof(sim_sample_t)); 
+        sample->trailmark = (uint8_t)(trailmark != 0); 
+        sample->fork = (uint16_t)((fork > SIM_ADC_MAX) ? SIM_ADC_MAX : fork); 
+        sample->shock = (uint16_t)((shock > SIM_ADC_MAX) ? SIM_ADC_MAX : shock); 
+
+        // Acceleration is only in the lines the accelerometer stream wrote 
+        if (sscanf(line, "%*u, %*u, %*u, %*[^,], %d, %d, %d", &ax, &ay, &az) == 3)
+        {
+            sample->accel[X_AXIS] = (int16_t)ax; 
+            sample->accel[Y_AXIS] = (int16_t)ay; 
+            sample->accel[Z_AXIS] = (int16_t)az; 
+        }
+    }
+
+    fclose(in); 
+
+    return recording->num_samples ? 0 : 1; 
+}
+
+
+// Get the sensor data of a sample 
+static void sim_sample_get(
+    const sim_recording_t *recording, 
+    uint64_t index, 
+    sim_sample_t *sample)
+{
+    if (recording != NULL)
+    {
+        *sample = recording->samples[index % recording->num_samples]; 
+        return; 
+    }
+
+    // Fork and shock travel at a few Hz with noise around the sag point 
+    double t = (double)index / LOG_SUS_RATE; 
+    double fork = 0.3 + 0.15 * sin(2.0 * M_PI * 2.0 * t) + 0.05 * sin(2.0 * M_PI * 7.3 * t); 
+    double shock = 0.3 + 0.1 * sin(2.0 * M_PI * 1.7 * t + 1.0); 
+
+    fork += 0.01 * ((double)(rand() % 201) - 100.0) / 100.0; 
+    shock += 0.01 * ((double)(rand() % 201) - 100.0) / 100.0; 
+
+    memset((void *)sample, 0, sizeof(sim_sample_t)); 
+    sample->fork = (uint16_t)(fork * SIM_ADC_MAX); 
+    sample->shock = (uint16_t)(shock * SIM_ADC_MAX); 
+    sample->accel[X_AXIS] = (int16_t)(2000.0 * sin(2.0 * M_PI * 3.0 * t)); 
+    sample->accel[Y_AXIS] = (int16_t)(1000.0 * sin(2.0 * M_PI * 0.5 * t)); 
+    sample->accel[Z_AXIS] = (int16_t)(16384 + (rand() % 1001) - 500); 
+}
+
+
+// Fill the DMA buffer being written with the next block of samples 
+static void sim_block_fill(
+    const sim_recording_t *recording, 
+    uint64_t index)
+{
+    // Current target set means memory 1 is being written 
+    uint8_t mem = (sim_dma_stream.CR & DMA_SxCR_CT) ? 1 : 0; 
+    uint16_t (*block)[LOG_ADC_OSR][ADC_BUFF_SIZE] = 
+        (uint16_t (*)[LOG_ADC_OSR][ADC_BUFF_SIZE])(size_t)dma_mock_get_mem_addr(mem); 
+    sim_sample_t sample; 
+
+    if (index == 0)
+    {
+        srand(SIM_SEED); 
+    }
+
+    for (uint8_t i = 0; i < LOG_ADC_BLOCK_SIZE; i++)
+    {
+        sim_sample_get(recording, index + i, &sample); 
+
+        if (sample.trailmark)
+        {
+            log_set_trailmark(); 
+        }
+
+        // The accelerometer is read by the stream that runs at the end of the block 
+        mpu6050_mock_set_accel(sample.accel[X_AXIS], sample.accel[Y_AXIS], 
+                               sample.accel[Z_AXIS]); 
+
+        uint32_t
+        soc = (uint32_t)SIM_ADC_MAX << LOG_ADC_OSR_BITS, 
+        fork = (uint32_t)sample.fork << LOG_ADC_OSR_BITS, 
+        shock = (uint32_t)sample.shock << LOG_ADC_OSR_BITS; 
+
+        for (uint8_t j = 0; j < LOG_ADC_OSR; j++)
+        {
+            block[i][j][ADC_SOC] = (uint16_t)(soc / LOG_ADC_OSR + (j < (soc % LOG_ADC_OSR))); 
+            block[i][j][ADC_FORK] = (uint16_t)(fork / LOG_ADC_OSR + (j < (fork % LOG_ADC_OSR))); 
+            block[i][j][ADC_SHOCK] = (uint16_t)(shock / LOG_ADC_OSR + (j < (shock % LOG_ADC_OSR))); 
+        }
+    }
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Results 
+
+// Record the times of a log_data call 
+static void sim_results_record(
+    sim_results_t *results, 
+    uint64_t host, 
+    uint32_t device, 
+    uint8_t sync)
+{
+    uint8_t bin = 0; 
+    uint32_t *device_max = sync ? &results->sync_device_max : &results->other_device_max; 
+
+    results->log_calls++; 
+    results->host_total += host; 
+    results->host_min = (host < results->host_min) ? host : results->host_min; 
+    results->host_max = (host > results->host_max) ? host : results->host_max; 
+    results->device_max = (device > results->device_max) ? device : results->device_max; 
+    *device_max = (device > *device_max) ? device : *device_max; 
+
+    while (host && (bin < (SIM_NUM_BINS - 1)))
+    {
+        host >>= 1; 
+        bin++; 
+    }
+
+    results->host_bins[bin]++; 
+}
+
+
+// Print the results 
+static void sim_results_print(
+    const sim_results_t *results, 
+    uint64_t sim_time, 
+    uint64_t host_time)
+{
+    const log_sim_devices_t *devices = log_sim_devices_get(); 
+    double sim_s = (double)sim_time / SIM_US_PER_S, host_s = (double)host_time / 1e9; 
+
+    printf("Sample rate:       %u Hz, %u samples per block\n", 
+           LOG_SUS_RATE, LOG_ADC_BLOCK_SIZE); 
+    printf("Simulated time:    %.1f s\n", sim_s); 
+    printf("Host time:         %.3f s (%.0fx real time)\n", 
+           host_s, (host_s > 0.0) ? (sim_s / host_s) : 0.0); 
+    printf("Samples:           %llu\n", (unsigned long long)results->samples); 
+    printf("Bytes written:     %llu (%.0f bytes/s)\n", 
+           (unsigned long long)devices->bytes, 
+           (sim_s > 0.0) ? ((double)devices->bytes / sim_s) : 0.0); 
+    printf("Sector writes:     %u\n", devices->sd_writes); 
+    printf("Write stalls:      %u\n", devices->sd_stalls); 
+    printf("Log syncs:         %u (%.1f s apart)\n", devices->sd_syncs, 
+           devices->sd_syncs ? (sim_s / devices->sd_syncs) : 0.0); 
+    printf("GPS reads:         %u\n", devices->gps_reads); 
+    printf("Accel reads:       %u\n", devices->accel_reads); 
+    printf("IMU FIFO reads:    %u, %llu samples, %u overflows\n", devices->imu_reads, 
+           (unsigned long long)devices->imu_samples, devices->imu_overflows); 
+    printf("Overruns:          %u samples dropped\n", results->drops); 
+    printf("ADC ring max:      %u of %u\n", results->ring_hwm, LOG_ADC_RING_SIZE); 
+    printf("Device time max:   %u us per log_data\n", results->device_max); 
+    printf("Sync slot max:     %u us device time (%u us without a sync)\n", 
+           results->sync_device_max, results->other_device_max); 
+
+    if (!results->log_calls)
+    {
+        return; 
+    }
+
+    printf("Host time:         min %llu, avg %llu, max %llu ns per log_data\n\n", 
+           (unsigned long long)results->host_min, 
+           (unsigned long long)(results->host_total / results->log_calls), 
+           (unsigned long long)results->host_max); 
+
+    printf("%-16s %12s\n", "host time (ns)", "log_data"); 
+
+    for (uint8_t bin = 0; bin < SIM_NUM_BINS; bin++)
+    {
+        char label[32]; 
+
+        if (!results->host_bins[bin])
+        {
+            continue; 
+        }
+
+        if (bin == 0)
+        {
+            snprintf(label, sizeof(label), "<1"); 
+        }
+        else if (bin == (SIM_NUM_BINS - 1))
+        {
+            snprintf(label, sizeof(label), "%llu+", 1ULL << (bin - 1)); 
+        }
+        else 
+        {
+            snprintf(label, sizeof(label), "%llu-%llu", 1ULL << (bin - 1), (1ULL << bin) - 1); 
+        }
+
+        printf("%-16s %12llu\n", label, (unsigned long long)results->host_bins[bin]); 
+    }
+}
+
+
+// Print the usage 
+static void sim_usage(const char *name)
+{
+    fprintf(stderr, 
+            "Usage: %s [options]\n"
+            "  -t <s>      simulated time (default %u)\n"
+            "  -m <mode>   log mode: text, binary or packed (default text)\n"
+            "  -i <file>   replay a recorded text log instead of synthetic data\n"
+            "  -o <file>   write the log to a file\n"
+            "  -s <us>     SD card write time per sector (default %u)\n"
+            "  -p <ms>     time between SD card write stalls, 0 for none (default %u)\n"
+            "  -S <us>     SD card write stall time (default %u)\n"
+            "  -y <us>     log file sync time (default %u)\n"
+            "  -g <us>     GPS read time (default %u)\n"
+            "  -a <us>     accelerometer read time (default %u)\n"
+            "  -b <us>     IMU FIFO read time per byte (default %u)\n"
+            "  -l <us>     main loop time besides log_data (default %u)\n"
+            "  -w <km/h>   wheel speed (default %.0f)\n", 
+            name, SIM_TIME, SIM_SD_SECTOR, SIM_SD_STALL_PERIOD, SIM_SD_STALL, 
+            SIM_SD_SYNC, SIM_GPS_READ, SIM_ACCEL_READ, SIM_I2C_BYTE, SIM_LOOP, 
+            SIM_WHEEL_SPEED); 
+}
+
+//=======================================================================================
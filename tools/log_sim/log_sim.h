@@ -0,0 +1,112 @@
+/**
+ * @file log_sim.h
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Data logging simulator interface 
+ * 
+ * @details Shared by the simulator and its simulated devices. The simulated devices 
+ *          stand in for the SD card, GPS and accelerometer controllers (including the 
+ *          IMU FIFO) and the system parameters. Instead of taking time they add the 
+ *          time they would take on the system to a total that the simulator uses to 
+ *          move its clock. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _LOG_SIM_H_ 
+#define _LOG_SIM_H_ 
+
+//=======================================================================================
+// Includes 
+
+#include <stdio.h>
+#include <stdint.h>
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// Device latencies (us) added to the simulated time 
+typedef struct log_sim_latency_s
+{
+    uint32_t sd_sector;                         // SD card write of each sector 
+    uint32_t sd_stall_period;                   // (ms) Time between write stalls, 0 = none 
+    uint32_t sd_stall;                          // SD card write stall (busy) time 
+    uint32_t sd_sync;                           // Log file sync 
+    uint32_t gps_read;                          // GPS read (I2C) 
+    uint32_t accel_read;                        // Accelerometer read (I2C) 
+    uint32_t i2c_byte;                          // I2C transfer of each IMU FIFO byte 
+    uint32_t loop;                              // Main loop time besides the devices 
+}
+log_sim_latency_t; 
+
+
+// Simulated device totals 
+typedef struct log_sim_devices_s
+{
+    uint64_t bytes;                             // Bytes written to the log file 
+    uint32_t sd_writes;                         // Sector writes 
+    uint32_t sd_stalls;                         // Write stalls 
+    uint32_t sd_syncs;                          // Log file syncs 
+    uint32_t gps_reads;                         // GPS reads 
+    uint32_t accel_reads;                       // Accelerometer reads 
+    uint32_t imu_reads;                         // IMU FIFO burst reads 
+    uint64_t imu_samples;                       // IMU FIFO samples read 
+    uint32_t imu_overflows;                     // IMU FIFO overflows (samples lost) 
+}
+log_sim_devices_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Simulated devices 
+
+/**
+ * @brief Initialize the simulated devices 
+ * 
+ * @param latency : device latencies 
+ * @param out : file to write the log to, NULL to only count the bytes 
+ */
+void log_sim_devices_init(
+    const log_sim_latency_t *latency, 
+    FILE *out); 
+
+
+/**
+ * @brief Set the simulated time 
+ * 
+ * @details Used to schedule the SD card write stalls. 
+ * 
+ * @param now : simulated time (us) 
+ */
+void log_sim_devices_set_time(uint64_t now); 
+
+
+/**
+ * @brief Get the device time 
+ * 
+ * @details Returns the device time (us) added since the last call and clears it. 
+ * 
+ * @return uint32_t : device time (us) 
+ */
+uint32_t log_sim_devices_elapsed(void); 
+
+
+/**
+ * @brief Get the device totals 
+ * 
+ * @return const log_sim_devices_t* : device totals 
+ */
+const log_sim_devices_t *log_sim_devices_get(void); 
+
+//=======================================================================================
+
+#endif   // _LOG_SIM_H_ 
@@ -0,0 +1,535 @@
+/**
+ * @file log_sim_devices.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Data logging simulator devices 
+ * 
+ * @details Host versions of the SD card controller, GPS and accelerometer controllers 
+ *          and system parameter functions used by the data logging module. The device 
+ *          data (GPS position, acceleration, etc.) comes from the unit test driver 
+ *          mocks. SD card writes are buffered the same way as the SD card controller 
+ *          write buffer so the write latency lands on the same calls it would on the 
+ *          system. The IMU FIFO fills at its sample rate on the simulated clock and 
+ *          overflows the same way the device FIFO does if it isn't read in time. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include "log_sim.h"
+#include "sd_controller.h"
+#include "m8q_controller.h"
+#include "mpu6050_controller.h"
+#include "system_parameters.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Variables 
+
+// Simulated device data 
+static struct log_sim_device_data_s
+{
+    log_sim_latency_t latency;                  // Device latencies 
+    log_sim_devices_t totals;                   // Device totals 
+    FILE *out;                                  // Log output 
+    uint64_t now;                               // (us) Simulated time 
+    uint64_t next_stall;                        // (us) Time of the next write stall 
+    uint32_t elapsed;                           // (us) Device time since last checked 
+    uint32_t buff_len;                          // Bytes in the SD card write buffer 
+    uint8_t open_file;                          // Open file flag 
+    uint8_t m8q_read;                           // GPS read flag 
+    uint8_t m8q_data_ready;                     // GPS data ready (TX ready) flag 
+    m8q_fix_t m8q_fix;                          // GPS fix published by the last read 
+    uint8_t mpu6050_read;                       // Accelerometer read flag 
+    uint8_t fifo_read;                          // IMU FIFO read flag 
+    uint8_t fifo_reset;                         // IMU FIFO reset flag 
+    uint32_t fifo_period;                       // (us) IMU FIFO sample period, 0 = no FIFO 
+    uint64_t fifo_next;                         // (us) Time of the next IMU FIFO sample 
+    uint16_t fifo_count;                        // Samples in the IMU FIFO 
+    uint16_t fifo_max;                          // Samples the burst read buffer holds 
+    uint16_t fifo_frames;                       // Samples from the last burst read 
+    uint64_t fifo_done;                         // (us) Time the last burst read finishes 
+    uint32_t fifo_time;                         // (us) Time of the last FIFO count read 
+    uint16_t fifo_overflow;                     // IMU FIFO overflows 
+#if M8Q_UBX_NAV_PVT
+    m8q_ubx_nav_pvt_t pvt;                      // GPS NAV-PVT fix 
+#endif
+}
+sim; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Simulated devices 
+
+// Initialize the simulated devices 
+void log_sim_devices_init(
+    const log_sim_latency_t *latency, 
+    FILE *out)
+{
+    memset((void *)&sim, CLEAR, sizeof(sim)); 
+    sim.latency = *latency; 
+    sim.out = out; 
+    sim.next_stall = (uint64_t)latency->sd_stall_period * 1000; 
+
+#if M8Q_UBX_NAV_PVT
+    // The same position and speed as the PUBX strings from the M8Q mock 
+    sim.pvt.fixType = M8Q_UBX_FIX_3D; 
+    sim.pvt.flags = M8Q_UBX_PVT_GNSS_FIX_OK; 
+    sim.pvt.numSV = 9; 
+    sim.pvt.lat = 492741667; 
+    sim.pvt.lon = -1231853333; 
+    sim.pvt.gSpeed = 1; 
+#endif
+}
+
+
+// Set the simulated time 
+void log_sim_devices_set_time(uint64_t now)
+{
+    sim.now = now; 
+}
+
+
+// Get the device time 
+uint32_t log_sim_devices_elapsed(void)
+{
+    uint32_t elapsed = sim.elapsed; 
+    sim.elapsed = CLEAR; 
+    return elapsed; 
+}
+
+
+// Get the device totals 
+const log_sim_devices_t *log_sim_devices_get(void)
+{
+    return &sim.totals; 
+}
+
+
+// Write sectors to the SD card 
+static void log_sim_sd_write(uint32_t sectors)
+{
+    sim.elapsed += sectors * sim.latency.sd_sector; 
+    sim.totals.sd_writes += sectors; 
+
+    // Cards are busy for a long time every so often (wear leveling, erasing, etc.) 
+    if (sim.latency.sd_stall_period && (sim.now >= sim.next_stall))
+    {
+        sim.elapsed += sim.latency.sd_stall; 
+        sim.totals.sd_stalls++; 
+
+        while (sim.next_stall <= sim.now)
+        {
+            sim.next_stall += (uint64_t)sim.latency.sd_stall_period * 1000; 
+        }
+    }
+}
+
+
+// Add bytes to the log file 
+static void log_sim_sd_bytes(
+    const void *buff, 
+    UINT btw)
+{
+    if (sim.out != NULL)
+    {
+        fwrite(buff, 1, btw, sim.out); 
+    }
+
+    sim.totals.bytes += btw; 
+}
+
+
+// Write the SD card write buffer 
+static void log_sim_sd_flush(void)
+{
+    if (sim.buff_len)
+    {
+        log_sim_sd_write((sim.buff_len + SD_SECTOR_SIZE - 1) / SD_SECTOR_SIZE); 
+        sim.buff_len = CLEAR; 
+    }
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// SD card controller 
+
+// Set the directory 
+void sd_set_dir(const TCHAR *dir)
+{
+    // 
+}
+
+
+// Open a file 
+FRESULT sd_open(
+    const TCHAR *file_name, 
+    uint8_t mode)
+{
+    sim.open_file = SET_BIT; 
+    return FR_OK; 
+}
+
+
+// Close the open file 
+FRESULT sd_close(void)
+{
+    log_sim_sd_flush(); 
+    sim.open_file = CLEAR_BIT; 
+    return FR_OK; 
+}
+
+
+// Write to the open file 
+FRESULT sd_f_write(
+    const void *buff, 
+    UINT btw)
+{
+    log_sim_sd_flush(); 
+    log_sim_sd_bytes(buff, btw); 
+    log_sim_sd_write((btw + SD_SECTOR_SIZE - 1) / SD_SECTOR_SIZE); 
+    return FR_OK; 
+}
+
+
+// Write a string to the open file 
+int16_t sd_puts(const TCHAR *str)
+{
+    UINT len = (UINT)strlen(str); 
+    sd_f_write((const void *)str, len); 
+    return (int16_t)len; 
+}
+
+
+// Sync the open file - the write buffer isn't written 
+FRESULT sd_sync(void)
+{
+    if (sim.open_file)
+    {
+        sim.elapsed += sim.latency.sd_sync; 
+        sim.totals.sd_syncs++; 
+    }
+
+    return FR_OK; 
+}
+
+
+// Pre-allocate the open file 
+FRESULT sd_expand(FSIZE_t size)
+{
+    return FR_OK; 
+}
+
+
+// Truncate the open file 
+FRESULT sd_truncate(void)
+{
+    return FR_OK; 
+}
+
+
+// Write to the open file through the write buffer 
+FRESULT sd_buff_write(
+    const void *buff, 
+    UINT btw)
+{
+    // The buffer is written each time it fills 
+    log_sim_sd_bytes(buff, btw); 
+    sim.buff_len += btw; 
+
+    while (sim.buff_len >= SD_BUFF_SIZE)
+    {
+        log_sim_sd_write(SD_BUFF_SECTORS); 
+        sim.buff_len -= SD_BUFF_SIZE; 
+    }
+
+    return FR_OK; 
+}
+
+
+// Write a string to the open file through the write buffer 
+int16_t sd_buff_puts(const TCHAR *str)
+{
+    UINT len = (UINT)strlen(str); 
+    sd_buff_write((const void *)str, len); 
+    return (int16_t)len; 
+}
+
+
+// Get the open file flag 
+SD_FILE_STATUS sd_get_file_status(void)
+{
+    return sim.open_file; 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// GPS and accelerometer controllers 
+
+// GPS controller - reads the device when the read flag and data ready flag are set and 
+// publishes the fix. NAV-PVT reads run in the background on the I2C bus so they don't 
+// add to the main loop time. 
+void m8q_controller(void)
+{
+    if (sim.m8q_read && sim.m8q_data_ready)
+    {
+        sim.m8q_data_ready = CLEAR; 
+#if !M8Q_UBX_NAV_PVT
+        sim.elapsed += sim.latency.gps_read; 
+#endif
+        sim.totals.gps_reads++; 
+
+        m8q_fix_t *fix = &sim.m8q_fix; 
+        fix->time = (uint32_t)sim.now; 
+#if M8Q_UBX_NAV_PVT
+        sim.pvt.iTOW = (uint32_t)(sim.now / 1000); 
+        fix->pvt = sim.pvt; 
+        fix->navstat = m8q_ubx_navstat(&sim.pvt); 
+        fix->lock = m8q_ubx_navstat_lock(&sim.pvt); 
+#else
+        m8q_get_position_lat_str(fix->lat_str, M8Q_FIX_STR_LEN); 
+        fix->NS = m8q_get_position_NS(); 
+        m8q_get_position_lon_str(fix->lon_str, M8Q_FIX_STR_LEN); 
+        fix->EW = m8q_get_position_EW(); 
+        m8q_get_position_sog_str(fix->sog_str, M8Q_FIX_STR_LEN); 
+        m8q_get_time_utc_time(fix->utc_time, M8Q_FIX_TIME_LEN); 
+        m8q_get_time_utc_date(fix->utc_date, M8Q_FIX_TIME_LEN); 
+#endif
+    }
+}
+
+
+// Set the GPS read flag 
+void m8q_set_read_flag(void)
+{
+    sim.m8q_read = SET_BIT; 
+}
+
+
+// Clear the GPS read flag 
+void m8q_set_idle_flag(void)
+{
+    sim.m8q_read = CLEAR_BIT; 
+}
+
+
+// Get the GPS data ready flag 
+uint8_t m8q_get_data_ready(void)
+{
+    return sim.m8q_data_ready; 
+}
+
+
+// Get the last GPS fix 
+void m8q_get_fix(m8q_fix_t *fix)
+{
+    *fix = sim.m8q_fix; 
+}
+
+
+// GPS TX ready interrupt - called by the simulator once each fix is ready 
+void m8q_txr_handler(void)
+{
+    sim.m8q_data_ready = SET_BIT; 
+}
+
+
+// Accelerometer controller - reads the device once when the read flag is set, resets 
+// the FIFO when the FIFO reset flag is set and burst reads the FIFO when the FIFO read 
+// flag is set. FIFO reads run in the background on the I2C bus so they don't add to the 
+// main loop time. Their samples can't be had until the bus transfer time has passed. 
+void mpu6050_controller(device_number_t device_num)
+{
+    if (sim.mpu6050_read)
+    {
+        sim.mpu6050_read = CLEAR_BIT; 
+        sim.elapsed += sim.latency.accel_read; 
+        sim.totals.accel_reads++; 
+    }
+
+    // Samples taken since the last read or reset go in the FIFO 
+    while (sim.fifo_period && (sim.fifo_next <= sim.now))
+    {
+        sim.fifo_count++; 
+        sim.fifo_next += sim.fifo_period; 
+    }
+
+    if (sim.fifo_reset)
+    {
+        sim.fifo_reset = CLEAR_BIT; 
+        sim.fifo_count = CLEAR; 
+        sim.fifo_frames = CLEAR; 
+    }
+
+    // A read is skipped while the last one is still on the bus 
+    if (sim.fifo_read && sim.fifo_period && (sim.now >= sim.fifo_done))
+    {
+        sim.fifo_read = CLEAR_BIT; 
+        sim.fifo_frames = CLEAR; 
+        sim.totals.imu_reads++; 
+
+        // The count is read first 
+        sim.fifo_done = sim.now + BYTE_2 * sim.latency.i2c_byte; 
+        sim.fifo_time = (uint32_t)sim.fifo_done; 
+
+        if ((sim.fifo_count * MPU6050_FIFO_FRAME_SIZE) >= MPU6050_FIFO_SIZE)
+        {
+            sim.fifo_count = CLEAR; 
+            sim.fifo_overflow++; 
+            sim.totals.imu_overflows++; 
+            return; 
+        }
+
+        sim.fifo_frames = (sim.fifo_count < sim.fifo_max) ? sim.fifo_count : sim.fifo_max; 
+        sim.fifo_count -= sim.fifo_frames; 
+        sim.fifo_done += sim.fifo_frames * MPU6050_FIFO_FRAME_SIZE * sim.latency.i2c_byte; 
+        sim.totals.imu_samples += sim.fifo_frames; 
+    }
+
+    sim.fifo_read = CLEAR_BIT; 
+}
+
+
+// Accelerometer FIFO init 
+void mpu6050_fifo_init(
+    device_number_t device_num, 
+    I2C_TypeDef *i2c, 
+    mpu6050_i2c_addr_t addr, 
+    uint8_t rate_div, 
+    uint8_t *buff, 
+    uint16_t buff_size)
+{
+    sim.fifo_period = (uint32_t)(rate_div + 1) * (1000000 / MPU6050_FIFO_BASE_RATE); 
+    sim.fifo_next = sim.now; 
+    sim.fifo_count = CLEAR; 
+    sim.fifo_max = buff_size / MPU6050_FIFO_FRAME_SIZE; 
+}
+
+
+// Set the accelerometer read flag 
+void mpu6050_set_read_flag(device_number_t device_num)
+{
+    sim.mpu6050_read = SET_BIT; 
+}
+
+
+// Set the accelerometer FIFO read flag 
+void mpu6050_set_fifo_flag(device_number_t device_num)
+{
+    sim.fifo_read = SET_BIT; 
+}
+
+
+// Set the accelerometer FIFO reset flag 
+void mpu6050_set_fifo_reset_flag(device_number_t device_num)
+{
+    sim.fifo_reset = SET_BIT; 
+}
+
+
+// Get the number of frames from the last FIFO burst read 
+uint16_t mpu6050_get_fifo_frames(device_number_t device_num)
+{
+    return (sim.now < sim.fifo_done) ? CLEAR : sim.fifo_frames; 
+}
+
+
+// Get the time of the last FIFO burst read 
+uint32_t mpu6050_get_fifo_time(device_number_t device_num)
+{
+    return sim.fifo_time; 
+}
+
+
+// Get a frame from the last FIFO burst read - the acceleration is the latest sensor 
+// data and the angular rate counts up so dropped or repeated samples stand out 
+void mpu6050_get_fifo_frame(
+    device_number_t device_num, 
+    uint16_t frame, 
+    int16_t *accel, 
+    int16_t *gyro)
+{
+    static int16_t rate = 0; 
+
+    mpu6050_get_accel_axis(device_num, accel); 
+
+    for (uint8_t i = X_AXIS; i < NUM_AXES; i++)
+    {
+        gyro[i] = rate; 
+    }
+
+    rate++; 
+}
+
+
+// Get the FIFO overflow count 
+uint16_t mpu6050_get_fifo_overflow(device_number_t device_num)
+{
+    return sim.fifo_overflow; 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// System parameters 
+
+// Write the system parameters 
+void param_write_sys_params(uint8_t mode)
+{
+    // 
+}
+
+
+// Write the bike parameters to the log file 
+void param_bike_format_write(void)
+{
+    sd_puts("Bike: simulated\r\n"); 
+}
+
+
+// Write the system parameters to the log file 
+void param_sys_format_write(void)
+{
+    sd_puts("System: simulated\r\n"); 
+}
+
+
+// Update the log index 
+void param_update_log_index(param_log_index_change_t log_index_change)
+{
+    // 
+}
+
+
+// Update a system setting 
+void param_update_system_setting(
+    param_sys_set_index_t setting_index, 
+    void *setting)
+{
+    // 
+}
+
+
+// Get the log index 
+uint8_t param_get_log_index(void)
+{
+    return 0; 
+}
+
+//=======================================================================================
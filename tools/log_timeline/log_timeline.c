@@ -0,0 +1,378 @@
+/**
+ * @file log_timeline.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Log stream schedule timeline report 
+ * 
+ * @details Host tool that prints the log stream schedule (log_schedule.h) and the slots 
+ *          of its hyperperiod. The slots are picked by the same schedule code the data 
+ *          logging module uses so the report shows the streams that run in each slot, 
+ *          the streams deferred to the next slot and the stream time (work) of the slot 
+ *          against the slot budget. The schedule checks are compiled in with the schedule 
+ *          so the tool doesn't build if the schedule is bad. 
+ * 
+ *          A stream deferred past the end of a hyperperiod changes the next one, so 
+ *          hyperperiods are reported until they start the same way as one before. 
+ * 
+ *          Usage: log_timeline [report] 
+ * 
+ *          Output goes to stdout if no report file is given. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "log_schedule.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define LOG_TIMELINE_SET_LEN 64          // Max length of a stream set name 
+#define LOG_TIMELINE_MAX_HYPER 256       // Hyperperiods looked at for a repeat 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// Schedule table row 
+typedef struct log_timeline_stream_s
+{
+    const char *name;                           // Stream name 
+    uint32_t offset;                            // Counter starting value 
+    uint32_t period;                            // Counter period (slots) 
+    uint32_t cost;                              // (us) Worst case stream time 
+    uint32_t share;                             // Can share a slot 
+}
+log_timeline_stream_t; 
+
+
+// Timeline totals 
+typedef struct log_timeline_stats_s
+{
+    uint32_t max_work;                          // (us) Most stream time in one slot 
+    uint32_t standard;                          // Slots with only the standard stream 
+    uint32_t deferred;                          // Slots that deferred a stream 
+    uint32_t max_delay[LOG_SCHED_NUM];          // Most slots a stream ran late 
+    uint32_t lost[LOG_SCHED_NUM];               // Runs lost (due again while deferred) 
+}
+log_timeline_stats_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Variables 
+
+// Schedule table by stream 
+#define LOG_TIMELINE_ROW(stream, offset, period, cost, share) \
+    { #stream, (offset), (period), (cost), (share) }, 
+
+static const log_timeline_stream_t log_timeline_streams[LOG_SCHED_NUM] = 
+{
+    { "STANDARD", 0, 0, 0, 0 }, 
+    LOG_SCHEDULE(LOG_TIMELINE_ROW)
+}; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Function prototypes 
+
+/**
+ * @brief Write the stream table and the stream pair collisions 
+ * 
+ * @param out : report file 
+ */
+void log_timeline_table(FILE *out); 
+
+
+/**
+ * @brief Write the slots of one hyperperiod 
+ * 
+ * @param out : report file 
+ * @param sched : schedule data at the start of the hyperperiod 
+ * @param due_slot : slot each stream was last due in 
+ * @param slot : first slot number of the hyperperiod 
+ * @param stats : timeline totals 
+ */
+void log_timeline_hyperperiod(
+    FILE *out, 
+    log_schedule_t *sched, 
+    uint32_t *due_slot, 
+    uint32_t slot, 
+    log_timeline_stats_t *stats); 
+
+
+/**
+ * @brief Format a set of streams 
+ * 
+ * @param streams : streams (LOG_SCHED_BIT) 
+ * @param buff : buffer for the stream names 
+ * @return const char * : stream names separated by '+', "-" for none 
+ */
+const char *log_timeline_set(
+    uint8_t streams, 
+    char *buff); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Main 
+
+int main(
+    int argc, 
+    char *argv[])
+{
+    log_schedule_t sched; 
+    log_timeline_stats_t stats; 
+    uint32_t due_slot[LOG_SCHED_NUM]; 
+    uint8_t start[LOG_TIMELINE_MAX_HYPER]; 
+    uint32_t load = 0; 
+    FILE *out; 
+
+    if (argc > 2)
+    {
+        fprintf(stderr, "Usage: %s [report]\n", argv[0]); 
+        return 1; 
+    }
+
+    out = (argc == 2) ? fopen(argv[1], "w") : stdout; 
+    if (out == NULL)
+    {
+        fprintf(stderr, "Can't open %s\n", argv[1]); 
+        return 1; 
+    }
+
+    for (uint8_t i = LOG_SCHED_STANDARD + 1; i < LOG_SCHED_NUM; i++)
+    {
+        load += log_timeline_streams[i].cost * 
+                (LOG_SCHED_HYPERPERIOD / log_timeline_streams[i].period); 
+    }
+
+    fprintf(out, "Log stream schedule\n\n"); 
+    fprintf(out, "Slot period: %ums\n", (unsigned)LOG_STREAM_PERIOD); 
+    fprintf(out, "Slot budget: %uus\n", (unsigned)LOG_SLOT_BUDGET); 
+    fprintf(out, "Hyperperiod: %u slots (%ums)\n", (unsigned)LOG_SCHED_HYPERPERIOD, 
+            (unsigned)(LOG_SCHED_HYPERPERIOD * LOG_STREAM_PERIOD)); 
+    fprintf(out, "Average load: %u.%u%% of the budget\n\n", 
+            (unsigned)((load * 100) / (LOG_SLOT_BUDGET * LOG_SCHED_HYPERPERIOD)), 
+            (unsigned)(((load * 1000) / (LOG_SLOT_BUDGET * LOG_SCHED_HYPERPERIOD)) % 10)); 
+
+    log_timeline_table(out); 
+
+    memset((void *)&stats, 0, sizeof(stats)); 
+    memset((void *)due_slot, 0, sizeof(due_slot)); 
+    log_schedule_init(&sched); 
+
+    // The schedule counters are the same at the start of every hyperperiod so only the 
+    // deferred streams can make one hyperperiod different from another. 
+    for (uint32_t h = 0; h < LOG_TIMELINE_MAX_HYPER; h++)
+    {
+        uint8_t repeat = 0; 
+
+        for (uint32_t i = 0; i < h; i++)
+        {
+            if (start[i] == sched.deferred)
+            {
+                fprintf(out, "Hyperperiod %u repeats hyperperiod %u\n\n", 
+                        (unsigned)(h + 1), (unsigned)(i + 1)); 
+                repeat = 1; 
+            }
+        }
+
+        if (repeat)
+        {
+            break; 
+        }
+
+        start[h] = sched.deferred; 
+        fprintf(out, "Hyperperiod %u\n", (unsigned)(h + 1)); 
+        log_timeline_hyperperiod(out, &sched, due_slot, (h * LOG_SCHED_HYPERPERIOD) + 1, 
+                                 &stats); 
+    }
+
+    fprintf(out, "Most work in a slot: %uus\n", (unsigned)stats.max_work); 
+    fprintf(out, "Standard stream slots: %u\n", (unsigned)stats.standard); 
+    fprintf(out, "Slots that deferred a stream: %u\n", (unsigned)stats.deferred); 
+
+    for (uint8_t i = LOG_SCHED_STANDARD + 1; i < LOG_SCHED_NUM; i++)
+    {
+        fprintf(out, "%s: most slots late %u, runs lost %u\n", 
+                log_timeline_streams[i].name, 
+                (unsigned)stats.max_delay[i], 
+                (unsigned)stats.lost[i]); 
+    }
+
+    if (out != stdout)
+    {
+        fclose(out); 
+    }
+
+    return 0; 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Functions 
+
+// Write the stream table and the stream pair collisions 
+void log_timeline_table(FILE *out)
+{
+    fprintf(out, "Stream    Offset  Period  Cost(us)  Share  Runs/hyperperiod\n"); 
+
+    for (uint8_t i = LOG_SCHED_STANDARD + 1; i < LOG_SCHED_NUM; i++)
+    {
+        fprintf(out, "%-8s  %6u  %6u  %8u  %5u  %16u\n", 
+                log_timeline_streams[i].name, 
+                (unsigned)log_timeline_streams[i].offset, 
+                (unsigned)log_timeline_streams[i].period, 
+                (unsigned)log_timeline_streams[i].cost, 
+                (unsigned)log_timeline_streams[i].share, 
+                (unsigned)(LOG_SCHED_HYPERPERIOD / log_timeline_streams[i].period)); 
+    }
+
+    fprintf(out, "\nCollisions\n"); 
+
+    for (uint8_t i = LOG_SCHED_STANDARD + 1; i < LOG_SCHED_NUM; i++)
+    {
+        for (uint8_t j = i + 1; j < LOG_SCHED_NUM; j++)
+        {
+            // Two streams are due in the same slot if their offsets match modulo the 
+            // GCD of their periods (same as the compile time checks). 
+            uint32_t a = log_timeline_streams[i].period; 
+            uint32_t b = log_timeline_streams[j].period; 
+
+            while (b)
+            {
+                uint32_t r = a % b; 
+                a = b; 
+                b = r; 
+            }
+
+            uint8_t collide = (log_timeline_streams[i].offset % a) == 
+                              (log_timeline_streams[j].offset % a); 
+
+            fprintf(out, "%s/%s: %s\n", 
+                    log_timeline_streams[i].name, log_timeline_streams[j].name, 
+                    !collide ? "never due together" : 
+                    (log_timeline_streams[i].share && log_timeline_streams[j].share) ? 
+                    "due together (shared)" : "due together (not allowed)"); 
+        }
+    }
+
+    fprintf(out, "\n"); 
+}
+
+
+// Write the slots of one hyperperiod 
+void log_timeline_hyperperiod(
+    FILE *out, 
+    log_schedule_t *sched, 
+    uint32_t *due_slot, 
+    uint32_t slot, 
+    log_timeline_stats_t *stats)
+{
+    char due_names[LOG_TIMELINE_SET_LEN], run_names[LOG_TIMELINE_SET_LEN]; 
+    char deferred_names[LOG_TIMELINE_SET_LEN]; 
+
+    fprintf(out, "%6s  %8s  %-20s  %-20s  %-20s  %8s\n", 
+            "Slot", "Time(ms)", "Due", "Run", "Deferred", "Work(us)"); 
+
+    for (uint32_t i = 0; i < LOG_SCHED_HYPERPERIOD; i++, slot++)
+    {
+        uint8_t deferred = sched->deferred, due = 0; 
+
+        // Streams due in this slot, worked out from the counters before the schedule 
+        // counts them 
+        for (uint8_t j = LOG_SCHED_STANDARD + 1; j < LOG_SCHED_NUM; j++)
+        {
+            if ((uint32_t)(sched->counter[j] + 1) >= log_timeline_streams[j].period)
+            {
+                due |= LOG_SCHED_BIT(j); 
+
+                if (deferred & LOG_SCHED_BIT(j))
+                {
+                    stats->lost[j]++; 
+                }
+                else 
+                {
+                    due_slot[j] = slot; 
+                }
+            }
+        }
+
+        uint8_t run = log_schedule_select(sched); 
+        uint32_t work = log_schedule_cost(run); 
+
+        for (uint8_t j = LOG_SCHED_STANDARD + 1; j < LOG_SCHED_NUM; j++)
+        {
+            if ((run & LOG_SCHED_BIT(j)) && ((slot - due_slot[j]) > stats->max_delay[j]))
+            {
+                stats->max_delay[j] = slot - due_slot[j]; 
+            }
+        }
+
+        if (work > stats->max_work)
+        {
+            stats->max_work = work; 
+        }
+
+        stats->standard += !run; 
+        stats->deferred += (sched->deferred != 0); 
+
+        fprintf(out, "%6u  %8u  %-20s  %-20s  %-20s  %8u\n", 
+                (unsigned)slot, 
+                (unsigned)(slot * LOG_STREAM_PERIOD), 
+                log_timeline_set(due, due_names), 
+                run ? log_timeline_set(run, run_names) : "STANDARD", 
+                log_timeline_set(sched->deferred, deferred_names), 
+                (unsigned)work); 
+    }
+
+    fprintf(out, "\n"); 
+}
+
+
+// Format a set of streams 
+const char *log_timeline_set(
+    uint8_t streams, 
+    char *buff)
+{
+    buff[0] = '\0'; 
+
+    for (uint8_t i = LOG_SCHED_STANDARD + 1; i < LOG_SCHED_NUM; i++)
+    {
+        if (streams & LOG_SCHED_BIT(i))
+        {
+            if (buff[0] != '\0')
+            {
+                strcat(buff, "+"); 
+            }
+            strcat(buff, log_timeline_streams[i].name); 
+        }
+    }
+
+    return (buff[0] != '\0') ? buff : "-"; 
+}
+
+//=======================================================================================
@@ -0,0 +1,265 @@
+/**
+ * @file sd_file_test.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief SD card file handle test 
+ * 
+ * @details Host test of the SD card controller file handles on FatFs with a RAM disk. 
+ *          The unit tests replace the SD card controller with a mock so the controller 
+ *          is checked here against FatFs itself. Checks that a file can't be open in two 
+ *          handles when either of them writes to it (FF_FS_LOCK), that it can be open in 
+ *          several handles for reading, that an open file can't be deleted and that 
+ *          every handle in the pool can be open at once. 
+ * 
+ *          Prints each failed check and returns non-zero if any failed. 
+ * 
+ *          Usage: sd_file_test 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sd_controller.h"
+#include "sd_ram_disk.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define TEST_CLUSTER_SIZE 512         // Cluster size (bytes) 
+#define TEST_PROJECT_DIR "MTBDL"      // Project directory 
+#define TEST_FILE "test.txt"          // File opened in more than one handle 
+#define TEST_NAME_LEN 16              // File name buffer size 
+
+#define TEST_MODE_W (FA_CREATE_ALWAYS | FA_WRITE)   // Write mode 
+#define TEST_MODE_R (FA_OPEN_EXISTING | FA_READ)    // Read mode 
+
+// Record a failed check with its line 
+#define TEST_CHECK(check) test_check((check), #check, __LINE__) 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Prototypes 
+
+/**
+ * @brief Record the result of a check 
+ * 
+ * @param pass : check result 
+ * @param check : check text 
+ * @param line : line of the check 
+ */
+static void test_check(
+    int pass, 
+    const char *check, 
+    int line); 
+
+
+/**
+ * @brief Format the RAM disk and mount it through the SD card controller 
+ * 
+ * @return int : 0 if successful 
+ */
+static int test_card_make(void); 
+
+
+/**
+ * @brief A file open for writing can't be opened in another handle 
+ */
+static void test_write_locked(void); 
+
+
+/**
+ * @brief A file can be open in several handles for reading 
+ */
+static void test_read_shared(void); 
+
+
+/**
+ * @brief An open file can't be deleted 
+ */
+static void test_unlink_locked(void); 
+
+
+/**
+ * @brief Every file handle can be open at once 
+ */
+static void test_all_handles(void); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Variables 
+
+static uint32_t test_checks, test_fails; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Test 
+
+int main(void)
+{
+    if (test_card_make())
+    {
+        return 1; 
+    }
+
+    test_write_locked(); 
+    test_read_shared(); 
+    test_unlink_locked(); 
+    test_all_handles(); 
+
+    printf("%u checks, %u failures\n", (unsigned)test_checks, (unsigned)test_fails); 
+
+    return test_fails ? 1 : 0; 
+}
+
+
+// Record the result of a check 
+static void test_check(
+    int pass, 
+    const char *check, 
+    int line)
+{
+    test_checks++; 
+
+    if (!pass)
+    {
+        test_fails++; 
+        fprintf(stderr, "Line %d: %s\n", line, check); 
+    }
+}
+
+
+// Format the RAM disk and mount it through the SD card controller 
+static int test_card_make(void)
+{
+    if (sd_ram_disk_format(TEST_CLUSTER_SIZE) != FR_OK)
+    {
+        fprintf(stderr, "Can't format the RAM disk\n"); 
+        return 1; 
+    }
+
+    // The first pass mounts the volume and makes the project directory 
+    sd_controller_init(TEST_PROJECT_DIR); 
+    sd_controller(); 
+    sd_controller(); 
+
+    if (sd_get_state() != SD_ACCESS_STATE)
+    {
+        fprintf(stderr, "Can't mount the RAM disk\n"); 
+        return 1; 
+    }
+
+    return 0; 
+}
+
+
+// A file open for writing can't be opened in another handle 
+static void test_write_locked(void)
+{
+    SD_HANDLE write_file, other_file; 
+    const char data[] = "data"; 
+    char read_data[sizeof(data)]; 
+
+    TEST_CHECK(sd_file_open(TEST_FILE, TEST_MODE_W, &write_file) == FR_OK); 
+    TEST_CHECK(sd_file_write(write_file, data, sizeof(data)) == FR_OK); 
+
+    // Neither a write nor a read can open it again and no handle is taken 
+    TEST_CHECK(sd_file_open(TEST_FILE, TEST_MODE_W, &other_file) == FR_LOCKED); 
+    TEST_CHECK(other_file == SD_HANDLE_NONE); 
+    TEST_CHECK(sd_file_open(TEST_FILE, TEST_MODE_R, &other_file) == FR_LOCKED); 
+    TEST_CHECK(other_file == SD_HANDLE_NONE); 
+
+    // The default file can't open it either 
+    TEST_CHECK(sd_open(TEST_FILE, TEST_MODE_W) == FR_LOCKED); 
+
+    // The rejected opens didn't empty the file 
+    TEST_CHECK(sd_file_close(write_file) == FR_OK); 
+    TEST_CHECK(sd_file_open(TEST_FILE, TEST_MODE_R, &other_file) == FR_OK); 
+    TEST_CHECK(sd_file_read(other_file, read_data, sizeof(read_data)) == FR_OK); 
+    TEST_CHECK(memcmp(data, read_data, sizeof(data)) == 0); 
+    TEST_CHECK(sd_file_close(other_file) == FR_OK); 
+
+    // It can be opened for writing again once it's closed 
+    TEST_CHECK(sd_file_open(TEST_FILE, TEST_MODE_W, &write_file) == FR_OK); 
+    TEST_CHECK(sd_file_close(write_file) == FR_OK); 
+}
+
+
+// A file can be open in several handles for reading 
+static void test_read_shared(void)
+{
+    SD_HANDLE read_file_1, read_file_2, write_file; 
+
+    TEST_CHECK(sd_file_open(TEST_FILE, TEST_MODE_R, &read_file_1) == FR_OK); 
+    TEST_CHECK(sd_file_open(TEST_FILE, TEST_MODE_R, &read_file_2) == FR_OK); 
+    TEST_CHECK(read_file_1 != read_file_2); 
+
+    // Still no writes while it's open for reading 
+    TEST_CHECK(sd_file_open(TEST_FILE, TEST_MODE_W, &write_file) == FR_LOCKED); 
+
+    TEST_CHECK(sd_file_close(read_file_1) == FR_OK); 
+    TEST_CHECK(sd_file_close(read_file_2) == FR_OK); 
+}
+
+
+// An open file can't be deleted 
+static void test_unlink_locked(void)
+{
+    SD_HANDLE file; 
+
+    TEST_CHECK(sd_file_open(TEST_FILE, TEST_MODE_R, &file) == FR_OK); 
+    TEST_CHECK(sd_unlink(TEST_FILE) == FR_LOCKED); 
+    TEST_CHECK(sd_get_exists(TEST_FILE) == FR_OK); 
+    TEST_CHECK(sd_file_close(file) == FR_OK); 
+
+    TEST_CHECK(sd_unlink(TEST_FILE) == FR_OK); 
+    TEST_CHECK(sd_get_exists(TEST_FILE) == FR_NO_FILE); 
+}
+
+
+// Every file handle can be open at once 
+static void test_all_handles(void)
+{
+    SD_HANDLE files[SD_NUM_FILES]; 
+    TCHAR name[TEST_NAME_LEN]; 
+
+    // The default file plus the rest of the pool 
+    TEST_CHECK(sd_open("file0.txt", TEST_MODE_W) == FR_OK); 
+
+    for (SD_HANDLE i = SD_FILE_DEFAULT + 1; i < SD_NUM_FILES; i++)
+    {
+        snprintf(name, TEST_NAME_LEN, "file%u.txt", (unsigned)i); 
+        TEST_CHECK(sd_file_open(name, TEST_MODE_W, &files[i]) == FR_OK); 
+    }
+
+    TEST_CHECK(sd_file_open("extra.txt", TEST_MODE_W, &files[SD_FILE_DEFAULT]) == 
+               FR_TOO_MANY_OPEN_FILES); 
+
+    for (SD_HANDLE i = SD_FILE_DEFAULT + 1; i < SD_NUM_FILES; i++)
+    {
+        TEST_CHECK(sd_file_close(files[i]) == FR_OK); 
+    }
+
+    TEST_CHECK(sd_close() == FR_OK); 
+}
+
+//=======================================================================================
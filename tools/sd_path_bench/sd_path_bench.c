@@ -0,0 +1,314 @@
+/**
+ * @file sd_path_bench.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief SD card file open benchmark 
+ * 
+ * @details Host tool that compares opening files by their full path from the volume 
+ *          root (how sd_open worked before the set directory was cached) against 
+ *          opening them through the SD card controller with the set directory resolved 
+ *          once (sd_set_dir + sd_open). Both use FatFs on a RAM disk formatted FAT32 with 
+ *          the same layout as the data logger card: the project directory with the data, 
+ *          parameter and fault directories and a data directory holding a season of ride 
+ *          logs. 
+ * 
+ *          Each method opens and closes the ride logs in turn. The sectors read from the 
+ *          disk per open are what matter on the target since each one is a 512 byte SPI 
+ *          transfer from the card. Time is reported in CPU timestamp counter cycles on 
+ *          x86 hosts and nanoseconds otherwise, and only shows the relative cost of the 
+ *          two methods. 
+ * 
+ *          Usage: sd_path_bench [opens] 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "sd_controller.h"
+#include "sd_ram_disk.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define BENCH_OPENS 10000             // Default number of opens per method 
+#define BENCH_CLUSTER_SIZE 512        // Cluster size (bytes) 
+#define BENCH_FILES 200               // Ride logs in the data directory 
+#define BENCH_FILE_LEN 2048           // Ride log size (bytes) 
+#define BENCH_NAME_LEN 16             // Ride log name buffer size 
+
+#define BENCH_PROJECT_DIR "MTBDL"     // Project directory 
+#define BENCH_DATA_DIR "data"         // Ride log directory 
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BENCH_UNIT "cycles" 
+#else
+#define BENCH_UNIT "ns" 
+#endif
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// Results of one method 
+typedef struct bench_result_s
+{
+    double time;                                // Average time per open 
+    double reads;                               // Average sectors read per open 
+    uint32_t fails;                             // Opens that failed 
+}
+bench_result_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Prototypes 
+
+/**
+ * @brief Read the time counter 
+ * 
+ * @return uint64_t : timestamp counter (x86) or monotonic time in ns 
+ */
+static uint64_t bench_time(void); 
+
+
+/**
+ * @brief Format the RAM disk and make the card layout through the SD card controller 
+ * 
+ * @return int : 0 if successful 
+ */
+static int bench_card_make(void); 
+
+
+/**
+ * @brief Open and close the ride logs by their full path 
+ * 
+ * @param opens : number of opens 
+ * @param result : results 
+ */
+static void bench_full_path(
+    uint32_t opens, 
+    bench_result_t *result); 
+
+
+/**
+ * @brief Open and close the ride logs through the SD card controller 
+ * 
+ * @param opens : number of opens 
+ * @param result : results 
+ */
+static void bench_controller(
+    uint32_t opens, 
+    bench_result_t *result); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Variables 
+
+// Ride log names 
+static TCHAR bench_names[BENCH_FILES][BENCH_NAME_LEN]; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Benchmark 
+
+int main(
+    int argc, 
+    char *argv[])
+{
+    uint32_t opens = BENCH_OPENS; 
+    bench_result_t full, cached; 
+
+    if (argc > 2)
+    {
+        fprintf(stderr, "Usage: %s [opens]\n", argv[0]); 
+        return 1; 
+    }
+
+    if (argc == 2)
+    {
+        opens = (uint32_t)strtoul(argv[1], NULL, 10); 
+    }
+
+    if (bench_card_make())
+    {
+        return 1; 
+    }
+
+    bench_full_path(opens, &full); 
+    bench_controller(opens, &cached); 
+
+    if (full.fails || cached.fails)
+    {
+        fprintf(stderr, "Failed opens: full path %u, controller %u\n", 
+                (unsigned)full.fails, (unsigned)cached.fails); 
+        return 1; 
+    }
+
+    printf("%u opens of %u ride logs in /%s/%s, %s per open\n\n", 
+           (unsigned)opens, (unsigned)BENCH_FILES, BENCH_PROJECT_DIR, BENCH_DATA_DIR, 
+           BENCH_UNIT); 
+    printf("%-24s %12s %14s\n", "method", "time", "sector reads"); 
+    printf("%-24s %12.1f %14.2f\n", "full path", full.time, full.reads); 
+    printf("%-24s %12.1f %14.2f\n", "cached directory", cached.time, cached.reads); 
+    printf("\nSpeedup: %.1fx time, %.1fx sector reads\n", 
+           (cached.time > 0.0) ? (full.time / cached.time) : 0.0, 
+           (cached.reads > 0.0) ? (full.reads / cached.reads) : 0.0); 
+
+    return 0; 
+}
+
+
+// Read the time counter 
+static uint64_t bench_time(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc(); 
+#else
+    struct timespec ts; 
+    clock_gettime(CLOCK_MONOTONIC, &ts); 
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec; 
+#endif
+}
+
+
+// Format the RAM disk and make the card layout through the SD card controller 
+static int bench_card_make(void)
+{
+    uint8_t log_data[BENCH_FILE_LEN]; 
+
+    if (sd_ram_disk_format(BENCH_CLUSTER_SIZE) != FR_OK)
+    {
+        fprintf(stderr, "Can't format the RAM disk\n"); 
+        return 1; 
+    }
+
+    // The first pass mounts the volume and makes the project directory 
+    sd_controller_init(BENCH_PROJECT_DIR); 
+    sd_controller(); 
+    sd_controller(); 
+
+    if (sd_get_state() != SD_ACCESS_STATE)
+    {
+        fprintf(stderr, "Can't mount the RAM disk\n"); 
+        return 1; 
+    }
+
+    sd_mkdir("params"); 
+    sd_mkdir("faults"); 
+    sd_mkdir(BENCH_DATA_DIR); 
+    memset((void *)log_data, 'x', sizeof(log_data)); 
+
+    for (uint16_t i = 0; i < BENCH_FILES; i++)
+    {
+        snprintf(bench_names[i], BENCH_NAME_LEN, "log%u.txt", (unsigned)i); 
+
+        if ((sd_open(bench_names[i], FA_CREATE_NEW | FA_WRITE) != FR_OK) || 
+            (sd_f_write((void *)log_data, sizeof(log_data)) != FR_OK) || 
+            (sd_close() != FR_OK))
+        {
+            fprintf(stderr, "Can't write %s\n", bench_names[i]); 
+            return 1; 
+        }
+    }
+
+    return 0; 
+}
+
+
+// Open and close the ride logs by their full path 
+static void bench_full_path(
+    uint32_t opens, 
+    bench_result_t *result)
+{
+    TCHAR file_dir[SD_PATH_SIZE*3]; 
+    FIL file; 
+
+    memset((void *)result, 0, sizeof(bench_result_t)); 
+
+    // Paths from the root like sd_open built before the directory was cached 
+    f_chdir("/"); 
+    sd_ram_disk_clear_reads(); 
+    uint64_t start = bench_time(); 
+
+    for (uint32_t i = 0; i < opens; i++)
+    {
+        strcpy(file_dir, BENCH_PROJECT_DIR); 
+        strcat(file_dir, "/"); 
+        strcat(file_dir, BENCH_DATA_DIR); 
+        strcat(file_dir, "/"); 
+        strcat(file_dir, bench_names[i % BENCH_FILES]); 
+
+        if (f_open(&file, file_dir, FA_READ) == FR_OK)
+        {
+            f_close(&file); 
+        }
+        else 
+        {
+            result->fails++; 
+        }
+    }
+
+    result->time = (double)(bench_time() - start) / opens; 
+    result->reads = (double)sd_ram_disk_get_reads() / opens; 
+}
+
+
+// Open and close the ride logs through the SD card controller 
+static void bench_controller(
+    uint32_t opens, 
+    bench_result_t *result)
+{
+    memset((void *)result, 0, sizeof(bench_result_t)); 
+
+    // Another directory first so the data directory is resolved in the timed loop 
+    sd_set_dir("params"); 
+    sd_get_exists("none"); 
+    sd_ram_disk_clear_reads(); 
+    uint64_t start = bench_time(); 
+
+    for (uint32_t i = 0; i < opens; i++)
+    {
+        sd_set_dir(BENCH_DATA_DIR); 
+
+        if (sd_open(bench_names[i % BENCH_FILES], FA_READ) == FR_OK)
+        {
+            sd_close(); 
+        }
+        else 
+        {
+            result->fails++; 
+        }
+    }
+
+    result->time = (double)(bench_time() - start) / opens; 
+    result->reads = (double)sd_ram_disk_get_reads() / opens; 
+}
+
+//=======================================================================================
@@ -0,0 +1,38 @@
+/**
+ * @file sd_driver.h
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief SD card driver interface for the host RAM disk 
+ * 
+ * @details Stands in for the driver library SD card driver so the SD card controller 
+ *          can run on FatFs with a RAM disk. Only what the controller uses is here. The 
+ *          host tools include this directory ahead of the driver library. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _SD_DRIVER_H_ 
+#define _SD_DRIVER_H_ 
+
+//=======================================================================================
+// Includes 
+
+#include "tools.h"
+#include "ff.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define SD_MOUNT_NOW 1              // Mount the volume right away (f_mount opt) 
+
+//=======================================================================================
+
+#endif   // _SD_DRIVER_H_ 
@@ -0,0 +1,167 @@
+/**
+ * @file sd_ram_disk.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief SD card RAM disk for host tools 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include <string.h>
+
+#include "sd_ram_disk.h"
+#include "diskio.h"
+#include "tools.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Variables 
+
+static BYTE sd_ram_disk[SD_RAM_DISK_SECTORS][FF_MIN_SS]; 
+static uint32_t sd_ram_disk_reads; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// RAM disk 
+
+// Format the RAM disk FAT32 
+FRESULT sd_ram_disk_format(UINT cluster_size)
+{
+    static BYTE work[FF_MAX_SS]; 
+    const MKFS_PARM opt = { FM_FAT32, 0, 0, 0, cluster_size }; 
+
+    return f_mkfs("", &opt, work, sizeof(work)); 
+}
+
+
+// Get the number of sectors read since the count was cleared 
+uint32_t sd_ram_disk_get_reads(void)
+{
+    return sd_ram_disk_reads; 
+}
+
+
+// Clear the sector read count 
+void sd_ram_disk_clear_reads(void)
+{
+    sd_ram_disk_reads = 0; 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// FatFs disk I/O 
+
+// Disk status 
+DSTATUS disk_status(BYTE pdrv)
+{
+    return pdrv ? STA_NOINIT : 0; 
+}
+
+
+// Disk init 
+DSTATUS disk_initialize(BYTE pdrv)
+{
+    return pdrv ? STA_NOINIT : 0; 
+}
+
+
+// Disk read 
+DRESULT disk_read(
+    BYTE pdrv, 
+    BYTE *buff, 
+    LBA_t sector, 
+    UINT count)
+{
+    if (pdrv || ((sector + count) > SD_RAM_DISK_SECTORS))
+    {
+        return RES_PARERR; 
+    }
+
+    memcpy((void *)buff, (void *)sd_ram_disk[sector], count * FF_MIN_SS); 
+    sd_ram_disk_reads += count; 
+
+    return RES_OK; 
+}
+
+
+// Disk write 
+DRESULT disk_write(
+    BYTE pdrv, 
+    const BYTE *buff, 
+    LBA_t sector, 
+    UINT count)
+{
+    if (pdrv || ((sector + count) > SD_RAM_DISK_SECTORS))
+    {
+        return RES_PARERR; 
+    }
+
+    memcpy((void *)sd_ram_disk[sector], (void *)buff, count * FF_MIN_SS); 
+
+    return RES_OK; 
+}
+
+
+// Disk control 
+DRESULT disk_ioctl(
+    BYTE pdrv, 
+    BYTE cmd, 
+    void *buff)
+{
+    if (pdrv)
+    {
+        return RES_PARERR; 
+    }
+
+    switch (cmd)
+    {
+        case CTRL_SYNC: 
+            return RES_OK; 
+
+        case GET_SECTOR_COUNT: 
+            *(LBA_t *)buff = SD_RAM_DISK_SECTORS; 
+            return RES_OK; 
+
+        case GET_BLOCK_SIZE: 
+            *(DWORD *)buff = 1; 
+            return RES_OK; 
+
+        default: 
+            return RES_PARERR; 
+    }
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// SD card disk I/O 
+
+// The RAM disk is always there 
+uint8_t sd_spi_present(void)
+{
+    return TRUE; 
+}
+
+
+// The RAM disk is always ready 
+uint8_t sd_spi_ready(void)
+{
+    return TRUE; 
+}
+
+//=======================================================================================
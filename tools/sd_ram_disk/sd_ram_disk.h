@@ -0,0 +1,66 @@
+/**
+ * @file sd_ram_disk.h
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief SD card RAM disk for host tools 
+ * 
+ * @details FatFs disk I/O functions on a RAM disk plus the SD card presence and ready 
+ *          checks the SD card controller uses, so the controller and FatFs can run on a 
+ *          host. Sector reads are counted since each one is a 512 byte SPI transfer from 
+ *          the card on the target. 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef _SD_RAM_DISK_H_ 
+#define _SD_RAM_DISK_H_ 
+
+//=======================================================================================
+// Includes 
+
+#include "ff.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define SD_RAM_DISK_SECTORS 131072     // RAM disk size (64MB - FAT32 with 512 byte clusters) 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Functions 
+
+/**
+ * @brief Format the RAM disk FAT32 
+ * 
+ * @param cluster_size : cluster size (bytes) 
+ * @return FRESULT : FATFS file function return code 
+ */
+FRESULT sd_ram_disk_format(UINT cluster_size); 
+
+
+/**
+ * @brief Get the number of sectors read since the count was cleared 
+ * 
+ * @return uint32_t : sectors read 
+ */
+uint32_t sd_ram_disk_get_reads(void); 
+
+
+/**
+ * @brief Clear the sector read count 
+ */
+void sd_ram_disk_clear_reads(void); 
+
+//=======================================================================================
+
+#endif   // _SD_RAM_DISK_H_ 
@@ -0,0 +1,766 @@
+/**
+ * @file sd_spi_sim.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief SD card SPI disk I/O simulator 
+ * 
+ * @details Host tool that runs the SD card SPI disk I/O (sd_spi.c) against a simulated 
+ *          SD card and measures sustained write throughput. The disk I/O port functions 
+ *          are replaced here. Each byte sent goes to a byte level model of a high 
+ *          capacity card in SPI mode (commands, responses, data tokens, data responses 
+ *          and busy) and moves a simulated clock forward by its SPI transfer time. 
+ *          Bytes sent one at a time by the CPU add a gap for the register polling. DMA 
+ *          blocks go back to back after a setup time. 
+ * 
+ *          After each block it accepts the card is busy for a program time: longer for 
+ *          a single block write than for a block in a multi-block write. Ending a 
+ *          multi-block write also makes the card busy. The card times are typical 
+ *          figures, not a particular card, so the results show what the SPI clock, 
+ *          DMA and command pattern cost rather than what a given card will do. 
+ * 
+ *          Each run writes data the way a log file is written. The SD card controller 
+ *          write buffer (SD_BUFF_SECTORS) is flushed to consecutive sectors, then the 
+ *          data is synced, read back and checked. The runs are: 
+ *            - 5.25MHz (the old SPI clock) byte loop, one single block write per sector 
+ *            - 5.25MHz byte loop, one multi-block write per flush 
+ *            - 21MHz DMA, one multi-block write per flush 
+ *            - 21MHz DMA, one multi-block write across flushes (sd_spi) 
+ * 
+ *          The time of each flush is what the logging sees. A gap (us) can be left 
+ *          between flushes for the time spent logging. The card programs the last block 
+ *          in the gap when the write is kept open. 
+ * 
+ *          Usage: sd_spi_sim [MB] [gap_us] 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sd_spi.h"
+#include "sd_controller.h"
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+// Simulated card 
+#define SIM_CARD_BLOCKS 131072           // Card size (64MB) 
+#define SIM_START_SECTOR 8192            // First sector written (after the FAT area) 
+#define SIM_T_INIT_US 20000              // Time to leave the idle state (ACMD41) 
+#define SIM_T_SINGLE_US 1000             // Program time of a single block write 
+#define SIM_T_MULTI_US 60                // Program time of a block in a multi-block write 
+#define SIM_T_STOP_US 400                // Busy time after a multi-block write ends 
+#define SIM_READ_WAIT 8                  // Bytes before a read data token 
+#define SIM_BLOCK_SIZE 512               // Block size (bytes) 
+#define SIM_CRC_SIZE 2                   // Data block CRC size (bytes) 
+#define SIM_CSD_SIZE 16                  // CSD register size (bytes) 
+#define SIM_OUT_SIZE 600                 // Card output queue size (bytes) 
+
+// Simulated host 
+#define SIM_INIT_HZ 328125               // Card init SPI clock (42MHz / 128) 
+#define SIM_BYTE_GAP_NS 400              // CPU time between bytes sent one at a time 
+#define SIM_DMA_SETUP_NS 2000            // DMA stream setup time per block 
+
+// Runs 
+#define SIM_MB 8                         // Default data written per run (MB) 
+#define SIM_FLUSH_SECTORS SD_BUFF_SECTORS 
+#define SIM_FILL 0xFF                    // Bus idle 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Structures 
+
+// Run settings 
+typedef struct sim_run_s
+{
+    const char *name;                           // Run description 
+    uint32_t hz;                                // SPI clock after card init 
+    uint8_t dma;                                // DMA data blocks 
+    uint8_t sectors_per_call;                   // Sectors per disk_write call 
+    uint8_t keep_open;                          // Multi-block write left open 
+}
+sim_run_t; 
+
+
+// Simulated card 
+typedef struct sim_card_s
+{
+    uint8_t *mem;                               // Card data 
+    uint8_t selected;                           // Slave select low 
+    uint8_t idle;                               // In the idle state 
+    uint8_t app;                                // Last command was CMD55 
+    uint64_t init_done;                         // (ns) Time the card leaves idle 
+    uint64_t busy_until;                        // (ns) Time the card is done programming 
+    uint64_t busy_after;                        // (ns) Busy time once the output is sent 
+
+    // Command in 
+    uint8_t cmd[6];                             // Command frame 
+    uint8_t cmd_len;                            // Command bytes received 
+
+    // Output queue 
+    uint8_t out[SIM_OUT_SIZE];                  // Bytes to send 
+    uint16_t out_len;                           // Bytes queued 
+    uint16_t out_pos;                           // Bytes sent 
+
+    // Data transfers 
+    uint8_t read_multi;                         // Multi-block read running 
+    uint8_t write_single;                       // Single block write waiting for data 
+    uint8_t write_multi;                        // Multi-block write running 
+    uint32_t block;                             // Next block to read or write 
+    uint8_t rx[SIM_BLOCK_SIZE + SIM_CRC_SIZE];  // Block being received 
+    uint16_t rx_len;                            // Block bytes expected (0 = none) 
+    uint16_t rx_pos;                            // Block bytes received 
+    uint32_t pre_erase;                         // Last pre-erase count (ACMD23) 
+    uint32_t pre_erases;                        // Pre-erase commands 
+}
+sim_card_t; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Prototypes 
+
+/**
+ * @brief Run a write throughput test 
+ * 
+ * @param run : run settings 
+ * @param mb : data to write (MB) 
+ * @param gap_us : time between flushes (us) 
+ * @return int : 0 if the data was written and read back 
+ */
+static int sim_run(
+    const sim_run_t *run, 
+    uint32_t mb, 
+    uint32_t gap_us); 
+
+
+/**
+ * @brief Fill a sector with its test data 
+ * 
+ * @param buff : sector buffer 
+ * @param sector : sector number 
+ */
+static void sim_pattern(
+    uint8_t *buff, 
+    LBA_t sector); 
+
+
+/**
+ * @brief Exchange a byte with the simulated card 
+ * 
+ * @param mosi : byte from the host 
+ * @return uint8_t : byte from the card 
+ */
+static uint8_t sim_card_xchg(uint8_t mosi); 
+
+
+/**
+ * @brief Run the command received by the simulated card 
+ */
+static void sim_card_cmd(void); 
+
+
+/**
+ * @brief Queue a data block (token, data, CRC) in the card output 
+ * 
+ * @param data : block data 
+ * @param len : block size 
+ */
+static void sim_card_queue_block(
+    const uint8_t *data, 
+    uint16_t len); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Variables 
+
+// Simulated host 
+static struct sim_host_s
+{
+    uint64_t now;                               // (ns) Simulated time 
+    uint32_t hz;                                // SPI clock 
+    const sim_run_t *run;                       // Run settings 
+}
+sim; 
+
+// Simulated card 
+static sim_card_t card; 
+
+// Test runs 
+static const sim_run_t sim_runs[] = 
+{
+    { "5.25MHz byte loop, single block",      5250000, FALSE, 1, FALSE }, 
+    { "5.25MHz byte loop, multi-block/flush", 5250000, FALSE, SIM_FLUSH_SECTORS, FALSE }, 
+    { "21MHz DMA, multi-block/flush",         21000000, TRUE, SIM_FLUSH_SECTORS, FALSE }, 
+    { "21MHz DMA, open multi-block (sd_spi)", 21000000, TRUE, SIM_FLUSH_SECTORS, TRUE }
+}; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Simulator 
+
+// Ends the open multi-block write - internal to sd_spi.c. Used to end the write after 
+// each call the way a disk I/O without an open write would. 
+void sd_spi_stream_stop(void); 
+
+
+int main(
+    int argc, 
+    char *argv[])
+{
+    uint32_t mb = SIM_MB, gap_us = CLEAR; 
+
+    if (argc > 3)
+    {
+        fprintf(stderr, "Usage: %s [MB] [gap_us]\n", argv[0]); 
+        return 1; 
+    }
+
+    if (argc > 1)
+    {
+        mb = (uint32_t)strtoul(argv[1], NULL, 10); 
+    }
+
+    if (argc > 2)
+    {
+        gap_us = (uint32_t)strtoul(argv[2], NULL, 10); 
+    }
+
+    if (!mb || (((mb << 20) / SIM_BLOCK_SIZE) > (SIM_CARD_BLOCKS - SIM_START_SECTOR)))
+    {
+        fprintf(stderr, "Data size must be 1-%u MB\n", 
+                (unsigned)(((SIM_CARD_BLOCKS - SIM_START_SECTOR) * SIM_BLOCK_SIZE) >> 20)); 
+        return 1; 
+    }
+
+    card.mem = calloc(SIM_CARD_BLOCKS, SIM_BLOCK_SIZE); 
+
+    if (card.mem == NULL)
+    {
+        return 1; 
+    }
+
+    printf("%u MB per run in %u sector flushes, %u us between flushes\n\n", 
+           (unsigned)mb, (unsigned)SIM_FLUSH_SECTORS, (unsigned)gap_us); 
+    printf("%-38s %8s %10s %10s %9s\n", 
+           "run", "MB/s", "flush avg", "flush max", "cmds/MB"); 
+
+    for (uint8_t i = CLEAR; i < (sizeof(sim_runs) / sizeof(sim_runs[0])); i++)
+    {
+        if (sim_run(&sim_runs[i], mb, gap_us))
+        {
+            free(card.mem); 
+            return 1; 
+        }
+    }
+
+    printf("\nFlush times in us. Card: single block %u us, multi-block %u us/block, "
+           "end %u us.\n", (unsigned)SIM_T_SINGLE_US, (unsigned)SIM_T_MULTI_US, 
+           (unsigned)SIM_T_STOP_US); 
+
+    free(card.mem); 
+
+    return 0; 
+}
+
+
+// Run a write throughput test 
+static int sim_run(
+    const sim_run_t *run, 
+    uint32_t mb, 
+    uint32_t gap_us)
+{
+    static uint8_t buff[SIM_FLUSH_SECTORS * SIM_BLOCK_SIZE]; 
+    uint32_t sectors = (mb << 20) / SIM_BLOCK_SIZE, flushes = CLEAR, cmds; 
+    uint64_t start, flush_start, flush_time, flush_total = CLEAR, flush_max = CLEAR; 
+    LBA_t card_sectors = CLEAR; 
+
+    sim.run = run; 
+
+    if ((disk_initialize(CLEAR) & STA_NOINIT) || 
+        (disk_ioctl(CLEAR, GET_SECTOR_COUNT, &card_sectors) != RES_OK) || 
+        (card_sectors != SIM_CARD_BLOCKS))
+    {
+        fprintf(stderr, "%s: card init failed\n", run->name); 
+        return 1; 
+    }
+
+    cmds = sd_spi_get_stats()->cmds; 
+    start = sim.now; 
+
+    for (LBA_t sector = SIM_START_SECTOR; sector < (SIM_START_SECTOR + sectors); 
+         sector += SIM_FLUSH_SECTORS)
+    {
+        for (uint8_t i = CLEAR; i < SIM_FLUSH_SECTORS; i++)
+        {
+            sim_pattern(&buff[i * SIM_BLOCK_SIZE], sector + i); 
+        }
+
+        flush_start = sim.now; 
+
+        for (uint8_t i = CLEAR; i < SIM_FLUSH_SECTORS; i += run->sectors_per_call)
+        {
+            if (disk_write(CLEAR, &buff[i * SIM_BLOCK_SIZE], sector + i, 
+                           run->sectors_per_call) != RES_OK)
+            {
+                fprintf(stderr, "%s: write failed at sector %u\n", 
+                        run->name, (unsigned)(sector + i)); 
+                return 1; 
+            }
+
+            if (!run->keep_open)
+            {
+                sd_spi_stream_stop(); 
+            }
+        }
+
+        flush_time = sim.now - flush_start; 
+        flush_total += flush_time; 
+        flush_max = (flush_time > flush_max) ? flush_time : flush_max; 
+        flushes++; 
+
+        sim.now += (uint64_t)gap_us * 1000; 
+    }
+
+    disk_ioctl(CLEAR, CTRL_SYNC, NULL); 
+
+    // Throughput leaves out the time between flushes 
+    double seconds = (double)(sim.now - start - ((uint64_t)gap_us * 1000 * flushes)) / 1e9; 
+    cmds = sd_spi_get_stats()->cmds - cmds; 
+
+    for (LBA_t sector = SIM_START_SECTOR; sector < (SIM_START_SECTOR + sectors); 
+         sector += SIM_FLUSH_SECTORS)
+    {
+        static uint8_t check[SIM_BLOCK_SIZE]; 
+
+        if (disk_read(CLEAR, buff, sector, SIM_FLUSH_SECTORS) != RES_OK)
+        {
+            fprintf(stderr, "%s: read failed at sector %u\n", 
+                    run->name, (unsigned)sector); 
+            return 1; 
+        }
+
+        for (uint8_t i = CLEAR; i < SIM_FLUSH_SECTORS; i++)
+        {
+            sim_pattern(check, sector + i); 
+
+            if (memcmp(check, &buff[i * SIM_BLOCK_SIZE], SIM_BLOCK_SIZE))
+            {
+                fprintf(stderr, "%s: data mismatch at sector %u\n", 
+                        run->name, (unsigned)(sector + i)); 
+                return 1; 
+            }
+        }
+    }
+
+    printf("%-38s %8.2f %10.1f %10.1f %9.1f\n", 
+           run->name, 
+           (double)mb / seconds, 
+           (double)flush_total / flushes / 1000.0, 
+           (double)flush_max / 1000.0, 
+           (double)cmds / mb); 
+
+    return 0; 
+}
+
+
+// Fill a sector with its test data 
+static void sim_pattern(
+    uint8_t *buff, 
+    LBA_t sector)
+{
+    for (uint16_t i = CLEAR; i < SIM_BLOCK_SIZE; i++)
+    {
+        buff[i] = (uint8_t)((sector * 31) + (i * 7) + (i >> 8)); 
+    }
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Port functions 
+
+// Select the card 
+void sd_spi_port_select(void)
+{
+    card.selected = TRUE; 
+    card.cmd_len = CLEAR; 
+}
+
+
+// Deselect the card 
+void sd_spi_port_deselect(void)
+{
+    card.selected = FALSE; 
+    card.cmd_len = CLEAR; 
+
+    // Output not read is dropped but the card still goes busy 
+    if (card.busy_after)
+    {
+        card.busy_until = sim.now + card.busy_after; 
+        card.busy_after = CLEAR; 
+    }
+
+    card.out_len = card.out_pos = CLEAR; 
+}
+
+
+// Send a byte and return the byte received at the same time 
+uint8_t sd_spi_port_xchg(uint8_t data)
+{
+    sim.now += (8000000000ULL / sim.hz) + SIM_BYTE_GAP_NS; 
+
+    return sim_card_xchg(data); 
+}
+
+
+// Send and receive a block of data 
+void sd_spi_port_block(
+    const uint8_t *tx, 
+    uint8_t *rx, 
+    uint16_t len)
+{
+    uint8_t miso; 
+
+    if (!sim.run->dma)
+    {
+        for (uint16_t i = CLEAR; i < len; i++)
+        {
+            miso = sd_spi_port_xchg((tx != NULL) ? tx[i] : SIM_FILL); 
+
+            if (rx != NULL)
+            {
+                rx[i] = miso; 
+            }
+        }
+
+        return; 
+    }
+
+    sim.now += SIM_DMA_SETUP_NS; 
+
+    for (uint16_t i = CLEAR; i < len; i++)
+    {
+        sim.now += 8000000000ULL / sim.hz; 
+        miso = sim_card_xchg((tx != NULL) ? tx[i] : SIM_FILL); 
+
+        if (rx != NULL)
+        {
+            rx[i] = miso; 
+        }
+    }
+}
+
+
+// Set the SPI clock speed 
+void sd_spi_port_speed(uint8_t speed)
+{
+    sim.hz = (speed == SD_SPI_FAST) ? sim.run->hz : SIM_INIT_HZ; 
+}
+
+
+// Get the time 
+uint32_t sd_spi_port_time(void)
+{
+    return (uint32_t)(sim.now / 1000); 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Simulated card 
+
+// Exchange a byte with the simulated card 
+static uint8_t sim_card_xchg(uint8_t mosi)
+{
+    uint8_t miso = SIM_FILL; 
+    uint8_t *dest; 
+
+    if (!card.selected)
+    {
+        return SIM_FILL; 
+    }
+
+    // Output held low while programming - the host only waits 
+    if (sim.now < card.busy_until)
+    {
+        return 0x00; 
+    }
+
+    if (card.out_pos < card.out_len)
+    {
+        miso = card.out[card.out_pos++]; 
+
+        if (card.out_pos == card.out_len)
+        {
+            card.out_len = card.out_pos = CLEAR; 
+
+            if (card.busy_after)
+            {
+                card.busy_until = sim.now + card.busy_after; 
+                card.busy_after = CLEAR; 
+            }
+            else if (card.read_multi && (card.block < SIM_CARD_BLOCKS))
+            {
+                sim_card_queue_block(&card.mem[card.block++ * SIM_BLOCK_SIZE], 
+                                     SIM_BLOCK_SIZE); 
+            }
+        }
+    }
+
+    // Write data block 
+    if (card.rx_len)
+    {
+        card.rx[card.rx_pos++] = mosi; 
+
+        if (card.rx_pos == card.rx_len)
+        {
+            card.rx_len = CLEAR; 
+
+            if (card.block >= SIM_CARD_BLOCKS)
+            {
+                card.out[card.out_len++] = 0xED;  // Write error 
+                return miso; 
+            }
+
+            dest = &card.mem[card.block++ * SIM_BLOCK_SIZE]; 
+            memcpy(dest, card.rx, SIM_BLOCK_SIZE); 
+
+            card.out[card.out_len++] = 0xE5;      // Data accepted 
+            card.busy_after = (card.write_single ? 
+                               SIM_T_SINGLE_US : SIM_T_MULTI_US) * 1000ULL; 
+            card.write_single = FALSE; 
+        }
+
+        return miso; 
+    }
+
+    // Write data tokens 
+    if ((card.write_single && (mosi == 0xFE)) || (card.write_multi && (mosi == 0xFC)))
+    {
+        card.rx_len = SIM_BLOCK_SIZE + SIM_CRC_SIZE; 
+        card.rx_pos = CLEAR; 
+        return miso; 
+    }
+
+    if (card.write_multi && (mosi == 0xFD))
+    {
+        card.write_multi = FALSE; 
+        card.busy_after = SIM_T_STOP_US * 1000ULL; 
+        card.out[card.out_len++] = SIM_FILL; 
+        return miso; 
+    }
+
+    // Commands 
+    if (card.cmd_len || ((mosi & 0xC0) == 0x40))
+    {
+        card.cmd[card.cmd_len++] = mosi; 
+
+        if (card.cmd_len == sizeof(card.cmd))
+        {
+            card.cmd_len = CLEAR; 
+            sim_card_cmd(); 
+        }
+    }
+
+    return miso; 
+}
+
+
+// Run the command received by the simulated card 
+static void sim_card_cmd(void)
+{
+    uint8_t index = card.cmd[0] & 0x3F, app = card.app, r1; 
+    uint32_t arg = ((uint32_t)card.cmd[1] << 24) | ((uint32_t)card.cmd[2] << 16) |
+                   ((uint32_t)card.cmd[3] << 8) | card.cmd[4]; 
+    uint8_t data[64]; 
+
+    card.app = FALSE; 
+    card.out_len = card.out_pos = CLEAR; 
+    card.out[card.out_len++] = SIM_FILL;          // One byte before the response 
+
+    // A stuff byte follows CMD12 and the data stops 
+    if (index == 12)
+    {
+        card.read_multi = FALSE; 
+        card.out[card.out_len++] = SIM_FILL; 
+    }
+
+    r1 = card.idle ? 0x01 : 0x00; 
+
+    if (app)
+    {
+        switch (index)
+        {
+            case 41: 
+                if (!card.init_done)
+                {
+                    card.init_done = sim.now + (SIM_T_INIT_US * 1000ULL); 
+                }
+
+                if (sim.now >= card.init_done)
+                {
+                    card.idle = FALSE; 
+                }
+
+                card.out[card.out_len++] = card.idle ? 0x01 : 0x00; 
+                return; 
+
+            case 23: 
+                card.pre_erase = arg; 
+                card.pre_erases++; 
+                card.out[card.out_len++] = r1; 
+                return; 
+
+            case 13: 
+                memset(data, CLEAR, sizeof(data)); 
+                data[10] = 0x90;                  // 4MB allocation unit 
+                card.out[card.out_len++] = r1; 
+                card.out[card.out_len++] = 0x00; 
+                sim_card_queue_block(data, sizeof(data)); 
+                return; 
+
+            default: 
+                card.out[card.out_len++] = r1 | 0x04; 
+                return; 
+        }
+    }
+
+    if (card.idle && (index != 0) && (index != 8) && (index != 55) && (index != 58))
+    {
+        card.out[card.out_len++] = r1 | 0x04; 
+        return; 
+    }
+
+    if (((index == 17) || (index == 18) || (index == 24) || (index == 25)) && 
+        (arg >= SIM_CARD_BLOCKS))
+    {
+        card.out[card.out_len++] = r1 | 0x20;    // Address error 
+        return; 
+    }
+
+    switch (index)
+    {
+        case 0: 
+            card.idle = TRUE; 
+            card.init_done = CLEAR; 
+            card.read_multi = card.write_single = card.write_multi = FALSE; 
+            card.rx_len = CLEAR; 
+            card.out[card.out_len++] = 0x01; 
+            break; 
+
+        case 8: 
+            card.out[card.out_len++] = r1; 
+            card.out[card.out_len++] = 0x00; 
+            card.out[card.out_len++] = 0x00; 
+            card.out[card.out_len++] = card.cmd[3]; 
+            card.out[card.out_len++] = card.cmd[4]; 
+            break; 
+
+        case 9: 
+            // CSD v2 - (C_SIZE + 1) * 1024 blocks 
+            memset(data, CLEAR, SIM_CSD_SIZE); 
+            data[0] = 0x40; 
+            data[7] = (uint8_t)(((SIM_CARD_BLOCKS >> 10) - 1) >> 16) & 0x3F; 
+            data[8] = (uint8_t)(((SIM_CARD_BLOCKS >> 10) - 1) >> 8); 
+            data[9] = (uint8_t)((SIM_CARD_BLOCKS >> 10) - 1); 
+            card.out[card.out_len++] = r1; 
+            sim_card_queue_block(data, SIM_CSD_SIZE); 
+            break; 
+
+        case 12: 
+        case 16: 
+            card.out[card.out_len++] = r1; 
+            break; 
+
+        case 13: 
+            card.out[card.out_len++] = r1; 
+            card.out[card.out_len++] = 0x00; 
+            break; 
+
+        case 17: 
+            card.out[card.out_len++] = r1; 
+            sim_card_queue_block(&card.mem[arg * SIM_BLOCK_SIZE], SIM_BLOCK_SIZE); 
+            break; 
+
+        case 18: 
+            card.out[card.out_len++] = r1; 
+            card.block = arg; 
+            card.read_multi = TRUE; 
+            sim_card_queue_block(&card.mem[card.block++ * SIM_BLOCK_SIZE], 
+                                 SIM_BLOCK_SIZE); 
+            break; 
+
+        case 24: 
+            card.out[card.out_len++] = r1; 
+            card.block = arg; 
+            card.write_single = TRUE; 
+            break; 
+
+        case 25: 
+            card.out[card.out_len++] = r1; 
+            card.block = arg; 
+            card.write_multi = TRUE; 
+            break; 
+
+        case 55: 
+            card.app = TRUE; 
+            card.out[card.out_len++] = r1; 
+            break; 
+
+        case 58: 
+            // Powered up, high capacity 
+            card.out[card.out_len++] = r1; 
+            card.out[card.out_len++] = 0xC0; 
+            card.out[card.out_len++] = 0xFF; 
+            card.out[card.out_len++] = 0x80; 
+            card.out[card.out_len++] = 0x00; 
+            break; 
+
+        default: 
+            card.out[card.out_len++] = r1 | 0x04; 
+            break; 
+    }
+}
+
+
+// Queue a data block (token, data, CRC) in the card output 
+static void sim_card_queue_block(
+    const uint8_t *data, 
+    uint16_t len)
+{
+    for (uint8_t i = CLEAR; i < SIM_READ_WAIT; i++)
+    {
+        card.out[card.out_len++] = SIM_FILL; 
+    }
+
+    card.out[card.out_len++] = 0xFE; 
+    memcpy(&card.out[card.out_len], data, len); 
+    card.out_len += len + SIM_CRC_SIZE; 
+    card.out[card.out_len - 2] = card.out[card.out_len - 1] = 0x00; 
+}
+
+//=======================================================================================
@@ -55,6 +55,7 @@
 #define NVIC_EnableIRQ              __NVIC_EnableIRQ
 #define NVIC_GetEnableIRQ           __NVIC_GetEnableIRQ
 #define NVIC_DisableIRQ             __NVIC_DisableIRQ
+#define NVIC_ClearPendingIRQ        __NVIC_ClearPendingIRQ
 
 
 /**
@@ -103,6 +104,22 @@ static inline void __NVIC_DisableIRQ(IRQn_Type IRQn)
     NVIC_SetEnableStatusIQR(NVIC_IQR_DISABLE); 
 }
 
+
+/**
+ * @brief Clear Pending Interrupt 
+ * 
+ * @details Clears the pending bit of a device specific interrupt in the NVIC pending 
+ *          register. No interrupts are pending in the unit tests so this does nothing. 
+ * 
+ * @param IRQn : Device specific interrupt number 
+ * 
+ * @note IRQn must not be negative. 
+ */
+static inline void __NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+    // 
+}
+
 //=======================================================================================
 
 #endif   // _CORE_CM4_H_ 
@@ -21,6 +21,16 @@
 //=======================================================================================
 
 
+//=======================================================================================
+// Mock data 
+
+// DMA stream configuration 
+static uint32_t dma_mock_mem_addr[DMA_MOCK_NUM_MEM]; 
+static uint16_t dma_mock_data_items; 
+
+//=======================================================================================
+
+
 //=======================================================================================
 // Driver functions 
 
@@ -50,7 +60,9 @@ void dma_stream_config(
     uint32_t mem1_addr, 
     uint16_t data_items)
 {
-    // 
+    dma_mock_mem_addr[0] = mem0_addr; 
+    dma_mock_mem_addr[1] = mem1_addr; 
+    dma_mock_data_items = data_items; 
 }
 
 
@@ -107,4 +119,18 @@ uint8_t dma_get_tc_status(
 
 //=======================================================================================
 // Mock functions 
+
+// Get a memory address set by the last stream configuration 
+uint32_t dma_mock_get_mem_addr(uint8_t mem)
+{
+    return (mem < DMA_MOCK_NUM_MEM) ? dma_mock_mem_addr[mem] : 0; 
+}
+
+
+// Get the number of data items set by the last stream configuration 
+uint16_t dma_mock_get_data_items(void)
+{
+    return dma_mock_data_items; 
+}
+
 //=======================================================================================
@@ -17,16 +17,30 @@
 
 //=======================================================================================
 // Includes 
+
+#include <stdint.h>
+
 //=======================================================================================
 
 
 //=======================================================================================
 // Macros 
+
+#define DMA_MOCK_NUM_MEM 2   // Memory addresses of a stream (double buffer mode) 
+
 //=======================================================================================
 
 
 //=======================================================================================
 // Mock functions 
+
+// Get a memory address set by the last stream configuration (0 or 1) 
+uint32_t dma_mock_get_mem_addr(uint8_t mem); 
+
+
+// Get the number of data items set by the last stream configuration 
+uint16_t dma_mock_get_data_items(void); 
+
 //=======================================================================================
 
 #endif   // _DMA_DRIVER_MOCK_H_ 
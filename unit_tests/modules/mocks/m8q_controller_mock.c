@@ -93,6 +93,57 @@ M8Q_FAULT_CODE m8q_get_fault_code(void)
     return NONE; 
 }
 
+
+// Get the navigation status 
+uint16_t m8q_get_navstat(void)
+{
+    return m8q_get_position_navstat(); 
+}
+
+
+// Get the navigation status lock 
+uint8_t m8q_get_navstat_lock(void)
+{
+    return m8q_get_position_navstat_lock(); 
+}
+
+
+// Get the data ready flag 
+uint8_t m8q_get_data_ready(void)
+{
+    return FALSE; 
+}
+
+
+// Get the last GPS fix - comes straight from the driver mock 
+void m8q_get_fix(m8q_fix_t *fix)
+{
+    if (fix == NULL)
+    {
+        return; 
+    }
+
+    memset((void *)fix, CLEAR, sizeof(m8q_fix_t)); 
+    fix->navstat = m8q_get_position_navstat(); 
+    fix->lock = m8q_get_position_navstat_lock(); 
+#if !M8Q_UBX_NAV_PVT
+    m8q_get_position_lat_str(fix->lat_str, M8Q_FIX_STR_LEN); 
+    fix->NS = m8q_get_position_NS(); 
+    m8q_get_position_lon_str(fix->lon_str, M8Q_FIX_STR_LEN); 
+    fix->EW = m8q_get_position_EW(); 
+    m8q_get_position_sog_str(fix->sog_str, M8Q_FIX_STR_LEN); 
+    m8q_get_time_utc_time(fix->utc_time, M8Q_FIX_TIME_LEN); 
+    m8q_get_time_utc_date(fix->utc_date, M8Q_FIX_TIME_LEN); 
+#endif
+}
+
+
+// TX ready interrupt callback 
+void m8q_txr_handler(void)
+{
+    // 
+}
+
 //=======================================================================================
 
 
@@ -41,6 +41,19 @@ void mpu6050_controller(device_number_t device_num)
 }
 
 
+// MPU6050 FIFO initialization 
+void mpu6050_fifo_init(
+    device_number_t device_num, 
+    I2C_TypeDef *i2c, 
+    mpu6050_i2c_addr_t addr, 
+    uint8_t rate_div, 
+    uint8_t *buff, 
+    uint16_t buff_size)
+{
+    // 
+}
+
+
 // Set low power flag 
 void mpu6050_set_low_power(device_number_t device_num)
 {
@@ -80,6 +93,20 @@ void mpu6050_set_read_flag(device_number_t device_num)
 }
 
 
+// Set the FIFO read flag 
+void mpu6050_set_fifo_flag(device_number_t device_num)
+{
+    // 
+}
+
+
+// Set the FIFO reset flag 
+void mpu6050_set_fifo_reset_flag(device_number_t device_num)
+{
+    // 
+}
+
+
 // Set reset flag 
 void mpu6050_set_reset_flag(device_number_t device_num)
 {
@@ -100,6 +127,38 @@ MPU6050_FAULT_CODE mpu6050_get_fault_code(device_number_t device_num)
     return NONE; 
 }
 
+
+// Get the number of frames from the last FIFO burst read 
+uint16_t mpu6050_get_fifo_frames(device_number_t device_num)
+{
+    return NONE; 
+}
+
+
+// Get the time of the last FIFO burst read 
+uint32_t mpu6050_get_fifo_time(device_number_t device_num)
+{
+    return NONE; 
+}
+
+
+// Get a frame from the last FIFO burst read 
+void mpu6050_get_fifo_frame(
+    device_number_t device_num, 
+    uint16_t frame, 
+    int16_t *accel, 
+    int16_t *gyro)
+{
+    // 
+}
+
+
+// Get the FIFO overflow count 
+uint16_t mpu6050_get_fifo_overflow(device_number_t device_num)
+{
+    return NONE; 
+}
+
 //=======================================================================================
 
 
@@ -0,0 +1,505 @@
+/**
+ * @file sd_controller_mock.c
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief SD card controller mock 
+ * 
+ * @version 0.1
+ * @date 2024-10-25
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include "sd_controller.h" 
+#include "sd_controller_mock.h" 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Mock data 
+
+typedef struct sd_controller_mock_data_s
+{
+    uint16_t write_index; 
+    uint16_t read_index; 
+    uint8_t data_buff[SD_MOCK_DATA_SIZE]; 
+    uint32_t lines;                     // Lines written (including past the buffer) 
+    uint32_t syncs;                     // File syncs 
+    uint32_t write_time;                // (us) Time each write takes 
+    uint32_t stall_time;                // (us) Time a stalled write takes 
+    uint16_t stall_writes;              // Writes per stalled write, 0 = no stalls 
+    uint16_t write_count;               // Writes since the last stall 
+    uint32_t time;                      // (us) Time spent in writes 
+    uint8_t open; 
+}
+sd_controller_mock_data_t; 
+
+static sd_controller_mock_data_t mock_data; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Prototypes 
+
+// Write data to the mock file 
+static void sd_mock_write(
+    const void *buff, 
+    UINT btw); 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Controller functions 
+
+// SD card controller initialization 
+void sd_controller_init(const char *path)
+{
+    // 
+}
+
+
+// SD card controller 
+void sd_controller(void)
+{
+    // 
+}
+
+
+// Set the check flag 
+void sd_set_check_flag(void)
+{
+    // 
+}
+
+
+// Clear the check flag 
+void sd_clear_check_flag(void)
+{
+    // 
+}
+
+
+// Set the eject flag 
+void sd_set_eject_flag(void)
+{
+    // 
+}
+
+
+// Clear the eject flag 
+void sd_clear_eject_flag(void)
+{
+    // 
+}
+
+
+// Set reset flag 
+void sd_set_reset_flag(void)
+{
+    // 
+}
+
+
+// Set directory 
+void sd_set_dir(const TCHAR *dir)
+{
+    if (dir == NULL)
+    {
+        return; 
+    }
+}
+
+
+// Make a new directory in the project directory 
+FRESULT sd_mkdir(const TCHAR *dir)
+{
+    return FR_OK; 
+}
+
+
+// Open a file 
+FRESULT sd_open(
+    const TCHAR *file_name, 
+    uint8_t mode)
+{
+    if (file_name == NULL)
+    {
+        return FR_INVALID_OBJECT; 
+    }
+
+    mock_data.open = SET_BIT; 
+
+    return FR_OK; 
+}
+
+
+// Close an open file 
+FRESULT sd_close(void)
+{
+    mock_data.open = CLEAR_BIT; 
+
+    return FR_OK; 
+}
+
+
+// Write data to the open file 
+FRESULT sd_f_write(
+    const void *buff, 
+    UINT btw)
+{
+    sd_mock_write(buff, btw); 
+
+    return FR_OK; 
+}
+
+
+// Write a string to the open file 
+int16_t sd_puts(const TCHAR *str)
+{
+    if (str == NULL)
+    {
+        return -1; 
+    }
+
+    sd_mock_write((const void *)str, (UINT)strlen(str)); 
+
+    return (int16_t)strlen(str); 
+}
+
+
+// Write a formatted string to the open file 
+int8_t sd_printf(
+    const TCHAR *fmt_str, 
+    uint16_t fmt_value)
+{
+    return 0; 
+}
+
+
+// Select read/write pointer within an open file 
+FRESULT sd_lseek(FSIZE_t offset)
+{
+    return FR_OK; 
+}
+
+
+// Pre-allocate contiguous space for the open file 
+FRESULT sd_expand(FSIZE_t size)
+{
+    return FR_OK; 
+}
+
+
+// Truncate the open file at the read/write pointer 
+FRESULT sd_truncate(void)
+{
+    return FR_OK; 
+}
+
+
+// Sync the open file 
+FRESULT sd_sync(void)
+{
+    mock_data.syncs++; 
+    return FR_OK; 
+}
+
+
+// Delete a file 
+FRESULT sd_unlink(const TCHAR* filename)
+{
+    return FR_OK; 
+}
+
+
+// Buffered write to the open file 
+FRESULT sd_buff_write(
+    const void *buff, 
+    UINT btw)
+{
+    sd_mock_write(buff, btw); 
+
+    return FR_OK; 
+}
+
+
+// Buffered write of a string to the open file 
+int16_t sd_buff_puts(const TCHAR *str)
+{
+    return sd_puts(str); 
+}
+
+
+// Flush the write buffer 
+FRESULT sd_buff_flush(void)
+{
+    return FR_OK; 
+}
+
+
+// Read the free space from the volume 
+FRESULT sd_refresh_free(void)
+{
+    return FR_OK; 
+}
+
+
+// Open a file in a free file handle 
+FRESULT sd_file_open(
+    const TCHAR *file_name, 
+    uint8_t mode, 
+    SD_HANDLE *handle)
+{
+    if (handle != NULL)
+    {
+        *handle = SD_HANDLE_NONE; 
+    }
+
+    return FR_TOO_MANY_OPEN_FILES; 
+}
+
+
+// Close a file handle 
+FRESULT sd_file_close(SD_HANDLE handle)
+{
+    return FR_OK; 
+}
+
+
+// Write data to a file handle 
+FRESULT sd_file_write(
+    SD_HANDLE handle, 
+    const void *buff, 
+    UINT btw)
+{
+    return FR_INVALID_OBJECT; 
+}
+
+
+// Read data from a file handle 
+FRESULT sd_file_read(
+    SD_HANDLE handle, 
+    void *buff, 
+    UINT btr)
+{
+    return FR_INVALID_OBJECT; 
+}
+
+
+// Move the read/write pointer of a file handle 
+FRESULT sd_file_lseek(
+    SD_HANDLE handle, 
+    FSIZE_t offset)
+{
+    return FR_INVALID_OBJECT; 
+}
+
+
+// Get controller state 
+SD_STATE sd_get_state(void)
+{
+    return SD_INIT_STATE; 
+}
+
+
+// Get fault code 
+SD_FAULT_CODE sd_get_fault_code(void)
+{
+    return 0; 
+}
+
+
+// Get fault mode 
+SD_FAULT_MODE sd_get_fault_mode(void)
+{
+    return 0; 
+}
+
+
+// Get open file flag 
+SD_FILE_STATUS sd_get_file_status(void)
+{
+    return mock_data.open; 
+}
+
+
+// Check for the existance of a file or directory 
+FRESULT sd_get_exists(const TCHAR *str)
+{
+    return FR_OK; 
+}
+
+
+// Read data from an open file 
+FRESULT sd_f_read(
+    void *buff, 
+    UINT btr)
+{
+    return FR_OK; 
+}
+
+
+// Reads a string from an open file 
+TCHAR* sd_gets(
+    TCHAR *buff, 
+    uint16_t len)
+{
+    return NULL; 
+}
+
+
+// Check for end of file on an open file 
+SD_EOF sd_eof(void)
+{
+    return 0; 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Mock functions 
+
+// SD Controller Mock: Init 
+void sd_controller_mock_init(void)
+{
+    memset((void *)&mock_data, CLEAR, sizeof(mock_data)); 
+}
+
+
+// SD Controller Mock: Get String 
+void sd_controller_mock_get_str(
+    char *buff, 
+    uint8_t buff_len)
+{
+    // Everything written goes in one data buffer so this reads the data back one line 
+    // at a time. This allows each line of a single data log write to be looked at 
+    // individually. 
+
+    uint8_t index = CLEAR; 
+
+    if ((buff == NULL) || (buff_len == 0))
+    {
+        return; 
+    }
+
+    while ((mock_data.read_index < mock_data.write_index) && (index < (buff_len - 1)))
+    {
+        buff[index] = (char)mock_data.data_buff[mock_data.read_index++]; 
+
+        if (buff[index++] == NL_CHAR)
+        {
+            break; 
+        }
+    }
+
+    buff[index] = NULL_CHAR; 
+}
+
+
+// SD Controller Mock: Get Data 
+uint16_t sd_controller_mock_get_data(
+    void *buff, 
+    uint16_t buff_len)
+{
+    uint16_t len = mock_data.write_index - mock_data.read_index; 
+
+    if (buff == NULL)
+    {
+        return 0; 
+    }
+
+    if (len > buff_len)
+    {
+        len = buff_len; 
+    }
+
+    memcpy(buff, (void *)&mock_data.data_buff[mock_data.read_index], (size_t)len); 
+    mock_data.read_index += len; 
+
+    return len; 
+}
+
+
+// SD Controller Mock: Set Write Time 
+void sd_controller_mock_set_write_time(
+    uint32_t write_time, 
+    uint32_t stall_time, 
+    uint16_t stall_writes)
+{
+    // Each write takes 'write_time' except every 'stall_writes' write which takes 
+    // 'stall_time' (card internal housekeeping). 
+    mock_data.write_time = write_time; 
+    mock_data.stall_time = stall_time; 
+    mock_data.stall_writes = stall_writes; 
+    mock_data.write_count = CLEAR; 
+}
+
+
+// SD Controller Mock: Get Write Time 
+uint32_t sd_controller_mock_get_write_time(void)
+{
+    return mock_data.time; 
+}
+
+
+// SD Controller Mock: Get Lines 
+uint32_t sd_controller_mock_get_lines(void)
+{
+    return mock_data.lines; 
+}
+
+
+// SD Controller Mock: Get Syncs 
+uint32_t sd_controller_mock_get_syncs(void)
+{
+    return mock_data.syncs; 
+}
+
+
+// Write data to the mock file 
+static void sd_mock_write(
+    const void *buff, 
+    UINT btw)
+{
+    const uint8_t *data = (const uint8_t *)buff; 
+
+    if (buff == NULL)
+    {
+        return; 
+    }
+
+    // Data that doesn't fit in the buffer is only counted 
+    for (UINT i = CLEAR; i < btw; i++)
+    {
+        if (mock_data.write_index < SD_MOCK_DATA_SIZE)
+        {
+            mock_data.data_buff[mock_data.write_index++] = data[i]; 
+        }
+
+        if (data[i] == NL_CHAR)
+        {
+            mock_data.lines++; 
+        }
+    }
+
+    if (mock_data.stall_writes && (++mock_data.write_count >= mock_data.stall_writes))
+    {
+        mock_data.write_count = CLEAR; 
+        mock_data.time += mock_data.stall_time; 
+    }
+    else 
+    {
+        mock_data.time += mock_data.write_time; 
+    }
+}
+
+//=======================================================================================
@@ -0,0 +1,71 @@
+/**
+ * @file sd_controller_mock.h
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief SD card controller mock interface 
+ * 
+ * @version 0.1
+ * @date 2024-10-25
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef _SD_CONTROLLER_MOCK_H_ 
+#define _SD_CONTROLLER_MOCK_H_ 
+
+//=======================================================================================
+// Includes 
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define SD_MOCK_STR_SIZE 100 
+#define SD_MOCK_DATA_SIZE 4096 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Mock functions 
+
+// SD Controller Mock: Init 
+void sd_controller_mock_init(void); 
+
+
+// SD Controller Mock: Get String 
+void sd_controller_mock_get_str(
+    char *buff, 
+    uint8_t buff_len); 
+
+
+// SD Controller Mock: Get Data 
+uint16_t sd_controller_mock_get_data(
+    void *buff, 
+    uint16_t buff_len); 
+
+
+// SD Controller Mock: Set Write Time 
+void sd_controller_mock_set_write_time(
+    uint32_t write_time, 
+    uint32_t stall_time, 
+    uint16_t stall_writes); 
+
+
+// SD Controller Mock: Get Write Time 
+uint32_t sd_controller_mock_get_write_time(void); 
+
+
+// SD Controller Mock: Get Lines 
+uint32_t sd_controller_mock_get_lines(void); 
+
+
+// SD Controller Mock: Get Syncs 
+uint32_t sd_controller_mock_get_syncs(void); 
+
+//=======================================================================================
+
+#endif   // _SD_CONTROLLER_MOCK_H_ 
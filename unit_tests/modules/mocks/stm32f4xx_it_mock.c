@@ -33,6 +33,13 @@ int_handle_flags_t handler_flags;
 //=======================================================================================
 // Interrupts 
 
+// EXTI Line 0 
+void EXTI0_IRQHandler(void)
+{
+    handler_flags.exti0_flag = SET_BIT; 
+}
+
+
 // EXTI Line 4 
 void EXTI4_IRQHandler(void)
 {
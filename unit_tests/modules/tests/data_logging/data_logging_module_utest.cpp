@@ -31,7 +31,11 @@ extern "C"
     #include "stm32f4xx_it.h" 
     #include "m8q_driver_mock.h" 
     #include "mpu6050_driver_mock.h" 
-    #include "fatfs_controller_mock.h" 
+    #include "sd_controller_mock.h"
+    #include "sd_controller.h" 
+
+    // Data logging module functions that aren't part of its interface 
+    void log_record_append(const void *record, uint16_t size); 
 }
 
 //=======================================================================================
@@ -42,6 +46,17 @@ extern "C"
 
 #define LOG_TEST_NUM_INTERVALS 100 
 #define LOG_TEST_NUM_REVS 4 
+#define LOG_TEST_MAX_REVS 200 
+#define LOG_TEST_RATE_TIME 10000      // (ms) Sustained sample rate logging time 
+#define LOG_TEST_STALL_PERIOD 1000    // (ms) Time between SD card write stalls 
+#define LOG_TEST_STALL_TIME 250       // (ms) SD card write stall (busy) time 
+#define LOG_TEST_WRITE_TIME 5000      // (us) SD card write time 
+#define LOG_TEST_HEADER_LINES 20      // Max text lines ahead of the binary header record 
+#define LOG_TEST_TIME 0x12345678      // (us) Timebase count of an ADC block 
+#define LOG_TEST_FILL_BYTE 0xA5       // Log string filler 
+#define LOG_TEST_SPARE_BYTES 2        // Log string left after the last record that fits 
+#define LOG_TEST_SYNC_SLOTS (3 * LOG_SYNC_SLOTS)   // Log stream slots of the sync tests 
+#define LOG_TEST_SYNC_FILL (LOG_MAX_LOG_LEN / 2)   // Log data added to each sync test slot 
 
 //=======================================================================================
 
@@ -52,16 +67,25 @@ extern "C"
 TEST_GROUP(data_logging_test)
 {
     // Global test group variables 
+    DMA_Stream_TypeDef dma_stream;   // ADC DMA stream registers 
+    TIM_TypeDef timebase;            // Timebase registers 
 
     // Constructor 
     void setup()
     {
-        log_init(EXTI4_IRQn, TIM1_TRG_COM_TIM11_IRQn, ADC1, DMA2, DMA2_Stream0); 
+        // A local copy of the DMA stream registers is used so the buffer the DMA is 
+        // filling (CT bit) can be read and set by the tests. 
+        memset((void *)&dma_stream, CLEAR, sizeof(dma_stream)); 
+        log_init(EXTI0_IRQn, DMA2_Stream0_IRQn, ADC1, DMA2, &dma_stream); 
+
+        // The timebase count is only read so a local copy that doesn't count is enough 
+        memset((void *)&timebase, CLEAR, sizeof(timebase)); 
+        log_timebase_init(&timebase); 
 
         // Mock init 
         m8q_mock_init(); 
         mpu6050_mock_init(); 
-        fatfs_controller_mock_init(); 
+        sd_controller_mock_init(); 
     }
 
     // Destructor 
@@ -82,9 +106,10 @@ void wheel_rev_iso(uint8_t& index, uint8_t rev_num)
 {
     while (++index < LOG_SPEED_PERIOD)
     {
+        log_data_adc_handler(); 
+
         for (uint8_t j = CLEAR; j < LOG_PERIOD_DIVIDER; j++)
         {
-            log_data_adc_handler(); 
             log_data(); 
         }
     }
@@ -93,33 +118,148 @@ void wheel_rev_iso(uint8_t& index, uint8_t rev_num)
 
     for (uint8_t i = CLEAR; i < rev_num; i++)
     {
-        EXTI4_IRQHandler(); 
+        EXTI0_IRQHandler(); 
         log_data(); 
     }
 
-    fatfs_controller_mock_init(); 
+    sd_controller_mock_init(); 
+
+    log_data_adc_handler(); 
 
     for (uint8_t i = CLEAR; i < LOG_PERIOD_DIVIDER; i++)
     {
-        log_data_adc_handler(); 
         log_data(); 
     }
 }
 
 
-// Wheel rev log read 
-void wheel_rev_log_read(unsigned int& rev_count)
+// Record bytes - append the bytes of one record to the expected log data 
+void record_bytes_append(
+    uint8_t *buff, 
+    uint16_t& len, 
+    const uint8_t *record, 
+    uint16_t size)
+{
+    memcpy((void *)&buff[len], (void *)record, size); 
+    len += size; 
+}
+
+
+// Wheel rev log read - revolutions in the short and long windows 
+void wheel_rev_log_read(
+    unsigned int& rev_short, 
+    unsigned int& rev_long)
 {
-    char log_line[FATFS_MOCK_STR_SIZE]; 
+    char log_line[SD_MOCK_STR_SIZE]; 
     memset((void *)log_line, CLEAR, sizeof(log_line)); 
     unsigned int dummy1 = CLEAR, dummy2 = CLEAR, dummy3 = CLEAR; 
 
     for (uint8_t i = CLEAR; i < LOG_PERIOD_DIVIDER; i++)
     {
-        fatfs_controller_mock_get_str(log_line, FATFS_MOCK_STR_SIZE); 
+        sd_controller_mock_get_str(log_line, SD_MOCK_STR_SIZE); 
     }
 
-    sscanf(log_line, "%u, %u, %u, %u", &dummy1, &dummy2, &dummy3, &rev_count); 
+    sscanf(log_line, "%u, %u, %u, %u/%u", &dummy1, &dummy2, &dummy3, &rev_short, &rev_long); 
+}
+
+
+
+// Log sync counts - syncs seen in a run of log stream slots 
+struct log_sync_counts_t
+{
+    uint32_t slot_syncs;       // Syncs due by log stream slots (including the first) 
+    uint32_t byte_syncs;       // Syncs due by log data bytes 
+    uint32_t deferred;         // Slots a due sync was deferred from 
+}; 
+
+
+// Log sync run - logs a binary log for a number of log stream slots and checks each 
+// sync against the sync policy 
+void log_sync_run(
+    TIM_TypeDef& timebase, 
+    uint16_t fill_len, 
+    log_sync_counts_t& counts)
+{
+    // The log stream schedule is run alongside the one in the data logging module to get 
+    // the streams of each slot. A sync is due at the start of the log, LOG_SYNC_SLOTS 
+    // slots after the last one or once LOG_SYNC_BYTES of log data have been written since 
+    // the last one, whichever comes first. It only runs in a slot with room for 
+    // LOG_SYNC_COST and no slot gets more than one. Each sync record must hold the 
+    // sequence number and offset of the log data written before it and the log id. 
+
+    static uint8_t fill[LOG_MAX_LOG_LEN]; 
+    static uint8_t data[SD_MOCK_DATA_SIZE]; 
+    log_schedule_t schedule; 
+    log_rec_sync_t record; 
+    uint32_t 
+    bytes = CLEAR,          // Log data bytes written 
+    sync_bytes = CLEAR,     // Log data bytes at the last sync 
+    seq = CLEAR,            // Syncs 
+    due = CLEAR;            // Slot the next sync is due by slots 
+    uint16_t len, data_len; 
+    uint32_t syncs; 
+    uint8_t room, by_bytes; 
+
+    memset((void *)fill, LOG_TEST_FILL_BYTE, sizeof(fill)); 
+    memset((void *)&counts, CLEAR, sizeof(counts)); 
+
+    timebase.CNT = LOG_TEST_TIME; 
+    log_set_mode(LOG_MODE_BINARY); 
+    log_data_file_prep(); 
+    log_data_prep(); 
+    log_schedule_init(&schedule); 
+
+    for (uint32_t slot = CLEAR; slot < LOG_TEST_SYNC_SLOTS; slot++)
+    {
+        room = ((log_schedule_cost(log_schedule_select(&schedule)) + LOG_SYNC_COST) <= 
+                LOG_SLOT_BUDGET); 
+
+        sd_controller_mock_init(); 
+        log_record_append((void *)fill, fill_len); 
+        log_data_adc_handler(); 
+
+        for (uint8_t i = CLEAR; i < LOG_PERIOD_DIVIDER; i++)
+        {
+            log_data(); 
+        }
+
+        syncs = sd_controller_mock_get_syncs(); 
+        len = sd_controller_mock_get_data((void *)data, sizeof(data)); 
+        data_len = syncs ? (len - sizeof(record)) : len; 
+        by_bytes = ((bytes + data_len - sync_bytes) >= LOG_SYNC_BYTES); 
+
+        UNSIGNED_LONGS_EQUAL(((slot >= due) || by_bytes) && room, syncs); 
+
+        if ((slot >= due) || by_bytes)
+        {
+            counts.deferred += !room; 
+        }
+
+        if (syncs)
+        {
+            // The sync record is the last thing written in the slot 
+            memcpy((void *)&record, (void *)&data[data_len], sizeof(record)); 
+            UNSIGNED_LONGS_EQUAL(LOG_REC_SYNC, record.tag); 
+            UNSIGNED_LONGS_EQUAL(seq, record.seq); 
+            UNSIGNED_LONGS_EQUAL(bytes + data_len, record.offset); 
+            UNSIGNED_LONGS_EQUAL(LOG_TEST_TIME, record.id); 
+
+            if (slot >= due)
+            {
+                counts.slot_syncs++; 
+            }
+            else 
+            {
+                counts.byte_syncs++; 
+            }
+
+            sync_bytes = bytes + data_len; 
+            seq++; 
+            due = slot + LOG_SYNC_SLOTS; 
+        }
+
+        bytes += len; 
+    }
 }
 
 //=======================================================================================
@@ -131,8 +271,10 @@ void wheel_rev_log_read(unsigned int& rev_count)
 // Log Data: schedule 
 TEST(data_logging_test, log_data_schedule)
 {
-    // This test makes sure no two streams get scheduled to run at the same time. This 
-    // is done using the starting offsets and counter periods of each stream. 
+    // This test makes sure the default schedule never has two streams due at the same 
+    // time. This is done using the starting offsets and counter periods of each stream. 
+    // Streams can share a slot within LOG_SLOT_BUDGET but keeping them apart keeps each 
+    // slot short. 
 
     uint16_t 
     test_time = LOG_PERIOD * LOG_PERIOD_DIVIDER * LOG_TEST_NUM_INTERVALS, 
@@ -200,8 +342,8 @@ TEST(data_logging_test, log_data_log_header_output)
     utc_date[] = "091202"; 
 
     // Data buffer 
-    char header_line[FATFS_MOCK_STR_SIZE]; 
-    char line_buff[FATFS_MOCK_STR_SIZE]; 
+    char header_line[SD_MOCK_STR_SIZE]; 
+    char line_buff[SD_MOCK_STR_SIZE]; 
     memset((void *)header_line, CLEAR, sizeof(header_line)); 
     memset((void *)line_buff, CLEAR, sizeof(line_buff)); 
 
@@ -229,46 +371,47 @@ TEST(data_logging_test, log_data_log_header_output)
     log_data_file_prep(); 
 
     // Check each line of the header 
-    fatfs_controller_mock_get_str(header_line, FATFS_MOCK_STR_SIZE); 
-    snprintf(line_buff, FATFS_MOCK_STR_SIZE, mtbdl_param_fork_info, 
+    sd_controller_mock_get_str(header_line, SD_MOCK_STR_SIZE); 
+    snprintf(line_buff, SD_MOCK_STR_SIZE, mtbdl_param_fork_info, 
              fork_psi, fork_compression, fork_rebound); 
     STRCMP_EQUAL(line_buff, header_line); 
 
-    fatfs_controller_mock_get_str(header_line, FATFS_MOCK_STR_SIZE); 
-    snprintf(line_buff, FATFS_MOCK_STR_SIZE, mtbdl_param_shock_info, 
+    sd_controller_mock_get_str(header_line, SD_MOCK_STR_SIZE); 
+    snprintf(line_buff, SD_MOCK_STR_SIZE, mtbdl_param_shock_info, 
              shock_psi, shock_lockout, shock_rebound); 
     STRCMP_EQUAL(line_buff, header_line); 
 
-    fatfs_controller_mock_get_str(header_line, FATFS_MOCK_STR_SIZE); 
-    snprintf(line_buff, FATFS_MOCK_STR_SIZE, mtbdl_param_bike_info, 
+    sd_controller_mock_get_str(header_line, SD_MOCK_STR_SIZE); 
+    snprintf(line_buff, SD_MOCK_STR_SIZE, mtbdl_param_bike_info, 
              fork_travel, shock_travel, wheel_size); 
     STRCMP_EQUAL(line_buff, header_line); 
 
-    fatfs_controller_mock_get_str(header_line, FATFS_MOCK_STR_SIZE); 
-    snprintf(line_buff, FATFS_MOCK_STR_SIZE, mtbdl_param_index, file_index); 
+    sd_controller_mock_get_str(header_line, SD_MOCK_STR_SIZE); 
+    snprintf(line_buff, SD_MOCK_STR_SIZE, mtbdl_param_index, file_index); 
     STRCMP_EQUAL(line_buff, header_line); 
 
-    fatfs_controller_mock_get_str(header_line, FATFS_MOCK_STR_SIZE); 
-    snprintf(line_buff, FATFS_MOCK_STR_SIZE, mtbdl_param_accel_rest, 
+    sd_controller_mock_get_str(header_line, SD_MOCK_STR_SIZE); 
+    snprintf(line_buff, SD_MOCK_STR_SIZE, mtbdl_param_accel_rest, 
              ax_rest, ay_rest, az_rest); 
     STRCMP_EQUAL(line_buff, header_line); 
 
-    fatfs_controller_mock_get_str(header_line, FATFS_MOCK_STR_SIZE); 
-    snprintf(line_buff, FATFS_MOCK_STR_SIZE, mtbdl_param_pot_rest, 
+    sd_controller_mock_get_str(header_line, SD_MOCK_STR_SIZE); 
+    snprintf(line_buff, SD_MOCK_STR_SIZE, mtbdl_param_pot_rest, 
              fork_rest, shock_rest); 
     STRCMP_EQUAL(line_buff, header_line); 
 
-    fatfs_controller_mock_get_str(header_line, FATFS_MOCK_STR_SIZE); 
-    snprintf(line_buff, FATFS_MOCK_STR_SIZE, mtbdl_param_time, 
+    sd_controller_mock_get_str(header_line, SD_MOCK_STR_SIZE); 
+    snprintf(line_buff, SD_MOCK_STR_SIZE, mtbdl_param_time, 
              utc_time, utc_date); 
     STRCMP_EQUAL(line_buff, header_line); 
 
-    fatfs_controller_mock_get_str(header_line, FATFS_MOCK_STR_SIZE); 
-    snprintf(line_buff, FATFS_MOCK_STR_SIZE, mtbdl_param_data, 
-             LOG_PERIOD, LOG_PERIOD * LOG_PERIOD_DIVIDER * LOG_SPEED_PERIOD, LOG_REV_SAMPLE_SIZE); 
+    sd_controller_mock_get_str(header_line, SD_MOCK_STR_SIZE); 
+    snprintf(line_buff, SD_MOCK_STR_SIZE, mtbdl_param_data, 
+             LOG_PERIOD, LOG_PERIOD * LOG_PERIOD_DIVIDER * LOG_SPEED_PERIOD, 
+             LOG_REV_WINDOW_SHORT, LOG_REV_WINDOW_LONG, LOG_ADC_RES_BITS); 
     STRCMP_EQUAL(line_buff, header_line); 
 
-    fatfs_controller_mock_get_str(header_line, FATFS_MOCK_STR_SIZE); 
+    sd_controller_mock_get_str(header_line, SD_MOCK_STR_SIZE); 
     STRCMP_EQUAL(mtbdl_data_log_start, header_line); 
 }
 
@@ -306,21 +449,21 @@ TEST(data_logging_test, log_data_log_output)
     ew[] = "E"; 
 
     char 
-    log_line[FATFS_MOCK_STR_SIZE], 
-    log_default[FATFS_MOCK_STR_SIZE], 
-    log_gps[FATFS_MOCK_STR_SIZE], 
-    log_accel[FATFS_MOCK_STR_SIZE], 
-    log_rev[FATFS_MOCK_STR_SIZE]; 
+    log_line[SD_MOCK_STR_SIZE], 
+    log_default[SD_MOCK_STR_SIZE], 
+    log_gps[SD_MOCK_STR_SIZE], 
+    log_accel[SD_MOCK_STR_SIZE], 
+    log_rev[SD_MOCK_STR_SIZE]; 
 
     memset((void *)log_line, CLEAR, sizeof(log_line)); 
-    snprintf(log_default, FATFS_MOCK_STR_SIZE, mtbdl_data_log_default, 
+    snprintf(log_default, SD_MOCK_STR_SIZE, mtbdl_data_log_default, 
              trail_mark, fork_adc, shock_adc); 
-    snprintf(log_gps, FATFS_MOCK_STR_SIZE, mtbdl_data_log_gps, 
+    snprintf(log_gps, SD_MOCK_STR_SIZE, mtbdl_data_log_gps, 
              "", "", "", "", trail_mark, fork_adc, shock_adc, sog, lat, ns[0], lon, ew[0]); 
-    snprintf(log_accel, FATFS_MOCK_STR_SIZE, mtbdl_data_log_accel, 
+    snprintf(log_accel, SD_MOCK_STR_SIZE, mtbdl_data_log_accel, 
              "", "", "", "", trail_mark, fork_adc, shock_adc, ax, ay, az); 
-    snprintf(log_rev, FATFS_MOCK_STR_SIZE, mtbdl_data_log_speed, 
-             "", "", "", "", trail_mark, fork_adc, shock_adc, wheel_speed); 
+    snprintf(log_rev, SD_MOCK_STR_SIZE, mtbdl_data_log_speed, 
+             "", "", "", "", trail_mark, fork_adc, shock_adc, wheel_speed, wheel_speed); 
     
     //==================================================
 
@@ -357,15 +500,16 @@ TEST(data_logging_test, log_data_log_output)
 
     for (uint8_t i = CLEAR; i < LOG_TEST_NUM_INTERVALS; i++)
     {
+        log_data_adc_handler(); 
+
         for (uint8_t j = CLEAR; j < LOG_PERIOD_DIVIDER; j++)
         {
-            log_data_adc_handler(); 
             log_data(); 
         }
 
         for (uint8_t j = CLEAR; j < LOG_PERIOD_DIVIDER; j++)
         {
-            fatfs_controller_mock_get_str(log_line, FATFS_MOCK_STR_SIZE); 
+            sd_controller_mock_get_str(log_line, SD_MOCK_STR_SIZE); 
 
             if (!strcmp(log_line, log_default))
             {
@@ -385,7 +529,7 @@ TEST(data_logging_test, log_data_log_output)
             }
         }
 
-        fatfs_controller_mock_init(); 
+        sd_controller_mock_init(); 
     }
 
     UNSIGNED_LONGS_EQUAL(standard_expected, standard_count); 
@@ -397,47 +541,365 @@ TEST(data_logging_test, log_data_log_output)
 }
 
 
+// Log Data: binary header record 
+TEST(data_logging_test, log_data_binary_header_record)
+{
+    // Binary logs have a header record after the same text header as text logs. The 
+    // record is checked byte for byte against the layout in log_record.h (packed, little 
+    // endian) and nothing else is written after it. 
+
+    char header_line[SD_MOCK_STR_SIZE]; 
+    uint8_t record[sizeof(log_rec_header_t) + 1]; 
+    uint16_t rev_period = LOG_PERIOD * LOG_PERIOD_DIVIDER * LOG_SPEED_PERIOD; 
+
+    const uint8_t expected[] = 
+    {
+        LOG_REC_HEADER, 
+        'M', 'T', 'B', 'L', 
+        LOG_REC_VERSION, 
+        LOG_PERIOD, 
+        LOG_PERIOD_DIVIDER, 
+        (uint8_t)rev_period, (uint8_t)(rev_period >> 8), 
+        LOG_REV_WINDOW_SHORT, 
+        LOG_REV_WINDOW_LONG, 
+        LOG_ADC_RES_BITS, 
+        (uint8_t)LOG_IMU_RATE, (uint8_t)(LOG_IMU_RATE >> 8), 
+        0x78, 0x56, 0x34, 0x12
+    }; 
+
+    memset((void *)header_line, CLEAR, sizeof(header_line)); 
+
+    // The log id is the timebase count when the file is made 
+    timebase.CNT = LOG_TEST_TIME; 
+    log_set_mode(LOG_MODE_BINARY); 
+    log_data_file_prep(); 
+
+    // Skip the text header 
+    for (uint8_t i = CLEAR; i < LOG_TEST_HEADER_LINES; i++)
+    {
+        sd_controller_mock_get_str(header_line, SD_MOCK_STR_SIZE); 
+
+        if (!strcmp(header_line, mtbdl_data_log_start))
+        {
+            break; 
+        }
+    }
+
+    STRCMP_EQUAL(mtbdl_data_log_start, header_line); 
+    UNSIGNED_LONGS_EQUAL(sizeof(expected), sizeof(log_rec_header_t)); 
+    UNSIGNED_LONGS_EQUAL(sizeof(expected), 
+                         sd_controller_mock_get_data((void *)record, sizeof(record))); 
+    MEMCMP_EQUAL(expected, record, sizeof(expected)); 
+}
+
+
+// Log Data: binary interval records 
+TEST(data_logging_test, log_data_binary_interval_records)
+{
+    // The records of one log stream period are checked byte for byte. Each interval has 
+    // an ADC record, the interval the trail marker is set in has a trail marker record 
+    // ahead of its ADC record and the last interval starts with a time record. The DMA 
+    // blocks aren't filled in the tests so every ADC sample is zero. Stream records 
+    // after the ADC record of the last interval aren't checked. 
+
+    const uint8_t
+    adc[] = { LOG_REC_ADC, 0x00, 0x00, 0x00, 0x00 }, 
+    trailmark[] = { LOG_REC_TRAILMARK }, 
+    time[] = { LOG_REC_TIME, 0x78, 0x56, 0x34, 0x12 }; 
+
+    uint8_t
+    expected[LOG_MAX_LOG_LEN], 
+    data[LOG_MAX_LOG_LEN]; 
+
+    uint16_t
+    expected_len = CLEAR, 
+    data_len; 
+
+    for (uint8_t i = CLEAR; i < LOG_PERIOD_DIVIDER; i++)
+    {
+        if (i == BYTE_1)
+        {
+            record_bytes_append(expected, expected_len, trailmark, sizeof(trailmark)); 
+        }
+        if (i == (LOG_PERIOD_DIVIDER - 1))
+        {
+            record_bytes_append(expected, expected_len, time, sizeof(time)); 
+        }
+        record_bytes_append(expected, expected_len, adc, sizeof(adc)); 
+    }
+
+    log_set_mode(LOG_MODE_BINARY); 
+    log_data_prep(); 
+
+    timebase.CNT = LOG_TEST_TIME; 
+    log_data_adc_handler(); 
+
+    for (uint8_t i = CLEAR; i < LOG_PERIOD_DIVIDER; i++)
+    {
+        if (i == BYTE_1)
+        {
+            log_set_trailmark(); 
+        }
+        log_data(); 
+    }
+
+    data_len = sd_controller_mock_get_data((void *)data, sizeof(data)); 
+
+    CHECK(data_len >= expected_len); 
+    MEMCMP_EQUAL(expected, data, expected_len); 
+}
+
+
+// Log Data: binary record dropped when the log string is full 
+TEST(data_logging_test, log_data_binary_record_full)
+{
+    // Records that don't fit in what's left of the log string are dropped whole so a 
+    // record is never cut short in the log. The log string is filled so there's room 
+    // for one ADC record and a little more, then one log stream period is logged. Only 
+    // the ADC record of the first interval gets added and the rest of the period is 
+    // dropped. The log string is empty again once it's written so the next period 
+    // starts with its first ADC record. 
+
+    const uint8_t adc[] = { LOG_REC_ADC, 0x00, 0x00, 0x00, 0x00 }; 
+
+    uint8_t
+    fill[LOG_MAX_LOG_LEN], 
+    data[LOG_MAX_LOG_LEN]; 
+
+    uint16_t
+    fill_len = LOG_MAX_LOG_LEN - sizeof(adc) - LOG_TEST_SPARE_BYTES, 
+    data_len; 
+
+    memset((void *)fill, LOG_TEST_FILL_BYTE, sizeof(fill)); 
+
+    log_set_mode(LOG_MODE_BINARY); 
+    log_data_prep(); 
+    log_record_append((void *)fill, fill_len); 
+
+    log_data_adc_handler(); 
+
+    for (uint8_t i = CLEAR; i < LOG_PERIOD_DIVIDER; i++)
+    {
+        log_data(); 
+    }
+
+    data_len = sd_controller_mock_get_data((void *)data, sizeof(data)); 
+
+    UNSIGNED_LONGS_EQUAL(fill_len + sizeof(adc), data_len); 
+    MEMCMP_EQUAL(fill, data, fill_len); 
+    MEMCMP_EQUAL(adc, &data[fill_len], sizeof(adc)); 
+
+    // Next log stream period 
+    log_data_adc_handler(); 
+
+    for (uint8_t i = CLEAR; i < LOG_PERIOD_DIVIDER; i++)
+    {
+        log_data(); 
+    }
+
+    data_len = sd_controller_mock_get_data((void *)data, sizeof(data)); 
+
+    CHECK(data_len >= sizeof(adc)); 
+    MEMCMP_EQUAL(adc, data, sizeof(adc)); 
+}
+
+
+// Log Data: log file sync by log stream slots 
+TEST(data_logging_test, log_data_sync_slots)
+{
+    // A binary log with only its own records writes much less than LOG_SYNC_BYTES in 
+    // LOG_SYNC_SLOTS slots so every sync is due by slots. The first sync runs in the 
+    // first slot with room for it and each one after is LOG_SYNC_SLOTS slots later. 
+
+    log_sync_counts_t counts; 
+
+    log_sync_run(timebase, CLEAR, counts); 
+
+    UNSIGNED_LONGS_EQUAL(LOG_TEST_SYNC_SLOTS / LOG_SYNC_SLOTS, counts.slot_syncs); 
+    UNSIGNED_LONGS_EQUAL(CLEAR, counts.byte_syncs); 
+}
+
+
+// Log Data: log file sync by log data bytes 
+TEST(data_logging_test, log_data_sync_bytes)
+{
+    // Log data is added to each slot so LOG_SYNC_BYTES is reached long before 
+    // LOG_SYNC_SLOTS. Only the first sync is due by slots. The bytes limit is reached 
+    // in slots of every kind so some of the syncs have to wait for a slot with room. 
+
+    log_sync_counts_t counts; 
+
+    log_sync_run(timebase, LOG_TEST_SYNC_FILL, counts); 
+
+    UNSIGNED_LONGS_EQUAL(1, counts.slot_syncs); 
+    CHECK(counts.byte_syncs > 1); 
+    CHECK(counts.deferred > 0); 
+}
+
+
 // Log Data: wheel revolution calculation 
 TEST(data_logging_test, log_data_wheel_revs)
 {
     // The wheel revolution log stream records the number of detected wheel revolutions 
     // since the last time the stream was called. The number of times gets recorded in a 
-    // circular buffer by taking the place of the oldest data. All interval numbers get 
-    // summed so the total rev count over X stream calls (known time delta) is know and 
-    // that sum gets logged. This test fills the circular buffer with each spot having 
-    // the same value so the expected sum is easy to determine. The stream is then run 
-    // once more but with a different number of detected revolutions and it's checked 
-    // that the oldest piece of data is replaced by the new piece of data. 
+    // circular buffer by taking the place of the oldest data. The interval numbers in 
+    // each revolution window are summed so the total rev count over X stream calls 
+    // (known time delta) is known and the short and long window sums get logged. This 
+    // test fills the circular buffer with each spot having the same value so the 
+    // expected sums are easy to determine. The stream is then run once more but with a 
+    // different number of detected revolutions and it's checked that the oldest piece 
+    // of data in each window is replaced by the new piece of data. 
 
     uint8_t 
     index = LOG_SPEED_OFFSET, 
-    rev_num = LOG_TEST_NUM_REVS, 
-    rev_sum = rev_num * LOG_REV_SAMPLE_SIZE; 
-    unsigned int rev_count = CLEAR; 
+    rev_num = LOG_TEST_NUM_REVS; 
+    unsigned int
+    short_sum = rev_num * LOG_REV_WINDOW_SHORT, 
+    long_sum = rev_num * LOG_REV_WINDOW_LONG, 
+    short_count = CLEAR, 
+    long_count = CLEAR; 
 
     log_data_prep(); 
 
-    // Run the wheel rev stream until it's buffer fills up and check that the rev count 
-    // is as expected by reading the data logged. 
+    // Run the wheel rev stream until it's buffer fills up and check that the rev counts 
+    // are as expected by reading the data logged. 
     for (uint8_t i = CLEAR; i < LOG_REV_SAMPLE_SIZE; i++)
     {
         wheel_rev_iso(index, rev_num); 
     }
 
-    wheel_rev_log_read(rev_count); 
-    UNSIGNED_LONGS_EQUAL(rev_sum, rev_count); 
+    wheel_rev_log_read(short_count, long_count); 
+    UNSIGNED_LONGS_EQUAL(short_sum, short_count); 
+    UNSIGNED_LONGS_EQUAL(long_sum, long_count); 
 
     // Change the number of revs that occur between log samples. To show that we've 
-    // reached the rev sum buffer limit and the new value will replace an old value, 
-    // the expected sum gets updated. Run the log sequence until the next wheel rev 
+    // reached the rev sum window limits and the new value will replace an old value, 
+    // the expected sums get updated. Run the log sequence until the next wheel rev 
     // stream is reached and re-check the results. 
-    rev_sum -= rev_num; 
+    short_sum -= rev_num; 
+    long_sum -= rev_num; 
     rev_num *= rev_num; 
-    rev_sum += rev_num; 
+    short_sum += rev_num; 
+    long_sum += rev_num; 
 
     wheel_rev_iso(index, rev_num); 
-    wheel_rev_log_read(rev_count); 
-    UNSIGNED_LONGS_EQUAL(rev_sum, rev_count); 
+    wheel_rev_log_read(short_count, long_count); 
+    UNSIGNED_LONGS_EQUAL(short_sum, short_count); 
+    UNSIGNED_LONGS_EQUAL(long_sum, long_count); 
+}
+
+
+// Log Data: wheel revolution window sums larger than one interval count 
+TEST(data_logging_test, log_data_wheel_revs_wide)
+{
+    // The window sums can be larger than the revolutions counted in one interval can be. 
+    // Each interval is filled with a high revolution count so the long window sum is 
+    // well past 8 bits. The revolutions then stop and it's checked that each window 
+    // drops back to 0 once the high count intervals have left it. 
+
+    uint8_t
+    index = LOG_SPEED_OFFSET, 
+    rev_num = LOG_TEST_MAX_REVS; 
+    unsigned int short_count = CLEAR, long_count = CLEAR; 
+
+    log_data_prep(); 
+
+    for (uint8_t i = CLEAR; i < LOG_REV_SAMPLE_SIZE; i++)
+    {
+        wheel_rev_iso(index, rev_num); 
+    }
+
+    wheel_rev_log_read(short_count, long_count); 
+    UNSIGNED_LONGS_EQUAL(rev_num * LOG_REV_WINDOW_SHORT, short_count); 
+    UNSIGNED_LONGS_EQUAL(rev_num * LOG_REV_WINDOW_LONG, long_count); 
+
+    for (uint8_t i = CLEAR; i < LOG_REV_WINDOW_SHORT; i++)
+    {
+        wheel_rev_iso(index, CLEAR); 
+    }
+
+    wheel_rev_log_read(short_count, long_count); 
+    UNSIGNED_LONGS_EQUAL(CLEAR, short_count); 
+    UNSIGNED_LONGS_EQUAL(rev_num * (LOG_REV_WINDOW_LONG - LOG_REV_WINDOW_SHORT), long_count); 
+
+    for (uint8_t i = LOG_REV_WINDOW_SHORT; i < LOG_REV_WINDOW_LONG; i++)
+    {
+        wheel_rev_iso(index, CLEAR); 
+    }
+
+    wheel_rev_log_read(short_count, long_count); 
+    UNSIGNED_LONGS_EQUAL(CLEAR, short_count); 
+    UNSIGNED_LONGS_EQUAL(CLEAR, long_count); 
+}
+
+
+// Log Data: sustained sample rate 
+TEST(data_logging_test, log_data_sustained_rate)
+{
+    // Data logging is run at the suspension sample rate (LOG_SUS_RATE) for a fixed time 
+    // through the SD card write path and it's checked that the write path keeps up. Time 
+    // is counted in the test: the DMA hands off a block of samples every block time 
+    // while the main loop logs the queued samples, and the main loop only takes time in 
+    // the SD card writes (SD card controller mock write time). Every 
+    // LOG_TEST_STALL_PERIOD one write stalls for LOG_TEST_STALL_TIME (internal 
+    // housekeeping on a real card) and the blocks that arrive during the stall must wait 
+    // in the ADC ring. The test can be run at other sample rates by building the unit 
+    // tests with LOG_SUS_RATE set (see the makefile). 
+
+    uint32_t 
+    block_time = LOG_PERIOD_US * LOG_ADC_BLOCK_SIZE,   // (us) Time to fill a block 
+    num_blocks = LOG_TEST_RATE_TIME * 1000 / block_time, 
+    blocks = CLEAR, 
+    block_due = block_time,                            // (us) Time the next block is full 
+    time = CLEAR,                                      // (us) Test time 
+    write_time; 
+
+    sd_controller_mock_set_write_time(LOG_TEST_WRITE_TIME, 
+                                      LOG_TEST_STALL_TIME * 1000, 
+                                      LOG_TEST_STALL_PERIOD / LOG_STREAM_PERIOD); 
+    log_data_prep(); 
+
+    while (blocks < num_blocks)
+    {
+        // The DMA swaps buffers each time a block is full, even while a write is busy 
+        while ((time >= block_due) && (blocks < num_blocks))
+        {
+            dma_stream.CR ^= DMA_SxCR_CT; 
+            log_data_adc_handler(); 
+            block_due += block_time; 
+            blocks++; 
+        }
+
+        // Log the next queued sample. The main loop waits for the next block if the 
+        // ring is empty. 
+        if (log_get_adc_ring_count())
+        {
+            write_time = sd_controller_mock_get_write_time(); 
+            log_data(); 
+            time += sd_controller_mock_get_write_time() - write_time; 
+        }
+        else 
+        {
+            time = block_due; 
+        }
+    }
+
+    // Keeping up means the main loop works through the blocks from a stall before the 
+    // next one, so it ends with at most the last block still waiting to be logged. 
+    CHECK(log_get_adc_ring_count() <= LOG_ADC_BLOCK_SIZE); 
+
+    while (log_get_adc_ring_count())
+    {
+        log_data(); 
+    }
+
+    // No samples were dropped and every one of them was written (one text line each). 
+    // The most samples queued at once is at least every sample from a stall, which must 
+    // fit in the ring. 
+    UNSIGNED_LONGS_EQUAL(CLEAR, log_get_adc_ring_drops()); 
+    UNSIGNED_LONGS_EQUAL(num_blocks * LOG_ADC_BLOCK_SIZE, sd_controller_mock_get_lines()); 
+    CHECK(log_get_adc_ring_hwm() >= (LOG_TEST_STALL_TIME / LOG_PERIOD)); 
+    CHECK(log_get_adc_ring_hwm() < LOG_ADC_RING_SIZE); 
 }
 
 
@@ -452,7 +914,7 @@ TEST(data_logging_test, calibration_calculation)
     // values recorded from calibration are found through the calibration calculation 
     // function. This average value is what is checked. 
 
-    char sys_param_line[FATFS_MOCK_STR_SIZE]; 
+    char sys_param_line[SD_MOCK_STR_SIZE]; 
 
     int16_t 
     ax[BYTE_2] = { 500, 1000 }, 
@@ -479,9 +941,10 @@ TEST(data_logging_test, calibration_calculation)
 
         while (++index <= LOG_ACCEL_PERIOD)
         {
+            log_data_adc_handler(); 
+
             for (uint8_t j = CLEAR; j < LOG_PERIOD_DIVIDER; j++)
             {
-                log_data_adc_handler(); 
                 log_calibration(); 
             }
         }
@@ -494,12 +957,12 @@ TEST(data_logging_test, calibration_calculation)
 
     // The data must be read in the order that it was written to the SD card. 
     // Logging params 
-    fatfs_controller_mock_get_str(sys_param_line, FATFS_MOCK_STR_SIZE); 
+    sd_controller_mock_get_str(sys_param_line, SD_MOCK_STR_SIZE); 
     // Accelerometer calibration 
-    fatfs_controller_mock_get_str(sys_param_line, FATFS_MOCK_STR_SIZE); 
+    sd_controller_mock_get_str(sys_param_line, SD_MOCK_STR_SIZE); 
     sscanf(sys_param_line, mtbdl_param_accel_rest, &ax_calc, &ay_calc, &az_calc); 
     // Voltage/potentiometer calibration 
-    fatfs_controller_mock_get_str(sys_param_line, FATFS_MOCK_STR_SIZE); 
+    sd_controller_mock_get_str(sys_param_line, SD_MOCK_STR_SIZE); 
 
     LONGS_EQUAL((ax[BYTE_0] + ax[BYTE_1]) / BYTE_2, ax_calc); 
     LONGS_EQUAL((ay[BYTE_0] + ay[BYTE_1]) / BYTE_2, ay_calc); 
@@ -0,0 +1,393 @@
+/**
+ * @file log_format_module_utest.cpp
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Data log text formatting module unit tests 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Notes 
+// - snprintf with the data log formats is used as the reference for every test since 
+//   the formatter output must match it byte for byte. 
+//=======================================================================================
+
+
+//=======================================================================================
+// Includes 
+
+#include <iostream>
+#include <cstdio>
+
+#include "CppUTest/TestHarness.h"
+
+extern "C"
+{
+	// Add your C-only include files here 
+    #include "log_format.h"
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define FORMAT_TEST_STR_LEN 256 
+#define FORMAT_TEST_GUARD 0x5A 
+#define FORMAT_TEST_NUM_AXES 3 
+#define FORMAT_TEST_ARRAY_LEN(a) (sizeof(a) / sizeof(a[0])) 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Test group 
+
+TEST_GROUP(log_format_test)
+{
+    // Global test group variables 
+    char expected[FORMAT_TEST_STR_LEN]; 
+    char actual[FORMAT_TEST_STR_LEN]; 
+
+    // Constructor 
+    void setup()
+    {
+        memset((void *)expected, 0, sizeof(expected)); 
+        memset((void *)actual, FORMAT_TEST_GUARD, sizeof(actual)); 
+    }
+
+    // Destructor 
+    void teardown()
+    {
+        // 
+    }
+}; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Helper functions 
+
+// Check the written text and the returned end pointer 
+void format_check(
+    const char *expected, 
+    const char *actual, 
+    const char *end)
+{
+    STRCMP_EQUAL(expected, actual); 
+    LONGS_EQUAL(strlen(expected), end - actual); 
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Tests 
+
+// Numbers: unsigned 16-bit 
+TEST(log_format_test, log_format_u16_all)
+{
+    char *end; 
+
+    for (uint32_t value = 0; value <= UINT16_MAX; value++)
+    {
+        snprintf(expected, FORMAT_TEST_STR_LEN, "%u", (unsigned int)value); 
+        end = log_format_u16(actual, (uint16_t)value); 
+        format_check(expected, actual, end); 
+    }
+
+    // Nothing is written past the terminator 
+    UNSIGNED_LONGS_EQUAL(FORMAT_TEST_GUARD, (uint8_t)actual[LOG_FORMAT_U16_MAX_LEN + 1]); 
+}
+
+
+// Numbers: signed 16-bit 
+TEST(log_format_test, log_format_i16_all)
+{
+    char *end; 
+
+    for (int32_t value = INT16_MIN; value <= INT16_MAX; value++)
+    {
+        snprintf(expected, FORMAT_TEST_STR_LEN, "%d", (int)value); 
+        end = log_format_i16(actual, (int16_t)value); 
+        format_check(expected, actual, end); 
+    }
+
+    UNSIGNED_LONGS_EQUAL(FORMAT_TEST_GUARD, (uint8_t)actual[LOG_FORMAT_I16_MAX_LEN + 1]); 
+}
+
+
+// Numbers: unsigned 32-bit 
+TEST(log_format_test, log_format_u32_edges)
+{
+    char *end; 
+    uint32_t value = 1; 
+
+    // Every digit count edge 
+    for (uint8_t digits = 1; digits < LOG_FORMAT_U32_MAX_LEN; digits++, value *= 10)
+    {
+        uint32_t edges[] = { value - 1, value, value + 1, value * 9 + (value - 1) }; 
+
+        for (uint8_t i = 0; i < FORMAT_TEST_ARRAY_LEN(edges); i++)
+        {
+            snprintf(expected, FORMAT_TEST_STR_LEN, "%lu", (unsigned long)edges[i]); 
+            end = log_format_u32(actual, edges[i]); 
+            format_check(expected, actual, end); 
+        }
+    }
+
+    // Spread over the whole range 
+    for (uint64_t big = 0; big <= UINT32_MAX; big += 65521)
+    {
+        snprintf(expected, FORMAT_TEST_STR_LEN, "%lu", (unsigned long)big); 
+        end = log_format_u32(actual, (uint32_t)big); 
+        format_check(expected, actual, end); 
+    }
+
+    snprintf(expected, FORMAT_TEST_STR_LEN, "%lu", (unsigned long)UINT32_MAX); 
+    end = log_format_u32(actual, UINT32_MAX); 
+    format_check(expected, actual, end); 
+
+    UNSIGNED_LONGS_EQUAL(FORMAT_TEST_GUARD, (uint8_t)actual[LOG_FORMAT_U32_MAX_LEN + 1]); 
+}
+
+
+// Numbers: unsigned 8-bit 
+TEST(log_format_test, log_format_u8_all)
+{
+    char *end; 
+
+    for (uint16_t value = 0; value <= UINT8_MAX; value++)
+    {
+        snprintf(expected, FORMAT_TEST_STR_LEN, "%u", (unsigned int)value); 
+        end = log_format_u8(actual, (uint8_t)value); 
+        format_check(expected, actual, end); 
+    }
+}
+
+
+// Strings and characters 
+TEST(log_format_test, log_format_str_char)
+{
+    char *end; 
+
+    // Copying stops at the end of the string 
+    end = log_format_str(actual, "4717.11321", FORMAT_TEST_STR_LEN); 
+    format_check("4717.11321", actual, end); 
+
+    // or at the max length 
+    end = log_format_str(actual, "4717.11321", 4); 
+    format_check("4717", actual, end); 
+
+    end = log_format_str(actual, "", FORMAT_TEST_STR_LEN); 
+    format_check("", actual, end); 
+
+    // A '\0' character is not written 
+    end = log_format_char(log_format_char(actual, 'N'), '\0'); 
+    format_check("N", actual, end); 
+}
+
+
+// Numbers: zero padded and thousandths 
+TEST(log_format_test, log_format_pad_milli)
+{
+    const uint32_t values[] = { 0, 7, 99, 100, 999, 1000, 12345, 2000000, UINT32_MAX }; 
+    char *end; 
+
+    for (uint8_t i = 0; i < FORMAT_TEST_ARRAY_LEN(values); i++)
+    {
+        for (uint8_t width = 0; width <= LOG_FORMAT_U32_MAX_LEN; width++)
+        {
+            snprintf(expected, FORMAT_TEST_STR_LEN, "%0*lu", width, (unsigned long)values[i]); 
+            end = log_format_u32_pad(actual, values[i], width); 
+            format_check(expected, actual, end); 
+        }
+
+        snprintf(expected, FORMAT_TEST_STR_LEN, "%lu.%03lu", 
+                 (unsigned long)(values[i] / 1000), (unsigned long)(values[i] % 1000)); 
+        end = log_format_milli(actual, values[i]); 
+        format_check(expected, actual, end); 
+    }
+
+    // Ground speed the way the M8Q gives it in the PUBX POSITION message (km/h) 
+    end = log_format_milli(actual, LOG_FORMAT_KMH_MILLI(2)); 
+    format_check("0.007", actual, end); 
+    end = log_format_milli(actual, LOG_FORMAT_KMH_MILLI(5432)); 
+    format_check("19.555", actual, end); 
+}
+
+
+// GPS coordinates 
+TEST(log_format_test, log_format_coord)
+{
+    const struct { int32_t value; uint8_t deg_len; const char *text; } coords[] = 
+    {
+        { 472851886,   LOG_FORMAT_LAT_DEG_LEN, "4717.11132N" }, 
+        { 492827291,   LOG_FORMAT_LAT_DEG_LEN, "4916.96375N" }, 
+        { -338688197,  LOG_FORMAT_LAT_DEG_LEN, "3352.12918S" }, 
+        { 0,           LOG_FORMAT_LAT_DEG_LEN, "0000.00000N" }, 
+        { 9999999,     LOG_FORMAT_LAT_DEG_LEN, "0059.99999N" }, 
+        { -900000000,  LOG_FORMAT_LAT_DEG_LEN, "9000.00000S" }, 
+        { 85652530,    LOG_FORMAT_LON_DEG_LEN, "00833.91518E" }, 
+        { -1231207570, LOG_FORMAT_LON_DEG_LEN, "12307.24542W" }, 
+        { 1800000000,  LOG_FORMAT_LON_DEG_LEN, "18000.00000E" }, 
+        { -1,          LOG_FORMAT_LON_DEG_LEN, "00000.00001W" }
+    }; 
+    char *end; 
+
+    for (uint8_t i = 0; i < FORMAT_TEST_ARRAY_LEN(coords); i++)
+    {
+        end = log_format_coord(actual, coords[i].value, coords[i].deg_len, 
+                               (coords[i].deg_len == LOG_FORMAT_LAT_DEG_LEN) ? 'N' : 'E', 
+                               (coords[i].deg_len == LOG_FORMAT_LAT_DEG_LEN) ? 'S' : 'W'); 
+        format_check(coords[i].text, actual, end); 
+    }
+
+    // The most negative value doesn't overflow 
+    end = log_format_coord(actual, INT32_MIN, LOG_FORMAT_LON_DEG_LEN, 'E', 'W'); 
+    format_check("21444.90189W", actual, end); 
+    UNSIGNED_LONGS_EQUAL(FORMAT_TEST_GUARD, (uint8_t)actual[LOG_FORMAT_COORD_MAX_LEN + 1]); 
+}
+
+
+// Lines: every data log line format 
+TEST(log_format_test, log_format_lines)
+{
+    // Each line is checked with edge values and the GPS strings the M8Q gives. The 
+    // first four "%s" of each format are the lines from earlier intervals which are 
+    // written separately by the formatter so they're left empty here. 
+
+    const uint8_t trailmarks[] = { 0, 1 }; 
+    const uint16_t adc[] = { 0, 9, 10, 99, 100, 4095, UINT16_MAX }; 
+    const int16_t accel[] = { INT16_MIN, -450, -1, 0, 60, INT16_MAX }; 
+    const uint16_t revs[] = { 0, 7, 80, UINT8_MAX, 1000, UINT16_MAX }; 
+    const char sog[] = "0.007", lat[] = "4717.11321", lon[] = "00833.91518"; 
+    char *line; 
+
+    for (uint8_t t = 0; t < sizeof(trailmarks); t++)
+    {
+        for (uint8_t a = 0; a < FORMAT_TEST_ARRAY_LEN(adc); a++)
+        {
+            uint16_t fork = adc[a], shock = adc[(a + 3) % FORMAT_TEST_ARRAY_LEN(adc)]; 
+
+            // ADC only 
+            snprintf(expected, FORMAT_TEST_STR_LEN, mtbdl_data_log_default, 
+                     trailmarks[t], fork, shock); 
+            line = log_format_line_start(actual, trailmarks[t], fork, shock); 
+            line = log_format_line_end(line, LOG_FORMAT_LINE_FIELDS); 
+            format_check(expected, actual, line); 
+
+            snprintf(expected, FORMAT_TEST_STR_LEN, mtbdl_data_log_adc, 
+                     "", "", "", "", trailmarks[t], fork, shock); 
+            STRCMP_EQUAL(expected, actual); 
+
+            // GPS 
+            snprintf(expected, FORMAT_TEST_STR_LEN, mtbdl_data_log_gps, 
+                     "", "", "", "", trailmarks[t], fork, shock, sog, lat, 'N', lon, 'E'); 
+            line = log_format_line_start(actual, trailmarks[t], fork, shock); 
+            line = log_format_line_blank(line, LOG_FORMAT_GPS_FIELD); 
+            line = log_format_sep(line); 
+            line = log_format_str(line, sog, FORMAT_TEST_STR_LEN); 
+            line = log_format_sep(line); 
+            line = log_format_str(line, lat, FORMAT_TEST_STR_LEN); 
+            line = log_format_char(line, 'N'); 
+            line = log_format_sep(line); 
+            line = log_format_str(line, lon, FORMAT_TEST_STR_LEN); 
+            line = log_format_char(line, 'E'); 
+            line = log_format_line_end(line, 
+                LOG_FORMAT_LINE_FIELDS - LOG_FORMAT_GPS_FIELD - LOG_FORMAT_GPS_FIELDS); 
+            format_check(expected, actual, line); 
+
+            // Accelerometer 
+            for (uint8_t i = 0; i < FORMAT_TEST_ARRAY_LEN(accel); i++)
+            {
+                int16_t
+                x = accel[i], 
+                y = accel[(i + 1) % FORMAT_TEST_ARRAY_LEN(accel)], 
+                z = accel[(i + 2) % FORMAT_TEST_ARRAY_LEN(accel)]; 
+
+                snprintf(expected, FORMAT_TEST_STR_LEN, mtbdl_data_log_accel, 
+                         "", "", "", "", trailmarks[t], fork, shock, x, y, z); 
+                line = log_format_line_start(actual, trailmarks[t], fork, shock); 
+                line = log_format_line_blank(line, LOG_FORMAT_ACCEL_FIELD); 
+                line = log_format_sep(line); 
+                line = log_format_i16(line, x); 
+                line = log_format_sep(line); 
+                line = log_format_i16(line, y); 
+                line = log_format_sep(line); 
+                line = log_format_i16(line, z); 
+                line = log_format_line_end(line, LOG_FORMAT_LINE_FIELDS - LOG_FORMAT_ACCEL_FIELD - 
+                                                 FORMAT_TEST_NUM_AXES); 
+                format_check(expected, actual, line); 
+            }
+
+            // Wheel speed (short/long window revolutions) 
+            for (uint8_t i = 0; i < FORMAT_TEST_ARRAY_LEN(revs); i++)
+            {
+                uint16_t
+                rev_short = revs[i], 
+                rev_long = revs[(i + 1) % FORMAT_TEST_ARRAY_LEN(revs)]; 
+
+                snprintf(expected, FORMAT_TEST_STR_LEN, mtbdl_data_log_speed, 
+                         "", "", "", "", trailmarks[t], fork, shock, rev_short, rev_long); 
+                line = log_format_line_start(actual, trailmarks[t], fork, shock); 
+                line = log_format_line_blank(line, LOG_FORMAT_SPEED_FIELD); 
+                line = log_format_sep(line); 
+                line = log_format_u16(line, rev_short); 
+                line = log_format_char(line, '/'); 
+                line = log_format_u16(line, rev_long); 
+                line = log_format_line_end(line, LOG_FORMAT_LINE_FIELDS - 1); 
+                format_check(expected, actual, line); 
+            }
+
+            // Wheel revolution period (input capture) 
+            snprintf(expected, FORMAT_TEST_STR_LEN, mtbdl_data_log_rev_period, 
+                     "", "", "", "", trailmarks[t], fork, shock, 1234567u); 
+            line = log_format_line_start(actual, trailmarks[t], fork, shock); 
+            line = log_format_line_blank(line, LOG_FORMAT_SPEED_FIELD); 
+            line = log_format_sep(line); 
+            line = log_format_u32(line, 1234567); 
+            line = log_format_line_end(line, LOG_FORMAT_LINE_FIELDS - 1); 
+            format_check(expected, actual, line); 
+        }
+    }
+}
+
+
+// Lines: a full logging period 
+TEST(log_format_test, log_format_period)
+{
+    // Lines are appended one after another the same way the data logging module builds 
+    // a logging period, which snprintf did in one call with the earlier lines as strings. 
+
+    char earlier[4][FORMAT_TEST_STR_LEN]; 
+    char *line = actual; 
+
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        snprintf(earlier[i], FORMAT_TEST_STR_LEN, mtbdl_data_log_default, 
+                 (unsigned int)(i & 1), 1000u + i, 2000u + i); 
+        line = log_format_line_start(line, (uint8_t)(i & 1), 1000 + i, 2000 + i); 
+        line = log_format_line_end(line, LOG_FORMAT_LINE_FIELDS); 
+    }
+
+    snprintf(expected, FORMAT_TEST_STR_LEN, mtbdl_data_log_speed, 
+             earlier[0], earlier[1], earlier[2], earlier[3], 0u, 1004u, 2004u, 12u, 45u); 
+    line = log_format_line_start(line, 0, 1004, 2004); 
+    line = log_format_sep(line); 
+    line = log_format_u16(line, 12); 
+    line = log_format_char(line, '/'); 
+    line = log_format_u16(line, 45); 
+    line = log_format_line_end(line, LOG_FORMAT_LINE_FIELDS - 1); 
+    format_check(expected, actual, line); 
+}
+
+//=======================================================================================
@@ -0,0 +1,317 @@
+/**
+ * @file log_pack_module_utest.cpp
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Packed ADC sample module unit tests 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Notes 
+// - Blocks are packed then unpacked and the samples compared since the packed data 
+//   only has to be read back by the same module. A fixed seed keeps failures 
+//   repeatable. 
+// - The compression test models suspension travel as a few slow strokes with ADC noise 
+//   at the default sample rate and compares it to the text log lines of the same data. 
+//=======================================================================================
+
+
+//=======================================================================================
+// Includes 
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+
+#include "CppUTest/TestHarness.h"
+
+extern "C"
+{
+	// Add your C-only include files here 
+    #include "log_pack.h"
+    #include "string_config.h"
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define PACK_TEST_SEED 0x4D544244 
+#define PACK_TEST_BLOCK_LEN 5            // Samples per block at the default sample rate 
+#define PACK_TEST_KEY_PERIOD 4 
+#define PACK_TEST_NUM_BLOCKS 2000 
+#define PACK_TEST_ADC_MAX 4095           // 12-bit ADC samples (oversampled) 
+#define PACK_TEST_SAMPLE_RATE 100.0      // (Hz) 
+#define PACK_TEST_STR_LEN 256 
+#define PACK_TEST_MIN_RATIO 4 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Test group 
+
+TEST_GROUP(log_pack_test)
+{
+    // Global test group variables 
+    log_pack_t pack; 
+    log_unpack_t unpack; 
+    uint8_t block[LOG_PACK_MAX_RECORD_LEN]; 
+    uint16_t samples[LOG_PACK_MAX_SAMPLES][LOG_REC_PACK_CHANNELS]; 
+
+    // Constructor 
+    void setup()
+    {
+        srand(PACK_TEST_SEED); 
+        log_pack_init(&pack, PACK_TEST_KEY_PERIOD); 
+        log_unpack_init(&unpack); 
+    }
+
+    // Destructor 
+    void teardown()
+    {
+        // 
+    }
+}; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Helper functions 
+
+// Unpack a block written by log_pack_block 
+int pack_unpack(
+    log_unpack_t *unpack, 
+    const uint8_t *block, 
+    uint16_t size, 
+    uint16_t (*samples)[LOG_REC_PACK_CHANNELS])
+{
+    log_rec_adc_pack_t record; 
+
+    memcpy((void *)&record, (void *)block, sizeof(record)); 
+    LONGS_EQUAL(size, sizeof(record) + record.size); 
+
+    return log_unpack_block(unpack, &record, &block[sizeof(record)], samples); 
+}
+
+
+// Pack a block of samples then check they unpack to the same values 
+void pack_check_block(
+    log_pack_t *pack, 
+    log_unpack_t *unpack, 
+    const uint16_t (*in)[LOG_REC_PACK_CHANNELS], 
+    uint8_t count)
+{
+    uint8_t block[LOG_PACK_MAX_RECORD_LEN]; 
+    uint16_t out[LOG_PACK_MAX_SAMPLES][LOG_REC_PACK_CHANNELS]; 
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        log_pack_sample(pack, in[i], 0); 
+    }
+
+    uint16_t size = log_pack_block(pack, block); 
+    CHECK(size <= LOG_PACK_MAX_RECORD_LEN); 
+    LONGS_EQUAL(count, pack_unpack(unpack, block, size, out)); 
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        for (uint8_t j = 0; j < LOG_REC_PACK_CHANNELS; j++)
+        {
+            UNSIGNED_LONGS_EQUAL(in[i][j], out[i][j]); 
+        }
+    }
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Tests 
+
+// Value encoding: zig-zag 
+TEST(log_pack_test, log_pack_zigzag)
+{
+    const int32_t values[] = { 0, -1, 1, -2, 2, -65535, 65535, INT32_MIN, INT32_MAX }; 
+    const uint32_t encoded[] = { 0, 1, 2, 3, 4, 131069, 131070, UINT32_MAX, UINT32_MAX - 1 }; 
+
+    for (uint8_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    {
+        UNSIGNED_LONGS_EQUAL(encoded[i], log_pack_zigzag(values[i])); 
+        LONGS_EQUAL(values[i], log_unpack_zigzag(encoded[i])); 
+    }
+}
+
+
+// Value encoding: varints 
+TEST(log_pack_test, log_pack_varint)
+{
+    const uint32_t values[] = { 0, 127, 128, 16383, 16384, 131070, UINT32_MAX }; 
+    const uint8_t lengths[] = { 1, 1, 2, 2, 3, 3, LOG_PACK_VARINT_MAX_LEN }; 
+    uint8_t buff[LOG_PACK_VARINT_MAX_LEN + 1]; 
+    uint32_t value; 
+
+    for (uint8_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    {
+        uint8_t *end = log_pack_varint(buff, values[i]); 
+        LONGS_EQUAL(lengths[i], end - buff); 
+        POINTERS_EQUAL(end, log_unpack_varint(buff, end, &value)); 
+        UNSIGNED_LONGS_EQUAL(values[i], value); 
+
+        // An incomplete number is not read 
+        POINTERS_EQUAL(NULL, log_unpack_varint(buff, end - 1, &value)); 
+    }
+
+    // Neither is a number that's too long 
+    memset((void *)buff, 0xFF, sizeof(buff)); 
+    POINTERS_EQUAL(NULL, log_unpack_varint(buff, buff + sizeof(buff), &value)); 
+}
+
+
+// Blocks: random walk and full scale steps 
+TEST(log_pack_test, log_pack_round_trip)
+{
+    uint16_t in[LOG_PACK_MAX_SAMPLES][LOG_REC_PACK_CHANNELS]; 
+    int32_t walk[LOG_REC_PACK_CHANNELS] = { 2048, 1024 }; 
+
+    for (uint16_t b = 0; b < PACK_TEST_NUM_BLOCKS; b++)
+    {
+        uint8_t count = (uint8_t)(1 + (rand() % LOG_PACK_MAX_SAMPLES)); 
+
+        for (uint8_t i = 0; i < count; i++)
+        {
+            for (uint8_t j = 0; j < LOG_REC_PACK_CHANNELS; j++)
+            {
+                walk[j] += (rand() % 201) - 100; 
+                walk[j] = (walk[j] < 0) ? 0 : (walk[j] > UINT16_MAX) ? UINT16_MAX : walk[j]; 
+                in[i][j] = (uint16_t)walk[j]; 
+            }
+        }
+
+        pack_check_block(&pack, &unpack, in, count); 
+    }
+
+    // Largest changes in both directions. These are the largest packed values. 
+    for (uint8_t i = 0; i < LOG_PACK_MAX_SAMPLES; i++)
+    {
+        in[i][0] = (i & 1) ? UINT16_MAX : 0; 
+        in[i][1] = (i & 1) ? 0 : UINT16_MAX; 
+    }
+
+    for (uint8_t b = 0; b < PACK_TEST_KEY_PERIOD; b++)
+    {
+        pack_check_block(&pack, &unpack, in, LOG_PACK_MAX_SAMPLES); 
+    }
+}
+
+
+// Blocks: keyframes, sample index and trail marker 
+TEST(log_pack_test, log_pack_keyframes)
+{
+    const uint16_t sample[LOG_REC_PACK_CHANNELS] = { 1000, 2000 }; 
+    log_rec_adc_pack_t record; 
+
+    // Nothing is written for an empty block 
+    LONGS_EQUAL(0, log_pack_block(&pack, block)); 
+
+    for (uint8_t b = 0; b < (2 * PACK_TEST_KEY_PERIOD); b++)
+    {
+        for (uint8_t i = 0; i < PACK_TEST_BLOCK_LEN; i++)
+        {
+            log_pack_sample(&pack, sample, (i == b % PACK_TEST_BLOCK_LEN)); 
+        }
+
+        uint16_t size = log_pack_block(&pack, block); 
+        memcpy((void *)&record, (void *)block, sizeof(record)); 
+
+        UNSIGNED_LONGS_EQUAL((b % PACK_TEST_KEY_PERIOD) ? LOG_REC_ADC_DELTA : LOG_REC_ADC_KEY, 
+                             record.tag); 
+        UNSIGNED_LONGS_EQUAL(PACK_TEST_BLOCK_LEN, record.count); 
+        UNSIGNED_LONGS_EQUAL(b % PACK_TEST_BLOCK_LEN, record.trailmark); 
+
+        // Keyframes can be read without the blocks before them 
+        if (record.tag == LOG_REC_ADC_KEY)
+        {
+            log_unpack_init(&unpack); 
+        }
+
+        LONGS_EQUAL(PACK_TEST_BLOCK_LEN, pack_unpack(&unpack, block, size, samples)); 
+        UNSIGNED_LONGS_EQUAL((b + 1) * PACK_TEST_BLOCK_LEN, unpack.index); 
+        UNSIGNED_LONGS_EQUAL(sample[0], samples[PACK_TEST_BLOCK_LEN - 1][0]); 
+        UNSIGNED_LONGS_EQUAL(sample[1], samples[PACK_TEST_BLOCK_LEN - 1][1]); 
+    }
+
+    // No trail marker 
+    log_pack_sample(&pack, sample, 0); 
+    log_pack_block(&pack, block); 
+    memcpy((void *)&record, (void *)block, sizeof(record)); 
+    UNSIGNED_LONGS_EQUAL(LOG_REC_NO_TRAILMARK, record.trailmark); 
+}
+
+
+// Blocks: delta blocks can't be read before a keyframe 
+TEST(log_pack_test, log_pack_no_keyframe)
+{
+    const uint16_t sample[LOG_REC_PACK_CHANNELS] = { 1000, 2000 }; 
+
+    log_pack_sample(&pack, sample, 0); 
+    log_pack_block(&pack, block); 
+
+    log_pack_sample(&pack, sample, 0); 
+    uint16_t size = log_pack_block(&pack, block); 
+
+    LONGS_EQUAL(-1, pack_unpack(&unpack, block, size, samples)); 
+
+    // A block with bad data is rejected too 
+    log_pack_init(&pack, PACK_TEST_KEY_PERIOD); 
+    log_pack_sample(&pack, sample, 0); 
+    size = log_pack_block(&pack, block); 
+    block[size - 1] |= 0x80; 
+
+    LONGS_EQUAL(-1, pack_unpack(&unpack, block, size, samples)); 
+}
+
+
+// Compression: packed blocks compared to text log lines 
+TEST(log_pack_test, log_pack_compression)
+{
+    char line[PACK_TEST_STR_LEN]; 
+    uint32_t text_size = 0, pack_size = 0; 
+    uint16_t sample[LOG_REC_PACK_CHANNELS]; 
+
+    log_pack_init(&pack, 20); 
+
+    for (uint32_t n = 0; n < (PACK_TEST_NUM_BLOCKS * PACK_TEST_BLOCK_LEN); n++)
+    {
+        double t = n / PACK_TEST_SAMPLE_RATE; 
+        double fork = 1800.0 + 1200.0 * sin(2.0 * M_PI * 1.5 * t) * sin(2.0 * M_PI * 0.1 * t); 
+        double shock = 1200.0 + 800.0 * sin(2.0 * M_PI * 1.2 * t + 0.5); 
+
+        sample[0] = (uint16_t)(fork + (rand() % 9) - 4); 
+        sample[1] = (uint16_t)(shock + (rand() % 9) - 4); 
+        CHECK((sample[0] <= PACK_TEST_ADC_MAX) && (sample[1] <= PACK_TEST_ADC_MAX)); 
+
+        text_size += snprintf(line, PACK_TEST_STR_LEN, mtbdl_data_log_default, 
+                              0u, sample[0], sample[1]); 
+        log_pack_sample(&pack, sample, 0); 
+
+        if ((n % PACK_TEST_BLOCK_LEN) == (PACK_TEST_BLOCK_LEN - 1))
+        {
+            pack_size += log_pack_block(&pack, block); 
+        }
+    }
+
+    CHECK(text_size >= (PACK_TEST_MIN_RATIO * pack_size)); 
+}
+
+//=======================================================================================
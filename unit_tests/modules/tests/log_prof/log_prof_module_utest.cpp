@@ -0,0 +1,133 @@
+/**
+ * @file log_prof_module_utest.cpp
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Execution time profiling module unit tests 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include <iostream>
+
+#include "CppUTest/TestHarness.h"
+
+extern "C"
+{
+	// Add your C-only include files here 
+    #include "log_prof.h"
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define PROF_TEST_STR_LEN 256 
+#define PROF_TEST_US(us) ((uint32_t)(us) * LOG_PROF_CLOCK_MHZ) 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Test group 
+
+TEST_GROUP(log_prof_test)
+{
+    // Global test group variables 
+    char line[PROF_TEST_STR_LEN]; 
+
+    // Constructor 
+    void setup()
+    {
+        log_prof_reset(); 
+    }
+
+    // Destructor 
+    void teardown()
+    {
+        // 
+    }
+}; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Tests 
+
+// Histogram bins: bin edges 
+TEST(log_prof_test, log_prof_bin_edges)
+{
+    UNSIGNED_LONGS_EQUAL(0, log_prof_bin(0)); 
+    UNSIGNED_LONGS_EQUAL(0, log_prof_bin(PROF_TEST_US(1) - 1)); 
+    UNSIGNED_LONGS_EQUAL(1, log_prof_bin(PROF_TEST_US(1))); 
+
+    for (uint8_t bin = 1; bin < (LOG_PROF_NUM_BINS - 1); bin++)
+    {
+        uint32_t edge = PROF_TEST_US(1UL << (bin - 1)); 
+        UNSIGNED_LONGS_EQUAL(bin, log_prof_bin(edge)); 
+        UNSIGNED_LONGS_EQUAL(bin, log_prof_bin(PROF_TEST_US(1UL << bin) - 1)); 
+    }
+
+    // Longer times all go in the last bin 
+    UNSIGNED_LONGS_EQUAL(LOG_PROF_NUM_BINS - 1, log_prof_bin(PROF_TEST_US(1UL << 14))); 
+    UNSIGNED_LONGS_EQUAL(LOG_PROF_NUM_BINS - 1, log_prof_bin(UINT32_MAX)); 
+}
+
+
+// Histograms: recording and reset 
+TEST(log_prof_test, log_prof_record_reset)
+{
+    const log_prof_hist_t *hist = log_prof_get(LOG_PROF_GPS); 
+
+    log_prof_record(LOG_PROF_GPS, PROF_TEST_US(3)); 
+    log_prof_record(LOG_PROF_GPS, PROF_TEST_US(3)); 
+    log_prof_record(LOG_PROF_GPS, PROF_TEST_US(12000)); 
+    log_prof_record(LOG_PROF_GPS, 10); 
+
+    UNSIGNED_LONGS_EQUAL(4, hist->count); 
+    UNSIGNED_LONGS_EQUAL(PROF_TEST_US(12000), hist->max); 
+    UNSIGNED_LONGS_EQUAL(1, hist->bins[0]); 
+    UNSIGNED_LONGS_EQUAL(2, hist->bins[2]); 
+    UNSIGNED_LONGS_EQUAL(1, hist->bins[14]); 
+
+    // Other histograms are not changed 
+    UNSIGNED_LONGS_EQUAL(0, log_prof_get(LOG_PROF_STANDARD)->count); 
+    UNSIGNED_LONGS_EQUAL(0, log_prof_get(LOG_PROF_M8Q)->count); 
+
+    // Invalid histograms are ignored 
+    log_prof_record(LOG_PROF_NUM, PROF_TEST_US(1)); 
+    POINTERS_EQUAL(NULL, log_prof_get(LOG_PROF_NUM)); 
+
+    log_prof_reset(); 
+    UNSIGNED_LONGS_EQUAL(0, hist->count); 
+    UNSIGNED_LONGS_EQUAL(0, hist->max); 
+    UNSIGNED_LONGS_EQUAL(0, hist->bins[2]); 
+}
+
+
+// Log footer: histogram lines 
+TEST(log_prof_test, log_prof_format_line)
+{
+    log_prof_record(LOG_PROF_SD_PUTS, PROF_TEST_US(1)); 
+    log_prof_record(LOG_PROF_SD_PUTS, PROF_TEST_US(20000)); 
+
+    uint16_t len = log_prof_format(line, PROF_TEST_STR_LEN, LOG_PROF_SD_PUTS); 
+    STRCMP_EQUAL("sd_puts, 2, 20000, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1\r\n", line); 
+    UNSIGNED_LONGS_EQUAL(strlen(line), len); 
+
+    // Nothing is written if the line doesn't fit or the histogram is invalid 
+    UNSIGNED_LONGS_EQUAL(0, log_prof_format(line, len, LOG_PROF_SD_PUTS)); 
+    UNSIGNED_LONGS_EQUAL(0, log_prof_format(line, PROF_TEST_STR_LEN, LOG_PROF_NUM)); 
+}
+
+//=======================================================================================
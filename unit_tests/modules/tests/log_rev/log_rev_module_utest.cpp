@@ -0,0 +1,211 @@
+/**
+ * @file log_rev_module_utest.cpp
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Wheel revolution capture module unit tests 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include <iostream>
+
+#include "CppUTest/TestHarness.h"
+
+extern "C"
+{
+	// Add your C-only include files here 
+    #include "log_rev.h"
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define REV_TEST_SIZE 8 
+#define REV_TEST_PERIOD 500000           // (us) Revolution period used by the tests 
+#define REV_TEST_MAX_PERIODS 2           // Revolution periods read per update 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Test group 
+
+TEST_GROUP(log_rev_test)
+{
+    // Global test group variables 
+    log_rev_t rev; 
+    uint32_t capture[REV_TEST_SIZE]; 
+    uint16_t head; 
+
+    // Constructor 
+    void setup()
+    {
+        memset((void *)capture, 0, sizeof(capture)); 
+        head = 0; 
+        log_rev_init(&rev, capture, REV_TEST_SIZE); 
+    }
+
+    // Destructor 
+    void teardown()
+    {
+        // 
+    }
+
+    // Capture a revolution the way the DMA would 
+    void rev_capture(uint32_t time)
+    {
+        capture[head] = time; 
+        head = (uint16_t)((head + 1) % REV_TEST_SIZE); 
+    }
+}; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Tests 
+
+// Revolution period: no period until two edges are seen 
+TEST(log_rev_test, log_rev_first_edges)
+{
+    UNSIGNED_LONGS_EQUAL(0, log_rev_update(&rev, head, NULL, 0)); 
+    UNSIGNED_LONGS_EQUAL(0, log_rev_period(&rev, 1000)); 
+
+    rev_capture(1000); 
+    UNSIGNED_LONGS_EQUAL(0, log_rev_update(&rev, head, NULL, 0)); 
+    UNSIGNED_LONGS_EQUAL(0, log_rev_period(&rev, 2000)); 
+
+    rev_capture(1000 + REV_TEST_PERIOD); 
+    UNSIGNED_LONGS_EQUAL(1, log_rev_update(&rev, head, NULL, 0)); 
+    UNSIGNED_LONGS_EQUAL(REV_TEST_PERIOD, log_rev_period(&rev, 1000 + REV_TEST_PERIOD)); 
+}
+
+
+// Revolution period: several edges per update and buffer wrap 
+TEST(log_rev_test, log_rev_many_edges)
+{
+    uint32_t time = 0; 
+
+    rev_capture(time); 
+
+    // Three updates of 3 edges go around the buffer more than once 
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            time += REV_TEST_PERIOD + (uint32_t)j * 1000; 
+            rev_capture(time); 
+        }
+
+        UNSIGNED_LONGS_EQUAL(3, log_rev_update(&rev, head, NULL, 0)); 
+        UNSIGNED_LONGS_EQUAL(REV_TEST_PERIOD + 2000, log_rev_period(&rev, time)); 
+    }
+
+    // Nothing new 
+    UNSIGNED_LONGS_EQUAL(0, log_rev_update(&rev, head, NULL, 0)); 
+}
+
+
+// Revolution period: the period of every revolution is read 
+TEST(log_rev_test, log_rev_periods)
+{
+    uint32_t periods[REV_TEST_MAX_PERIODS + 1]; 
+    uint32_t time = 0; 
+
+    memset((void *)periods, 0, sizeof(periods)); 
+    rev_capture(time); 
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        time += REV_TEST_PERIOD + (uint32_t)i * 1000; 
+        rev_capture(time); 
+    }
+
+    // The read stops once the buffer is full and the rest are read next update 
+    UNSIGNED_LONGS_EQUAL(REV_TEST_MAX_PERIODS, 
+                         log_rev_update(&rev, head, periods, REV_TEST_MAX_PERIODS)); 
+    UNSIGNED_LONGS_EQUAL(REV_TEST_PERIOD, periods[0]); 
+    UNSIGNED_LONGS_EQUAL(REV_TEST_PERIOD + 1000, periods[1]); 
+    UNSIGNED_LONGS_EQUAL(0, periods[2]); 
+
+    UNSIGNED_LONGS_EQUAL(1, log_rev_update(&rev, head, periods, REV_TEST_MAX_PERIODS)); 
+    UNSIGNED_LONGS_EQUAL(REV_TEST_PERIOD + 2000, periods[0]); 
+    UNSIGNED_LONGS_EQUAL(REV_TEST_PERIOD + 2000, log_rev_period(&rev, time)); 
+
+    // An edge after a stop has no period 
+    time += LOG_REV_STOP_TIME; 
+    rev_capture(time); 
+    UNSIGNED_LONGS_EQUAL(0, log_rev_update(&rev, head, periods, REV_TEST_MAX_PERIODS)); 
+}
+
+
+// Revolution period: slowing down and stopping between edges 
+TEST(log_rev_test, log_rev_slowing_stopped)
+{
+    rev_capture(0); 
+    rev_capture(REV_TEST_PERIOD); 
+    log_rev_update(&rev, head, NULL, 0); 
+
+    // The period holds until the time since the last edge is longer than it 
+    UNSIGNED_LONGS_EQUAL(REV_TEST_PERIOD, log_rev_period(&rev, REV_TEST_PERIOD + 1000)); 
+    UNSIGNED_LONGS_EQUAL(REV_TEST_PERIOD + 1000, 
+                         log_rev_period(&rev, 2 * REV_TEST_PERIOD + 1000)); 
+
+    // Stopped 
+    UNSIGNED_LONGS_EQUAL(0, log_rev_period(&rev, REV_TEST_PERIOD + LOG_REV_STOP_TIME)); 
+
+    // The first edge after a stop only restarts the period 
+    uint32_t time = 2 * REV_TEST_PERIOD + LOG_REV_STOP_TIME; 
+    rev_capture(time); 
+    UNSIGNED_LONGS_EQUAL(0, log_rev_update(&rev, head, NULL, 0)); 
+    UNSIGNED_LONGS_EQUAL(0, log_rev_period(&rev, time)); 
+
+    rev_capture(time + REV_TEST_PERIOD); 
+    UNSIGNED_LONGS_EQUAL(1, log_rev_update(&rev, head, NULL, 0)); 
+    UNSIGNED_LONGS_EQUAL(REV_TEST_PERIOD, log_rev_period(&rev, time + REV_TEST_PERIOD)); 
+}
+
+
+// Revolution period: sensor bounce and timer wrap 
+TEST(log_rev_test, log_rev_bounce_wrap)
+{
+    uint32_t time = UINT32_MAX - (REV_TEST_PERIOD / 2); 
+
+    rev_capture(time); 
+    rev_capture(time + (LOG_REV_MIN_PERIOD - 1)); 
+    rev_capture(time + REV_TEST_PERIOD); 
+
+    // The bounce is ignored and the period is right across the timer wrap 
+    UNSIGNED_LONGS_EQUAL(1, log_rev_update(&rev, head, NULL, 0)); 
+    UNSIGNED_LONGS_EQUAL(REV_TEST_PERIOD, log_rev_period(&rev, time + REV_TEST_PERIOD)); 
+}
+
+
+// Revolution period: reset skips old edges 
+TEST(log_rev_test, log_rev_reset_skip)
+{
+    rev_capture(0); 
+    rev_capture(REV_TEST_PERIOD); 
+    log_rev_reset(&rev, head); 
+
+    UNSIGNED_LONGS_EQUAL(0, log_rev_update(&rev, head, NULL, 0)); 
+    UNSIGNED_LONGS_EQUAL(0, log_rev_period(&rev, REV_TEST_PERIOD)); 
+
+    rev_capture(2 * REV_TEST_PERIOD); 
+    rev_capture(3 * REV_TEST_PERIOD); 
+    UNSIGNED_LONGS_EQUAL(1, log_rev_update(&rev, head, NULL, 0)); 
+    UNSIGNED_LONGS_EQUAL(REV_TEST_PERIOD, log_rev_period(&rev, 3 * REV_TEST_PERIOD)); 
+}
+
+//=======================================================================================
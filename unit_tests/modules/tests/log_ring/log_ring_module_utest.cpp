@@ -0,0 +1,273 @@
+/**
+ * @file log_ring_module_utest.cpp
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Sample ring module unit tests 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Notes 
+// - The randomized tests model the ISR (producer) and log_data (consumer) as a random 
+//   sequence of pushes and pops. Each push/pop is atomic with respect to the other side 
+//   as far as the indexes are concerned so this covers every order the two can 
+//   interleave in on a single core. A fixed seed keeps failures repeatable. 
+//=======================================================================================
+
+
+//=======================================================================================
+// Includes 
+
+#include <iostream>
+#include <cstdlib>
+
+#include "CppUTest/TestHarness.h"
+
+extern "C"
+{
+	// Add your C-only include files here 
+    #include "log_ring.h"
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define RING_TEST_SIZE 16 
+#define RING_TEST_ITEM_LEN 3 
+#define RING_TEST_SEED 0x4D544244 
+#define RING_TEST_NUM_OPS 100000 
+#define RING_TEST_NUM_RUNS 8 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Test group 
+
+TEST_GROUP(log_ring_test)
+{
+    // Global test group variables 
+    log_ring_t ring; 
+    uint16_t ring_buff[RING_TEST_SIZE][RING_TEST_ITEM_LEN]; 
+
+    // Constructor 
+    void setup()
+    {
+        log_ring_init(&ring, (void *)ring_buff, sizeof(ring_buff[0]), RING_TEST_SIZE); 
+    }
+
+    // Destructor 
+    void teardown()
+    {
+        // 
+    }
+}; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Helper functions 
+
+// Fill an item with values derived from a sequence number 
+void ring_item_make(uint16_t *item, uint32_t seq)
+{
+    for (uint8_t i = CLEAR; i < RING_TEST_ITEM_LEN; i++)
+    {
+        item[i] = (uint16_t)(seq * RING_TEST_ITEM_LEN + i); 
+    }
+}
+
+
+// Randomized producer/consumer interleaving 
+void ring_random_run(
+    log_ring_t& ring, 
+    uint8_t producer_weight, 
+    uint32_t& pushed, 
+    uint32_t& popped, 
+    uint32_t& dropped, 
+    uint32_t& max_count)
+{
+    uint16_t item[RING_TEST_ITEM_LEN], expected[RING_TEST_ITEM_LEN]; 
+    uint32_t produce_seq = CLEAR, consume_seq = CLEAR, count = CLEAR; 
+
+    pushed = popped = dropped = max_count = CLEAR; 
+
+    for (uint32_t i = CLEAR; i < RING_TEST_NUM_OPS; i++)
+    {
+        if ((uint8_t)(rand() % 100) < producer_weight)
+        {
+            // ISR - every interval produces a sample even if it ends up being dropped 
+            ring_item_make(item, produce_seq); 
+
+            if (log_ring_push(&ring, (void *)item))
+            {
+                // Only items that made it into the ring are expected out in order 
+                produce_seq++; 
+                pushed++; 
+
+                if (++count > max_count)
+                {
+                    max_count = count; 
+                }
+            }
+            else 
+            {
+                dropped++; 
+                UNSIGNED_LONGS_EQUAL(RING_TEST_SIZE, count); 
+            }
+        }
+        else if (log_ring_pop(&ring, (void *)item))
+        {
+            // Consumer - items must come out whole and in the order they went in 
+            ring_item_make(expected, consume_seq++); 
+            MEMCMP_EQUAL(expected, item, sizeof(item)); 
+            popped++; 
+            count--; 
+        }
+        else 
+        {
+            UNSIGNED_LONGS_EQUAL(CLEAR, count); 
+        }
+
+        UNSIGNED_LONGS_EQUAL(count, log_ring_get_count(&ring)); 
+    }
+
+    // Drain what's left 
+    while (log_ring_pop(&ring, (void *)item))
+    {
+        ring_item_make(expected, consume_seq++); 
+        MEMCMP_EQUAL(expected, item, sizeof(item)); 
+        popped++; 
+    }
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Tests 
+
+// Ring: invalid size 
+TEST(log_ring_test, log_ring_invalid_size)
+{
+    uint16_t item[RING_TEST_ITEM_LEN] = { 1, 2, 3 }; 
+
+    UNSIGNED_LONGS_EQUAL(FALSE, 
+        log_ring_init(&ring, (void *)ring_buff, sizeof(ring_buff[0]), RING_TEST_SIZE - 1)); 
+    UNSIGNED_LONGS_EQUAL(FALSE, 
+        log_ring_init(&ring, (void *)ring_buff, sizeof(ring_buff[0]), CLEAR)); 
+
+    // A ring that failed to initialize drops everything 
+    UNSIGNED_LONGS_EQUAL(FALSE, log_ring_push(&ring, (void *)item)); 
+    UNSIGNED_LONGS_EQUAL(FALSE, log_ring_pop(&ring, (void *)item)); 
+    UNSIGNED_LONGS_EQUAL(1, log_ring_get_drops(&ring)); 
+}
+
+
+// Ring: empty and full 
+TEST(log_ring_test, log_ring_empty_full)
+{
+    uint16_t item[RING_TEST_ITEM_LEN], expected[RING_TEST_ITEM_LEN]; 
+
+    // Empty 
+    UNSIGNED_LONGS_EQUAL(FALSE, log_ring_pop(&ring, (void *)item)); 
+    UNSIGNED_LONGS_EQUAL(CLEAR, log_ring_get_count(&ring)); 
+
+    // Fill 
+    for (uint32_t i = CLEAR; i < RING_TEST_SIZE; i++)
+    {
+        ring_item_make(item, i); 
+        UNSIGNED_LONGS_EQUAL(TRUE, log_ring_push(&ring, (void *)item)); 
+    }
+
+    UNSIGNED_LONGS_EQUAL(RING_TEST_SIZE, log_ring_get_count(&ring)); 
+    UNSIGNED_LONGS_EQUAL(RING_TEST_SIZE, log_ring_get_hwm(&ring)); 
+
+    // Full - new items are dropped and the queued items are untouched 
+    ring_item_make(item, RING_TEST_SIZE); 
+    UNSIGNED_LONGS_EQUAL(FALSE, log_ring_push(&ring, (void *)item)); 
+    UNSIGNED_LONGS_EQUAL(FALSE, log_ring_push(&ring, (void *)item)); 
+    UNSIGNED_LONGS_EQUAL(2, log_ring_get_drops(&ring)); 
+
+    for (uint32_t i = CLEAR; i < RING_TEST_SIZE; i++)
+    {
+        ring_item_make(expected, i); 
+        UNSIGNED_LONGS_EQUAL(TRUE, log_ring_pop(&ring, (void *)item)); 
+        MEMCMP_EQUAL(expected, item, sizeof(item)); 
+    }
+
+    UNSIGNED_LONGS_EQUAL(FALSE, log_ring_pop(&ring, (void *)item)); 
+
+    // The high water mark and drops are kept until reset 
+    UNSIGNED_LONGS_EQUAL(RING_TEST_SIZE, log_ring_get_hwm(&ring)); 
+    log_ring_reset(&ring); 
+    UNSIGNED_LONGS_EQUAL(CLEAR, log_ring_get_hwm(&ring)); 
+    UNSIGNED_LONGS_EQUAL(CLEAR, log_ring_get_drops(&ring)); 
+}
+
+
+// Ring: index wrap 
+TEST(log_ring_test, log_ring_index_wrap)
+{
+    // The indexes are free running so they must still work when they overflow 
+    uint16_t item[RING_TEST_ITEM_LEN], expected[RING_TEST_ITEM_LEN]; 
+
+    ring.head = ring.tail = UINT32_MAX - (RING_TEST_SIZE / 2); 
+
+    for (uint32_t i = CLEAR; i < RING_TEST_SIZE; i++)
+    {
+        ring_item_make(item, i); 
+        UNSIGNED_LONGS_EQUAL(TRUE, log_ring_push(&ring, (void *)item)); 
+    }
+
+    UNSIGNED_LONGS_EQUAL(FALSE, log_ring_push(&ring, (void *)item)); 
+    UNSIGNED_LONGS_EQUAL(RING_TEST_SIZE, log_ring_get_count(&ring)); 
+
+    for (uint32_t i = CLEAR; i < RING_TEST_SIZE; i++)
+    {
+        ring_item_make(expected, i); 
+        UNSIGNED_LONGS_EQUAL(TRUE, log_ring_pop(&ring, (void *)item)); 
+        MEMCMP_EQUAL(expected, item, sizeof(item)); 
+    }
+
+    UNSIGNED_LONGS_EQUAL(CLEAR, log_ring_get_count(&ring)); 
+}
+
+
+// Ring: randomized interleavings 
+TEST(log_ring_test, log_ring_random_interleave)
+{
+    // Runs the producer and consumer in random orders. The producer weight is varied 
+    // from a consumer that keeps up easily to one that falls behind so the ring spends 
+    // time empty, part full and full. Every item that's not dropped must come out once 
+    // and in order, and the counters must match what the test saw. 
+
+    uint32_t pushed, popped, dropped, max_count; 
+
+    srand(RING_TEST_SEED); 
+
+    for (uint8_t run = CLEAR; run < RING_TEST_NUM_RUNS; run++)
+    {
+        uint8_t producer_weight = (uint8_t)(30 + run * 8); 
+
+        log_ring_reset(&ring); 
+        ring_random_run(ring, producer_weight, pushed, popped, dropped, max_count); 
+
+        UNSIGNED_LONGS_EQUAL(pushed, popped); 
+        UNSIGNED_LONGS_EQUAL(dropped, log_ring_get_drops(&ring)); 
+        UNSIGNED_LONGS_EQUAL(max_count, log_ring_get_hwm(&ring)); 
+        CHECK(log_ring_get_hwm(&ring) <= RING_TEST_SIZE); 
+    }
+}
+
+//=======================================================================================
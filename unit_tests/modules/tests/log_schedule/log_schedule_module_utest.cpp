@@ -0,0 +1,183 @@
+/**
+ * @file log_schedule_module_utest.cpp
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief Log stream schedule module unit tests 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include <iostream>
+
+#include "CppUTest/TestHarness.h"
+
+extern "C"
+{
+	// Add your C-only include files here 
+    #include "log_schedule.h"
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define SCHED_TEST_HYPERPERIODS 3        // Hyperperiods each test runs for 
+#define SCHED_TEST_SLOTS (SCHED_TEST_HYPERPERIODS * LOG_SCHED_HYPERPERIOD) 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Test group 
+
+TEST_GROUP(log_schedule_test)
+{
+    // Global test group variables 
+    log_schedule_t sched; 
+
+    // Constructor 
+    void setup()
+    {
+        log_schedule_init(&sched); 
+    }
+
+    // Destructor 
+    void teardown()
+    {
+        // 
+    }
+}; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Tests 
+
+// Hyperperiod: every stream period divides it and nothing smaller fits them all 
+TEST(log_schedule_test, log_schedule_hyperperiod)
+{
+    const uint16_t periods[] = { LOG_GPS_PERIOD, LOG_ACCEL_PERIOD, LOG_SPEED_PERIOD }; 
+    uint16_t smallest = 0; 
+
+    for (uint16_t h = 1; (h <= LOG_SCHED_HYPERPERIOD) && !smallest; h++)
+    {
+        uint8_t fits = 1; 
+
+        for (uint8_t i = 0; i < (sizeof(periods) / sizeof(periods[0])); i++)
+        {
+            fits &= !(h % periods[i]); 
+        }
+
+        smallest = fits ? h : 0; 
+    }
+
+    LONGS_EQUAL(LOG_SCHED_HYPERPERIOD, smallest); 
+}
+
+
+// Select: each stream runs once per period starting from its offset 
+TEST(log_schedule_test, log_schedule_select_periods)
+{
+    const uint8_t streams[] = { LOG_SCHED_GPS, LOG_SCHED_ACCEL, LOG_SCHED_SPEED }; 
+    const uint8_t periods[] = { LOG_GPS_PERIOD, LOG_ACCEL_PERIOD, LOG_SPEED_PERIOD }; 
+    const uint8_t offsets[] = { LOG_GPS_OFFSET, LOG_ACCEL_OFFSET, LOG_SPEED_OFFSET }; 
+    uint16_t runs[LOG_SCHED_NUM] = { 0 }; 
+
+    for (uint16_t slot = 1; slot <= SCHED_TEST_SLOTS; slot++)
+    {
+        uint8_t run = log_schedule_select(&sched); 
+
+        for (uint8_t i = 0; i < sizeof(streams); i++)
+        {
+            uint8_t due = !((offsets[i] + slot) % periods[i]); 
+
+            LONGS_EQUAL(due, !!(run & LOG_SCHED_BIT(streams[i]))); 
+            runs[streams[i]] += due; 
+        }
+    }
+
+    for (uint8_t i = 0; i < sizeof(streams); i++)
+    {
+        LONGS_EQUAL(SCHED_TEST_SLOTS / periods[i], runs[streams[i]]); 
+    }
+}
+
+
+// Select: the default schedule never has streams due together or deferred and every slot 
+// fits in the budget 
+TEST(log_schedule_test, log_schedule_select_no_collisions)
+{
+    LONGS_EQUAL(0, LOG_SCHED_GPS_ACCEL_COLLIDE); 
+    LONGS_EQUAL(0, LOG_SCHED_GPS_SPEED_COLLIDE); 
+    LONGS_EQUAL(0, LOG_SCHED_ACCEL_SPEED_COLLIDE); 
+
+    for (uint16_t slot = 1; slot <= SCHED_TEST_SLOTS; slot++)
+    {
+        uint8_t run = log_schedule_select(&sched); 
+
+        // At most one bit set 
+        LONGS_EQUAL(0, run & (run - 1)); 
+        LONGS_EQUAL(0, sched.deferred); 
+        CHECK(log_schedule_cost(run) <= LOG_SLOT_BUDGET); 
+    }
+}
+
+
+// Select: the schedule starts over after init 
+TEST(log_schedule_test, log_schedule_init_restart)
+{
+    uint8_t first[LOG_SCHED_HYPERPERIOD]; 
+
+    for (uint16_t slot = 0; slot < LOG_SCHED_HYPERPERIOD; slot++)
+    {
+        first[slot] = log_schedule_select(&sched); 
+    }
+
+    // Part way through a hyperperiod 
+    log_schedule_select(&sched); 
+    log_schedule_select(&sched); 
+    log_schedule_init(&sched); 
+
+    for (uint16_t slot = 0; slot < LOG_SCHED_HYPERPERIOD; slot++)
+    {
+        LONGS_EQUAL(first[slot], log_schedule_select(&sched)); 
+    }
+}
+
+
+// Due: one stream counted on its own and the standard stream is never due 
+TEST(log_schedule_test, log_schedule_due_single)
+{
+    for (uint16_t slot = 1; slot <= LOG_SCHED_HYPERPERIOD; slot++)
+    {
+        LONGS_EQUAL(!((LOG_ACCEL_OFFSET + slot) % LOG_ACCEL_PERIOD), 
+                    log_schedule_due(&sched, LOG_SCHED_ACCEL)); 
+        LONGS_EQUAL(0, log_schedule_due(&sched, LOG_SCHED_STANDARD)); 
+    }
+}
+
+
+// Cost: summed over a set of streams 
+TEST(log_schedule_test, log_schedule_cost_sets)
+{
+    LONGS_EQUAL(0, log_schedule_cost(0)); 
+    LONGS_EQUAL(0, log_schedule_cost(LOG_SCHED_BIT(LOG_SCHED_STANDARD))); 
+    LONGS_EQUAL(LOG_ACCEL_COST, log_schedule_cost(LOG_SCHED_BIT(LOG_SCHED_ACCEL))); 
+    LONGS_EQUAL(LOG_GPS_COST + LOG_ACCEL_COST + LOG_SPEED_COST, 
+                log_schedule_cost(LOG_SCHED_BIT(LOG_SCHED_GPS) |
+                                  LOG_SCHED_BIT(LOG_SCHED_ACCEL) |
+                                  LOG_SCHED_BIT(LOG_SCHED_SPEED))); 
+}
+
+//=======================================================================================
@@ -0,0 +1,271 @@
+/**
+ * @file m8q_ubx_module_utest.cpp
+ * 
+ * @author Sam Donnelly (samueldonnelly11@gmail.com)
+ * 
+ * @brief SAM-M8Q UBX message parser module unit tests 
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+//=======================================================================================
+// Includes 
+
+#include <iostream>
+
+#include "CppUTest/TestHarness.h"
+
+extern "C"
+{
+	// Add your C-only include files here 
+    #include "m8q_ubx.h"
+}
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Macros 
+
+#define UBX_TEST_BUFF_LEN 512 
+#define UBX_TEST_LAT 492827291           // (1e-7 deg) Latitude used by the tests 
+#define UBX_TEST_LON -1231207570         // (1e-7 deg) Longitude used by the tests 
+#define UBX_TEST_SPEED 5432              // (mm/s) Ground speed used by the tests 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Test group 
+
+TEST_GROUP(m8q_ubx_test)
+{
+    // Global test group variables 
+    m8q_ubx_t ubx; 
+    m8q_ubx_nav_pvt_t pvt; 
+    uint8_t stream[UBX_TEST_BUFF_LEN]; 
+    uint16_t len; 
+
+    // Constructor 
+    void setup()
+    {
+        m8q_ubx_init(&ubx); 
+        memset((void *)stream, 0, sizeof(stream)); 
+        len = 0; 
+
+        memset((void *)&pvt, 0, sizeof(pvt)); 
+        pvt.iTOW = 345600123; 
+        pvt.year = 2026; 
+        pvt.month = 10; 
+        pvt.day = 16; 
+        pvt.hour = 14; 
+        pvt.min = 5; 
+        pvt.sec = 9; 
+        pvt.fixType = M8Q_UBX_FIX_3D; 
+        pvt.flags = M8Q_UBX_PVT_GNSS_FIX_OK; 
+        pvt.numSV = 11; 
+        pvt.lat = UBX_TEST_LAT; 
+        pvt.lon = UBX_TEST_LON; 
+        pvt.gSpeed = UBX_TEST_SPEED; 
+    }
+
+    // Destructor 
+    void teardown()
+    {
+        // 
+    }
+
+    // Add a UBX message to the stream the way the M8Q sends it 
+    void ubx_add_msg(
+        uint8_t msg_class, 
+        uint8_t msg_id, 
+        const void *payload, 
+        uint16_t payload_len)
+    {
+        uint8_t *msg = &stream[len], ck_a = 0, ck_b = 0; 
+
+        msg[0] = M8Q_UBX_SYNC_1; 
+        msg[1] = M8Q_UBX_SYNC_2; 
+        msg[2] = msg_class; 
+        msg[3] = msg_id; 
+        msg[4] = (uint8_t)payload_len; 
+        msg[5] = (uint8_t)(payload_len >> 8); 
+        memcpy((void *)&msg[6], payload, payload_len); 
+
+        for (uint16_t i = 2; i < (payload_len + 6); i++)
+        {
+            ck_a += msg[i]; 
+            ck_b += ck_a; 
+        }
+
+        msg[payload_len + 6] = ck_a; 
+        msg[payload_len + 7] = ck_b; 
+        len += payload_len + M8Q_UBX_FRAME_LEN; 
+    }
+
+    // Add text (NMEA) to the stream 
+    void ubx_add_text(const char *text)
+    {
+        memcpy((void *)&stream[len], (void *)text, strlen(text)); 
+        len += strlen(text); 
+    }
+
+    // Check the parsed NAV-PVT message against the one sent 
+    void ubx_check_pvt(void)
+    {
+        MEMCMP_EQUAL(&pvt, &ubx.pvt, sizeof(pvt)); 
+        LONGS_EQUAL(UBX_TEST_LAT, ubx.pvt.lat); 
+        LONGS_EQUAL(UBX_TEST_LON, ubx.pvt.lon); 
+        LONGS_EQUAL(UBX_TEST_SPEED, ubx.pvt.gSpeed); 
+    }
+}; 
+
+//=======================================================================================
+
+
+//=======================================================================================
+// Tests 
+
+// NAV-PVT: the payload is the size the message says 
+TEST(m8q_ubx_test, m8q_ubx_pvt_size)
+{
+    LONGS_EQUAL(M8Q_UBX_NAV_PVT_LEN, sizeof(m8q_ubx_nav_pvt_t)); 
+}
+
+
+// NAV-PVT: a whole message in one read 
+TEST(m8q_ubx_test, m8q_ubx_pvt_whole)
+{
+    ubx_add_msg(M8Q_UBX_CLASS_NAV, M8Q_UBX_ID_NAV_PVT, &pvt, sizeof(pvt)); 
+
+    LONGS_EQUAL(1, m8q_ubx_parse(&ubx, stream, len)); 
+    ubx_check_pvt(); 
+    LONGS_EQUAL(1, ubx.pvt_count); 
+    LONGS_EQUAL(0, ubx.errors); 
+}
+
+
+// NAV-PVT: a message split over reads (one byte at a time) 
+TEST(m8q_ubx_test, m8q_ubx_pvt_split)
+{
+    uint8_t found = 0; 
+
+    ubx_add_msg(M8Q_UBX_CLASS_NAV, M8Q_UBX_ID_NAV_PVT, &pvt, sizeof(pvt)); 
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        found += m8q_ubx_parse(&ubx, &stream[i], 1); 
+
+        // Nothing changes until the checksum is read 
+        if (i < (len - 1))
+        {
+            LONGS_EQUAL(0, found); 
+            LONGS_EQUAL(0, ubx.pvt.lat); 
+        }
+    }
+
+    LONGS_EQUAL(1, found); 
+    ubx_check_pvt(); 
+}
+
+
+// NAV-PVT: other messages and text around it are skipped 
+TEST(m8q_ubx_test, m8q_ubx_pvt_mixed)
+{
+    const uint8_t ack[] = { 0x06, 0x01 }; 
+    const uint8_t other[20] = { M8Q_UBX_SYNC_1, M8Q_UBX_SYNC_2 }; 
+
+    ubx_add_text("$GNGGA,,,,,,0,00,99.99,,,,,,*56\r\n"); 
+    ubx_add_msg(0x05, 0x01, ack, sizeof(ack)); 
+    ubx_add_msg(M8Q_UBX_CLASS_NAV, 0x03, other, sizeof(other)); 
+
+    // A stray sync character right before a message 
+    stream[len++] = M8Q_UBX_SYNC_1; 
+    ubx_add_msg(M8Q_UBX_CLASS_NAV, M8Q_UBX_ID_NAV_PVT, &pvt, sizeof(pvt)); 
+    ubx_add_text("$GNGLL,,,,,,V,N*7A\r\n"); 
+
+    LONGS_EQUAL(1, m8q_ubx_parse(&ubx, stream, len)); 
+    ubx_check_pvt(); 
+    LONGS_EQUAL(0, ubx.errors); 
+}
+
+
+// NAV-PVT: a message with a bad checksum is dropped and the last good one is kept 
+TEST(m8q_ubx_test, m8q_ubx_pvt_checksum)
+{
+    ubx_add_msg(M8Q_UBX_CLASS_NAV, M8Q_UBX_ID_NAV_PVT, &pvt, sizeof(pvt)); 
+    LONGS_EQUAL(1, m8q_ubx_parse(&ubx, stream, len)); 
+
+    // Payload byte corrupted 
+    len = 0; 
+    pvt.lat = -UBX_TEST_LAT; 
+    ubx_add_msg(M8Q_UBX_CLASS_NAV, M8Q_UBX_ID_NAV_PVT, &pvt, sizeof(pvt)); 
+    stream[20] ^= 0x01; 
+    LONGS_EQUAL(0, m8q_ubx_parse(&ubx, stream, len)); 
+    LONGS_EQUAL(UBX_TEST_LAT, ubx.pvt.lat); 
+
+    // Second checksum byte corrupted 
+    stream[20] ^= 0x01; 
+    stream[len - 1] ^= 0x01; 
+    LONGS_EQUAL(0, m8q_ubx_parse(&ubx, stream, len)); 
+    LONGS_EQUAL(UBX_TEST_LAT, ubx.pvt.lat); 
+    LONGS_EQUAL(2, ubx.errors); 
+
+    // The next good message is still found 
+    stream[len - 1] ^= 0x01; 
+    LONGS_EQUAL(1, m8q_ubx_parse(&ubx, stream, len)); 
+    LONGS_EQUAL(-UBX_TEST_LAT, ubx.pvt.lat); 
+}
+
+
+// NAV-PVT: several messages in one read 
+TEST(m8q_ubx_test, m8q_ubx_pvt_multiple)
+{
+    ubx_add_msg(M8Q_UBX_CLASS_NAV, M8Q_UBX_ID_NAV_PVT, &pvt, sizeof(pvt)); 
+    pvt.iTOW += 1000; 
+    pvt.lat += 100; 
+    ubx_add_msg(M8Q_UBX_CLASS_NAV, M8Q_UBX_ID_NAV_PVT, &pvt, sizeof(pvt)); 
+
+    LONGS_EQUAL(2, m8q_ubx_parse(&ubx, stream, len)); 
+    LONGS_EQUAL(UBX_TEST_LAT + 100, ubx.pvt.lat); 
+    LONGS_EQUAL(2, ubx.pvt_count); 
+}
+
+
+// Navigation status: fix types 
+TEST(m8q_ubx_test, m8q_ubx_navstat)
+{
+    const struct { uint8_t fix, flags; char status[3]; uint8_t lock; } cases[] = 
+    {
+        { M8Q_UBX_FIX_NONE,    0,                                                "NF", 0 }, 
+        { M8Q_UBX_FIX_3D,      0,                                                "NF", 0 }, 
+        { M8Q_UBX_FIX_DR,      M8Q_UBX_PVT_GNSS_FIX_OK,                          "DR", 0 }, 
+        { M8Q_UBX_FIX_2D,      M8Q_UBX_PVT_GNSS_FIX_OK,                          "G2", 1 }, 
+        { M8Q_UBX_FIX_3D,      M8Q_UBX_PVT_GNSS_FIX_OK,                          "G3", 1 }, 
+        { M8Q_UBX_FIX_3D,      M8Q_UBX_PVT_GNSS_FIX_OK | M8Q_UBX_PVT_DIFF_SOLN,  "D3", 1 }, 
+        { M8Q_UBX_FIX_GNSS_DR, M8Q_UBX_PVT_GNSS_FIX_OK,                          "RK", 1 }, 
+        { M8Q_UBX_FIX_TIME,    M8Q_UBX_PVT_GNSS_FIX_OK,                          "TT", 0 }
+    }; 
+
+    for (uint8_t i = 0; i < (sizeof(cases) / sizeof(cases[0])); i++)
+    {
+        pvt.fixType = cases[i].fix; 
+        pvt.flags = cases[i].flags; 
+
+        uint16_t navstat = m8q_ubx_navstat(&pvt); 
+
+        BYTES_EQUAL(cases[i].status[0], navstat >> 8); 
+        BYTES_EQUAL(cases[i].status[1], navstat & 0xFF); 
+        LONGS_EQUAL(cases[i].lock, m8q_ubx_navstat_lock(&pvt)); 
+    }
+
+    // No fix before the first message 
+    m8q_ubx_init(&ubx); 
+    LONGS_EQUAL(0, m8q_ubx_navstat_lock(&ubx.pvt)); 
+}
+
+//=======================================================================================